@@ -188,6 +188,48 @@ extern void (*MEM_reset_peak_memory)(void);
 /** Get the peak memory usage in bytes, including mmap allocations. */
 extern size_t (*MEM_get_peak_memory)(void) ATTR_WARN_UNUSED_RESULT;
 
+/**
+ * Memory domains allow to account allocations to the subsystem which did them, without the need
+ * of the fully guarded allocator.
+ *
+ * The domain is stored in every allocated block, so that freeing it (from any domain or thread)
+ * decreases the counters of the domain the block was allocated in. The current domain is a
+ * per-thread state, tasks which run on other threads need to begin the domain on their own.
+ */
+typedef enum eMemDomain {
+  /** Allocations outside of any domain. */
+  MEM_DOMAIN_NONE = 0,
+  MEM_DOMAIN_DEPSGRAPH = 1,
+  MEM_DOMAIN_GEOMETRY_NODES = 2,
+  MEM_DOMAIN_IMAGE_CACHE = 3,
+  MEM_DOMAIN_UNDO = 4,
+  MEM_DOMAIN_RENDER = 5,
+} eMemDomain;
+
+#define MEM_DOMAIN_NUM 6
+
+/**
+ * Account all further allocations of the calling thread to the given domain.
+ *
+ * \return The previously active domain, which is to be passed to #MEM_domain_end.
+ */
+eMemDomain MEM_domain_begin(eMemDomain domain);
+/** Restore the domain which was active before the matching #MEM_domain_begin. */
+void MEM_domain_end(eMemDomain previous_domain);
+/** Domain which allocations of the calling thread are accounted to. */
+eMemDomain MEM_domain_current(void);
+/** Identifier of the domain, for printing and scripting. */
+const char *MEM_domain_name(eMemDomain domain);
+/** Print memory usage of all domains. */
+void MEM_domain_print_stats(void);
+
+/** Memory usage of the domain, in bytes. */
+extern size_t (*MEM_get_domain_memory_in_use)(eMemDomain domain);
+/** Number of memory blocks allocated in the domain which are not freed yet. */
+extern unsigned int (*MEM_get_domain_blocks_in_use)(eMemDomain domain);
+/** Peak memory usage of the domain since start or #MEM_reset_peak_memory, in bytes. */
+extern size_t (*MEM_get_domain_peak_memory)(eMemDomain domain) ATTR_WARN_UNUSED_RESULT;
+
 #ifdef __GNUC__
 #  define MEM_SAFE_FREE(v) \
     do { \
@@ -264,6 +306,27 @@ void MEM_use_guarded_allocator(void);
 #  include <type_traits>
 #  include <utility>
 
+/**
+ * Account allocations of the current thread to a memory domain for the lifetime of this object.
+ */
+class MEM_DomainScope {
+ private:
+  eMemDomain previous_domain_;
+
+ public:
+  explicit MEM_DomainScope(const eMemDomain domain) : previous_domain_(MEM_domain_begin(domain))
+  {
+  }
+
+  ~MEM_DomainScope()
+  {
+    MEM_domain_end(previous_domain_);
+  }
+
+  MEM_DomainScope(const MEM_DomainScope &other) = delete;
+  MEM_DomainScope &operator=(const MEM_DomainScope &other) = delete;
+};
+
 /**
  * Allocate new memory for and constructs an object of type #T.
  * #MEM_delete should be used to delete the object. Just calling #MEM_freeN is not enough when #T
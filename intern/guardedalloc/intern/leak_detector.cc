@@ -39,6 +39,9 @@ class MemLeakPrinter {
  public:
   ~MemLeakPrinter()
   {
+    if (mem_domain_print_on_exit) {
+      MEM_domain_print_stats();
+    }
     if (ignore_memleak) {
       return;
     }
@@ -26,6 +26,7 @@
 #include "../../source/blender/blenlib/BLI_strict_flags.h"
 
 #include <assert.h>
+#include <stdio.h> /* printf */
 
 #include "mallocn_intern.h"
 
@@ -60,11 +61,69 @@ size_t (*MEM_get_memory_in_use)(void) = MEM_lockfree_get_memory_in_use;
 unsigned int (*MEM_get_memory_blocks_in_use)(void) = MEM_lockfree_get_memory_blocks_in_use;
 void (*MEM_reset_peak_memory)(void) = MEM_lockfree_reset_peak_memory;
 size_t (*MEM_get_peak_memory)(void) = MEM_lockfree_get_peak_memory;
+size_t (*MEM_get_domain_memory_in_use)(eMemDomain domain) = MEM_lockfree_get_domain_memory_in_use;
+unsigned int (*MEM_get_domain_blocks_in_use)(eMemDomain domain) =
+    MEM_lockfree_get_domain_blocks_in_use;
+size_t (*MEM_get_domain_peak_memory)(eMemDomain domain) = MEM_lockfree_get_domain_peak_memory;
 
 #ifndef NDEBUG
 const char *(*MEM_name_ptr)(void *vmemh) = MEM_lockfree_name_ptr;
 #endif
 
+MEM_THREAD_LOCAL eMemDomain mem_thread_domain = MEM_DOMAIN_NONE;
+bool mem_domain_print_on_exit = false;
+
+eMemDomain MEM_domain_begin(eMemDomain domain)
+{
+  assert(domain >= MEM_DOMAIN_NONE && domain < MEM_DOMAIN_NUM);
+  const eMemDomain previous_domain = mem_thread_domain;
+  mem_thread_domain = domain;
+  return previous_domain;
+}
+
+void MEM_domain_end(eMemDomain previous_domain)
+{
+  mem_thread_domain = previous_domain;
+}
+
+eMemDomain MEM_domain_current(void)
+{
+  return mem_thread_domain;
+}
+
+const char *MEM_domain_name(eMemDomain domain)
+{
+  switch (domain) {
+    case MEM_DOMAIN_NONE:
+      return "NONE";
+    case MEM_DOMAIN_DEPSGRAPH:
+      return "DEPSGRAPH";
+    case MEM_DOMAIN_GEOMETRY_NODES:
+      return "GEOMETRY_NODES";
+    case MEM_DOMAIN_IMAGE_CACHE:
+      return "IMAGE_CACHE";
+    case MEM_DOMAIN_UNDO:
+      return "UNDO";
+    case MEM_DOMAIN_RENDER:
+      return "RENDER";
+  }
+  return "UNKNOWN";
+}
+
+void MEM_domain_print_stats(void)
+{
+  printf("\nMemory domains:\n");
+  printf(" %-16s %12s %12s %12s\n", "DOMAIN", "BLOCKS", "IN-USE-MiB", "PEAK-MiB");
+  for (int i = 0; i < MEM_DOMAIN_NUM; i++) {
+    const eMemDomain domain = (eMemDomain)i;
+    printf(" %-16s %12u %12.3f %12.3f\n",
+           MEM_domain_name(domain),
+           MEM_get_domain_blocks_in_use(domain),
+           (double)MEM_get_domain_memory_in_use(domain) / (double)(1024 * 1024),
+           (double)MEM_get_domain_peak_memory(domain) / (double)(1024 * 1024));
+  }
+}
+
 void *aligned_malloc(size_t size, size_t alignment)
 {
   /* #posix_memalign requires alignment to be a multiple of `sizeof(void *)`. */
@@ -139,6 +198,9 @@ void MEM_use_lockfree_allocator(void)
   MEM_get_memory_blocks_in_use = MEM_lockfree_get_memory_blocks_in_use;
   MEM_reset_peak_memory = MEM_lockfree_reset_peak_memory;
   MEM_get_peak_memory = MEM_lockfree_get_peak_memory;
+  MEM_get_domain_memory_in_use = MEM_lockfree_get_domain_memory_in_use;
+  MEM_get_domain_blocks_in_use = MEM_lockfree_get_domain_blocks_in_use;
+  MEM_get_domain_peak_memory = MEM_lockfree_get_domain_peak_memory;
 
 #ifndef NDEBUG
   MEM_name_ptr = MEM_lockfree_name_ptr;
@@ -170,6 +232,9 @@ void MEM_use_guarded_allocator(void)
   MEM_get_memory_blocks_in_use = MEM_guarded_get_memory_blocks_in_use;
   MEM_reset_peak_memory = MEM_guarded_reset_peak_memory;
   MEM_get_peak_memory = MEM_guarded_get_peak_memory;
+  MEM_get_domain_memory_in_use = MEM_guarded_get_domain_memory_in_use;
+  MEM_get_domain_blocks_in_use = MEM_guarded_get_domain_blocks_in_use;
+  MEM_get_domain_peak_memory = MEM_guarded_get_domain_peak_memory;
 
 #ifndef NDEBUG
   MEM_name_ptr = MEM_guarded_name_ptr;
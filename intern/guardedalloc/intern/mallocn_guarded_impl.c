@@ -97,7 +97,8 @@ typedef struct MemHead {
   const char *name;
   const char *nextname;
   int tag2;
-  short pad1;
+  /* #eMemDomain the block was allocated in. */
+  short domain;
   /* if non-zero aligned allocation was used and alignment is stored here. */
   short alignment;
 #ifdef DEBUG_MEMCOUNTER
@@ -162,6 +163,8 @@ static const char *check_memlist(MemHead *memh);
 
 static unsigned int totblock = 0;
 static size_t mem_in_use = 0, peak_mem = 0;
+static unsigned int domain_totblock[MEM_DOMAIN_NUM] = {0};
+static size_t domain_mem_in_use[MEM_DOMAIN_NUM] = {0}, domain_peak_mem[MEM_DOMAIN_NUM] = {0};
 
 static volatile struct localListBase _membase;
 static volatile struct localListBase *membase = &_membase;
@@ -240,6 +243,7 @@ void MEM_guarded_set_error_callback(void (*func)(const char *))
 void MEM_guarded_set_memory_debug(void)
 {
   malloc_debug_memset = true;
+  mem_domain_print_on_exit = true;
 }
 
 size_t MEM_guarded_allocN_len(const void *vmemh)
@@ -418,7 +422,7 @@ static void make_memhead_header(MemHead *memh, size_t len, const char *str)
   memh->name = str;
   memh->nextname = NULL;
   memh->len = len;
-  memh->pad1 = 0;
+  memh->domain = (short)mem_thread_domain;
   memh->alignment = 0;
   memh->tag2 = MEMTAG2;
 
@@ -435,6 +439,8 @@ static void make_memhead_header(MemHead *memh, size_t len, const char *str)
 
   atomic_add_and_fetch_u(&totblock, 1);
   atomic_add_and_fetch_z(&mem_in_use, len);
+  atomic_add_and_fetch_u(&domain_totblock[memh->domain], 1);
+  atomic_add_and_fetch_z(&domain_mem_in_use[memh->domain], len);
 
   mem_lock_thread();
   addtail(membase, &memh->next);
@@ -442,6 +448,9 @@ static void make_memhead_header(MemHead *memh, size_t len, const char *str)
     memh->nextname = MEMNEXT(memh->next)->name;
   }
   peak_mem = mem_in_use > peak_mem ? mem_in_use : peak_mem;
+  if (domain_mem_in_use[memh->domain] > domain_peak_mem[memh->domain]) {
+    domain_peak_mem[memh->domain] = domain_mem_in_use[memh->domain];
+  }
   mem_unlock_thread();
 }
 
@@ -715,6 +724,8 @@ void MEM_guarded_printmemlist_stats(void)
 
   mem_unlock_thread();
 
+  MEM_domain_print_stats();
+
 #ifdef HAVE_MALLOC_STATS
   printf("System Statistics:\n");
   malloc_stats();
@@ -1006,6 +1017,8 @@ static void rem_memblock(MemHead *memh)
 
   atomic_sub_and_fetch_u(&totblock, 1);
   atomic_sub_and_fetch_z(&mem_in_use, memh->len);
+  atomic_sub_and_fetch_u(&domain_totblock[memh->domain], 1);
+  atomic_sub_and_fetch_z(&domain_mem_in_use[memh->domain], memh->len);
 
 #ifdef DEBUG_MEMDUPLINAME
   if (memh->need_free_name)
@@ -1179,6 +1192,9 @@ void MEM_guarded_reset_peak_memory(void)
 {
   mem_lock_thread();
   peak_mem = mem_in_use;
+  for (int i = 0; i < MEM_DOMAIN_NUM; i++) {
+    domain_peak_mem[i] = domain_mem_in_use[i];
+  }
   mem_unlock_thread();
 }
 
@@ -1204,6 +1220,39 @@ unsigned int MEM_guarded_get_memory_blocks_in_use(void)
   return _totblock;
 }
 
+size_t MEM_guarded_get_domain_memory_in_use(eMemDomain domain)
+{
+  size_t _mem_in_use;
+
+  mem_lock_thread();
+  _mem_in_use = domain_mem_in_use[domain];
+  mem_unlock_thread();
+
+  return _mem_in_use;
+}
+
+unsigned int MEM_guarded_get_domain_blocks_in_use(eMemDomain domain)
+{
+  unsigned int _totblock;
+
+  mem_lock_thread();
+  _totblock = domain_totblock[domain];
+  mem_unlock_thread();
+
+  return _totblock;
+}
+
+size_t MEM_guarded_get_domain_peak_memory(eMemDomain domain)
+{
+  size_t _peak_mem;
+
+  mem_lock_thread();
+  _peak_mem = domain_peak_mem[domain];
+  mem_unlock_thread();
+
+  return _peak_mem;
+}
+
 #ifndef NDEBUG
 const char *MEM_guarded_name_ptr(void *vmemh)
 {
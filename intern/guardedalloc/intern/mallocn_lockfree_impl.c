@@ -20,7 +20,9 @@
  * Memory allocation which keeps track on allocated memory counters
  */
 
+#include <pthread.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h> /* printf */
 #include <stdlib.h>
 #include <string.h> /* memcpy */
@@ -46,6 +48,8 @@ typedef struct MemHeadAligned {
 
 static unsigned int totblock = 0;
 static size_t mem_in_use = 0, peak_mem = 0;
+static unsigned int domain_totblock[MEM_DOMAIN_NUM] = {0};
+static size_t domain_mem_in_use[MEM_DOMAIN_NUM] = {0}, domain_peak_mem[MEM_DOMAIN_NUM] = {0};
 static bool malloc_debug_memset = false;
 
 static void (*error_callback)(const char *) = NULL;
@@ -59,9 +63,99 @@ enum {
 #define MEMHEAD_ALIGNED_FROM_PTR(ptr) (((MemHeadAligned *)ptr) - 1)
 #define MEMHEAD_IS_ALIGNED(memhead) ((memhead)->len & (size_t)MEMHEAD_ALIGN_FLAG)
 
+/* The memory domain of a block is stored in the highest byte of its length. */
+#if UINTPTR_MAX > 0xffffffffu
+#  define MEMHEAD_DOMAIN_SHIFT 56
+#  define MEMHEAD_LEN_MASK \
+    ((((size_t)1 << MEMHEAD_DOMAIN_SHIFT) - 1) & ~((size_t)MEMHEAD_ALIGN_FLAG))
+#  define MEMHEAD_DOMAIN(memhead) ((eMemDomain)((memhead)->len >> MEMHEAD_DOMAIN_SHIFT))
+#  define MEMHEAD_DOMAIN_BITS(domain) ((size_t)(domain) << MEMHEAD_DOMAIN_SHIFT)
+#else
+/* There are no spare bits on 32 bit platforms, all blocks are accounted to #MEM_DOMAIN_NONE. */
+#  define MEMHEAD_LEN_MASK (~((size_t)MEMHEAD_ALIGN_FLAG))
+#  define MEMHEAD_DOMAIN(memhead) MEM_DOMAIN_NONE
+#  define MEMHEAD_DOMAIN_BITS(domain) ((size_t)0)
+#endif
+
 /* Uncomment this to have proper peak counter. */
 #define USE_ATOMIC_MAX
 
+/* Keep small freed blocks in per-thread free lists and accumulate memory statistics per thread,
+ * so that the common allocation pattern of many small short-lived blocks neither goes to the
+ * system allocator nor causes contention on the global counters.
+ *
+ * Address sanitizer needs to see every allocation to detect use-after-free, so the cache is not
+ * used there. */
+#if defined(__SANITIZE_ADDRESS__)
+#  define USE_THREAD_CACHE 0
+#elif defined(__has_feature)
+#  if __has_feature(address_sanitizer)
+#    define USE_THREAD_CACHE 0
+#  endif
+#endif
+#ifndef USE_THREAD_CACHE
+#  define USE_THREAD_CACHE 1
+#endif
+
+#ifdef _MSC_VER
+#  define MEM_THREAD_LOCAL __declspec(thread)
+#else
+#  define MEM_THREAD_LOCAL __thread
+#endif
+
+/* Granularity of the small size classes, also the minimum size of a cached block so that the
+ * free list link fits into it. */
+#define SIZE_CLASS_STEP 16
+/* Largest allocation (in bytes, without MemHead) which is served from the thread cache. */
+#define SIZE_CLASS_MAX_SIZE 256
+#define SIZE_CLASS_NUM (SIZE_CLASS_MAX_SIZE / SIZE_CLASS_STEP)
+/* Upper bound of memory kept in a free list of a single size class. */
+#define SIZE_CLASS_CACHE_MAX_BYTES (8 * 1024)
+
+/* Memory counters of a thread are merged into the global ones once they drift this far.
+ * Allocations of at least this size bypass the per-thread counters completely.
+ *
+ * The values returned by #MEM_lockfree_get_memory_in_use() and
+ * #MEM_lockfree_get_memory_blocks_in_use() include the pending counters of all threads, so they
+ * are exact when no other thread is allocating at the same time. The peak memory counter is only
+ * updated on merge and can be lower than the actual peak by at most this threshold per thread. */
+#define STATS_FLUSH_THRESHOLD (64 * 1024)
+#define STATS_FLUSH_THRESHOLD_BLOCKS 1024
+
+#define SIZE_CLASS_INDEX(len) (((len) + (SIZE_CLASS_STEP - 1)) / SIZE_CLASS_STEP)
+#define SIZE_CLASS_CAPACITY(index) ((size_t)(index)*SIZE_CLASS_STEP)
+
+typedef struct MemFreeBlock {
+  struct MemFreeBlock *next;
+} MemFreeBlock;
+
+typedef struct MemThreadCache {
+  struct MemThreadCache *next, *prev;
+
+  /* Changes of the memory counters which are not yet merged into the global ones. */
+  int64_t mem_in_use_delta;
+  int totblock_delta;
+  int64_t domain_mem_in_use_delta[MEM_DOMAIN_NUM];
+  int domain_totblock_delta[MEM_DOMAIN_NUM];
+
+  /* Freed blocks (pointing to the MemHead), index 0 is for zero sized allocations. */
+  MemFreeBlock *free_list[SIZE_CLASS_NUM + 1];
+  unsigned int free_list_len[SIZE_CLASS_NUM + 1];
+} MemThreadCache;
+
+#if USE_THREAD_CACHE
+static MEM_THREAD_LOCAL MemThreadCache *thread_cache = NULL;
+/* Set once the cache of the thread is destroyed on thread exit, further allocations done by
+ * other thread-local destructors go directly to the system allocator. */
+static MEM_THREAD_LOCAL bool thread_cache_finished = false;
+
+/* All the thread caches, so that the pending memory counters can be summed up. */
+static MemThreadCache *thread_caches = NULL;
+static pthread_mutex_t thread_caches_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t thread_cache_key;
+static pthread_once_t thread_cache_key_once = PTHREAD_ONCE_INIT;
+#endif
+
 MEM_INLINE void update_maximum(size_t *maximum_value, size_t value)
 {
 #ifdef USE_ATOMIC_MAX
@@ -90,10 +184,258 @@ print_error(const char *str, ...)
   }
 }
 
+MEM_INLINE void memory_usage_add_global(size_t len, eMemDomain domain)
+{
+  atomic_add_and_fetch_u(&totblock, 1);
+  update_maximum(&peak_mem, atomic_add_and_fetch_z(&mem_in_use, len));
+  atomic_add_and_fetch_u(&domain_totblock[domain], 1);
+  update_maximum(&domain_peak_mem[domain],
+                 atomic_add_and_fetch_z(&domain_mem_in_use[domain], len));
+}
+
+MEM_INLINE void memory_usage_sub_global(size_t len, eMemDomain domain)
+{
+  atomic_sub_and_fetch_u(&totblock, 1);
+  atomic_sub_and_fetch_z(&mem_in_use, len);
+  atomic_sub_and_fetch_u(&domain_totblock[domain], 1);
+  atomic_sub_and_fetch_z(&domain_mem_in_use[domain], len);
+}
+
+#if USE_THREAD_CACHE
+
+static void memory_usage_merge(unsigned int *r_totblock,
+                               size_t *r_mem_in_use,
+                               size_t *r_peak_mem,
+                               int totblock_delta,
+                               int64_t mem_in_use_delta)
+{
+  if (totblock_delta > 0) {
+    atomic_add_and_fetch_u(r_totblock, (unsigned int)totblock_delta);
+  }
+  else if (totblock_delta < 0) {
+    atomic_sub_and_fetch_u(r_totblock, (unsigned int)-totblock_delta);
+  }
+
+  if (mem_in_use_delta > 0) {
+    const size_t value = atomic_add_and_fetch_z(r_mem_in_use, (size_t)mem_in_use_delta);
+    /* Other threads might have merged frees of blocks whose allocation is still pending in yet
+     * another thread, so the global counter can temporarily wrap around. */
+    if ((int64_t)value > 0) {
+      update_maximum(r_peak_mem, value);
+    }
+  }
+  else if (mem_in_use_delta < 0) {
+    atomic_sub_and_fetch_z(r_mem_in_use, (size_t)-mem_in_use_delta);
+  }
+}
+
+static void thread_cache_flush_stats(MemThreadCache *cache)
+{
+  memory_usage_merge(
+      &totblock, &mem_in_use, &peak_mem, cache->totblock_delta, cache->mem_in_use_delta);
+  cache->totblock_delta = 0;
+  cache->mem_in_use_delta = 0;
+
+  for (int i = 0; i < MEM_DOMAIN_NUM; i++) {
+    memory_usage_merge(&domain_totblock[i],
+                       &domain_mem_in_use[i],
+                       &domain_peak_mem[i],
+                       cache->domain_totblock_delta[i],
+                       cache->domain_mem_in_use_delta[i]);
+    cache->domain_totblock_delta[i] = 0;
+    cache->domain_mem_in_use_delta[i] = 0;
+  }
+}
+
+/* Counters of a domain can drift independently of the total ones when blocks are freed from
+ * within another domain than they were allocated in, so both are checked. */
+MEM_INLINE bool memory_usage_delta_exceeded(int totblock_delta, int64_t mem_in_use_delta)
+{
+  return mem_in_use_delta >= STATS_FLUSH_THRESHOLD || mem_in_use_delta <= -STATS_FLUSH_THRESHOLD ||
+         totblock_delta >= STATS_FLUSH_THRESHOLD_BLOCKS ||
+         totblock_delta <= -STATS_FLUSH_THRESHOLD_BLOCKS;
+}
+
+static void thread_cache_free(void *data)
+{
+  MemThreadCache *cache = (MemThreadCache *)data;
+
+  pthread_mutex_lock(&thread_caches_lock);
+  thread_cache_flush_stats(cache);
+  if (cache->prev) {
+    cache->prev->next = cache->next;
+  }
+  else {
+    thread_caches = cache->next;
+  }
+  if (cache->next) {
+    cache->next->prev = cache->prev;
+  }
+  pthread_mutex_unlock(&thread_caches_lock);
+
+  for (int i = 0; i <= SIZE_CLASS_NUM; i++) {
+    MemFreeBlock *block = cache->free_list[i];
+    while (block) {
+      MemFreeBlock *next = block->next;
+      free(block);
+      block = next;
+    }
+  }
+  free(cache);
+
+  thread_cache = NULL;
+  thread_cache_finished = true;
+}
+
+static void thread_cache_key_create(void)
+{
+  pthread_key_create(&thread_cache_key, thread_cache_free);
+}
+
+static MemThreadCache *thread_cache_create(void)
+{
+  if (thread_cache_finished) {
+    return NULL;
+  }
+
+  pthread_once(&thread_cache_key_once, thread_cache_key_create);
+
+  MemThreadCache *cache = (MemThreadCache *)calloc(1, sizeof(MemThreadCache));
+  if (UNLIKELY(cache == NULL)) {
+    return NULL;
+  }
+
+  pthread_mutex_lock(&thread_caches_lock);
+  cache->next = thread_caches;
+  if (thread_caches) {
+    thread_caches->prev = cache;
+  }
+  thread_caches = cache;
+  pthread_mutex_unlock(&thread_caches_lock);
+
+  /* The key is only used to get notified about thread exit, main thread never calls this so its
+   * cache stays alive (and reachable from the list) until the very end. */
+  pthread_setspecific(thread_cache_key, cache);
+  thread_cache = cache;
+
+  return cache;
+}
+
+MEM_INLINE MemThreadCache *thread_cache_get(void)
+{
+  MemThreadCache *cache = thread_cache;
+  if (LIKELY(cache)) {
+    return cache;
+  }
+  return thread_cache_create();
+}
+
+#endif /* USE_THREAD_CACHE */
+
+MEM_INLINE void memory_usage_add(size_t len, eMemDomain domain)
+{
+#if USE_THREAD_CACHE
+  if (len < STATS_FLUSH_THRESHOLD) {
+    MemThreadCache *cache = thread_cache_get();
+    if (LIKELY(cache)) {
+      cache->totblock_delta++;
+      cache->mem_in_use_delta += (int64_t)len;
+      cache->domain_totblock_delta[domain]++;
+      cache->domain_mem_in_use_delta[domain] += (int64_t)len;
+      if (UNLIKELY(
+              memory_usage_delta_exceeded(cache->totblock_delta, cache->mem_in_use_delta) ||
+              memory_usage_delta_exceeded(cache->domain_totblock_delta[domain],
+                                          cache->domain_mem_in_use_delta[domain]))) {
+        thread_cache_flush_stats(cache);
+      }
+      return;
+    }
+  }
+#endif
+  memory_usage_add_global(len, domain);
+}
+
+MEM_INLINE void memory_usage_sub(size_t len, eMemDomain domain)
+{
+#if USE_THREAD_CACHE
+  if (len < STATS_FLUSH_THRESHOLD) {
+    MemThreadCache *cache = thread_cache_get();
+    if (LIKELY(cache)) {
+      cache->totblock_delta--;
+      cache->mem_in_use_delta -= (int64_t)len;
+      cache->domain_totblock_delta[domain]--;
+      cache->domain_mem_in_use_delta[domain] -= (int64_t)len;
+      if (UNLIKELY(
+              memory_usage_delta_exceeded(cache->totblock_delta, cache->mem_in_use_delta) ||
+              memory_usage_delta_exceeded(cache->domain_totblock_delta[domain],
+                                          cache->domain_mem_in_use_delta[domain]))) {
+        thread_cache_flush_stats(cache);
+      }
+      return;
+    }
+  }
+#endif
+  memory_usage_sub_global(len, domain);
+}
+
+/**
+ * Allocate a non-aligned block for `len` bytes of user data (already aligned to 4),
+ * small blocks are taken from the free lists of the thread cache when possible.
+ */
+MEM_INLINE MemHead *memhead_alloc(size_t len, bool clear)
+{
+#if USE_THREAD_CACHE
+  if (len <= SIZE_CLASS_MAX_SIZE) {
+    const size_t index = SIZE_CLASS_INDEX(len);
+    MemThreadCache *cache = thread_cache_get();
+    if (LIKELY(cache)) {
+      MemFreeBlock *block = cache->free_list[index];
+      if (block) {
+        cache->free_list[index] = block->next;
+        cache->free_list_len[index]--;
+        MemHead *memh = (MemHead *)block;
+        if (clear) {
+          memset(memh, 0, sizeof(MemHead) + len);
+        }
+        return memh;
+      }
+    }
+    /* All small blocks are allocated with the capacity of their size class, so that they can be
+     * put into the free list of that class when freed, on any thread. */
+    len = SIZE_CLASS_CAPACITY(index);
+  }
+#endif
+  if (clear) {
+    return (MemHead *)calloc(1, len + sizeof(MemHead));
+  }
+  return (MemHead *)malloc(len + sizeof(MemHead));
+}
+
+MEM_INLINE void memhead_free(MemHead *memh, size_t len)
+{
+#if USE_THREAD_CACHE
+  if (len <= SIZE_CLASS_MAX_SIZE) {
+    const size_t index = SIZE_CLASS_INDEX(len);
+    MemThreadCache *cache = thread_cache_get();
+    const size_t block_size = SIZE_CLASS_CAPACITY(index) + sizeof(MemHead);
+    if (LIKELY(cache) && cache->free_list_len[index] * block_size < SIZE_CLASS_CACHE_MAX_BYTES) {
+      MemFreeBlock *block = (MemFreeBlock *)memh;
+      block->next = cache->free_list[index];
+      cache->free_list[index] = block;
+      cache->free_list_len[index]++;
+      return;
+    }
+  }
+#else
+  (void)len;
+#endif
+  free(memh);
+}
+
 size_t MEM_lockfree_allocN_len(const void *vmemh)
 {
   if (vmemh) {
-    return MEMHEAD_FROM_PTR(vmemh)->len & ~((size_t)(MEMHEAD_ALIGN_FLAG));
+    return MEMHEAD_FROM_PTR(vmemh)->len & MEMHEAD_LEN_MASK;
   }
 
   return 0;
@@ -116,8 +458,7 @@ void MEM_lockfree_freeN(void *vmemh)
     return;
   }
 
-  atomic_sub_and_fetch_u(&totblock, 1);
-  atomic_sub_and_fetch_z(&mem_in_use, len);
+  memory_usage_sub(len, MEMHEAD_DOMAIN(memh));
 
   if (UNLIKELY(malloc_debug_memset && len)) {
     memset(memh + 1, 255, len);
@@ -127,7 +468,7 @@ void MEM_lockfree_freeN(void *vmemh)
     aligned_free(MEMHEAD_REAL_PTR(memh_aligned));
   }
   else {
-    free(memh);
+    memhead_free(memh, len);
   }
 }
 
@@ -233,13 +574,11 @@ void *MEM_lockfree_callocN(size_t len, const char *str)
 
   len = SIZET_ALIGN_4(len);
 
-  memh = (MemHead *)calloc(1, len + sizeof(MemHead));
+  memh = memhead_alloc(len, true);
 
   if (LIKELY(memh)) {
-    memh->len = len;
-    atomic_add_and_fetch_u(&totblock, 1);
-    atomic_add_and_fetch_z(&mem_in_use, len);
-    update_maximum(&peak_mem, mem_in_use);
+    memh->len = len | MEMHEAD_DOMAIN_BITS(mem_thread_domain);
+    memory_usage_add(len, mem_thread_domain);
 
     return PTR_FROM_MEMHEAD(memh);
   }
@@ -274,17 +613,15 @@ void *MEM_lockfree_mallocN(size_t len, const char *str)
 
   len = SIZET_ALIGN_4(len);
 
-  memh = (MemHead *)malloc(len + sizeof(MemHead));
+  memh = memhead_alloc(len, false);
 
   if (LIKELY(memh)) {
     if (UNLIKELY(malloc_debug_memset && len)) {
       memset(memh + 1, 255, len);
     }
 
-    memh->len = len;
-    atomic_add_and_fetch_u(&totblock, 1);
-    atomic_add_and_fetch_z(&mem_in_use, len);
-    update_maximum(&peak_mem, mem_in_use);
+    memh->len = len | MEMHEAD_DOMAIN_BITS(mem_thread_domain);
+    memory_usage_add(len, mem_thread_domain);
 
     return PTR_FROM_MEMHEAD(memh);
   }
@@ -351,11 +688,9 @@ void *MEM_lockfree_mallocN_aligned(size_t len, size_t alignment, const char *str
       memset(memh + 1, 255, len);
     }
 
-    memh->len = len | (size_t)MEMHEAD_ALIGN_FLAG;
+    memh->len = len | (size_t)MEMHEAD_ALIGN_FLAG | MEMHEAD_DOMAIN_BITS(mem_thread_domain);
     memh->alignment = (short)alignment;
-    atomic_add_and_fetch_u(&totblock, 1);
-    atomic_add_and_fetch_z(&mem_in_use, len);
-    update_maximum(&peak_mem, mem_in_use);
+    memory_usage_add(len, mem_thread_domain);
 
     return PTR_FROM_MEMHEAD(memh);
   }
@@ -382,8 +717,11 @@ void MEM_lockfree_callbackmemlist(void (*func)(void *))
 
 void MEM_lockfree_printmemlist_stats(void)
 {
-  printf("\ntotal memory len: %.3f MB\n", (double)mem_in_use / (double)(1024 * 1024));
-  printf("peak memory len: %.3f MB\n", (double)peak_mem / (double)(1024 * 1024));
+  printf("\ntotal memory len: %.3f MB\n",
+         (double)MEM_lockfree_get_memory_in_use() / (double)(1024 * 1024));
+  printf("peak memory len: %.3f MB\n",
+         (double)MEM_lockfree_get_peak_memory() / (double)(1024 * 1024));
+  MEM_domain_print_stats();
   printf(
       "\nFor more detailed per-block statistics run Blender with memory debugging command line "
       "argument.\n");
@@ -407,27 +745,85 @@ bool MEM_lockfree_consistency_check(void)
 void MEM_lockfree_set_memory_debug(void)
 {
   malloc_debug_memset = true;
+  mem_domain_print_on_exit = true;
 }
 
 size_t MEM_lockfree_get_memory_in_use(void)
 {
-  return mem_in_use;
+  size_t value = mem_in_use;
+#if USE_THREAD_CACHE
+  /* Pending changes are read without synchronization with their threads, which is fine since
+   * the result is only approximate while other threads are allocating. Unsigned overflow makes
+   * negative deltas work as expected. */
+  pthread_mutex_lock(&thread_caches_lock);
+  for (const MemThreadCache *cache = thread_caches; cache; cache = cache->next) {
+    value += (size_t)cache->mem_in_use_delta;
+  }
+  pthread_mutex_unlock(&thread_caches_lock);
+#endif
+  return value;
 }
 
 unsigned int MEM_lockfree_get_memory_blocks_in_use(void)
 {
-  return totblock;
+  unsigned int value = totblock;
+#if USE_THREAD_CACHE
+  pthread_mutex_lock(&thread_caches_lock);
+  for (const MemThreadCache *cache = thread_caches; cache; cache = cache->next) {
+    value += (unsigned int)cache->totblock_delta;
+  }
+  pthread_mutex_unlock(&thread_caches_lock);
+#endif
+  return value;
 }
 
 /* dummy */
 void MEM_lockfree_reset_peak_memory(void)
 {
-  peak_mem = mem_in_use;
+  peak_mem = MEM_lockfree_get_memory_in_use();
+  for (int i = 0; i < MEM_DOMAIN_NUM; i++) {
+    domain_peak_mem[i] = MEM_lockfree_get_domain_memory_in_use((eMemDomain)i);
+  }
 }
 
 size_t MEM_lockfree_get_peak_memory(void)
 {
-  return peak_mem;
+  const size_t value = MEM_lockfree_get_memory_in_use();
+  /* Peak is only updated when merging per-thread counters, make sure it is never below the
+   * current usage. */
+  return value > peak_mem ? value : peak_mem;
+}
+
+size_t MEM_lockfree_get_domain_memory_in_use(eMemDomain domain)
+{
+  size_t value = domain_mem_in_use[domain];
+#if USE_THREAD_CACHE
+  pthread_mutex_lock(&thread_caches_lock);
+  for (const MemThreadCache *cache = thread_caches; cache; cache = cache->next) {
+    value += (size_t)cache->domain_mem_in_use_delta[domain];
+  }
+  pthread_mutex_unlock(&thread_caches_lock);
+#endif
+  return value;
+}
+
+unsigned int MEM_lockfree_get_domain_blocks_in_use(eMemDomain domain)
+{
+  unsigned int value = domain_totblock[domain];
+#if USE_THREAD_CACHE
+  pthread_mutex_lock(&thread_caches_lock);
+  for (const MemThreadCache *cache = thread_caches; cache; cache = cache->next) {
+    value += (unsigned int)cache->domain_totblock_delta[domain];
+  }
+  pthread_mutex_unlock(&thread_caches_lock);
+#endif
+  return value;
+}
+
+size_t MEM_lockfree_get_domain_peak_memory(eMemDomain domain)
+{
+  const size_t value = MEM_lockfree_get_domain_memory_in_use(domain);
+  return value > domain_peak_mem[domain] ? value : domain_peak_mem[domain];
 }
 
 #ifndef NDEBUG
@@ -0,0 +1,78 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <thread>
+
+#include "BLI_utildefines.h"
+
+#include "MEM_guardedalloc.h"
+#include "guardedalloc_test_base.h"
+
+namespace {
+
+void DoBasicDomainChecks()
+{
+  const size_t depsgraph_memory = MEM_get_domain_memory_in_use(MEM_DOMAIN_DEPSGRAPH);
+  const unsigned int depsgraph_blocks = MEM_get_domain_blocks_in_use(MEM_DOMAIN_DEPSGRAPH);
+  const size_t undo_memory = MEM_get_domain_memory_in_use(MEM_DOMAIN_UNDO);
+
+  void *outside = MEM_mallocN(100, __func__);
+  EXPECT_EQ(MEM_get_domain_memory_in_use(MEM_DOMAIN_DEPSGRAPH), depsgraph_memory);
+
+  void *inside, *inside_aligned, *nested;
+  {
+    MEM_DomainScope scope(MEM_DOMAIN_DEPSGRAPH);
+    EXPECT_EQ(MEM_domain_current(), MEM_DOMAIN_DEPSGRAPH);
+    inside = MEM_callocN(1000, __func__);
+    inside_aligned = MEM_mallocN_aligned(200000, 64, __func__);
+    {
+      MEM_DomainScope nested_scope(MEM_DOMAIN_UNDO);
+      nested = MEM_mallocN(64, __func__);
+    }
+    EXPECT_EQ(MEM_domain_current(), MEM_DOMAIN_DEPSGRAPH);
+  }
+  EXPECT_EQ(MEM_domain_current(), MEM_DOMAIN_NONE);
+
+  EXPECT_EQ(MEM_allocN_len(inside), 1000u);
+  EXPECT_EQ(MEM_allocN_len(inside_aligned), 200000u);
+  EXPECT_EQ(MEM_get_domain_memory_in_use(MEM_DOMAIN_DEPSGRAPH), depsgraph_memory + 201000);
+  EXPECT_EQ(MEM_get_domain_blocks_in_use(MEM_DOMAIN_DEPSGRAPH), depsgraph_blocks + 2);
+  EXPECT_EQ(MEM_get_domain_memory_in_use(MEM_DOMAIN_UNDO), undo_memory + 64);
+  EXPECT_GE(MEM_get_domain_peak_memory(MEM_DOMAIN_DEPSGRAPH), depsgraph_memory + 201000);
+
+  /* Blocks are accounted to the domain they were allocated in, regardless of where they are
+   * freed. */
+  {
+    MEM_DomainScope scope(MEM_DOMAIN_RENDER);
+    MEM_freeN(inside);
+    MEM_freeN(nested);
+  }
+  std::thread thread([inside_aligned]() { MEM_freeN(inside_aligned); });
+  thread.join();
+  MEM_freeN(outside);
+
+  EXPECT_EQ(MEM_get_domain_memory_in_use(MEM_DOMAIN_DEPSGRAPH), depsgraph_memory);
+  EXPECT_EQ(MEM_get_domain_blocks_in_use(MEM_DOMAIN_DEPSGRAPH), depsgraph_blocks);
+  EXPECT_EQ(MEM_get_domain_memory_in_use(MEM_DOMAIN_UNDO), undo_memory);
+  EXPECT_EQ(MEM_get_domain_memory_in_use(MEM_DOMAIN_RENDER), 0u);
+}
+
+}  // namespace
+
+TEST_F(LockFreeAllocatorTest, memory_domains)
+{
+  DoBasicDomainChecks();
+}
+
+TEST_F(GuardedAllocatorTest, memory_domains)
+{
+  DoBasicDomainChecks();
+}
+
+TEST(guardedalloc, memory_domain_names)
+{
+  EXPECT_STREQ(MEM_domain_name(MEM_DOMAIN_NONE), "NONE");
+  EXPECT_STREQ(MEM_domain_name(MEM_DOMAIN_GEOMETRY_NODES), "GEOMETRY_NODES");
+  EXPECT_STREQ(MEM_domain_name(MEM_DOMAIN_IMAGE_CACHE), "IMAGE_CACHE");
+}
@@ -0,0 +1,136 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "BLI_utildefines.h"
+
+#include "MEM_guardedalloc.h"
+#include "PIL_time.h"
+#include "guardedalloc_test_base.h"
+
+namespace {
+
+constexpr int ALLOCATIONS_NUM = 1 << 12;
+constexpr int ITERATIONS_NUM = 64;
+
+/* Sizes typical for small structs and short arrays, deterministic so runs are comparable. */
+size_t allocation_size(const int i)
+{
+  return size_t(8 + (i * 37) % 240);
+}
+
+void allocate_and_free(void **pointers, const int num)
+{
+  for (int iteration = 0; iteration < ITERATIONS_NUM; iteration++) {
+    for (int i = 0; i < num; i++) {
+      pointers[i] = MEM_mallocN(allocation_size(i + iteration), __func__);
+    }
+    /* Free in a different order than allocated, like most real code does. */
+    for (int i = num - 1; i >= 0; i -= 2) {
+      MEM_freeN(pointers[i]);
+    }
+    for (int i = num - 2; i >= 0; i -= 2) {
+      MEM_freeN(pointers[i]);
+    }
+  }
+}
+
+void run_allocation_benchmark(const char *name, const int threads_num)
+{
+  std::vector<void *> pointers(size_t(ALLOCATIONS_NUM) * size_t(threads_num));
+  const int num = ALLOCATIONS_NUM;
+
+  const double time_start = PIL_check_seconds_timer();
+  std::vector<std::thread> threads;
+  for (int thread_index = 0; thread_index < threads_num; thread_index++) {
+    void **thread_pointers = &pointers[size_t(thread_index) * size_t(num)];
+    threads.emplace_back([thread_pointers, num]() { allocate_and_free(thread_pointers, num); });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  const double time = PIL_check_seconds_timer() - time_start;
+
+  printf("%s: %d threads, %d allocations: %.3f ms\n",
+         name,
+         threads_num,
+         ALLOCATIONS_NUM * ITERATIONS_NUM * threads_num,
+         time * 1000.0);
+}
+
+}  // namespace
+
+TEST_F(LockFreeAllocatorTest, performance_small_allocations)
+{
+  const size_t memory_in_use = MEM_get_memory_in_use();
+  const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  const int threads_num = std::max(int(std::thread::hardware_concurrency()), 1);
+  run_allocation_benchmark("Lock-free allocator", 1);
+  run_allocation_benchmark("Lock-free allocator", threads_num);
+
+  EXPECT_EQ(MEM_get_memory_in_use(), memory_in_use);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+}
+
+TEST_F(GuardedAllocatorTest, performance_small_allocations)
+{
+  run_allocation_benchmark("Guarded allocator", 1);
+}
+
+TEST_F(LockFreeAllocatorTest, memory_in_use_cross_thread_free)
+{
+  const size_t memory_in_use = MEM_get_memory_in_use();
+  const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  /* Blocks allocated on one thread and freed on another one, so the pending counters of the
+   * threads go in opposite directions. */
+  std::vector<void *> pointers(ALLOCATIONS_NUM);
+  std::thread producer([&pointers]() {
+    for (int i = 0; i < ALLOCATIONS_NUM; i++) {
+      pointers[i] = MEM_callocN(allocation_size(i), __func__);
+    }
+  });
+  producer.join();
+
+  size_t allocated_size = 0;
+  for (int i = 0; i < ALLOCATIONS_NUM; i++) {
+    allocated_size += MEM_allocN_len(pointers[i]);
+  }
+  EXPECT_EQ(MEM_get_memory_in_use(), memory_in_use + allocated_size);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use + ALLOCATIONS_NUM);
+  EXPECT_GE(MEM_get_peak_memory(), memory_in_use + allocated_size);
+
+  std::thread consumer([&pointers]() {
+    for (int i = 0; i < ALLOCATIONS_NUM; i++) {
+      MEM_freeN(pointers[i]);
+    }
+  });
+  consumer.join();
+
+  EXPECT_EQ(MEM_get_memory_in_use(), memory_in_use);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+}
+
+TEST_F(LockFreeAllocatorTest, cached_block_reuse)
+{
+  /* Re-used small blocks must keep the semantic of the allocation function. */
+  for (int i = 0; i < 64; i++) {
+    char *data = (char *)MEM_mallocN(size_t(i), __func__);
+    memset(data, 0xff, size_t(i));
+    EXPECT_EQ(MEM_allocN_len(data), (size_t(i) + 3) & ~size_t(3));
+    MEM_freeN(data);
+
+    data = (char *)MEM_callocN(size_t(i), __func__);
+    for (int j = 0; j < i; j++) {
+      EXPECT_EQ(data[j], 0);
+    }
+    MEM_freeN(data);
+  }
+}
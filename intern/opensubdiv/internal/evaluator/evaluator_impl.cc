@@ -151,6 +151,83 @@ void convertPatchCoordsToArray(const OpenSubdiv_PatchCoord *patch_coords,
   }
 }
 
+bool isPatchCoordLess(const PatchCoord &a, const PatchCoord &b)
+{
+  if (a.handle.arrayIndex != b.handle.arrayIndex) {
+    return a.handle.arrayIndex < b.handle.arrayIndex;
+  }
+  return a.handle.patchIndex < b.handle.patchIndex;
+}
+
+// Get order in which patch coordinates are to be evaluated, so that coordinates which belong to
+// the same patch are evaluated together and patch data is accessed in a cache friendly manner.
+//
+// The order is left empty when coordinates are already sorted by their patch, which is the
+// common case for coordinates generated by iterating over ptex faces.
+void getPatchCoordsEvaluationOrder(const PatchCoord *patch_coords,
+                                   const int num_patch_coords,
+                                   vector<int> *order)
+{
+  order->clear();
+  bool is_sorted = true;
+  for (int i = 1; i < num_patch_coords; ++i) {
+    if (isPatchCoordLess(patch_coords[i], patch_coords[i - 1])) {
+      is_sorted = false;
+      break;
+    }
+  }
+  if (is_sorted) {
+    return;
+  }
+  order->resize(num_patch_coords);
+  for (int i = 0; i < num_patch_coords; ++i) {
+    (*order)[i] = i;
+  }
+  std::stable_sort(order->begin(), order->end(), [&](const int a, const int b) {
+    return isPatchCoordLess(patch_coords[a], patch_coords[b]);
+  });
+}
+
+void reorderPatchCoords(const PatchCoord *patch_coords,
+                        const vector<int> &order,
+                        vector<PatchCoord> *sorted_patch_coords)
+{
+  sorted_patch_coords->clear();
+  sorted_patch_coords->reserve(order.size());
+  for (const int index : order) {
+    sorted_patch_coords->push_back(patch_coords[index]);
+  }
+}
+
+// Copy values which were evaluated in the given order back to their original position.
+void scatterSortedValues(const vector<int> &order,
+                         const float *sorted_values,
+                         const int num_components,
+                         float *values)
+{
+  const int num_values = order.size();
+  for (int i = 0; i < num_values; ++i) {
+    memcpy(&values[order[i] * num_components],
+           &sorted_values[i * num_components],
+           sizeof(float) * num_components);
+  }
+}
+
+void evaluatePatchesLimitInOrder(EvalOutputAPI::EvalOutput *implementation,
+                                 const PatchCoord *patch_coords,
+                                 const int num_patch_coords,
+                                 float *P,
+                                 float *dPdu,
+                                 float *dPdv)
+{
+  if (dPdu != NULL || dPdv != NULL) {
+    implementation->evalPatchesWithDerivatives(patch_coords, num_patch_coords, P, dPdu, dPdv);
+  }
+  else {
+    implementation->evalPatches(patch_coords, num_patch_coords, P);
+  }
+}
+
 }  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -309,13 +386,54 @@ void EvalOutputAPI::evaluatePatchesLimit(const OpenSubdiv_PatchCoord *patch_coor
 {
   StackOrHeapPatchCoordArray patch_coords_array;
   convertPatchCoordsToArray(patch_coords, num_patch_coords, patch_map_, &patch_coords_array);
-  if (dPdu != NULL || dPdv != NULL) {
-    implementation_->evalPatchesWithDerivatives(
-        patch_coords_array.data(), num_patch_coords, P, dPdu, dPdv);
+  vector<int> order;
+  getPatchCoordsEvaluationOrder(patch_coords_array.data(), num_patch_coords, &order);
+  if (order.empty()) {
+    evaluatePatchesLimitInOrder(
+        implementation_, patch_coords_array.data(), num_patch_coords, P, dPdu, dPdv);
+    return;
   }
-  else {
-    implementation_->evalPatches(patch_coords_array.data(), num_patch_coords, P);
+  vector<PatchCoord> sorted_patch_coords;
+  reorderPatchCoords(patch_coords_array.data(), order, &sorted_patch_coords);
+  const bool need_derivatives = (dPdu != NULL || dPdv != NULL);
+  vector<float> sorted_P(num_patch_coords * 3);
+  vector<float> sorted_dPdu(need_derivatives ? num_patch_coords * 3 : 0);
+  vector<float> sorted_dPdv(need_derivatives ? num_patch_coords * 3 : 0);
+  evaluatePatchesLimitInOrder(implementation_,
+                              sorted_patch_coords.data(),
+                              num_patch_coords,
+                              sorted_P.data(),
+                              need_derivatives ? sorted_dPdu.data() : NULL,
+                              need_derivatives ? sorted_dPdv.data() : NULL);
+  scatterSortedValues(order, sorted_P.data(), 3, P);
+  if (need_derivatives) {
+    scatterSortedValues(order, sorted_dPdu.data(), 3, dPdu);
+    scatterSortedValues(order, sorted_dPdv.data(), 3, dPdv);
+  }
+}
+
+void EvalOutputAPI::evaluatePatchesFaceVarying(const int face_varying_channel,
+                                               const OpenSubdiv_PatchCoord *patch_coords,
+                                               const int num_patch_coords,
+                                               float *face_varying)
+{
+  StackOrHeapPatchCoordArray patch_coords_array;
+  convertPatchCoordsToArray(patch_coords, num_patch_coords, patch_map_, &patch_coords_array);
+  vector<int> order;
+  getPatchCoordsEvaluationOrder(patch_coords_array.data(), num_patch_coords, &order);
+  if (order.empty()) {
+    implementation_->evalPatchesFaceVarying(
+        face_varying_channel, patch_coords_array.data(), num_patch_coords, face_varying);
+    return;
   }
+  vector<PatchCoord> sorted_patch_coords;
+  reorderPatchCoords(patch_coords_array.data(), order, &sorted_patch_coords);
+  vector<float> sorted_face_varying(num_patch_coords * 2);
+  implementation_->evalPatchesFaceVarying(face_varying_channel,
+                                          sorted_patch_coords.data(),
+                                          num_patch_coords,
+                                          sorted_face_varying.data());
+  scatterSortedValues(order, sorted_face_varying.data(), 2, face_varying);
 }
 
 void EvalOutputAPI::getPatchMap(OpenSubdiv_Buffer *patch_map_handles,
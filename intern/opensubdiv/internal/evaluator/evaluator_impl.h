@@ -137,6 +137,14 @@ class EvalOutputAPI {
                             float *dPdu,
                             float *dPdv);
 
+  // Evaluate face-varying data at the given coordinates.
+  //
+  // NOTE: Output array must point to a memory of size float[2]*num_patch_coords.
+  void evaluatePatchesFaceVarying(const int face_varying_channel,
+                                  const OpenSubdiv_PatchCoord *patch_coords,
+                                  const int num_patch_coords,
+                                  float *face_varying);
+
   // Fill the output buffers and variables with data from the PatchMap.
   void getPatchMap(OpenSubdiv_Buffer *patch_map_handles,
                    OpenSubdiv_Buffer *patch_map_quadtree,
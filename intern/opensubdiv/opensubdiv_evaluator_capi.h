@@ -146,6 +146,9 @@ typedef struct OpenSubdiv_Evaluator {
                               float face_varying[2]);
 
   // Batched evaluation of multiple input coordinates.
+  //
+  // Coordinates do not need to be in any particular order: they are evaluated grouped by their
+  // patch, and the results are written in the order of the input coordinates.
 
   // Evaluate limit surface.
   // If derivatives are NULL, they will not be evaluated.
@@ -158,6 +161,15 @@ typedef struct OpenSubdiv_Evaluator {
                                float *dPdu,
                                float *dPdv);
 
+  // Evaluate face-varying data.
+  //
+  // NOTE: Output array must point to a memory of size float[2]*num_patch_coords.
+  void (*evaluatePatchesFaceVarying)(struct OpenSubdiv_Evaluator *evaluator,
+                                     const int face_varying_channel,
+                                     const struct OpenSubdiv_PatchCoord *patch_coords,
+                                     const int num_patch_coords,
+                                     float *face_varying);
+
   // Copy the patch map to the given buffers, and output some topology information.
   void (*getPatchMap)(struct OpenSubdiv_Evaluator *evaluator,
                       struct OpenSubdiv_Buffer *patch_map_handles,
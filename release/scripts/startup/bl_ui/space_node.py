@@ -694,6 +694,9 @@ class NODE_PT_quality(bpy.types.Panel):
         col.prop(tree, "use_opencl")
         col.prop(tree, "use_groupnode_buffer")
         col.prop(tree, "use_two_pass")
+        if prefs.experimental.use_full_frame_compositor and tree.execution_mode == 'FULL_FRAME':
+            col.prop(tree, "use_half_float_buffers")
+            col.prop(tree, "use_viewer_region_first")
         col.prop(tree, "use_viewer_border")
         col.separator()
         col.prop(snode, "use_auto_render")
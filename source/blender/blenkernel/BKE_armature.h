@@ -664,6 +664,32 @@ void BKE_armature_deform_coords_with_editmesh(const struct Object *ob_arm,
                                               const char *defgrp_name,
                                               struct BMEditMesh *em_target);
 
+/**
+ * Prepare deforming the coordinates of a mesh in separate ranges, for combining the armature
+ * deform with other deform modifiers. No deform matrices are computed.
+ *
+ * \return NULL when the armature doesn't deform anything.
+ */
+struct ArmatureDeformCoordsData *BKE_armature_deform_coords_data_create_with_mesh(
+    const struct Object *ob_arm,
+    const struct Object *ob_target,
+    float (*vert_coords)[3],
+    int deformflag,
+    float (*vert_coords_prev)[3],
+    const char *defgrp_name,
+    const struct Mesh *me_target);
+/**
+ * Deform the coordinates from \a start up to \a end, can be called from multiple threads.
+ */
+void BKE_armature_deform_coords_data_eval_range(
+    const struct ArmatureDeformCoordsData *deform_data, int start, int end);
+void BKE_armature_deform_coords_data_destroy(struct ArmatureDeformCoordsData *deform_data);
+
+/**
+ * Free the vertex group to bone tables cached on a mesh by armature deform.
+ */
+void BKE_armature_deform_skinning_cache_free(struct Mesh *mesh);
+
 /** \} */
 
 #ifdef __cplusplus
@@ -485,6 +485,12 @@ void CustomData_set_layer_stencil_index(struct CustomData *data, int type, int n
 void CustomData_set_layer_flag(struct CustomData *data, int type, int flag);
 void CustomData_clear_layer_flag(struct CustomData *data, int type, int flag);
 
+/**
+ * Allocate an (uninitialized) block from the layers memory pool, freeing any existing block.
+ * Allows filling the block data later from multiple threads, since the pool itself isn't
+ * thread-safe.
+ */
+void CustomData_bmesh_alloc_block(struct CustomData *data, void **block);
 void CustomData_bmesh_set_default(struct CustomData *data, void **block);
 void CustomData_bmesh_free_block(struct CustomData *data, void **block);
 /**
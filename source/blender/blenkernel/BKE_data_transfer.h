@@ -29,6 +29,7 @@
 extern "C" {
 #endif
 
+struct DataTransferRemapCache;
 struct Depsgraph;
 struct Object;
 struct ReportList;
@@ -163,6 +164,12 @@ bool BKE_object_data_transfer_mesh(struct Depsgraph *depsgraph,
                                    const char *vgroup_name,
                                    bool invert_vgroup,
                                    struct ReportList *reports);
+
+/**
+ * \param remap_cache: Optional storage for the computed geometry mappings, reused as long as the
+ * geometry and mapping settings they were computed from do not change (see
+ * #BKE_object_data_transfer_remap_cache_new).
+ */
 bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
                                  struct Scene *scene,
                                  struct Object *ob_src,
@@ -185,8 +192,12 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
                                  float mix_factor,
                                  const char *vgroup_name,
                                  bool invert_vgroup,
+                                 struct DataTransferRemapCache *remap_cache,
                                  struct ReportList *reports);
 
+struct DataTransferRemapCache *BKE_object_data_transfer_remap_cache_new(void);
+void BKE_object_data_transfer_remap_cache_free(struct DataTransferRemapCache *remap_cache);
+
 #ifdef __cplusplus
 }
 #endif
@@ -129,6 +129,27 @@ void BKE_lattice_deform_coords_with_editmesh(const struct Object *ob_lattice,
                                              float fac,
                                              struct BMEditMesh *em_target);
 
+/**
+ * Prepare deforming the coordinates of a mesh in separate ranges, for combining the lattice
+ * deform with other deform modifiers.
+ *
+ * \return NULL when \a ob_lattice is not a lattice.
+ */
+struct LatticeDeformCoordsData *BKE_lattice_deform_coords_data_create_with_mesh(
+    const struct Object *ob_lattice,
+    const struct Object *ob_target,
+    float (*vert_coords)[3],
+    short flag,
+    const char *defgrp_name,
+    float fac,
+    const struct Mesh *me_target) ATTR_WARN_UNUSED_RESULT;
+/**
+ * Deform the coordinates from \a start up to \a end, can be called from multiple threads.
+ */
+void BKE_lattice_deform_coords_data_eval_range(
+    const struct LatticeDeformCoordsData *deform_data, int start, int end);
+void BKE_lattice_deform_coords_data_destroy(struct LatticeDeformCoordsData *deform_data);
+
 /** \} */
 
 #ifdef __cplusplus
@@ -27,6 +27,8 @@ extern "C" {
 #endif
 
 struct MEdge;
+struct Mesh;
+struct MeshTopologyMaps;
 struct MLoop;
 struct MLoopTri;
 struct MLoopUV;
@@ -181,6 +183,20 @@ void BKE_mesh_edge_poly_map_create(MeshElemMap **r_map,
                                    int totpoly,
                                    const struct MLoop *mloop,
                                    int totloop);
+/**
+ * Cached versions of the maps above, built in parallel on first use and stored in the mesh
+ * runtime data, so all users of the mesh share them until its topology changes.
+ * The maps are owned by the mesh and must not be modified or freed.
+ */
+const MeshElemMap *BKE_mesh_vert_edge_map_ensure(const struct Mesh *mesh);
+const MeshElemMap *BKE_mesh_vert_poly_map_ensure(const struct Mesh *mesh);
+const MeshElemMap *BKE_mesh_edge_poly_map_ensure(const struct Mesh *mesh);
+/**
+ * The index of the polygon of each loop.
+ */
+const int *BKE_mesh_loop_poly_map_ensure(const struct Mesh *mesh);
+void BKE_mesh_topology_maps_free(struct MeshTopologyMaps *maps);
+
 /**
  * This function creates a map so the source-data (vert/edge/loop/poly)
  * can loop over the destination data (using the destination arrays origindex).
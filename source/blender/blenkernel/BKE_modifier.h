@@ -228,6 +228,30 @@ typedef struct ModifierTypeInfo {
                            float (*defMats)[3][3],
                            int numVerts);
 
+  /**
+   * Optional, for deform types where each vertex is deformed independently of the others, only
+   * based on its own coordinate. The modifier stack evaluates consecutive modifiers supporting
+   * this together over small ranges of vertices that stay in the CPU cache, instead of going
+   * over all vertices once per modifier.
+   *
+   * Prepare the deformation of \a vertexCos, returning the data passed to #deformVertsRange,
+   * or NULL when the current settings don't allow it, then #deformVerts is used instead.
+   * The coordinates must not be accessed here, previous modifiers may not have deformed them
+   * yet.
+   */
+  void *(*deformVertsRangeBegin)(struct ModifierData *md,
+                                 const struct ModifierEvalContext *ctx,
+                                 struct Mesh *mesh,
+                                 float (*vertexCos)[3],
+                                 int numVerts);
+  /**
+   * Deform the coordinates from \a start up to (not including) \a end, with exactly the same
+   * result as #deformVerts. Called from multiple threads for different ranges at once.
+   */
+  void (*deformVertsRange)(struct ModifierData *md, void *range_data, int start, int end);
+  /** Free the data returned by #deformVertsRangeBegin, after all ranges are deformed. */
+  void (*deformVertsRangeEnd)(struct ModifierData *md, void *range_data);
+
   /********************* Non-deform modifier functions *********************/
 
   /**
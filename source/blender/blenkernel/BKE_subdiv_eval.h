@@ -31,6 +31,7 @@ extern "C" {
 
 struct Mesh;
 struct OpenSubdiv_EvaluatorCache;
+struct OpenSubdiv_PatchCoord;
 struct Subdiv;
 
 typedef enum eSubdivEvaluatorType {
@@ -102,6 +103,28 @@ void BKE_subdiv_eval_displacement(struct Subdiv *subdiv,
 void BKE_subdiv_eval_final_point(
     struct Subdiv *subdiv, int ptex_face_index, float u, float v, float r_P[3]);
 
+/* Batched queries.
+ *
+ * Evaluate many points at once, which is much faster than evaluating them one by one: patches
+ * are looked up and evaluated in tight loops, and big batches are split between threads.
+ * Coordinates can be in any order, output arrays are indexed the same as the coordinates. */
+
+/* Evaluate points at a limit surface, with optional derivatives.
+ * Derivatives are either both NULL or both non-NULL. */
+void BKE_subdiv_eval_limit_patch_coords(struct Subdiv *subdiv,
+                                        const struct OpenSubdiv_PatchCoord *patch_coords,
+                                        int num_patch_coords,
+                                        float (*r_P)[3],
+                                        float (*r_dPdu)[3],
+                                        float (*r_dPdv)[3]);
+
+/* Evaluate face-varying layer (such as UV) at the given points. */
+void BKE_subdiv_eval_face_varying_patch_coords(struct Subdiv *subdiv,
+                                               int face_varying_channel,
+                                               const struct OpenSubdiv_PatchCoord *patch_coords,
+                                               int num_patch_coords,
+                                               float (*r_face_varying)[2]);
+
 #ifdef __cplusplus
 }
 #endif
@@ -883,6 +883,79 @@ static Mesh *modifier_modify_mesh_and_geometry_set(ModifierData *md,
   return mesh_output;
 }
 
+/**
+ * Applies deform modifiers, where consecutive modifiers supporting
+ * #ModifierTypeInfo.deformVertsRange are gathered and evaluated together. Each chunk of
+ * vertices is deformed by all of them while it is in the CPU cache, instead of going over all
+ * vertices once per modifier. Chunks are deformed in parallel.
+ *
+ * #flush must be called before the coordinates are used in any other way.
+ */
+class DeformModifierQueue {
+ private:
+  struct QueuedModifier {
+    ModifierData *md;
+    void *range_data;
+  };
+  blender::Vector<QueuedModifier> modifiers_;
+  float (*vert_coords_)[3] = nullptr;
+  int verts_len_ = 0;
+
+ public:
+  ~DeformModifierQueue()
+  {
+    BLI_assert(modifiers_.is_empty());
+  }
+
+  void deform_verts(ModifierData *md,
+                    const ModifierEvalContext *mectx,
+                    Mesh *mesh,
+                    float (*vert_coords)[3],
+                    const int verts_len)
+  {
+    const ModifierTypeInfo *mti = BKE_modifier_get_info((ModifierType)md->type);
+    if (mti->deformVertsRangeBegin != nullptr) {
+      if (vert_coords != vert_coords_) {
+        this->flush();
+      }
+      void *range_data = mti->deformVertsRangeBegin(md, mectx, mesh, vert_coords, verts_len);
+      if (range_data != nullptr) {
+        modifiers_.append({md, range_data});
+        vert_coords_ = vert_coords;
+        verts_len_ = verts_len;
+        return;
+      }
+    }
+    this->flush();
+    BKE_modifier_deform_verts(md, mectx, mesh, vert_coords, verts_len);
+  }
+
+  void flush()
+  {
+    if (modifiers_.is_empty()) {
+      return;
+    }
+    /* Small enough for the coordinates to stay in the cache between modifiers. */
+    const int chunk_size = 1024;
+    blender::threading::parallel_for(
+        blender::IndexRange(verts_len_), chunk_size, [&](const blender::IndexRange range) {
+          for (int start = range.start(); start < range.one_after_last(); start += chunk_size) {
+            const int end = std::min<int>(start + chunk_size, range.one_after_last());
+            for (const QueuedModifier &queued : modifiers_) {
+              const ModifierTypeInfo *mti = BKE_modifier_get_info((ModifierType)queued.md->type);
+              mti->deformVertsRange(queued.md, queued.range_data, start, end);
+            }
+          }
+        });
+    for (const QueuedModifier &queued : modifiers_) {
+      const ModifierTypeInfo *mti = BKE_modifier_get_info((ModifierType)queued.md->type);
+      mti->deformVertsRangeEnd(queued.md, queued.range_data);
+    }
+    modifiers_.clear();
+    vert_coords_ = nullptr;
+  }
+};
+
 static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
                                 Scene *scene,
                                 Object *ob,
@@ -916,6 +989,7 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
   float(*deformed_verts)[3] = nullptr;
   int num_deformed_verts = mesh_input->totvert;
   bool isPrevDeform = false;
+  DeformModifierQueue deform_queue;
 
   /* Mesh with constructive modifiers but no deformation applied. Tracked
    * along with final mesh if undeformed / orco coordinates are requested
@@ -989,6 +1063,7 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
           deformed_verts = BKE_mesh_vert_coords_alloc(mesh_input, &num_deformed_verts);
         }
         else if (isPrevDeform && mti->dependsOnNormals && mti->dependsOnNormals(md)) {
+          deform_queue.flush();
           if (mesh_final == nullptr) {
             mesh_final = BKE_mesh_copy_for_eval(mesh_input, true);
             ASSERT_IS_VALID_MESH(mesh_final);
@@ -996,7 +1071,7 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
           BKE_mesh_vert_coords_apply(mesh_final, deformed_verts);
         }
 
-        BKE_modifier_deform_verts(md, &mectx, mesh_final, deformed_verts, num_deformed_verts);
+        deform_queue.deform_verts(md, &mectx, mesh_final, deformed_verts, num_deformed_verts);
 
         isPrevDeform = true;
       }
@@ -1011,6 +1086,8 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
       }
     }
 
+    deform_queue.flush();
+
     /* Result of all leading deforming modifiers is cached for
      * places that wish to use the original mesh but with deformed
      * coordinates (like vertex paint). */
@@ -1105,15 +1182,18 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
       /* if this is not the last modifier in the stack then recalculate the normals
        * to avoid giving bogus normals to the next modifier see: T23673. */
       else if (isPrevDeform && mti->dependsOnNormals && mti->dependsOnNormals(md)) {
+        deform_queue.flush();
         if (mesh_final == nullptr) {
           mesh_final = BKE_mesh_copy_for_eval(mesh_input, true);
           ASSERT_IS_VALID_MESH(mesh_final);
         }
         BKE_mesh_vert_coords_apply(mesh_final, deformed_verts);
       }
-      BKE_modifier_deform_verts(md, &mectx, mesh_final, deformed_verts, num_deformed_verts);
+      deform_queue.deform_verts(md, &mectx, mesh_final, deformed_verts, num_deformed_verts);
     }
     else {
+      deform_queue.flush();
+
       bool check_for_needs_mapping = false;
       /* apply vertex coordinates or build a Mesh as necessary */
       if (mesh_final != nullptr) {
@@ -1294,6 +1374,8 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
     }
   }
 
+  deform_queue.flush();
+
   BLI_linklist_free((LinkNode *)datamasks, nullptr);
 
   for (md = firstmd; md; md = md->next) {
@@ -37,6 +37,7 @@
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
 
+#include "DNA_ID.h"
 #include "DNA_armature_types.h"
 #include "DNA_gpencil_types.h"
 #include "DNA_lattice_types.h"
@@ -56,6 +57,8 @@
 
 #include "CLG_log.h"
 
+#include "atomic_ops.h"
+
 static CLG_LogRef LOG = {"bke.armature_deform"};
 
 /* -------------------------------------------------------------------- */
@@ -96,6 +99,12 @@ static void pchan_deform_accumulate(const DualQuat *deform_dq,
   }
 }
 
+static bool pchan_use_bbone_deform(const bPoseChannel *pchan)
+{
+  const Bone *bone = pchan->bone;
+  return bone->segments > 1 && pchan->runtime.bbone_segments == bone->segments;
+}
+
 static void b_bone_deform(const bPoseChannel *pchan,
                           const float co[3],
                           float weight,
@@ -191,7 +200,7 @@ static float dist_bone_deform(
     fac *= bone->weight;
     contrib = fac;
     if (contrib > 0.0f) {
-      if (bone->segments > 1 && pchan->runtime.bbone_segments == bone->segments) {
+      if (pchan_use_bbone_deform(pchan)) {
         b_bone_deform(pchan, co, fac, vec, dq, mat);
       }
       else {
@@ -212,13 +221,11 @@ static void pchan_bone_deform(bPoseChannel *pchan,
                               const float co[3],
                               float *contrib)
 {
-  Bone *bone = pchan->bone;
-
   if (!weight) {
     return;
   }
 
-  if (bone->segments > 1 && pchan->runtime.bbone_segments == bone->segments) {
+  if (pchan_use_bbone_deform(pchan)) {
     b_bone_deform(pchan, co, weight, vec, dq, mat);
   }
   else {
@@ -231,6 +238,219 @@ static void pchan_bone_deform(bPoseChannel *pchan,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Armature Deform Skinning Cache
+ *
+ * Resolving #MDeformVert weights to bones means a lookup per weight and a scattered read of
+ * every vertex' weight array, on every evaluation. Evaluated meshes keep a compact table of
+ * the influences of deforming bones instead, which only depends on the vertex groups of the
+ * mesh and on which of them have a deforming bone, so it is shared by all armatures and
+ * objects with the same mapping. Changing the weights creates a new evaluated mesh, changing
+ * the bones changes the mapping, both cause the table to be rebuilt.
+ * \{ */
+
+/** Don't keep more tables than this on a single mesh, use the #MDeformVert data instead. */
+#define SKINNING_CACHE_MAX 4
+
+typedef struct ArmatureSkinningCache {
+  struct ArmatureSkinningCache *next;
+
+  /** Vertex group data the table was built from. */
+  const MDeformVert *dverts;
+  int dverts_len;
+
+  /** For every vertex group, whether it is used by a deforming bone. */
+  bool *defgroup_is_bone;
+  int defbase_len;
+
+  /** The vertex group of every bone used by the table. */
+  int *bone_defgroup;
+  int bones_len;
+
+  /** Influences of vertex `i` are in the range `vert_offsets[i]` to `vert_offsets[i + 1]`. */
+  int *vert_offsets;
+  /** Index in #bone_defgroup and weight of every influence. */
+  int *influence_bones;
+  float *influence_weights;
+} ArmatureSkinningCache;
+
+static ArmatureSkinningCache *skinning_cache_create(const MDeformVert *dverts,
+                                                    const int dverts_len,
+                                                    bool *defgroup_is_bone,
+                                                    const int defbase_len)
+{
+  ArmatureSkinningCache *skinning = MEM_callocN(sizeof(*skinning), __func__);
+  skinning->dverts = dverts;
+  skinning->dverts_len = dverts_len;
+  skinning->defgroup_is_bone = defgroup_is_bone;
+  skinning->defbase_len = defbase_len;
+
+  int *defgroup_bone = MEM_malloc_arrayN(defbase_len, sizeof(*defgroup_bone), __func__);
+  skinning->bone_defgroup = MEM_malloc_arrayN(
+      defbase_len, sizeof(*skinning->bone_defgroup), __func__);
+  for (int i = 0; i < defbase_len; i++) {
+    if (defgroup_is_bone[i]) {
+      defgroup_bone[i] = skinning->bones_len;
+      skinning->bone_defgroup[skinning->bones_len++] = i;
+    }
+    else {
+      defgroup_bone[i] = -1;
+    }
+  }
+
+  int *vert_offsets = MEM_malloc_arrayN(dverts_len + 1, sizeof(*vert_offsets), __func__);
+  int influences_len = 0;
+  for (int i = 0; i < dverts_len; i++) {
+    vert_offsets[i] = influences_len;
+    const MDeformWeight *dw = dverts[i].dw;
+    for (int j = 0; j < dverts[i].totweight; j++, dw++) {
+      if ((uint)dw->def_nr < (uint)defbase_len && defgroup_bone[dw->def_nr] != -1) {
+        influences_len++;
+      }
+    }
+  }
+  vert_offsets[dverts_len] = influences_len;
+
+  /* Influences keep the order of the weights, blending dual quaternions depends on it. */
+  int *influence_bones = MEM_malloc_arrayN(influences_len, sizeof(*influence_bones), __func__);
+  float *influence_weights = MEM_malloc_arrayN(
+      influences_len, sizeof(*influence_weights), __func__);
+  int influence = 0;
+  for (int i = 0; i < dverts_len; i++) {
+    const MDeformWeight *dw = dverts[i].dw;
+    for (int j = 0; j < dverts[i].totweight; j++, dw++) {
+      if ((uint)dw->def_nr < (uint)defbase_len && defgroup_bone[dw->def_nr] != -1) {
+        influence_bones[influence] = defgroup_bone[dw->def_nr];
+        influence_weights[influence] = dw->weight;
+        influence++;
+      }
+    }
+  }
+
+  skinning->vert_offsets = vert_offsets;
+  skinning->influence_bones = influence_bones;
+  skinning->influence_weights = influence_weights;
+
+  MEM_freeN(defgroup_bone);
+  return skinning;
+}
+
+static void skinning_cache_free(ArmatureSkinningCache *skinning)
+{
+  MEM_freeN(skinning->defgroup_is_bone);
+  MEM_freeN(skinning->bone_defgroup);
+  MEM_freeN(skinning->vert_offsets);
+  MEM_freeN(skinning->influence_bones);
+  MEM_freeN(skinning->influence_weights);
+  MEM_freeN(skinning);
+}
+
+static bool skinning_cache_matches(const ArmatureSkinningCache *skinning,
+                                   const MDeformVert *dverts,
+                                   const int dverts_len,
+                                   const bool *defgroup_is_bone,
+                                   const int defbase_len)
+{
+  return skinning->dverts == dverts && skinning->dverts_len == dverts_len &&
+         skinning->defbase_len == defbase_len &&
+         memcmp(skinning->defgroup_is_bone, defgroup_is_bone, sizeof(bool) * defbase_len) == 0;
+}
+
+/**
+ * Find or build the skinning table of an evaluated mesh.
+ *
+ * \return NULL when too many different bone mappings are used with this mesh.
+ */
+static const ArmatureSkinningCache *skinning_cache_ensure(const Mesh *mesh,
+                                                          bPoseChannel **pchan_from_defbase,
+                                                          const int defbase_len)
+{
+  bool *defgroup_is_bone = MEM_malloc_arrayN(defbase_len, sizeof(bool), __func__);
+  for (int i = 0; i < defbase_len; i++) {
+    defgroup_is_bone[i] = pchan_from_defbase[i] != NULL;
+  }
+
+  /* The tables are lazily initialized cache data, not part of the mesh state. */
+  void **skinning_p = (void **)&mesh->runtime.skinning_cache;
+
+  int skinning_len = 0;
+  for (ArmatureSkinningCache *skinning = *skinning_p; skinning; skinning = skinning->next) {
+    if (skinning_cache_matches(
+            skinning, mesh->dvert, mesh->totvert, defgroup_is_bone, defbase_len)) {
+      MEM_freeN(defgroup_is_bone);
+      return skinning;
+    }
+    skinning_len++;
+  }
+  if (skinning_len >= SKINNING_CACHE_MAX) {
+    MEM_freeN(defgroup_is_bone);
+    return NULL;
+  }
+
+  ArmatureSkinningCache *skinning = skinning_cache_create(
+      mesh->dvert, mesh->totvert, defgroup_is_bone, defbase_len);
+
+  /* Objects sharing the mesh may be evaluated at the same time. A table which was added by
+   * another thread in the meantime is a duplicate at worst, which is freed with the others. */
+  void *head;
+  do {
+    head = *skinning_p;
+    skinning->next = head;
+  } while (atomic_cas_ptr(skinning_p, head, skinning) != head);
+
+  return skinning;
+}
+
+void BKE_armature_deform_skinning_cache_free(Mesh *mesh)
+{
+  ArmatureSkinningCache *skinning = mesh->runtime.skinning_cache;
+  while (skinning) {
+    ArmatureSkinningCache *next = skinning->next;
+    skinning_cache_free(skinning);
+    skinning = next;
+  }
+  mesh->runtime.skinning_cache = NULL;
+}
+
+/** Bone of a skinning table, prepared for one evaluation. */
+typedef struct ArmatureSkinningBone {
+  bPoseChannel *pchan;
+  /**
+   * Index of the deform matrix in #ArmatureUserdata.skinning_mats,
+   * B-Bones have one matrix per segment.
+   */
+  int mat_index;
+  bool use_bbone;
+  bool use_envelope_multiply;
+  /** B-Bones only: Y axis of the B-Bone space divided by the bone length, to find the segments. */
+  float bbone_y_axis[4];
+} ArmatureSkinningBone;
+
+/**
+ * Add the effect of one bone or B-Bone segment to the blended matrix.
+ * Skinning matrices are affine, only their 3x3 part and translation are stored.
+ */
+static void skinning_mat_accumulate(const float deform_mat[4][3],
+                                    const float weight,
+                                    float mat_accum[4][3])
+{
+  /* Flat loop so the compiler can vectorize it. */
+  const float *__restrict src = &deform_mat[0][0];
+  float *__restrict dst = &mat_accum[0][0];
+  for (int i = 0; i < 12; i++) {
+    dst[i] += src[i] * weight;
+  }
+}
+
+static void skinning_mat_from_m4(float r_mat[4][3], const float mat[4][4])
+{
+  for (int axis = 0; axis < 4; axis++) {
+    copy_v3_v3(r_mat[axis], mat[axis]);
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Armature Deform #BKE_armature_deform_coords API
  *
@@ -258,6 +478,15 @@ typedef struct ArmatureUserdata {
   bPoseChannel **pchan_from_defbase;
   int defbase_len;
 
+  /** Cached influences of the vertex groups, used instead of `dverts` when set. */
+  const ArmatureSkinningCache *skinning;
+  ArmatureSkinningBone *skinning_bones;
+  /**
+   * Deform matrices of the skinning bones, including the conversion from and to the space of the
+   * deformed object.
+   */
+  float (*skinning_mats)[4][3];
+
   float premat[4][4];
   float postmat[4][4];
 
@@ -267,6 +496,143 @@ typedef struct ArmatureUserdata {
   } bmesh;
 } ArmatureUserdata;
 
+static void skinning_bones_init(ArmatureUserdata *data, bPoseChannel **pchan_from_defbase)
+{
+  const ArmatureSkinningCache *skinning = data->skinning;
+  ArmatureSkinningBone *skin_bones = MEM_malloc_arrayN(
+      skinning->bones_len, sizeof(*skin_bones), __func__);
+
+  int mats_len = 0;
+  for (int i = 0; i < skinning->bones_len; i++) {
+    bPoseChannel *pchan = pchan_from_defbase[skinning->bone_defgroup[i]];
+    skin_bones[i].pchan = pchan;
+    skin_bones[i].mat_index = mats_len;
+    skin_bones[i].use_bbone = pchan_use_bbone_deform(pchan);
+    skin_bones[i].use_envelope_multiply = (pchan->bone->flag & BONE_MULT_VG_ENV) != 0;
+    mats_len += skin_bones[i].use_bbone ? pchan->runtime.bbone_segments + 1 : 1;
+  }
+  data->skinning_bones = skin_bones;
+
+  float(*mats)[4][3] = MEM_malloc_arrayN(mats_len, sizeof(*mats), __func__);
+  float mat[4][4];
+  for (int i = 0; i < skinning->bones_len; i++) {
+    ArmatureSkinningBone *skin_bone = &skin_bones[i];
+    const bPoseChannel *pchan = skin_bone->pchan;
+    if (skin_bone->use_bbone) {
+      const Mat4 *bbone_mats = pchan->runtime.bbone_deform_mats;
+      float bbone_space[4][4];
+      mul_m4_m4m4(bbone_space, bbone_mats[0].mat, data->premat);
+      for (int axis = 0; axis < 4; axis++) {
+        skin_bone->bbone_y_axis[axis] = bbone_space[axis][1] / pchan->bone->length;
+      }
+      for (int segment = 0; segment <= pchan->runtime.bbone_segments; segment++) {
+        mul_m4_series(mat, data->postmat, bbone_mats[segment + 1].mat, data->premat);
+        skinning_mat_from_m4(mats[skin_bone->mat_index + segment], mat);
+      }
+    }
+    else {
+      mul_m4_series(mat, data->postmat, pchan->chan_mat, data->premat);
+      skinning_mat_from_m4(mats[skin_bone->mat_index], mat);
+    }
+  }
+  data->skinning_mats = mats;
+}
+
+/**
+ * Linear blending by the influences of the skinning table. The deform matrices already include
+ * the conversion to armature space and back, so the coordinate is only transformed once.
+ *
+ * \return false when the vertex has no influence of a deforming bone.
+ */
+static bool armature_vert_skinning_deform_linear(const ArmatureUserdata *data,
+                                                 const int i,
+                                                 float co[3],
+                                                 const float armature_weight)
+{
+  const ArmatureSkinningCache *skinning = data->skinning;
+  if (i >= skinning->dverts_len) {
+    return false;
+  }
+  const int influence_start = skinning->vert_offsets[i];
+  const int influence_end = skinning->vert_offsets[i + 1];
+  if (influence_start == influence_end) {
+    return false;
+  }
+
+  float blend_mat[4][3] = {{0.0f}};
+  float contrib = 0.0f;
+  /* Armature space coordinate, only needed for bones using their envelope. */
+  float co_arm[3];
+  bool has_co_arm = false;
+
+  for (int j = influence_start; j < influence_end; j++) {
+    const ArmatureSkinningBone *skin_bone = &data->skinning_bones[skinning->influence_bones[j]];
+    float weight = skinning->influence_weights[j];
+
+    if (skin_bone->use_envelope_multiply) {
+      const Bone *bone = skin_bone->pchan->bone;
+      if (!has_co_arm) {
+        mul_v3_m4v3(co_arm, data->premat, co);
+        has_co_arm = true;
+      }
+      weight *= distfactor_to_bone(
+          co_arm, bone->arm_head, bone->arm_tail, bone->rad_head, bone->rad_tail, bone->dist);
+    }
+    if (weight == 0.0f) {
+      continue;
+    }
+
+    const float(*mats)[4][3] = &data->skinning_mats[skin_bone->mat_index];
+    if (skin_bone->use_bbone) {
+      const float y = dot_v3v3(skin_bone->bbone_y_axis, co) + skin_bone->bbone_y_axis[3];
+      float blend;
+      int index;
+      BKE_pchan_bbone_deform_segment_index(skin_bone->pchan, y, &index, &blend);
+      skinning_mat_accumulate(mats[index], weight * (1.0f - blend), blend_mat);
+      skinning_mat_accumulate(mats[index + 1], weight * blend, blend_mat);
+    }
+    else {
+      skinning_mat_accumulate(mats[0], weight, blend_mat);
+    }
+    contrib += weight;
+  }
+
+  /* Same threshold as #armature_vert_task_with_dvert. */
+  if (contrib > 0.0001f) {
+    const float fac = armature_weight / contrib;
+    float vec[3];
+    copy_v3_v3(vec, blend_mat[3]);
+    madd_v3_v3fl(vec, blend_mat[0], co[0]);
+    madd_v3_v3fl(vec, blend_mat[1], co[1]);
+    madd_v3_v3fl(vec, blend_mat[2], co[2]);
+    madd_v3_v3fl(vec, co, -contrib);
+    madd_v3_v3fl(co, vec, fac);
+
+    if (data->vert_deform_mats) {
+      float smat[3][3], tmpmat[3][3];
+      copy_m3_m3(smat, blend_mat);
+      mul_m3_fl(smat, fac);
+      copy_m3_m3(tmpmat, data->vert_deform_mats[i]);
+      mul_m3_m3m3(data->vert_deform_mats[i], smat, tmpmat);
+    }
+  }
+
+  return true;
+}
+
+/* Interpolate with previous modifier position using weight group. */
+static void armature_vert_coords_prev_blend(const ArmatureUserdata *data,
+                                            const int i,
+                                            const float co[3],
+                                            const float prevco_weight)
+{
+  float mw = 1.0f - prevco_weight;
+  float *vert_co = data->vert_coords[i];
+  vert_co[0] = prevco_weight * vert_co[0] + mw * co[0];
+  vert_co[1] = prevco_weight * vert_co[1] + mw * co[1];
+  vert_co[2] = prevco_weight * vert_co[2] + mw * co[2];
+}
+
 static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
                                           const int i,
                                           const MDeformVert *dvert)
@@ -324,12 +690,19 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
   /* get the coord we work on */
   co = vert_coords_prev ? vert_coords_prev[i] : vert_coords[i];
 
+  if (data->skinning && armature_vert_skinning_deform_linear(data, i, co, armature_weight)) {
+    if (vert_coords_prev) {
+      armature_vert_coords_prev_blend(data, i, co, prevco_weight);
+    }
+    return;
+  }
+
   /* Apply the object's matrix */
   mul_m4_v3(data->premat, co);
 
+  bool deformed = false;
   if (use_dverts && dvert && dvert->totweight) { /* use weight groups ? */
     const MDeformWeight *dw = dvert->dw;
-    int deformed = 0;
     unsigned int j;
     for (j = dvert->totweight; j != 0; j--, dw++) {
       const uint index = dw->def_nr;
@@ -337,7 +710,7 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
         float weight = dw->weight;
         Bone *bone = pchan->bone;
 
-        deformed = 1;
+        deformed = true;
 
         if (bone && bone->flag & BONE_MULT_VG_ENV) {
           weight *= distfactor_to_bone(
@@ -347,16 +720,10 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
         pchan_bone_deform(pchan, weight, vec, dq, smat, co, &contrib);
       }
     }
-    /* If there are vertex-groups but not groups with bones (like for soft-body groups). */
-    if (deformed == 0 && use_envelope) {
-      for (pchan = data->ob_arm->pose->chanbase.first; pchan; pchan = pchan->next) {
-        if (!(pchan->bone->flag & BONE_NO_DEFORM)) {
-          contrib += dist_bone_deform(pchan, vec, dq, smat, co);
-        }
-      }
-    }
   }
-  else if (use_envelope) {
+
+  /* If there are no vertex-groups or not groups with bones (like for soft-body groups). */
+  if (!deformed && use_envelope) {
     for (pchan = data->ob_arm->pose->chanbase.first; pchan; pchan = pchan->next) {
       if (!(pchan->bone->flag & BONE_NO_DEFORM)) {
         contrib += dist_bone_deform(pchan, vec, dq, smat, co);
@@ -407,10 +774,7 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
 
   /* interpolate with previous modifier position using weight group */
   if (vert_coords_prev) {
-    float mw = 1.0f - prevco_weight;
-    vert_coords[i][0] = prevco_weight * vert_coords[i][0] + mw * co[0];
-    vert_coords[i][1] = prevco_weight * vert_coords[i][1] + mw * co[1];
-    vert_coords[i][2] = prevco_weight * vert_coords[i][2] + mw * co[2];
+    armature_vert_coords_prev_blend(data, i, co, prevco_weight);
   }
 }
 
@@ -463,20 +827,26 @@ static void armature_vert_task_editmesh_no_dvert(void *__restrict userdata,
   armature_vert_task_with_dvert(data, BM_elem_index_get(v), NULL);
 }
 
-static void armature_deform_coords_impl(const Object *ob_arm,
-                                        const Object *ob_target,
-                                        float (*vert_coords)[3],
-                                        float (*vert_deform_mats)[3][3],
-                                        const int vert_coords_len,
-                                        const int deformflag,
-                                        float (*vert_coords_prev)[3],
-                                        const char *defgrp_name,
-                                        const Mesh *me_target,
-                                        BMEditMesh *em_target,
-                                        bGPDstroke *gps_target)
+/**
+ * Prepare \a data for deforming the coordinates.
+ *
+ * \return false when the armature doesn't deform anything (edit-mode or missing pose).
+ */
+static bool armature_deform_data_init(ArmatureUserdata *data,
+                                      const Object *ob_arm,
+                                      const Object *ob_target,
+                                      float (*vert_coords)[3],
+                                      float (*vert_deform_mats)[3][3],
+                                      const int deformflag,
+                                      float (*vert_coords_prev)[3],
+                                      const char *defgrp_name,
+                                      const Mesh *me_target,
+                                      BMEditMesh *em_target,
+                                      bGPDstroke *gps_target)
 {
   bArmature *arm = ob_arm->data;
   bPoseChannel **pchan_from_defbase = NULL;
+  const ArmatureSkinningCache *skinning = NULL;
   const MDeformVert *dverts = NULL;
   bDeformGroup *dg;
   const bool use_envelope = (deformflag & ARM_DEF_ENVELOPE) != 0;
@@ -490,7 +860,7 @@ static void armature_deform_coords_impl(const Object *ob_arm,
 
   /* in editmode, or not an armature */
   if (arm->edbo || (ob_arm->pose == NULL)) {
-    return;
+    return false;
   }
 
   if ((ob_arm->pose->flag & POSE_RECALC) != 0) {
@@ -559,11 +929,25 @@ static void armature_deform_coords_impl(const Object *ob_arm,
             }
           }
         }
+
+        /* Evaluated meshes only get new weights as a new copy, so their skinning table can be
+         * kept between evaluations. Temporary meshes of the modifier stack may be changed in
+         * place by other modifiers.
+         * Dual quaternion blending keeps reading the vertex groups, its time goes into
+         * normalizing and applying the blended dual quaternion, not into finding the weights. */
+        const Mesh *me_skinning = me_target;
+        if (me_skinning == NULL && em_target == NULL && ob_target->type == OB_MESH) {
+          me_skinning = ob_target->data;
+        }
+        if (!use_quaternion && me_skinning != NULL && me_skinning->dvert != NULL &&
+            (me_skinning->id.tag & LIB_TAG_COPIED_ON_WRITE)) {
+          skinning = skinning_cache_ensure(me_skinning, pchan_from_defbase, defbase_len);
+        }
       }
     }
   }
 
-  ArmatureUserdata data = {
+  *data = (ArmatureUserdata){
       .ob_arm = ob_arm,
       .ob_target = ob_target,
       .me_target = me_target,
@@ -579,6 +963,7 @@ static void armature_deform_coords_impl(const Object *ob_arm,
       .dverts_len = dverts_len,
       .pchan_from_defbase = pchan_from_defbase,
       .defbase_len = defbase_len,
+      .skinning = skinning,
       .bmesh =
           {
               .cd_dvert_offset = cd_dvert_offset,
@@ -588,8 +973,49 @@ static void armature_deform_coords_impl(const Object *ob_arm,
   float obinv[4][4];
   invert_m4_m4(obinv, ob_target->obmat);
 
-  mul_m4_m4m4(data.postmat, obinv, ob_arm->obmat);
-  invert_m4_m4(data.premat, data.postmat);
+  mul_m4_m4m4(data->postmat, obinv, ob_arm->obmat);
+  invert_m4_m4(data->premat, data->postmat);
+
+  if (skinning) {
+    skinning_bones_init(data, pchan_from_defbase);
+  }
+
+  return true;
+}
+
+static void armature_deform_data_free(ArmatureUserdata *data)
+{
+  MEM_SAFE_FREE(data->pchan_from_defbase);
+  MEM_SAFE_FREE(data->skinning_bones);
+  MEM_SAFE_FREE(data->skinning_mats);
+}
+
+static void armature_deform_coords_impl(const Object *ob_arm,
+                                        const Object *ob_target,
+                                        float (*vert_coords)[3],
+                                        float (*vert_deform_mats)[3][3],
+                                        const int vert_coords_len,
+                                        const int deformflag,
+                                        float (*vert_coords_prev)[3],
+                                        const char *defgrp_name,
+                                        const Mesh *me_target,
+                                        BMEditMesh *em_target,
+                                        bGPDstroke *gps_target)
+{
+  ArmatureUserdata data;
+  if (!armature_deform_data_init(&data,
+                                 ob_arm,
+                                 ob_target,
+                                 vert_coords,
+                                 vert_deform_mats,
+                                 deformflag,
+                                 vert_coords_prev,
+                                 defgrp_name,
+                                 me_target,
+                                 em_target,
+                                 gps_target)) {
+    return;
+  }
 
   if (em_target != NULL) {
     /* While this could cause an extra loop over mesh data, in most cases this will
@@ -599,7 +1025,7 @@ static void armature_deform_coords_impl(const Object *ob_arm,
     TaskParallelSettings settings;
     BLI_parallel_mempool_settings_defaults(&settings);
 
-    if (use_dverts) {
+    if (data.use_dverts) {
       BLI_task_parallel_mempool(
           em_target->bm->vpool, &data, armature_vert_task_editmesh, &settings);
     }
@@ -615,9 +1041,7 @@ static void armature_deform_coords_impl(const Object *ob_arm,
     BLI_task_parallel_range(0, vert_coords_len, &data, armature_vert_task, &settings);
   }
 
-  if (pchan_from_defbase) {
-    MEM_freeN(pchan_from_defbase);
-  }
+  armature_deform_data_free(&data);
 }
 
 void BKE_armature_deform_coords_with_gpencil_stroke(const Object *ob_arm,
@@ -689,4 +1113,51 @@ void BKE_armature_deform_coords_with_editmesh(const Object *ob_arm,
                               NULL);
 }
 
+/** Armature deform prepared for evaluating ranges of coordinates separately. */
+typedef struct ArmatureDeformCoordsData {
+  ArmatureUserdata data;
+} ArmatureDeformCoordsData;
+
+ArmatureDeformCoordsData *BKE_armature_deform_coords_data_create_with_mesh(
+    const Object *ob_arm,
+    const Object *ob_target,
+    float (*vert_coords)[3],
+    int deformflag,
+    float (*vert_coords_prev)[3],
+    const char *defgrp_name,
+    const Mesh *me_target)
+{
+  ArmatureDeformCoordsData *deform_data = MEM_mallocN(sizeof(*deform_data), __func__);
+  if (!armature_deform_data_init(&deform_data->data,
+                                 ob_arm,
+                                 ob_target,
+                                 vert_coords,
+                                 NULL,
+                                 deformflag,
+                                 vert_coords_prev,
+                                 defgrp_name,
+                                 me_target,
+                                 NULL,
+                                 NULL)) {
+    MEM_freeN(deform_data);
+    return NULL;
+  }
+  return deform_data;
+}
+
+void BKE_armature_deform_coords_data_eval_range(const ArmatureDeformCoordsData *deform_data,
+                                                const int start,
+                                                const int end)
+{
+  for (int i = start; i < end; i++) {
+    armature_vert_task((void *)&deform_data->data, i, NULL);
+  }
+}
+
+void BKE_armature_deform_coords_data_destroy(ArmatureDeformCoordsData *deform_data)
+{
+  armature_deform_data_free(&deform_data->data);
+  MEM_freeN(deform_data);
+}
+
 /** \} */
@@ -0,0 +1,127 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include "DNA_armature_types.h"
+#include "DNA_mesh_types.h"
+
+#include "BKE_armature.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_utildefines.h"
+
+#include "tests/BKE_armature_test_utils.hh"
+#include "tests/BKE_mesh_test_utils.hh"
+
+namespace blender::bke::tests {
+
+class ArmatureDeformTest : public MeshTest {
+};
+
+static void test_armature_deform_skinning_matches(const int deformflag)
+{
+  ArmatureDeformTestContext ctx = {};
+  const int verts_len = 5000;
+  test_armature_deform_init(&ctx, 24, verts_len);
+
+  float(*coords)[3] = (float(*)[3])MEM_malloc_arrayN(verts_len, sizeof(float[3]), __func__);
+  float(*deform_mats)[3][3] = (float(*)[3][3])MEM_malloc_arrayN(
+      verts_len, sizeof(float[3][3]), __func__);
+  float(*skinning_coords)[3] = (float(*)[3])MEM_malloc_arrayN(
+      verts_len, sizeof(float[3]), __func__);
+  float(*skinning_deform_mats)[3][3] = (float(*)[3][3])MEM_malloc_arrayN(
+      verts_len, sizeof(float[3][3]), __func__);
+
+  /* Original meshes read the weights from the vertex groups. */
+  test_armature_deform(&ctx, deformflag, coords, deform_mats);
+  EXPECT_EQ(ctx.mesh->runtime.skinning_cache, nullptr);
+
+  /* Evaluated meshes use a skinning table for linear blending only. */
+  ctx.mesh->id.tag |= LIB_TAG_COPIED_ON_WRITE;
+  test_armature_deform(&ctx, deformflag, skinning_coords, skinning_deform_mats);
+  EXPECT_EQ(ctx.mesh->runtime.skinning_cache != nullptr, !(deformflag & ARM_DEF_QUATERNION));
+
+  for (int i = 0; i < verts_len; i++) {
+    EXPECT_V3_NEAR(coords[i], skinning_coords[i], 1e-5f);
+    EXPECT_M3_NEAR(deform_mats[i], skinning_deform_mats[i], 1e-5f);
+  }
+
+  MEM_freeN(coords);
+  MEM_freeN(deform_mats);
+  MEM_freeN(skinning_coords);
+  MEM_freeN(skinning_deform_mats);
+  test_armature_deform_free(&ctx);
+}
+
+TEST_F(ArmatureDeformTest, skinning_linear)
+{
+  test_armature_deform_skinning_matches(ARM_DEF_VGROUP | ARM_DEF_ENVELOPE);
+}
+
+TEST_F(ArmatureDeformTest, skinning_dual_quaternion)
+{
+  test_armature_deform_skinning_matches(ARM_DEF_VGROUP | ARM_DEF_ENVELOPE | ARM_DEF_QUATERNION);
+}
+
+/* Deforming separate ranges must give exactly the same result as deforming all at once. */
+static void test_armature_deform_ranges_match(const int deformflag)
+{
+  ArmatureDeformTestContext ctx = {};
+  const int verts_len = 5000;
+  test_armature_deform_init(&ctx, 24, verts_len);
+
+  float(*coords)[3] = (float(*)[3])MEM_malloc_arrayN(verts_len, sizeof(float[3]), __func__);
+  float(*range_coords)[3] = (float(*)[3])MEM_malloc_arrayN(
+      verts_len, sizeof(float[3]), __func__);
+
+  for (const bool use_skinning_cache : {false, true}) {
+    SET_FLAG_FROM_TEST(ctx.mesh->id.tag, use_skinning_cache, LIB_TAG_COPIED_ON_WRITE);
+    test_armature_deform(&ctx, deformflag, coords, nullptr);
+
+    memcpy(range_coords, ctx.coords, sizeof(float[3]) * verts_len);
+    ArmatureDeformCoordsData *deform_data = BKE_armature_deform_coords_data_create_with_mesh(
+        &ctx.ob_arm, &ctx.ob_mesh, range_coords, deformflag, nullptr, "", nullptr);
+    ASSERT_NE(deform_data, nullptr);
+    /* Ranges out of order and of different sizes. */
+    BKE_armature_deform_coords_data_eval_range(deform_data, 1000, verts_len);
+    BKE_armature_deform_coords_data_eval_range(deform_data, 3, 1000);
+    BKE_armature_deform_coords_data_eval_range(deform_data, 0, 3);
+    BKE_armature_deform_coords_data_destroy(deform_data);
+
+    for (int i = 0; i < verts_len; i++) {
+      EXPECT_EQ(coords[i][0], range_coords[i][0]);
+      EXPECT_EQ(coords[i][1], range_coords[i][1]);
+      EXPECT_EQ(coords[i][2], range_coords[i][2]);
+    }
+  }
+
+  MEM_freeN(coords);
+  MEM_freeN(range_coords);
+  test_armature_deform_free(&ctx);
+}
+
+TEST_F(ArmatureDeformTest, ranges_linear)
+{
+  test_armature_deform_ranges_match(ARM_DEF_VGROUP | ARM_DEF_ENVELOPE);
+}
+
+TEST_F(ArmatureDeformTest, ranges_dual_quaternion)
+{
+  test_armature_deform_ranges_match(ARM_DEF_VGROUP | ARM_DEF_ENVELOPE | ARM_DEF_QUATERNION);
+}
+
+}  // namespace blender::bke::tests
@@ -33,6 +33,7 @@
 #include "DNA_scene_types.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
 
@@ -1343,6 +1344,152 @@ void BKE_object_data_transfer_layout(struct Depsgraph *depsgraph,
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Geometry Mapping Cache
+ *
+ * Computing the geometry mappings is by far the most expensive part of a transfer, while the
+ * Data Transfer modifier typically re-evaluates with unchanged source and destination
+ * geometries (e.g. when only the mix factor is animated). Mappings are kept around between
+ * evaluations and only recomputed when anything they depend on changes.
+ * \{ */
+
+/**
+ * Everything a geometry mapping depends on. Sizes and settings are compared exactly, the
+ * geometry itself only through a hash.
+ */
+typedef struct DataTransferRemapKey {
+  int domain;
+  int map_mode;
+  float max_distance;
+  float ray_radius;
+  float islands_handling_precision;
+  MeshRemapIslandsCalc island_callback;
+  bool use_space_transform;
+  SpaceTransform space_transform;
+  /** Vertex, edge, loop and polygon counts of the source and destination meshes. */
+  int src_sizes[4];
+  int dst_sizes[4];
+  /** Hash of the geometry (and normals for loop mappings) of both meshes. */
+  uint32_t data_hash;
+} DataTransferRemapKey;
+
+typedef struct DataTransferRemapCache {
+  MeshPairRemap geom_map[4];
+  DataTransferRemapKey geom_map_key[4];
+} DataTransferRemapCache;
+
+DataTransferRemapCache *BKE_object_data_transfer_remap_cache_new(void)
+{
+  return MEM_callocN(sizeof(DataTransferRemapCache), __func__);
+}
+
+void BKE_object_data_transfer_remap_cache_free(DataTransferRemapCache *remap_cache)
+{
+  for (int i = 0; i < ARRAY_SIZE(remap_cache->geom_map); i++) {
+    BKE_mesh_remap_free(&remap_cache->geom_map[i]);
+  }
+  MEM_freeN(remap_cache);
+}
+
+static void data_transfer_remap_key_add_mesh(BLI_HashMurmur2A *mm2, const Mesh *me)
+{
+  BLI_hash_mm2a_add(mm2, (const uchar *)me->mvert, sizeof(*me->mvert) * (size_t)me->totvert);
+  BLI_hash_mm2a_add(mm2, (const uchar *)me->medge, sizeof(*me->medge) * (size_t)me->totedge);
+  BLI_hash_mm2a_add(mm2, (const uchar *)me->mloop, sizeof(*me->mloop) * (size_t)me->totloop);
+  BLI_hash_mm2a_add(mm2, (const uchar *)me->mpoly, sizeof(*me->mpoly) * (size_t)me->totpoly);
+}
+
+static void data_transfer_remap_key_mesh_sizes(const Mesh *me, int r_sizes[4])
+{
+  r_sizes[0] = me->totvert;
+  r_sizes[1] = me->totedge;
+  r_sizes[2] = me->totloop;
+  r_sizes[3] = me->totpoly;
+}
+
+/**
+ * Gather all inputs the mapping of given \a domain depends on.
+ */
+static void data_transfer_remap_key_init(DataTransferRemapKey *r_key,
+                                         const int domain,
+                                         const int map_mode,
+                                         const Mesh *me_src,
+                                         const Mesh *me_dst,
+                                         const SpaceTransform *space_transform,
+                                         const float max_distance,
+                                         const float ray_radius,
+                                         const float islands_handling_precision,
+                                         MeshRemapIslandsCalc island_callback)
+{
+  memset(r_key, 0, sizeof(*r_key));
+  r_key->domain = domain;
+  r_key->map_mode = map_mode;
+  r_key->max_distance = max_distance;
+  r_key->ray_radius = ray_radius;
+  r_key->islands_handling_precision = islands_handling_precision;
+  r_key->island_callback = island_callback;
+  if (space_transform) {
+    r_key->use_space_transform = true;
+    r_key->space_transform = *space_transform;
+  }
+  data_transfer_remap_key_mesh_sizes(me_src, r_key->src_sizes);
+  data_transfer_remap_key_mesh_sizes(me_dst, r_key->dst_sizes);
+
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, (uint32_t)domain);
+  data_transfer_remap_key_add_mesh(&mm2, me_src);
+  data_transfer_remap_key_add_mesh(&mm2, me_dst);
+
+  if (domain == ME_LOOP) {
+    /* Loop mappings also depend on (custom) split normals of both meshes. */
+    const short(*custom_nors_dst)[2] = CustomData_get_layer(&me_dst->ldata,
+                                                            CD_CUSTOMLOOPNORMAL);
+    const float(*loop_nors_src)[3] = CustomData_get_layer(&me_src->ldata, CD_NORMAL);
+
+    if (custom_nors_dst) {
+      BLI_hash_mm2a_add(&mm2,
+                        (const uchar *)custom_nors_dst,
+                        sizeof(*custom_nors_dst) * (size_t)me_dst->totloop);
+    }
+    if (loop_nors_src) {
+      BLI_hash_mm2a_add(
+          &mm2, (const uchar *)loop_nors_src, sizeof(*loop_nors_src) * (size_t)me_src->totloop);
+    }
+    BLI_hash_mm2a_add_int(&mm2, me_dst->flag & ME_AUTOSMOOTH);
+    BLI_hash_mm2a_add(&mm2, (const uchar *)&me_dst->smoothresh, sizeof(me_dst->smoothresh));
+  }
+
+  r_key->data_hash = BLI_hash_mm2a_end(&mm2);
+}
+
+static bool data_transfer_remap_key_equal(const DataTransferRemapKey *a,
+                                          const DataTransferRemapKey *b)
+{
+  return (a->domain == b->domain && a->map_mode == b->map_mode &&
+          a->max_distance == b->max_distance && a->ray_radius == b->ray_radius &&
+          a->islands_handling_precision == b->islands_handling_precision &&
+          a->island_callback == b->island_callback &&
+          a->use_space_transform == b->use_space_transform &&
+          memcmp(&a->space_transform, &b->space_transform, sizeof(a->space_transform)) == 0 &&
+          memcmp(a->src_sizes, b->src_sizes, sizeof(a->src_sizes)) == 0 &&
+          memcmp(a->dst_sizes, b->dst_sizes, sizeof(a->dst_sizes)) == 0 &&
+          a->data_hash == b->data_hash);
+}
+
+/**
+ * \return true when \a remap_cache holds a mapping of given domain computed from inputs
+ * matching \a key.
+ */
+static bool data_transfer_remap_cache_is_valid(const DataTransferRemapCache *remap_cache,
+                                               const int domain_index,
+                                               const DataTransferRemapKey *key)
+{
+  return remap_cache && remap_cache->geom_map[domain_index].items != NULL &&
+         data_transfer_remap_key_equal(&remap_cache->geom_map_key[domain_index], key);
+}
+
+/** \} */
+
 bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
                                  Scene *scene,
                                  Object *ob_src,
@@ -1365,6 +1512,7 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
                                  const float mix_factor,
                                  const char *vgroup_name,
                                  const bool invert_vgroup,
+                                 DataTransferRemapCache *remap_cache,
                                  ReportList *reports)
 {
 #define VDATA 0
@@ -1383,7 +1531,9 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
   int vg_idx = -1;
   float *weights[DATAMAX] = {NULL};
 
-  MeshPairRemap geom_map[DATAMAX] = {{0}};
+  MeshPairRemap geom_map_local[DATAMAX] = {{0}};
+  MeshPairRemap *geom_map = remap_cache ? remap_cache->geom_map : geom_map_local;
+  DataTransferRemapKey geom_map_key[DATAMAX];
   bool geom_map_init[DATAMAX] = {0};
   ListBase lay_map = {NULL};
   bool changed = false;
@@ -1471,6 +1621,21 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
       MVert *verts_dst = me_dst->mvert;
       const int num_verts_dst = me_dst->totvert;
 
+      if (!geom_map_init[VDATA] && remap_cache) {
+        data_transfer_remap_key_init(&geom_map_key[VDATA],
+                                     ME_VERT,
+                                     map_vert_mode,
+                                     me_src,
+                                     me_dst,
+                                     space_transform,
+                                     max_distance,
+                                     ray_radius,
+                                     0.0f,
+                                     NULL);
+        geom_map_init[VDATA] = data_transfer_remap_cache_is_valid(
+            remap_cache, VDATA, &geom_map_key[VDATA]);
+      }
+
       if (!geom_map_init[VDATA]) {
         const int num_verts_src = me_src->totvert;
 
@@ -1513,6 +1678,9 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
                                             me_src,
                                             &geom_map[VDATA]);
         geom_map_init[VDATA] = true;
+        if (remap_cache) {
+          remap_cache->geom_map_key[VDATA] = geom_map_key[VDATA];
+        }
       }
 
       if (mdef && vg_idx != -1 && !weights[VDATA]) {
@@ -1554,6 +1722,21 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
       MEdge *edges_dst = me_dst->medge;
       const int num_edges_dst = me_dst->totedge;
 
+      if (!geom_map_init[EDATA] && remap_cache) {
+        data_transfer_remap_key_init(&geom_map_key[EDATA],
+                                     ME_EDGE,
+                                     map_edge_mode,
+                                     me_src,
+                                     me_dst,
+                                     space_transform,
+                                     max_distance,
+                                     ray_radius,
+                                     0.0f,
+                                     NULL);
+        geom_map_init[EDATA] = data_transfer_remap_cache_is_valid(
+            remap_cache, EDATA, &geom_map_key[EDATA]);
+      }
+
       if (!geom_map_init[EDATA]) {
         const int num_edges_src = me_src->totedge;
 
@@ -1591,6 +1774,9 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
                                             me_src,
                                             &geom_map[EDATA]);
         geom_map_init[EDATA] = true;
+        if (remap_cache) {
+          remap_cache->geom_map_key[EDATA] = geom_map_key[EDATA];
+        }
       }
 
       if (mdef && vg_idx != -1 && !weights[EDATA]) {
@@ -1639,6 +1825,21 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
 
       MeshRemapIslandsCalc island_callback = data_transfer_get_loop_islands_generator(cddata_type);
 
+      if (!geom_map_init[LDATA] && remap_cache) {
+        data_transfer_remap_key_init(&geom_map_key[LDATA],
+                                     ME_LOOP,
+                                     map_loop_mode,
+                                     me_src,
+                                     me_dst,
+                                     space_transform,
+                                     max_distance,
+                                     ray_radius,
+                                     islands_handling_precision,
+                                     island_callback);
+        geom_map_init[LDATA] = data_transfer_remap_cache_is_valid(
+            remap_cache, LDATA, &geom_map_key[LDATA]);
+      }
+
       if (!geom_map_init[LDATA]) {
         const int num_loops_src = me_src->totloop;
 
@@ -1686,6 +1887,9 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
                                             islands_handling_precision,
                                             &geom_map[LDATA]);
         geom_map_init[LDATA] = true;
+        if (remap_cache) {
+          remap_cache->geom_map_key[LDATA] = geom_map_key[LDATA];
+        }
       }
 
       if (mdef && vg_idx != -1 && !weights[LDATA]) {
@@ -1729,6 +1933,21 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
       MLoop *loops_dst = me_dst->mloop;
       const int num_loops_dst = me_dst->totloop;
 
+      if (!geom_map_init[PDATA] && remap_cache) {
+        data_transfer_remap_key_init(&geom_map_key[PDATA],
+                                     ME_POLY,
+                                     map_poly_mode,
+                                     me_src,
+                                     me_dst,
+                                     space_transform,
+                                     max_distance,
+                                     ray_radius,
+                                     0.0f,
+                                     NULL);
+        geom_map_init[PDATA] = data_transfer_remap_cache_is_valid(
+            remap_cache, PDATA, &geom_map_key[PDATA]);
+      }
+
       if (!geom_map_init[PDATA]) {
         const int num_polys_src = me_src->totpoly;
 
@@ -1766,6 +1985,9 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
                                             me_src,
                                             &geom_map[PDATA]);
         geom_map_init[PDATA] = true;
+        if (remap_cache) {
+          remap_cache->geom_map_key[PDATA] = geom_map_key[PDATA];
+        }
       }
 
       if (mdef && vg_idx != -1 && !weights[PDATA]) {
@@ -1813,7 +2035,7 @@ bool BKE_object_data_transfer_ex(struct Depsgraph *depsgraph,
   }
 
   for (int i = 0; i < DATAMAX; i++) {
-    BKE_mesh_remap_free(&geom_map[i]);
+    BKE_mesh_remap_free(&geom_map_local[i]);
     MEM_SAFE_FREE(weights[i]);
   }
 
@@ -1871,5 +2093,6 @@ bool BKE_object_data_transfer_mesh(struct Depsgraph *depsgraph,
                                      mix_factor,
                                      vgroup_name,
                                      invert_vgroup,
+                                     NULL,
                                      reports);
 }
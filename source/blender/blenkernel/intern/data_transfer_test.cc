@@ -0,0 +1,149 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include <cfloat>
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_data_transfer.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
+#include "BKE_mesh_remap.h"
+#include "BKE_mesh_runtime.h"
+
+#include "BLI_math.h"
+
+#include "tests/BKE_mesh_test_utils.hh"
+
+namespace blender::bke::tests {
+
+class DataTransferTest : public MeshTest {
+};
+
+/** Create a grid with #mesh_grid_create, each vertex gets a distinct bevel weight. */
+static Mesh *test_grid_mesh_create(const int res, const float size, const float3 offset)
+{
+  Mesh *mesh = mesh_grid_create(res, size, offset);
+  for (int v = 0; v < mesh->totvert; v++) {
+    mesh->mvert[v].bweight = char(v);
+  }
+  mesh->cd_flag |= ME_CDFLAG_VERT_BWEIGHT;
+  return mesh;
+}
+
+/**
+ * Transfer vertex bevel weights from the nearest vertex of \a me_src, the way the Data Transfer
+ * modifier does it.
+ */
+static void test_transfer_bweight(Mesh *me_src, Mesh *me_dst, DataTransferRemapCache *remap_cache)
+{
+  const int data_types = DT_TYPE_BWEIGHT_VERT;
+  const int map_vert_mode = MREMAP_MODE_VERT_NEAREST;
+
+  Object ob_src = {};
+  ob_src.type = OB_MESH;
+  ob_src.data = me_src;
+  ob_src.runtime.data_eval = &me_src->id;
+  /* Same mask as requested by the transfer, as if the source object was evaluated for it. */
+  ob_src.runtime.last_data_mask = CD_MASK_BAREMESH;
+  BKE_object_data_transfer_dttypes_to_cdmask(data_types, &ob_src.runtime.last_data_mask);
+  BKE_mesh_remap_calc_source_cddata_masks_from_map_modes(
+      map_vert_mode, 0, 0, 0, &ob_src.runtime.last_data_mask);
+
+  Object ob_dst = {};
+  ob_dst.type = OB_MESH;
+  ob_dst.data = me_dst;
+
+  const int layers_select[DT_MULTILAYER_INDEX_MAX] = {0};
+  BKE_object_data_transfer_ex(nullptr,
+                              nullptr,
+                              &ob_src,
+                              &ob_dst,
+                              me_dst,
+                              data_types,
+                              false,
+                              map_vert_mode,
+                              0,
+                              0,
+                              0,
+                              nullptr,
+                              false,
+                              FLT_MAX,
+                              0.0f,
+                              0.0f,
+                              layers_select,
+                              layers_select,
+                              CDT_MIX_TRANSFER,
+                              1.0f,
+                              nullptr,
+                              false,
+                              remap_cache,
+                              nullptr);
+}
+
+static void test_expect_nearest_bweight(const Mesh *me_src, const Mesh *me_dst)
+{
+  for (int i = 0; i < me_dst->totvert; i++) {
+    int nearest = -1;
+    float nearest_dist_sq = FLT_MAX;
+    for (int j = 0; j < me_src->totvert; j++) {
+      const float dist_sq = len_squared_v3v3(me_dst->mvert[i].co, me_src->mvert[j].co);
+      if (dist_sq < nearest_dist_sq) {
+        nearest_dist_sq = dist_sq;
+        nearest = j;
+      }
+    }
+    EXPECT_EQ(me_dst->mvert[i].bweight, me_src->mvert[nearest].bweight);
+  }
+}
+
+TEST_F(DataTransferTest, remap_cache_invalidated_by_source_change)
+{
+  /* Offsets avoid vertices at equal distance from several source vertices. */
+  const float3 offset_dst(0.0f, 0.0f, 0.0f);
+  const float3 offset_src(0.3f, 0.2f, 0.0f);
+  Mesh *me_dst = test_grid_mesh_create(8, 1.0f, offset_dst);
+  Mesh *me_src = test_grid_mesh_create(8, 1.0f, offset_src);
+  DataTransferRemapCache *remap_cache = BKE_object_data_transfer_remap_cache_new();
+
+  test_transfer_bweight(me_src, me_dst, remap_cache);
+  test_expect_nearest_bweight(me_src, me_dst);
+
+  /* Same topology, moved vertices. */
+  for (int i = 0; i < me_src->totvert; i++) {
+    me_src->mvert[i].co[0] += 1.0f;
+  }
+  BKE_mesh_runtime_clear_geometry(me_src);
+  test_transfer_bweight(me_src, me_dst, remap_cache);
+  test_expect_nearest_bweight(me_src, me_dst);
+
+  /* Different amount of vertices. */
+  BKE_id_free(nullptr, me_src);
+  me_src = test_grid_mesh_create(4, 2.0f, offset_src);
+  test_transfer_bweight(me_src, me_dst, remap_cache);
+  test_expect_nearest_bweight(me_src, me_dst);
+
+  BKE_object_data_transfer_remap_cache_free(remap_cache);
+  BKE_id_free(nullptr, me_src);
+  BKE_id_free(nullptr, me_dst);
+}
+
+}  // namespace blender::bke::tests
@@ -5146,6 +5146,7 @@ static ImBuf *image_get_render_result(Image *ima, ImageUser *iuser, void **r_loc
   BLI_thread_lock(LOCK_COLORMANAGE);
   if (ibuf->x != rres.rectx || ibuf->y != rres.recty || ibuf->rect_float != rectf) {
     ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+    IMB_tag_changed(ibuf);
   }
 
   ibuf->x = rres.rectx;
@@ -5351,6 +5352,9 @@ static ImBuf *image_acquire_ibuf(Image *ima, ImageUser *iuser, void **r_lock)
   }
 
   if (ibuf == NULL) {
+    /* Loaded buffers are owned by the image cache. */
+    const eMemDomain previous_memory_domain = MEM_domain_begin(MEM_DOMAIN_IMAGE_CACHE);
+
     /* we are sure we have to load the ibuf, using source and type */
     if (ima->source == IMA_SRC_MOVIE) {
       /* source is from single file, use flipbook to store ibuf */
@@ -5442,6 +5446,8 @@ static ImBuf *image_acquire_ibuf(Image *ima, ImageUser *iuser, void **r_lock)
     if (ibuf != NULL && !ELEM(ima->source, IMA_SRC_MOVIE, IMA_SRC_SEQUENCE)) {
       ibuf->userflags |= IB_PERSISTENT;
     }
+
+    MEM_domain_end(previous_memory_domain);
   }
 
   BKE_image_tag_time(ima);
@@ -6052,6 +6058,7 @@ bool BKE_image_is_dirty(Image *image)
 void BKE_image_mark_dirty(Image *UNUSED(image), ImBuf *ibuf)
 {
   ibuf->userflags |= IB_BITMAPDIRTY;
+  IMB_tag_changed(ibuf);
 }
 
 bool BKE_image_buffer_format_writable(ImBuf *ibuf)
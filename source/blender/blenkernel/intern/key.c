@@ -31,6 +31,7 @@
 #include "BLI_endian_switch.h"
 #include "BLI_math_vector.h"
 #include "BLI_string_utils.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -63,8 +64,14 @@
 
 #include "RNA_access.h"
 
+#include "DEG_depsgraph_query.h"
+
 #include "BLO_read_write.h"
 
+#include "atomic_ops.h"
+
+static void key_block_delta_free(struct KeyBlockDelta *delta);
+
 static void shapekey_copy_data(Main *UNUSED(bmain),
                                ID *id_dst,
                                const ID *id_src,
@@ -80,6 +87,7 @@ static void shapekey_copy_data(Main *UNUSED(bmain),
     if (kb_dst->data) {
       kb_dst->data = MEM_dupallocN(kb_dst->data);
     }
+    kb_dst->delta = NULL;
     if (kb_src == key_src->refkey) {
       key_dst->refkey = kb_dst;
     }
@@ -95,6 +103,9 @@ static void shapekey_free_data(ID *id)
     if (kb->data) {
       MEM_freeN(kb->data);
     }
+    if (kb->delta) {
+      key_block_delta_free(kb->delta);
+    }
     MEM_freeN(kb);
   }
 }
@@ -126,6 +137,7 @@ static void shapekey_blend_write(BlendWriter *writer, ID *id, const void *id_add
   /* direct data */
   LISTBASE_FOREACH (KeyBlock *, kb, &key->block) {
     KeyBlock tmp_kb = *kb;
+    tmp_kb.delta = NULL;
     /* Do not store actual geometry data in case this is a library override ID. */
     if (ID_IS_OVERRIDE_LIBRARY(key) && !is_undo) {
       tmp_kb.totelem = 0;
@@ -182,6 +194,7 @@ static void shapekey_blend_read_data(BlendDataReader *reader, ID *id)
 
   LISTBASE_FOREACH (KeyBlock *, kb, &key->block) {
     BLO_read_data_address(reader, &kb->data);
+    kb->delta = NULL;
 
     if (BLO_read_requires_endian_switch(reader)) {
       switch_endian_keyblock(key, kb);
@@ -259,6 +272,9 @@ void BKE_key_free_nolib(Key *key)
     if (kb->data) {
       MEM_freeN(kb->data);
     }
+    if (kb->delta) {
+      key_block_delta_free(kb->delta);
+    }
     MEM_freeN(kb);
   }
 }
@@ -871,6 +887,299 @@ static void cp_cu_key(Curve *cu,
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Relative Coordinate Keys
+ *
+ * Relative keys of meshes and lattices are evaluated using offsets from their relative key,
+ * cached on the key-blocks of evaluated keys. Corrective keys typically only move a small part
+ * of the elements, and only those are visited. Ranges of elements are evaluated in parallel.
+ * Every element still gets the offsets of all key-blocks applied in the key-block order, so the
+ * result is the same as with the generic code-path of #key_evaluate_relative.
+ *
+ * Evaluated keys are re-created from the original when it is edited, which also frees the
+ * cached offsets. Original keys are edited in place, so they never use cached offsets.
+ * \{ */
+
+/** Key-blocks which move a bigger part of the elements are evaluated densely. */
+#define KEY_DELTA_SPARSE_MAX_FACTOR 0.5f
+/** Number of elements evaluated by a single task. */
+#define KEY_EVAL_CHUNK_SIZE 4096
+
+typedef struct KeyBlockDelta {
+  /** Data the offsets were calculated from, used to detect stale offsets. */
+  const void *data;
+  const void *ref_data;
+  int totelem;
+  /** Offsets are only stored when few enough elements differ from the relative key. */
+  bool is_sparse;
+  /** Number of elements which differ from the relative key. */
+  int totdelta;
+  /** Sorted indices of the differing elements, and their `ref_data - data` offsets. */
+  int *indices;
+  float (*offsets)[3];
+} KeyBlockDelta;
+
+static void key_block_delta_free(KeyBlockDelta *delta)
+{
+  MEM_SAFE_FREE(delta->indices);
+  MEM_SAFE_FREE(delta->offsets);
+  MEM_freeN(delta);
+}
+
+static bool key_offset_is_zero(const float data[3], const float ref_data[3])
+{
+  return (ref_data[0] - data[0]) == 0.0f && (ref_data[1] - data[1]) == 0.0f &&
+         (ref_data[2] - data[2]) == 0.0f;
+}
+
+static KeyBlockDelta *key_block_delta_create(const float (*data)[3],
+                                             const float (*ref_data)[3],
+                                             const int totelem)
+{
+  KeyBlockDelta *delta = MEM_callocN(sizeof(*delta), __func__);
+  delta->data = data;
+  delta->ref_data = ref_data;
+  delta->totelem = totelem;
+
+  int totdelta = 0;
+  for (int i = 0; i < totelem; i++) {
+    if (!key_offset_is_zero(data[i], ref_data[i])) {
+      totdelta++;
+    }
+  }
+  delta->totdelta = totdelta;
+  if (totdelta > totelem * KEY_DELTA_SPARSE_MAX_FACTOR) {
+    return delta;
+  }
+
+  delta->is_sparse = true;
+  if (totdelta == 0) {
+    return delta;
+  }
+  delta->indices = MEM_malloc_arrayN(totdelta, sizeof(*delta->indices), __func__);
+  delta->offsets = MEM_malloc_arrayN(totdelta, sizeof(*delta->offsets), __func__);
+  int delta_index = 0;
+  for (int i = 0; i < totelem; i++) {
+    if (!key_offset_is_zero(data[i], ref_data[i])) {
+      delta->indices[delta_index] = i;
+      sub_v3_v3v3(delta->offsets[delta_index], ref_data[i], data[i]);
+      delta_index++;
+    }
+  }
+  return delta;
+}
+
+/**
+ * Get cached offsets of the key-block, creating them when needed.
+ * Multiple threads can evaluate the same key, the first created offsets are kept.
+ *
+ * \return NULL when the offsets do not match the current data.
+ */
+static const KeyBlockDelta *key_block_delta_ensure(KeyBlock *kb, const KeyBlock *refb)
+{
+  KeyBlockDelta *delta = kb->delta;
+  if (delta == NULL) {
+    KeyBlockDelta *delta_new = key_block_delta_create(kb->data, refb->data, kb->totelem);
+    delta = atomic_cas_ptr((void **)&kb->delta, NULL, delta_new);
+    if (delta == NULL) {
+      delta = delta_new;
+    }
+    else {
+      key_block_delta_free(delta_new);
+    }
+  }
+  if (delta->data != kb->data || delta->ref_data != refb->data || delta->totelem != kb->totelem) {
+    return NULL;
+  }
+  return delta;
+}
+
+/** A key-block contributing to the result, with all the data needed for its evaluation. */
+typedef struct KeyBlockEval {
+  KeyBlock *kb;
+  const KeyBlock *refb;
+  const float (*data)[3];
+  const float (*ref_data)[3];
+  const float *weights;
+  float influence;
+  /** Data of the active key in edit-mode, freed after evaluation. */
+  char *freedata;
+  /** Sparse offsets, NULL when the key-block is evaluated densely. */
+  const KeyBlockDelta *delta;
+} KeyBlockEval;
+
+typedef struct KeyEvalRelativeCoordsData {
+  float (*out)[3];
+  int start;
+  int end;
+  KeyBlockEval *blocks;
+  int totblock;
+} KeyEvalRelativeCoordsData;
+
+static void key_block_delta_ensure_task(void *__restrict userdata,
+                                        const int block_index,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  KeyEvalRelativeCoordsData *data = userdata;
+  KeyBlockEval *block = &data->blocks[block_index];
+  /* Data of the active key taken from edit-mode is not the stored one. */
+  if (block->freedata != NULL) {
+    return;
+  }
+  const KeyBlockDelta *delta = key_block_delta_ensure(block->kb, block->refb);
+  if (delta && delta->is_sparse) {
+    block->delta = delta;
+  }
+}
+
+/** Index of the first offset of an element which is not smaller than the given one. */
+static int key_block_delta_lower_bound(const KeyBlockDelta *delta, const int index)
+{
+  int low = 0, high = delta->totdelta;
+  while (low < high) {
+    const int mid = (low + high) / 2;
+    if (delta->indices[mid] < index) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+static void key_block_eval_sparse(const KeyBlockEval *block,
+                                  const int start,
+                                  const int end,
+                                  float (*out)[3])
+{
+  const KeyBlockDelta *delta = block->delta;
+  const float influence = block->influence;
+  for (int j = key_block_delta_lower_bound(delta, start);
+       j < delta->totdelta && delta->indices[j] < end;
+       j++) {
+    const int i = delta->indices[j];
+    const float weight = block->weights ? (block->weights[i] * influence) : influence;
+    out[i][0] -= weight * delta->offsets[j][0];
+    out[i][1] -= weight * delta->offsets[j][1];
+    out[i][2] -= weight * delta->offsets[j][2];
+  }
+}
+
+static void key_block_eval_dense(const KeyBlockEval *block,
+                                 const int start,
+                                 const int end,
+                                 float (*out)[3])
+{
+  const float influence = block->influence;
+  if (block->weights == NULL) {
+    /* Flat loop over all floats, which can be vectorized. */
+    float *out_fl = out[start];
+    const float *ref_fl = block->ref_data[start];
+    const float *data_fl = block->data[start];
+    const int totfl = (end - start) * 3;
+    for (int a = 0; a < totfl; a++) {
+      out_fl[a] -= influence * (ref_fl[a] - data_fl[a]);
+    }
+    return;
+  }
+  for (int i = start; i < end; i++) {
+    const float weight = block->weights[i] * influence;
+    out[i][0] -= weight * (block->ref_data[i][0] - block->data[i][0]);
+    out[i][1] -= weight * (block->ref_data[i][1] - block->data[i][1]);
+    out[i][2] -= weight * (block->ref_data[i][2] - block->data[i][2]);
+  }
+}
+
+static void key_evaluate_relative_coords_task(void *__restrict userdata,
+                                              const int chunk_index,
+                                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const KeyEvalRelativeCoordsData *data = userdata;
+  const int start = data->start + chunk_index * KEY_EVAL_CHUNK_SIZE;
+  const int end = min_ii(start + KEY_EVAL_CHUNK_SIZE, data->end);
+  for (int block_index = 0; block_index < data->totblock; block_index++) {
+    const KeyBlockEval *block = &data->blocks[block_index];
+    if (block->delta) {
+      key_block_eval_sparse(block, start, end, data->out);
+    }
+    else {
+      key_block_eval_dense(block, start, end, data->out);
+    }
+  }
+}
+
+/**
+ * Apply all relative key-blocks to the coordinates of the reference key, which are expected to
+ * be in `out` already.
+ */
+static void key_evaluate_relative_coords(const int start,
+                                         const int end,
+                                         const int tot,
+                                         float (*out)[3],
+                                         Key *key,
+                                         KeyBlock *actkb,
+                                         float **per_keyblock_weights)
+{
+  KeyBlockEval *blocks = MEM_malloc_arrayN(key->totkey, sizeof(*blocks), __func__);
+  int totblock = 0;
+
+  KeyBlock *kb;
+  int keyblock_index;
+  for (kb = key->block.first, keyblock_index = 0; kb; kb = kb->next, keyblock_index++) {
+    if (kb == key->refkey) {
+      continue;
+    }
+    /* Only with value, and no difference allowed. */
+    if ((kb->flag & KEYBLOCK_MUTE) || kb->curval == 0.0f || kb->totelem != tot) {
+      continue;
+    }
+    /* Reference now can be any block. */
+    const KeyBlock *refb = BLI_findlink(&key->block, kb->relative);
+    if (refb == NULL) {
+      continue;
+    }
+    KeyBlockEval *block = &blocks[totblock++];
+    block->kb = kb;
+    block->refb = refb;
+    block->data = (const float(*)[3])key_block_get_data(key, actkb, kb, &block->freedata);
+    /* For meshes, use the original values instead of the bmesh values to
+     * maintain a constant offset. */
+    block->ref_data = refb->data;
+    block->weights = per_keyblock_weights ? per_keyblock_weights[keyblock_index] : NULL;
+    block->influence = kb->curval;
+    block->delta = NULL;
+  }
+
+  KeyEvalRelativeCoordsData data = {
+      .out = out,
+      .start = start,
+      .end = end,
+      .blocks = blocks,
+      .totblock = totblock,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+
+  if (DEG_is_evaluated_id(&key->id)) {
+    BLI_task_parallel_range(0, totblock, &data, key_block_delta_ensure_task, &settings);
+  }
+
+  const int totchunk = (end - start + KEY_EVAL_CHUNK_SIZE - 1) / KEY_EVAL_CHUNK_SIZE;
+  BLI_task_parallel_range(0, totchunk, &data, key_evaluate_relative_coords_task, &settings);
+
+  for (int i = 0; i < totblock; i++) {
+    if (blocks[i].freedata) {
+      MEM_freeN(blocks[i].freedata);
+    }
+  }
+  MEM_freeN(blocks);
+}
+
+/** \} */
+
 static void key_evaluate_relative(const int start,
                                   int end,
                                   const int tot,
@@ -907,6 +1216,12 @@ static void key_evaluate_relative(const int start,
   /* step 1 init */
   cp_key(start, end, tot, basispoin, key, actkb, key->refkey, NULL, mode);
 
+  if (mode == KEY_MODE_DUMMY && key->elemsize == sizeof(float[KEYELEM_FLOAT_LEN_COORD])) {
+    key_evaluate_relative_coords(
+        start, end, tot, (float(*)[3])basispoin, key, actkb, per_keyblock_weights);
+    return;
+  }
+
   /* step 2: do it */
 
   for (kb = key->block.first, keyblock_index = 0; kb; kb = kb->next, keyblock_index++) {
@@ -0,0 +1,158 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include "DNA_key_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_deform.h"
+#include "BKE_key.h"
+#include "BKE_lib_id.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+#include "BKE_object_deform.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_listbase.h"
+#include "BLI_rand.hh"
+#include "BLI_string.h"
+
+#include "tests/BKE_mesh_test_utils.hh"
+
+namespace blender::bke::tests {
+
+class KeyTest : public MeshTest {
+};
+
+struct ShapeKeyTestContext {
+  Main *bmain;
+  Mesh *mesh;
+  Object ob;
+  Key *key;
+};
+
+/**
+ * Create a mesh with relative shape keys, which each move a small part of the vertices, similar
+ * to corrective keys of a facial rig. Every fourth key is limited by a vertex group.
+ */
+static void test_shape_keys_init(ShapeKeyTestContext *ctx,
+                                 const int totvert,
+                                 const int totkey,
+                                 const int totvert_moved)
+{
+  RandomNumberGenerator rng;
+  ctx->mesh = BKE_mesh_new_nomain(totvert, 0, 0, 0, 0);
+  for (int i = 0; i < totvert; i++) {
+    ctx->mesh->mvert[i].co[0] = rng.get_float();
+    ctx->mesh->mvert[i].co[1] = rng.get_float();
+    ctx->mesh->mvert[i].co[2] = rng.get_float();
+  }
+
+  IDType_ID_OB.init_data(&ctx->ob.id);
+  STRNCPY(ctx->ob.id.name, "OBFace");
+  ctx->ob.type = OB_MESH;
+  ctx->ob.data = ctx->mesh;
+
+  ctx->mesh->dvert = (MDeformVert *)CustomData_add_layer(
+      &ctx->mesh->vdata, CD_MDEFORMVERT, CD_CALLOC, nullptr, totvert);
+  for (int group = 0; group < 4; group++) {
+    char name[MAX_NAME];
+    BLI_snprintf(name, sizeof(name), "Group %d", group);
+    BKE_object_defgroup_add_name(&ctx->ob, name);
+    for (int i = 0; i < totvert; i++) {
+      BKE_defvert_add_index_notest(&ctx->mesh->dvert[i], group, rng.get_float());
+    }
+  }
+
+  ctx->bmain = BKE_main_new();
+  ctx->key = BKE_key_add(ctx->bmain, &ctx->mesh->id);
+  ctx->key->type = KEY_RELATIVE;
+  ctx->mesh->key = ctx->key;
+  KeyBlock *basis = BKE_keyblock_add(ctx->key, "Basis");
+  BKE_keyblock_convert_from_mesh(ctx->mesh, ctx->key, basis);
+
+  for (int key_index = 0; key_index < totkey; key_index++) {
+    KeyBlock *kb = BKE_keyblock_add(ctx->key, nullptr);
+    BKE_keyblock_convert_from_mesh(ctx->mesh, ctx->key, kb);
+    float(*co)[3] = (float(*)[3])kb->data;
+    const int start = rng.get_int32(totvert - totvert_moved);
+    for (int i = start; i < start + totvert_moved; i++) {
+      co[i][0] += rng.get_float() - 0.5f;
+      co[i][2] += rng.get_float() - 0.5f;
+    }
+    kb->curval = rng.get_float();
+    if (key_index % 4 == 0) {
+      BLI_snprintf(kb->vgroup, sizeof(kb->vgroup), "Group %d", key_index % 3);
+    }
+  }
+  /* One key moving all vertices, such as a jaw opening. */
+  KeyBlock *kb = BKE_keyblock_add(ctx->key, "Jaw");
+  BKE_keyblock_convert_from_mesh(ctx->mesh, ctx->key, kb);
+  float(*co)[3] = (float(*)[3])kb->data;
+  for (int i = 0; i < totvert; i++) {
+    co[i][1] -= 0.25f;
+  }
+  kb->curval = 0.5f;
+}
+
+static void test_shape_keys_free(ShapeKeyTestContext *ctx)
+{
+  ctx->key->id.tag &= ~LIB_TAG_COPIED_ON_WRITE;
+  ctx->mesh->key = nullptr;
+  BKE_id_free(nullptr, ctx->mesh);
+  BKE_main_free(ctx->bmain);
+  IDType_ID_OB.free_data(&ctx->ob.id);
+}
+
+TEST_F(KeyTest, relative_sparse_matches_dense)
+{
+  ShapeKeyTestContext ctx = {};
+  test_shape_keys_init(&ctx, 10000, 40, 300);
+
+  /* Original keys are evaluated without cached offsets. */
+  int totelem;
+  float *co_dense = BKE_key_evaluate_object(&ctx.ob, &totelem);
+  ASSERT_EQ(totelem, 10000);
+  LISTBASE_FOREACH (KeyBlock *, kb, &ctx.key->block) {
+    EXPECT_EQ(kb->delta, nullptr);
+  }
+
+  ctx.key->id.tag |= LIB_TAG_COPIED_ON_WRITE;
+  float *co_sparse = BKE_key_evaluate_object(&ctx.ob, &totelem);
+  LISTBASE_FOREACH (KeyBlock *, kb, &ctx.key->block) {
+    if (kb != ctx.key->refkey) {
+      EXPECT_NE(kb->delta, nullptr);
+    }
+  }
+  float *co_cached = BKE_key_evaluate_object(&ctx.ob, &totelem);
+
+  for (int i = 0; i < totelem * 3; i++) {
+    EXPECT_EQ(co_dense[i], co_sparse[i]);
+    EXPECT_EQ(co_dense[i], co_cached[i]);
+  }
+
+  MEM_freeN(co_dense);
+  MEM_freeN(co_sparse);
+  MEM_freeN(co_cached);
+  test_shape_keys_free(&ctx);
+}
+
+}  // namespace blender::bke::tests
@@ -339,15 +339,20 @@ static void lattice_vert_task_editmesh_no_dvert(void *__restrict userdata,
   lattice_deform_vert_with_dvert(data, BM_elem_index_get(v), NULL);
 }
 
-static void lattice_deform_coords_impl(const Object *ob_lattice,
-                                       const Object *ob_target,
-                                       float (*vert_coords)[3],
-                                       const int vert_coords_len,
-                                       const short flag,
-                                       const char *defgrp_name,
-                                       const float fac,
-                                       const Mesh *me_target,
-                                       BMEditMesh *em_target)
+/**
+ * Prepare \a data for deforming the coordinates.
+ *
+ * \return false when \a ob_lattice is not a lattice.
+ */
+static bool lattice_deform_data_init(LatticeDeformUserdata *data,
+                                     const Object *ob_lattice,
+                                     const Object *ob_target,
+                                     float (*vert_coords)[3],
+                                     const short flag,
+                                     const char *defgrp_name,
+                                     const float fac,
+                                     const Mesh *me_target,
+                                     BMEditMesh *em_target)
 {
   LatticeDeformData *lattice_deform_data;
   const MDeformVert *dvert = NULL;
@@ -355,7 +360,7 @@ static void lattice_deform_coords_impl(const Object *ob_lattice,
   int cd_dvert_offset = -1;
 
   if (ob_lattice->type != OB_LATTICE) {
-    return;
+    return false;
   }
 
   lattice_deform_data = BKE_lattice_deform_data_create(ob_lattice, ob_target);
@@ -383,7 +388,7 @@ static void lattice_deform_coords_impl(const Object *ob_lattice,
     }
   }
 
-  LatticeDeformUserdata data = {
+  *data = (LatticeDeformUserdata){
       .lattice_deform_data = lattice_deform_data,
       .vert_coords = vert_coords,
       .dvert = dvert,
@@ -396,6 +401,32 @@ static void lattice_deform_coords_impl(const Object *ob_lattice,
           },
   };
 
+  return true;
+}
+
+static void lattice_deform_coords_impl(const Object *ob_lattice,
+                                       const Object *ob_target,
+                                       float (*vert_coords)[3],
+                                       const int vert_coords_len,
+                                       const short flag,
+                                       const char *defgrp_name,
+                                       const float fac,
+                                       const Mesh *me_target,
+                                       BMEditMesh *em_target)
+{
+  LatticeDeformUserdata data;
+  if (!lattice_deform_data_init(&data,
+                                ob_lattice,
+                                ob_target,
+                                vert_coords,
+                                flag,
+                                defgrp_name,
+                                fac,
+                                me_target,
+                                em_target)) {
+    return;
+  }
+
   if (em_target != NULL) {
     /* While this could cause an extra loop over mesh data, in most cases this will
      * have already been properly set. */
@@ -404,7 +435,7 @@ static void lattice_deform_coords_impl(const Object *ob_lattice,
     TaskParallelSettings settings;
     BLI_parallel_mempool_settings_defaults(&settings);
 
-    if (cd_dvert_offset != -1) {
+    if (data.bmesh.cd_dvert_offset != -1) {
       BLI_task_parallel_mempool(
           em_target->bm->vpool, &data, lattice_vert_task_editmesh, &settings);
     }
@@ -420,7 +451,7 @@ static void lattice_deform_coords_impl(const Object *ob_lattice,
     BLI_task_parallel_range(0, vert_coords_len, &data, lattice_deform_vert_task, &settings);
   }
 
-  BKE_lattice_deform_data_destroy(lattice_deform_data);
+  BKE_lattice_deform_data_destroy(data.lattice_deform_data);
 }
 
 void BKE_lattice_deform_coords(const Object *ob_lattice,
@@ -475,4 +506,50 @@ void BKE_lattice_deform_coords_with_editmesh(const struct Object *ob_lattice,
                              em_target);
 }
 
+/** Lattice deform prepared for evaluating ranges of coordinates separately. */
+typedef struct LatticeDeformCoordsData {
+  LatticeDeformUserdata data;
+} LatticeDeformCoordsData;
+
+LatticeDeformCoordsData *BKE_lattice_deform_coords_data_create_with_mesh(
+    const Object *ob_lattice,
+    const Object *ob_target,
+    float (*vert_coords)[3],
+    const short flag,
+    const char *defgrp_name,
+    const float fac,
+    const Mesh *me_target)
+{
+  LatticeDeformCoordsData *deform_data = MEM_mallocN(sizeof(*deform_data), __func__);
+  if (!lattice_deform_data_init(&deform_data->data,
+                                ob_lattice,
+                                ob_target,
+                                vert_coords,
+                                flag,
+                                defgrp_name,
+                                fac,
+                                me_target,
+                                NULL)) {
+    MEM_freeN(deform_data);
+    return NULL;
+  }
+  return deform_data;
+}
+
+void BKE_lattice_deform_coords_data_eval_range(const LatticeDeformCoordsData *deform_data,
+                                               const int start,
+                                               const int end)
+{
+  const LatticeDeformUserdata *data = &deform_data->data;
+  for (int i = start; i < end; i++) {
+    lattice_deform_vert_with_dvert(data, i, data->dvert ? &data->dvert[i] : NULL);
+  }
+}
+
+void BKE_lattice_deform_coords_data_destroy(LatticeDeformCoordsData *deform_data)
+{
+  BKE_lattice_deform_data_destroy(deform_data->data.lattice_deform_data);
+  MEM_freeN(deform_data);
+}
+
 /** \} */
@@ -22,6 +22,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "DNA_curve_types.h"
 #include "DNA_lattice_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_object_types.h"
@@ -136,4 +137,36 @@ TEST(lattice_deform_performance, performance_no_dvert_10000000)
   test_lattice_deform_free(&ctx);
 }
 
+TEST(lattice_deform, ranges_match_full_deform)
+{
+  const int32_t num_items = 5000;
+  LatticeDeformTestContext ctx = {{{nullptr}}};
+  RandomNumberGenerator rng;
+  test_lattice_deform_init(&ctx, &rng, num_items);
+  for (int i = 0; i < ctx.lattice.pntsu * ctx.lattice.pntsv * ctx.lattice.pntsw; i++) {
+    ctx.lattice.def[i].vec[0] += rng.get_float() - 0.5f;
+    ctx.lattice.def[i].vec[2] += rng.get_float() - 0.5f;
+  }
+
+  float(*coords)[3] = (float(*)[3])MEM_dupallocN(ctx.coords);
+  BKE_lattice_deform_coords_with_mesh(
+      &ctx.ob_lattice, &ctx.ob_mesh, coords, num_items, 0, "", 0.75f, &ctx.mesh);
+
+  LatticeDeformCoordsData *deform_data = BKE_lattice_deform_coords_data_create_with_mesh(
+      &ctx.ob_lattice, &ctx.ob_mesh, ctx.coords, 0, "", 0.75f, &ctx.mesh);
+  ASSERT_NE(deform_data, nullptr);
+  BKE_lattice_deform_coords_data_eval_range(deform_data, 2500, num_items);
+  BKE_lattice_deform_coords_data_eval_range(deform_data, 0, 2500);
+  BKE_lattice_deform_coords_data_destroy(deform_data);
+
+  for (int i = 0; i < num_items; i++) {
+    EXPECT_EQ(coords[i][0], ctx.coords[i][0]);
+    EXPECT_EQ(coords[i][1], ctx.coords[i][1]);
+    EXPECT_EQ(coords[i][2], ctx.coords[i][2]);
+  }
+
+  MEM_freeN(coords);
+  test_lattice_deform_free(&ctx);
+}
+
 }  // namespace blender::bke::tests
@@ -23,18 +23,22 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 #include "DNA_vec_types.h"
 
 #include "BLI_bitmap.h"
 #include "BLI_buffer.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_customdata.h"
 #include "BKE_mesh_mapping.h"
 #include "BLI_memarena.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_strict_flags.h"
 
 /* -------------------------------------------------------------------- */
@@ -564,6 +568,266 @@ void BKE_mesh_origindex_map_create_looptri(MeshElemMap **r_map,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Cached Mesh Topology Maps
+ *
+ * The same maps as above, stored in the mesh runtime data so that all users of a mesh share
+ * them. They only depend on the mesh topology, and are freed with the other derived geometry
+ * data in #BKE_mesh_runtime_clear_geometry.
+ * \{ */
+
+struct MeshTopologyMaps {
+  /**
+   * Each map is a single allocation: the #MeshElemMap array followed by the array of indices
+   * they reference (a compressed sparse row layout).
+   */
+  MeshElemMap *vert_to_edge;
+  MeshElemMap *vert_to_poly;
+  MeshElemMap *edge_to_poly;
+  int *loop_to_poly;
+};
+
+enum {
+  MESH_TOPOLOGY_MAP_VERT_EDGE = 0,
+  MESH_TOPOLOGY_MAP_VERT_POLY = 1,
+  MESH_TOPOLOGY_MAP_EDGE_POLY = 2,
+};
+
+typedef struct MeshTopologyMapData {
+  const Mesh *mesh;
+  const int *loop_to_poly;
+  int type;
+  MeshElemMap *map;
+} MeshTopologyMapData;
+
+/**
+ * Each map is built from a list of (key, value) entries: the two vertices of every edge, or the
+ * vertex or edge of every loop.
+ */
+BLI_INLINE void mesh_topology_map_entry(const MeshTopologyMapData *data,
+                                        const int entry,
+                                        int *r_key,
+                                        int *r_value)
+{
+  switch (data->type) {
+    case MESH_TOPOLOGY_MAP_VERT_EDGE: {
+      const MEdge *edge = &data->mesh->medge[entry / 2];
+      *r_key = (int)((entry % 2) ? edge->v2 : edge->v1);
+      *r_value = entry / 2;
+      break;
+    }
+    case MESH_TOPOLOGY_MAP_VERT_POLY:
+      *r_key = (int)data->mesh->mloop[entry].v;
+      *r_value = data->loop_to_poly[entry];
+      break;
+    case MESH_TOPOLOGY_MAP_EDGE_POLY:
+      *r_key = (int)data->mesh->mloop[entry].e;
+      *r_value = data->loop_to_poly[entry];
+      break;
+  }
+}
+
+static void mesh_topology_map_count_cb(void *__restrict userdata,
+                                       const int entry,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const MeshTopologyMapData *data = userdata;
+  int key, value;
+  mesh_topology_map_entry(data, entry, &key, &value);
+  atomic_add_and_fetch_int32(&data->map[key].count, 1);
+}
+
+static void mesh_topology_map_fill_cb(void *__restrict userdata,
+                                      const int entry,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const MeshTopologyMapData *data = userdata;
+  int key, value;
+  mesh_topology_map_entry(data, entry, &key, &value);
+  MeshElemMap *map_ele = &data->map[key];
+  map_ele->indices[atomic_fetch_and_add_int32(&map_ele->count, 1)] = value;
+}
+
+static int cmp_int(const void *a, const void *b)
+{
+  const int i1 = *(const int *)a;
+  const int i2 = *(const int *)b;
+  return (i1 > i2) - (i1 < i2);
+}
+
+/**
+ * Entries are added in an arbitrary order by the threads, sort them so the maps are identical
+ * to the ones created by the single threaded functions above.
+ */
+static void mesh_topology_map_sort_cb(void *__restrict userdata,
+                                      const int key,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const MeshTopologyMapData *data = userdata;
+  int *indices = data->map[key].indices;
+  const int count = data->map[key].count;
+
+  if (count > 16) {
+    qsort(indices, (size_t)count, sizeof(int), cmp_int);
+    return;
+  }
+  for (int i = 1; i < count; i++) {
+    const int value = indices[i];
+    int j = i;
+    for (; j > 0 && indices[j - 1] > value; j--) {
+      indices[j] = indices[j - 1];
+    }
+    indices[j] = value;
+  }
+}
+
+static MeshElemMap *mesh_topology_map_create(const Mesh *mesh,
+                                             const int *loop_to_poly,
+                                             const int type)
+{
+  const int totkey = (type == MESH_TOPOLOGY_MAP_EDGE_POLY) ? mesh->totedge : mesh->totvert;
+  const int totentry = (type == MESH_TOPOLOGY_MAP_VERT_EDGE) ? mesh->totedge * 2 :
+                                                               mesh->totloop;
+
+  MeshElemMap *map = MEM_callocN(
+      sizeof(MeshElemMap) * (size_t)totkey + sizeof(int) * (size_t)totentry, __func__);
+  int *indices = (int *)(map + totkey);
+
+  MeshTopologyMapData data = {
+      .mesh = mesh,
+      .loop_to_poly = loop_to_poly,
+      .type = type,
+      .map = map,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 4096;
+
+  BLI_task_parallel_range(0, totentry, &data, mesh_topology_map_count_cb, &settings);
+
+  /* Assign indices mem */
+  int *index_iter = indices;
+  for (int i = 0; i < totkey; i++) {
+    map[i].indices = index_iter;
+    index_iter += map[i].count;
+
+    /* Reset 'count' for use as index when filling. */
+    map[i].count = 0;
+  }
+
+  BLI_task_parallel_range(0, totentry, &data, mesh_topology_map_fill_cb, &settings);
+  BLI_task_parallel_range(0, totkey, &data, mesh_topology_map_sort_cb, &settings);
+
+  return map;
+}
+
+static void mesh_loop_poly_map_cb(void *__restrict userdata,
+                                  const int poly_index,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const MeshTopologyMapData *data = userdata;
+  const MPoly *mp = &data->mesh->mpoly[poly_index];
+  int *loop_to_poly = (int *)data->loop_to_poly;
+  for (int i = 0; i < mp->totloop; i++) {
+    loop_to_poly[mp->loopstart + i] = poly_index;
+  }
+}
+
+static struct MeshTopologyMaps *mesh_topology_maps_ensure(const Mesh *mesh)
+{
+  /* The maps are lazily initialized cache data, not part of the mesh state. */
+  void **maps_p = (void **)&mesh->runtime.topology_maps;
+  struct MeshTopologyMaps *maps = *maps_p;
+  if (maps == NULL) {
+    struct MeshTopologyMaps *maps_new = MEM_callocN(sizeof(*maps_new), __func__);
+    maps = atomic_cas_ptr(maps_p, NULL, maps_new);
+    if (maps == NULL) {
+      maps = maps_new;
+    }
+    else {
+      /* Another thread created them first. */
+      MEM_freeN(maps_new);
+    }
+  }
+  return maps;
+}
+
+/**
+ * Store a newly created map, unless another thread stored one in the meantime. The maps are
+ * built without locking, they are identical regardless of the thread building them.
+ */
+static void *mesh_topology_map_store(void **map_p, void *map_new)
+{
+  void *map = atomic_cas_ptr(map_p, NULL, map_new);
+  if (map != NULL) {
+    MEM_freeN(map_new);
+    return map;
+  }
+  return map_new;
+}
+
+const int *BKE_mesh_loop_poly_map_ensure(const Mesh *mesh)
+{
+  struct MeshTopologyMaps *maps = mesh_topology_maps_ensure(mesh);
+  if (maps->loop_to_poly == NULL) {
+    int *loop_to_poly = MEM_mallocN(sizeof(int) * (size_t)mesh->totloop, __func__);
+    MeshTopologyMapData data = {
+        .mesh = mesh,
+        .loop_to_poly = loop_to_poly,
+    };
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1024;
+    BLI_task_parallel_range(0, mesh->totpoly, &data, mesh_loop_poly_map_cb, &settings);
+    return mesh_topology_map_store((void **)&maps->loop_to_poly, loop_to_poly);
+  }
+  return maps->loop_to_poly;
+}
+
+const MeshElemMap *BKE_mesh_vert_edge_map_ensure(const Mesh *mesh)
+{
+  struct MeshTopologyMaps *maps = mesh_topology_maps_ensure(mesh);
+  if (maps->vert_to_edge == NULL) {
+    MeshElemMap *map = mesh_topology_map_create(mesh, NULL, MESH_TOPOLOGY_MAP_VERT_EDGE);
+    return mesh_topology_map_store((void **)&maps->vert_to_edge, map);
+  }
+  return maps->vert_to_edge;
+}
+
+const MeshElemMap *BKE_mesh_vert_poly_map_ensure(const Mesh *mesh)
+{
+  struct MeshTopologyMaps *maps = mesh_topology_maps_ensure(mesh);
+  if (maps->vert_to_poly == NULL) {
+    const int *loop_to_poly = BKE_mesh_loop_poly_map_ensure(mesh);
+    MeshElemMap *map = mesh_topology_map_create(mesh, loop_to_poly, MESH_TOPOLOGY_MAP_VERT_POLY);
+    return mesh_topology_map_store((void **)&maps->vert_to_poly, map);
+  }
+  return maps->vert_to_poly;
+}
+
+const MeshElemMap *BKE_mesh_edge_poly_map_ensure(const Mesh *mesh)
+{
+  struct MeshTopologyMaps *maps = mesh_topology_maps_ensure(mesh);
+  if (maps->edge_to_poly == NULL) {
+    const int *loop_to_poly = BKE_mesh_loop_poly_map_ensure(mesh);
+    MeshElemMap *map = mesh_topology_map_create(mesh, loop_to_poly, MESH_TOPOLOGY_MAP_EDGE_POLY);
+    return mesh_topology_map_store((void **)&maps->edge_to_poly, map);
+  }
+  return maps->edge_to_poly;
+}
+
+void BKE_mesh_topology_maps_free(struct MeshTopologyMaps *maps)
+{
+  MEM_SAFE_FREE(maps->vert_to_edge);
+  MEM_SAFE_FREE(maps->vert_to_poly);
+  MEM_SAFE_FREE(maps->edge_to_poly);
+  MEM_SAFE_FREE(maps->loop_to_poly);
+  MEM_freeN(maps);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Mesh loops/poly islands.
  * Used currently for UVs and 'smooth groups'.
@@ -0,0 +1,133 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
+#include "BKE_mesh_runtime.h"
+
+#include "BLI_utildefines.h"
+
+#include "tests/BKE_mesh_test_utils.hh"
+
+namespace blender::bke::tests {
+
+class MeshMappingTest : public MeshTest {
+};
+
+/* Enough loops for the cached maps to be built by several threads. */
+static const int grid_res = 64;
+
+static void expect_maps_equal(const MeshElemMap *map_a, const MeshElemMap *map_b, const int len)
+{
+  for (int i = 0; i < len; i++) {
+    ASSERT_EQ(map_a[i].count, map_b[i].count) << "index " << i;
+    for (int j = 0; j < map_a[i].count; j++) {
+      EXPECT_EQ(map_a[i].indices[j], map_b[i].indices[j]) << "index " << i;
+    }
+  }
+}
+
+/** Compare all cached topology maps of \a mesh with the ones created by the serial functions. */
+static void expect_topology_maps_match_serial(const Mesh *mesh)
+{
+  MeshElemMap *map;
+  int *mem;
+
+  BKE_mesh_vert_edge_map_create(&map, &mem, mesh->medge, mesh->totvert, mesh->totedge);
+  expect_maps_equal(BKE_mesh_vert_edge_map_ensure(mesh), map, mesh->totvert);
+  MEM_freeN(map);
+  MEM_freeN(mem);
+
+  BKE_mesh_vert_poly_map_create(&map,
+                                &mem,
+                                mesh->mpoly,
+                                mesh->mloop,
+                                mesh->totvert,
+                                mesh->totpoly,
+                                mesh->totloop);
+  expect_maps_equal(BKE_mesh_vert_poly_map_ensure(mesh), map, mesh->totvert);
+  MEM_freeN(map);
+  MEM_freeN(mem);
+
+  BKE_mesh_edge_poly_map_create(&map,
+                                &mem,
+                                mesh->medge,
+                                mesh->totedge,
+                                mesh->mpoly,
+                                mesh->totpoly,
+                                mesh->mloop,
+                                mesh->totloop);
+  expect_maps_equal(BKE_mesh_edge_poly_map_ensure(mesh), map, mesh->totedge);
+  MEM_freeN(map);
+  MEM_freeN(mem);
+
+  const int *loop_to_poly = BKE_mesh_loop_poly_map_ensure(mesh);
+  for (int i = 0; i < mesh->totpoly; i++) {
+    const MPoly *mp = &mesh->mpoly[i];
+    for (int j = 0; j < mp->totloop; j++) {
+      EXPECT_EQ(loop_to_poly[mp->loopstart + j], i);
+    }
+  }
+}
+
+TEST_F(MeshMappingTest, topology_maps_match_serial)
+{
+  Mesh *mesh = mesh_grid_create(grid_res);
+
+  expect_topology_maps_match_serial(mesh);
+
+  /* Maps are cached, the same arrays are returned until the mesh geometry is cleared. */
+  const MeshElemMap *vert_edge = BKE_mesh_vert_edge_map_ensure(mesh);
+  const MeshElemMap *vert_poly = BKE_mesh_vert_poly_map_ensure(mesh);
+  const MeshElemMap *edge_poly = BKE_mesh_edge_poly_map_ensure(mesh);
+  const int *loop_to_poly = BKE_mesh_loop_poly_map_ensure(mesh);
+  EXPECT_EQ(BKE_mesh_vert_edge_map_ensure(mesh), vert_edge);
+  EXPECT_EQ(BKE_mesh_vert_poly_map_ensure(mesh), vert_poly);
+  EXPECT_EQ(BKE_mesh_edge_poly_map_ensure(mesh), edge_poly);
+  EXPECT_EQ(BKE_mesh_loop_poly_map_ensure(mesh), loop_to_poly);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshMappingTest, topology_maps_cleared_with_geometry)
+{
+  Mesh *mesh = mesh_grid_create(grid_res);
+
+  expect_topology_maps_match_serial(mesh);
+  EXPECT_NE(mesh->runtime.topology_maps, nullptr);
+
+  /* Reverse the order of the polygons, which changes every map referencing them. */
+  for (int i = 0; i < mesh->totpoly / 2; i++) {
+    SWAP(MPoly, mesh->mpoly[i], mesh->mpoly[mesh->totpoly - 1 - i]);
+  }
+  BKE_mesh_runtime_clear_geometry(mesh);
+  EXPECT_EQ(mesh->runtime.topology_maps, nullptr);
+
+  expect_topology_maps_match_serial(mesh);
+  const int *loop_to_poly = BKE_mesh_loop_poly_map_ensure(mesh);
+  EXPECT_EQ(loop_to_poly[0], mesh->totpoly - 1);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::tests
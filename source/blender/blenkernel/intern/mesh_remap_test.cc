@@ -0,0 +1,312 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include <cfloat>
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
+#include "BKE_mesh_remap.h"
+
+#include "BLI_index_range.hh"
+#include "BLI_math.h"
+#include "BLI_task.hh"
+#include "BLI_utildefines.h"
+
+#include "tests/BKE_mesh_test_utils.hh"
+
+namespace blender::bke::tests {
+
+class MeshRemapTest : public MeshTest {
+};
+
+/* Large enough to be split in several blocks of destination elements. */
+static const int grid_res = 40;
+
+/**
+ * Same as #mesh_grid_create, but each quad uses its own vertices, moved towards the quad's
+ * center by the `shrink` factor.
+ */
+static Mesh *test_grid_split_mesh_create(const int res, const float3 offset, const float shrink)
+{
+  const int loops_len = res * res * 4;
+  Mesh *mesh = BKE_mesh_new_nomain(loops_len, 0, 0, loops_len, res * res);
+
+  for (int y = 0; y < res; y++) {
+    for (int x = 0; x < res; x++) {
+      const int poly_index = y * res + x;
+      const float corners[4][2] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+      MPoly *mp = &mesh->mpoly[poly_index];
+      mp->loopstart = poly_index * 4;
+      mp->totloop = 4;
+      for (int j = 0; j < 4; j++) {
+        const int l = mp->loopstart + j;
+        const float co[3] = {float(x) + 0.5f + (corners[j][0] - 0.5f) * (1.0f - shrink),
+                             float(y) + 0.5f + (corners[j][1] - 0.5f) * (1.0f - shrink),
+                             0.0f};
+        add_v3_v3v3(mesh->mvert[l].co, co, offset);
+        mesh->mloop[l].v = uint(l);
+      }
+    }
+  }
+  BKE_mesh_calc_edges(mesh, false, false);
+  return mesh;
+}
+
+static void test_remap_expect_equal(const MeshPairRemap &a, const MeshPairRemap &b)
+{
+  ASSERT_EQ(a.items_num, b.items_num);
+  for (int i = 0; i < a.items_num; i++) {
+    const MeshPairRemapItem &item_a = a.items[i];
+    const MeshPairRemapItem &item_b = b.items[i];
+    ASSERT_EQ(item_a.sources_num, item_b.sources_num);
+    for (int j = 0; j < item_a.sources_num; j++) {
+      EXPECT_EQ(item_a.indices_src[j], item_b.indices_src[j]);
+      EXPECT_EQ(item_a.weights_src[j], item_b.weights_src[j]);
+    }
+  }
+}
+
+/**
+ * Run \a fn with at most \a threads_num threads working on its parallel tasks. Only a local task
+ * arena is limited, the global task scheduler state is left untouched for other tests.
+ */
+template<typename Fn> static void test_with_threads(const int threads_num, const Fn &fn)
+{
+#ifdef WITH_TBB
+  tbb::task_arena arena(threads_num);
+  arena.execute(fn);
+#else
+  UNUSED_VARS(threads_num);
+  fn();
+#endif
+}
+
+/* Thread counts used by the repeatable tests, the first one is the reference. */
+static const int test_threads_num[] = {1, 2, 8};
+
+TEST_F(MeshRemapTest, verts_nearest)
+{
+  const float3 offset_src(0.0f, 0.0f, 0.0f);
+  const float3 offset_dst(0.1f, 0.2f, 0.3f);
+  Mesh *me_src = mesh_grid_create(grid_res, 1.0f, offset_src);
+  Mesh *me_dst = mesh_grid_create(grid_res, 1.0f, offset_dst);
+  MeshPairRemap map = {0};
+
+  BKE_mesh_remap_calc_verts_from_mesh(MREMAP_MODE_VERT_NEAREST,
+                                      nullptr,
+                                      FLT_MAX,
+                                      0.0f,
+                                      me_dst->mvert,
+                                      me_dst->totvert,
+                                      false,
+                                      me_src,
+                                      &map);
+
+  ASSERT_EQ(map.items_num, me_dst->totvert);
+  for (int i = 0; i < map.items_num; i++) {
+    ASSERT_EQ(map.items[i].sources_num, 1);
+    EXPECT_EQ(map.items[i].indices_src[0], i);
+    EXPECT_EQ(map.items[i].weights_src[0], 1.0f);
+  }
+
+  BKE_mesh_remap_free(&map);
+  BKE_id_free(nullptr, me_src);
+  BKE_id_free(nullptr, me_dst);
+}
+
+TEST_F(MeshRemapTest, verts_polyinterp_nearest_repeatable)
+{
+  const float3 offset_src(0.0f, 0.0f, 0.0f);
+  const float3 offset_dst(0.3f, 0.4f, 0.1f);
+  Mesh *me_src = mesh_grid_create(grid_res, 1.0f, offset_src);
+  Mesh *me_dst = mesh_grid_create(grid_res, 1.0f, offset_dst);
+  MeshPairRemap maps[ARRAY_SIZE(test_threads_num)] = {{0}};
+
+  for (const int i : IndexRange(ARRAY_SIZE(test_threads_num))) {
+    test_with_threads(test_threads_num[i], [&]() {
+      BKE_mesh_remap_calc_verts_from_mesh(MREMAP_MODE_VERT_POLYINTERP_NEAREST,
+                                          nullptr,
+                                          FLT_MAX,
+                                          0.0f,
+                                          me_dst->mvert,
+                                          me_dst->totvert,
+                                          false,
+                                          me_src,
+                                          &maps[i]);
+    });
+  }
+  const MeshPairRemap &map_a = maps[0];
+  for (const int i : IndexRange(1, ARRAY_SIZE(test_threads_num) - 1)) {
+    test_remap_expect_equal(map_a, maps[i]);
+  }
+
+  for (int i = 0; i < map_a.items_num; i++) {
+    const MeshPairRemapItem &item = map_a.items[i];
+    float weights_sum = 0.0f;
+    for (int j = 0; j < item.sources_num; j++) {
+      weights_sum += item.weights_src[j];
+    }
+    EXPECT_NEAR(weights_sum, 1.0f, 1e-5f);
+  }
+
+  for (MeshPairRemap &map : maps) {
+    BKE_mesh_remap_free(&map);
+  }
+  BKE_id_free(nullptr, me_src);
+  BKE_id_free(nullptr, me_dst);
+}
+
+TEST_F(MeshRemapTest, loops_polyinterp_nearest)
+{
+  const float3 offset_src(0.0f, 0.0f, 0.0f);
+  const float3 offset_dst(0.0f, 0.0f, 0.5f);
+  Mesh *me_src = mesh_grid_create(grid_res, 1.0f, offset_src);
+  Mesh *me_dst = test_grid_split_mesh_create(grid_res, offset_dst, 0.1f);
+  MeshPairRemap map = {0};
+
+  BKE_mesh_remap_calc_loops_from_mesh(MREMAP_MODE_LOOP_POLYINTERP_NEAREST,
+                                      nullptr,
+                                      FLT_MAX,
+                                      0.0f,
+                                      me_dst,
+                                      me_dst->mvert,
+                                      me_dst->totvert,
+                                      me_dst->medge,
+                                      me_dst->totedge,
+                                      me_dst->mloop,
+                                      me_dst->totloop,
+                                      me_dst->mpoly,
+                                      me_dst->totpoly,
+                                      &me_dst->ldata,
+                                      false,
+                                      0.0f,
+                                      false,
+                                      me_src,
+                                      nullptr,
+                                      0.0f,
+                                      &map);
+
+  ASSERT_EQ(map.items_num, me_dst->totloop);
+  for (int i = 0; i < me_dst->totpoly; i++) {
+    const MPoly *mp = &me_dst->mpoly[i];
+    for (int l = mp->loopstart; l < mp->loopstart + mp->totloop; l++) {
+      const MeshPairRemapItem &item = map.items[l];
+      ASSERT_EQ(item.sources_num, 4);
+      float weights_sum = 0.0f;
+      for (int j = 0; j < item.sources_num; j++) {
+        /* Source loops are those of the matching source poly. */
+        EXPECT_EQ(item.indices_src[j], mp->loopstart + j);
+        weights_sum += item.weights_src[j];
+      }
+      EXPECT_NEAR(weights_sum, 1.0f, 1e-5f);
+    }
+  }
+
+  BKE_mesh_remap_free(&map);
+  BKE_id_free(nullptr, me_src);
+  BKE_id_free(nullptr, me_dst);
+}
+
+TEST_F(MeshRemapTest, polys_nearest)
+{
+  const float3 offset_src(0.0f, 0.0f, 0.0f);
+  const float3 offset_dst(0.0f, 0.0f, 0.25f);
+  Mesh *me_src = mesh_grid_create(grid_res, 1.0f, offset_src);
+  Mesh *me_dst = mesh_grid_create(grid_res, 1.0f, offset_dst);
+  MeshPairRemap map = {0};
+
+  BKE_mesh_remap_calc_polys_from_mesh(MREMAP_MODE_POLY_NEAREST,
+                                      nullptr,
+                                      FLT_MAX,
+                                      0.0f,
+                                      me_dst,
+                                      me_dst->mvert,
+                                      me_dst->mloop,
+                                      me_dst->mpoly,
+                                      me_dst->totpoly,
+                                      me_src,
+                                      &map);
+
+  ASSERT_EQ(map.items_num, me_dst->totpoly);
+  for (int i = 0; i < map.items_num; i++) {
+    ASSERT_EQ(map.items[i].sources_num, 1);
+    EXPECT_EQ(map.items[i].indices_src[0], i);
+  }
+
+  BKE_mesh_remap_free(&map);
+  BKE_id_free(nullptr, me_src);
+  BKE_id_free(nullptr, me_dst);
+}
+
+TEST_F(MeshRemapTest, polys_polyinterp_pnorproj_repeatable)
+{
+  const float3 offset_src(0.0f, 0.0f, 0.0f);
+  const float3 offset_dst(0.5f, 0.5f, 0.25f);
+  Mesh *me_src = mesh_grid_create(grid_res, 1.0f, offset_src);
+  Mesh *me_dst = mesh_grid_create(grid_res, 1.0f, offset_dst);
+  MeshPairRemap maps[ARRAY_SIZE(test_threads_num)] = {{0}};
+
+  for (const int i : IndexRange(ARRAY_SIZE(test_threads_num))) {
+    test_with_threads(test_threads_num[i], [&]() {
+      BKE_mesh_remap_calc_polys_from_mesh(MREMAP_MODE_POLY_POLYINTERP_PNORPROJ,
+                                          nullptr,
+                                          FLT_MAX,
+                                          0.1f,
+                                          me_dst,
+                                          me_dst->mvert,
+                                          me_dst->mloop,
+                                          me_dst->mpoly,
+                                          me_dst->totpoly,
+                                          me_src,
+                                          &maps[i]);
+    });
+  }
+  const MeshPairRemap &map_a = maps[0];
+  for (const int i : IndexRange(1, ARRAY_SIZE(test_threads_num) - 1)) {
+    test_remap_expect_equal(map_a, maps[i]);
+  }
+
+  for (int i = 0; i < map_a.items_num; i++) {
+    const MeshPairRemapItem &item = map_a.items[i];
+    float weights_sum = 0.0f;
+    for (int j = 0; j < item.sources_num; j++) {
+      /* Sources are sorted. */
+      if (j > 0) {
+        EXPECT_LT(item.indices_src[j - 1], item.indices_src[j]);
+      }
+      weights_sum += item.weights_src[j];
+    }
+    if (item.sources_num) {
+      EXPECT_NEAR(weights_sum, 1.0f, 1e-5f);
+    }
+  }
+  /* Dest polys fully inside the source grid overlap four source polys. */
+  const MeshPairRemapItem &item = map_a.items[grid_res + 1];
+  EXPECT_EQ(item.sources_num, 4);
+
+  for (MeshPairRemap &map : maps) {
+    BKE_mesh_remap_free(&map);
+  }
+  BKE_id_free(nullptr, me_src);
+  BKE_id_free(nullptr, me_dst);
+}
+
+}  // namespace blender::bke::tests
@@ -51,6 +51,9 @@
 
 #define LEAF_LIMIT 10000
 
+/* Number of primitives above which the bounds of a node are computed in parallel. */
+#define BUILD_THREADED_LIMIT 100000
+
 //#define PERFCNTRS
 
 #define STACK_FIXED_DEPTH 100
@@ -246,42 +249,33 @@ void pbvh_grow_nodes(PBVH *pbvh, int totnode)
   pbvh->totnode = totnode;
 }
 
-/* Add a vertex to the map, with a positive value for unique vertices and
- * a negative value for additional vertices */
-static int map_insert_vert(
-    PBVH *pbvh, GHash *map, unsigned int *face_verts, unsigned int *uniq_verts, int vertex)
-{
-  void *key, **value_p;
-
-  key = POINTER_FROM_INT(vertex);
-  if (!BLI_ghash_ensure_p(map, key, &value_p)) {
-    int value_i;
-    if (BLI_BITMAP_TEST(pbvh->vert_bitmap, vertex) == 0) {
-      BLI_BITMAP_ENABLE(pbvh->vert_bitmap, vertex);
-      value_i = *uniq_verts;
-      (*uniq_verts)++;
-    }
-    else {
-      value_i = ~(*face_verts);
-      (*face_verts)++;
-    }
-    *value_p = POINTER_FROM_INT(value_i);
-    return value_i;
-  }
-
-  return POINTER_AS_INT(*value_p);
-}
+/**
+ * Vertices used by a mesh leaf node, gathered before deciding which node owns each vertex.
+ * The ownership depends on the order nodes are visited, so that part can't be threaded.
+ */
+typedef struct PBVHLeafVertMap {
+  /** Vertex to index in #verts, the iteration order defines the order of the node vertices. */
+  GHash *map;
+  /**
+   * Vertices in the order they are first used by the node triangles. Replaced by
+   * #build_mesh_leaf_owners with a positive value for unique vertices and a negative value for
+   * additional vertices.
+   */
+  int *verts;
+  int totvert;
+} PBVHLeafVertMap;
 
-/* Find vertices used by the faces in this node and update the draw buffers */
-static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
+/* Find vertices used by the faces in this node. */
+static void build_mesh_leaf_map(PBVH *pbvh, PBVHNode *node, PBVHLeafVertMap *leaf_map)
 {
   bool has_visible = false;
 
-  node->uniq_verts = node->face_verts = 0;
   const int totface = node->totprim;
 
   /* reserve size is rough guess */
   GHash *map = BLI_ghash_int_new_ex("build_mesh_leaf_node gh", 2 * totface);
+  int *verts = MEM_mallocN(sizeof(int) * totface * 3, "bvh node leaf verts");
+  int totvert = 0;
 
   int(*face_vert_indices)[3] = MEM_mallocN(sizeof(int[3]) * totface, "bvh node face vert indices");
 
@@ -294,8 +288,13 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
   for (int i = 0; i < totface; i++) {
     const MLoopTri *lt = &pbvh->looptri[node->prim_indices[i]];
     for (int j = 0; j < 3; j++) {
-      face_vert_indices[i][j] = map_insert_vert(
-          pbvh, map, &node->face_verts, &node->uniq_verts, pbvh->mloop[lt->tri[j]].v);
+      const int vertex = pbvh->mloop[lt->tri[j]].v;
+      void **value_p;
+      if (!BLI_ghash_ensure_p(map, POINTER_FROM_INT(vertex), &value_p)) {
+        *value_p = POINTER_FROM_INT(totvert);
+        verts[totvert++] = vertex;
+      }
+      face_vert_indices[i][j] = POINTER_AS_INT(*value_p);
     }
 
     if (has_visible == false) {
@@ -305,15 +304,42 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
     }
   }
 
+  BKE_pbvh_node_fully_hidden_set(node, !has_visible);
+
+  leaf_map->map = map;
+  leaf_map->verts = verts;
+  leaf_map->totvert = totvert;
+}
+
+/* Assign vertices to the first node using them, nodes must be visited in depth-first order. */
+static void build_mesh_leaf_owners(PBVH *pbvh, PBVHNode *node, PBVHLeafVertMap *leaf_map)
+{
+  node->uniq_verts = node->face_verts = 0;
+
+  for (int i = 0; i < leaf_map->totvert; i++) {
+    const int vertex = leaf_map->verts[i];
+    if (BLI_BITMAP_TEST(pbvh->vert_bitmap, vertex) == 0) {
+      BLI_BITMAP_ENABLE(pbvh->vert_bitmap, vertex);
+      leaf_map->verts[i] = node->uniq_verts++;
+    }
+    else {
+      leaf_map->verts[i] = ~(node->face_verts++);
+    }
+  }
+}
+
+/* Build the vertex list of the node and update the draw buffers. */
+static void build_mesh_leaf_indices(PBVHNode *node, PBVHLeafVertMap *leaf_map)
+{
   int *vert_indices = MEM_callocN(sizeof(int) * (node->uniq_verts + node->face_verts),
                                   "bvh node vert indices");
   node->vert_indices = vert_indices;
 
   /* Build the vertex list, unique verts first */
   GHashIterator gh_iter;
-  GHASH_ITER (gh_iter, map) {
+  GHASH_ITER (gh_iter, leaf_map->map) {
     void *value = BLI_ghashIterator_getValue(&gh_iter);
-    int ndx = POINTER_AS_INT(value);
+    int ndx = leaf_map->verts[POINTER_AS_INT(value)];
 
     if (ndx < 0) {
       ndx = -ndx + node->uniq_verts - 1;
@@ -322,30 +348,103 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
     vert_indices[ndx] = POINTER_AS_INT(BLI_ghashIterator_getKey(&gh_iter));
   }
 
-  for (int i = 0; i < totface; i++) {
+  int(*face_vert_indices)[3] = (int(*)[3])node->face_vert_indices;
+  for (int i = 0; i < node->totprim; i++) {
     const int sides = 3;
 
     for (int j = 0; j < sides; j++) {
-      if (face_vert_indices[i][j] < 0) {
-        face_vert_indices[i][j] = -face_vert_indices[i][j] + node->uniq_verts - 1;
+      int ndx = leaf_map->verts[face_vert_indices[i][j]];
+      if (ndx < 0) {
+        ndx = -ndx + node->uniq_verts - 1;
       }
+      face_vert_indices[i][j] = ndx;
     }
   }
 
   BKE_pbvh_node_mark_rebuild_draw(node);
 
-  BKE_pbvh_node_fully_hidden_set(node, !has_visible);
+  BLI_ghash_free(leaf_map->map, NULL, NULL);
+  MEM_freeN(leaf_map->verts);
+}
+
+typedef struct PBVHBoundsData {
+  const int *prim_indices;
+  BBC *prim_bbc;
+  int offset;
+} PBVHBoundsData;
+
+typedef struct PBVHBoundsChunk {
+  /** Bounds of the primitives. */
+  BB vb;
+  /** Bounds of the primitive centroids. */
+  BB cb;
+} PBVHBoundsChunk;
 
-  BLI_ghash_free(map, NULL, NULL);
+static void pbvh_bounds_task_cb(void *__restrict userdata,
+                                const int n,
+                                const TaskParallelTLS *__restrict tls)
+{
+  const PBVHBoundsData *data = userdata;
+  PBVHBoundsChunk *chunk = tls->userdata_chunk;
+  BBC *bbc = &data->prim_bbc[data->prim_indices[data->offset + n]];
+
+  BB_expand_with_bb(&chunk->vb, (BB *)bbc);
+  BB_expand(&chunk->cb, bbc->bcentroid);
 }
 
-static void update_vb(PBVH *pbvh, PBVHNode *node, BBC *prim_bbc, int offset, int count)
+static void pbvh_bounds_reduce(const void *__restrict UNUSED(userdata),
+                               void *__restrict chunk_join,
+                               void *__restrict chunk)
 {
-  BB_reset(&node->vb);
-  for (int i = offset + count - 1; i >= offset; i--) {
-    BB_expand_with_bb(&node->vb, (BB *)(&prim_bbc[pbvh->prim_indices[i]]));
+  PBVHBoundsChunk *join = chunk_join;
+  PBVHBoundsChunk *bounds = chunk;
+
+  BB_expand_with_bb(&join->vb, &bounds->vb);
+  BB_expand_with_bb(&join->cb, &bounds->cb);
+}
+
+/**
+ * Compute the bounds of a range of primitives and of their centroids, threaded for the large
+ * ranges near the root of the tree.
+ */
+static void update_bounds(
+    const int *prim_indices, BBC *prim_bbc, int offset, int count, BB *r_vb, BB *r_cb)
+{
+  if (count <= BUILD_THREADED_LIMIT) {
+    BB_reset(r_vb);
+    for (int i = offset + count - 1; i >= offset; i--) {
+      BB_expand_with_bb(r_vb, (BB *)(&prim_bbc[prim_indices[i]]));
+    }
+    if (r_cb) {
+      BB_reset(r_cb);
+      for (int i = offset + count - 1; i >= offset; i--) {
+        BB_expand(r_cb, prim_bbc[prim_indices[i]].bcentroid);
+      }
+    }
+    return;
+  }
+
+  PBVHBoundsData data = {
+      .prim_indices = prim_indices,
+      .prim_bbc = prim_bbc,
+      .offset = offset,
+  };
+  PBVHBoundsChunk bounds;
+  BB_reset(&bounds.vb);
+  BB_reset(&bounds.cb);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = BUILD_THREADED_LIMIT / 4;
+  settings.userdata_chunk = &bounds;
+  settings.userdata_chunk_size = sizeof(bounds);
+  settings.func_reduce = pbvh_bounds_reduce;
+  BLI_task_parallel_range(0, count, &data, pbvh_bounds_task_cb, &settings);
+
+  *r_vb = bounds.vb;
+  if (r_cb) {
+    *r_cb = bounds.cb;
   }
-  node->orig_vb = node->vb;
 }
 
 int BKE_pbvh_count_grid_quads(BLI_bitmap **grid_hidden,
@@ -408,24 +507,6 @@ static void build_grid_leaf_node(PBVH *pbvh, PBVHNode *node)
   BKE_pbvh_node_mark_rebuild_draw(node);
 }
 
-static void build_leaf(PBVH *pbvh, int node_index, BBC *prim_bbc, int offset, int count)
-{
-  pbvh->nodes[node_index].flag |= PBVH_Leaf;
-
-  pbvh->nodes[node_index].prim_indices = pbvh->prim_indices + offset;
-  pbvh->nodes[node_index].totprim = count;
-
-  /* Still need vb for searches */
-  update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
-
-  if (pbvh->looptri) {
-    build_mesh_leaf_node(pbvh, pbvh->nodes + node_index);
-  }
-  else {
-    build_grid_leaf_node(pbvh, pbvh->nodes + node_index);
-  }
-}
-
 /* Return zero if all primitives in the node can be drawn with the
  * same material (including flat/smooth shading), non-zero otherwise */
 static bool leaf_needs_material_split(PBVH *pbvh, int offset, int count)
@@ -460,19 +541,41 @@ static bool leaf_needs_material_split(PBVH *pbvh, int offset, int count)
   return false;
 }
 
+/**
+ * Node of the temporary tree built by #build_sub. The tree is only converted to #PBVHNode once
+ * complete, since the node indices depend on the size of the subtrees built before them.
+ */
+typedef struct PBVHBuildNode {
+  /** Both children are null for leaf nodes. */
+  struct PBVHBuildNode *children[2];
+  /** Bounds of the primitives in the node. */
+  BB vb;
+  /** Range in the array of primitive indices. */
+  int offset, count;
+} PBVHBuildNode;
+
+typedef struct PBVHBuildContext {
+  PBVH *pbvh;
+  BBC *prim_bbc;
+  int totleaf;
+} PBVHBuildContext;
+
+static void build_sub_task_cb(TaskPool *__restrict pool, void *taskdata);
+
 /* Recursively build a node in the tree
- *
- * vb is the voxel box around all of the primitives contained in
- * this node.
  *
  * cb is the bounding box around all the centroids of the primitives
- * contained in this node
+ * contained in this node, computed when NULL.
  *
- * offset and start indicate a range in the array of primitive indices
+ * Subtrees that still need to be split are built in parallel tasks, their primitives are
+ * contiguous and disjoint ranges of the primitive indices.
  */
 
-static void build_sub(PBVH *pbvh, int node_index, BB *cb, BBC *prim_bbc, int offset, int count)
+static void build_sub(PBVHBuildContext *ctx, TaskPool *pool, PBVHBuildNode *node, const BB *cb)
 {
+  PBVH *pbvh = ctx->pbvh;
+  const int offset = node->offset;
+  const int count = node->count;
   int end;
   BB cb_backing;
 
@@ -480,26 +583,26 @@ static void build_sub(PBVH *pbvh, int node_index, BB *cb, BBC *prim_bbc, int off
   const bool below_leaf_limit = count <= pbvh->leaf_limit;
   if (below_leaf_limit) {
     if (!leaf_needs_material_split(pbvh, offset, count)) {
-      build_leaf(pbvh, node_index, prim_bbc, offset, count);
+      /* Still need vb for searches */
+      update_bounds(pbvh->prim_indices, ctx->prim_bbc, offset, count, &node->vb, NULL);
+      atomic_add_and_fetch_int32(&ctx->totleaf, 1);
       return;
     }
   }
 
-  /* Add two child nodes */
-  pbvh->nodes[node_index].children_offset = pbvh->totnode;
-  pbvh_grow_nodes(pbvh, pbvh->totnode + 2);
-
-  /* Update parent node bounding box */
-  update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
+  /* Update parent node bounding box, and find the centroid bounds if not known yet. */
+  const bool calc_cb = !below_leaf_limit && !cb;
+  update_bounds(pbvh->prim_indices,
+                ctx->prim_bbc,
+                offset,
+                count,
+                &node->vb,
+                calc_cb ? &cb_backing : NULL);
 
   if (!below_leaf_limit) {
     /* Find axis with widest range of primitive centroids */
-    if (!cb) {
+    if (calc_cb) {
       cb = &cb_backing;
-      BB_reset(cb);
-      for (int i = offset + count - 1; i >= offset; i--) {
-        BB_expand(cb, prim_bbc[pbvh->prim_indices[i]].bcentroid);
-      }
     }
     const int axis = BB_widest_axis(cb);
 
@@ -509,7 +612,7 @@ static void build_sub(PBVH *pbvh, int node_index, BB *cb, BBC *prim_bbc, int off
                             offset + count - 1,
                             axis,
                             (cb->bmax[axis] + cb->bmin[axis]) * 0.5f,
-                            prim_bbc);
+                            ctx->prim_bbc);
   }
   else {
     /* Partition primitives by material */
@@ -517,13 +620,118 @@ static void build_sub(PBVH *pbvh, int node_index, BB *cb, BBC *prim_bbc, int off
   }
 
   /* Build children */
-  build_sub(pbvh, pbvh->nodes[node_index].children_offset, NULL, prim_bbc, offset, end - offset);
-  build_sub(pbvh,
-            pbvh->nodes[node_index].children_offset + 1,
-            NULL,
-            prim_bbc,
-            end,
-            offset + count - end);
+  const int child_offsets[2] = {offset, end};
+  const int child_counts[2] = {end - offset, offset + count - end};
+  for (int i = 0; i < 2; i++) {
+    PBVHBuildNode *child = MEM_callocN(sizeof(PBVHBuildNode), "PBVHBuildNode");
+    child->offset = child_offsets[i];
+    child->count = child_counts[i];
+    node->children[i] = child;
+
+    if (child->count > pbvh->leaf_limit) {
+      BLI_task_pool_push(pool, build_sub_task_cb, child, false, NULL);
+    }
+    else {
+      build_sub(ctx, pool, child, NULL);
+    }
+  }
+}
+
+static void build_sub_task_cb(TaskPool *__restrict pool, void *taskdata)
+{
+  PBVHBuildContext *ctx = BLI_task_pool_user_data(pool);
+  build_sub(ctx, pool, taskdata, NULL);
+}
+
+/**
+ * Create the #PBVHNode for the build tree, in the same depth-first order as the nodes would be
+ * created by a single threaded build, and free the build tree.
+ */
+static void build_nodes_from_tree(PBVH *pbvh,
+                                  int node_index,
+                                  PBVHBuildNode *build_node,
+                                  int *r_leaves,
+                                  int *r_totleaf)
+{
+  PBVHNode *node = &pbvh->nodes[node_index];
+  node->vb = build_node->vb;
+  node->orig_vb = build_node->vb;
+
+  if (build_node->children[0] == NULL) {
+    node->flag |= PBVH_Leaf;
+    node->prim_indices = pbvh->prim_indices + build_node->offset;
+    node->totprim = build_node->count;
+    r_leaves[(*r_totleaf)++] = node_index;
+  }
+  else {
+    /* Add two child nodes, note that this may re-allocate the nodes. */
+    const int children_offset = pbvh->totnode;
+    node->children_offset = children_offset;
+    pbvh_grow_nodes(pbvh, pbvh->totnode + 2);
+
+    build_nodes_from_tree(pbvh, children_offset, build_node->children[0], r_leaves, r_totleaf);
+    build_nodes_from_tree(
+        pbvh, children_offset + 1, build_node->children[1], r_leaves, r_totleaf);
+  }
+
+  MEM_freeN(build_node);
+}
+
+typedef struct PBVHBuildLeavesData {
+  PBVH *pbvh;
+  const int *leaves;
+  PBVHLeafVertMap *leaf_maps;
+} PBVHBuildLeavesData;
+
+static void build_mesh_leaf_map_task_cb(void *__restrict userdata,
+                                        const int n,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHBuildLeavesData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  build_mesh_leaf_map(pbvh, &pbvh->nodes[data->leaves[n]], &data->leaf_maps[n]);
+}
+
+static void build_mesh_leaf_indices_task_cb(void *__restrict userdata,
+                                            const int n,
+                                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHBuildLeavesData *data = userdata;
+  build_mesh_leaf_indices(&data->pbvh->nodes[data->leaves[n]], &data->leaf_maps[n]);
+}
+
+static void build_grid_leaf_task_cb(void *__restrict userdata,
+                                    const int n,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  PBVHBuildLeavesData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  build_grid_leaf_node(pbvh, &pbvh->nodes[data->leaves[n]]);
+}
+
+/* Leaves are given in depth-first order. */
+static void build_leaves(PBVH *pbvh, const int *leaves, int totleaf)
+{
+  PBVHBuildLeavesData data = {
+      .pbvh = pbvh,
+      .leaves = leaves,
+  };
+
+  TaskParallelSettings settings;
+  BKE_pbvh_parallel_range_settings(&settings, true, totleaf);
+
+  if (pbvh->looptri) {
+    data.leaf_maps = MEM_mallocN(sizeof(PBVHLeafVertMap) * totleaf, "PBVHLeafVertMap");
+    BLI_task_parallel_range(0, totleaf, &data, build_mesh_leaf_map_task_cb, &settings);
+    for (int i = 0; i < totleaf; i++) {
+      build_mesh_leaf_owners(pbvh, &pbvh->nodes[leaves[i]], &data.leaf_maps[i]);
+    }
+    BLI_task_parallel_range(0, totleaf, &data, build_mesh_leaf_indices_task_cb, &settings);
+    MEM_freeN(data.leaf_maps);
+  }
+  else {
+    BLI_task_parallel_range(0, totleaf, &data, build_grid_leaf_task_cb, &settings);
+  }
 }
 
 static void pbvh_build(PBVH *pbvh, BB *cb, BBC *prim_bbc, int totprim)
@@ -547,8 +755,92 @@ static void pbvh_build(PBVH *pbvh, BB *cb, BBC *prim_bbc, int totprim)
     }
   }
 
+  PBVHBuildContext ctx = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+      .totleaf = 0,
+  };
+  PBVHBuildNode *root = MEM_callocN(sizeof(PBVHBuildNode), "PBVHBuildNode");
+  root->offset = 0;
+  root->count = totprim;
+
+  TaskPool *pool = BLI_task_pool_create(&ctx, TASK_PRIORITY_HIGH);
+  build_sub(&ctx, pool, root, cb);
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+
+  int *leaves = MEM_mallocN(sizeof(int) * ctx.totleaf, "pbvh build leaves");
+  int totleaf = 0;
   pbvh->totnode = 1;
-  build_sub(pbvh, 0, cb, prim_bbc, 0, totprim);
+  build_nodes_from_tree(pbvh, 0, root, leaves, &totleaf);
+  BLI_assert(totleaf == ctx.totleaf);
+
+  build_leaves(pbvh, leaves, totleaf);
+  MEM_freeN(leaves);
+}
+
+typedef struct PBVHPrimBoundsData {
+  const PBVH *pbvh;
+  BBC *prim_bbc;
+} PBVHPrimBoundsData;
+
+static void pbvh_prim_bounds_task_cb(void *__restrict userdata,
+                                     const int n,
+                                     const TaskParallelTLS *__restrict tls)
+{
+  const PBVHPrimBoundsData *data = userdata;
+  const PBVH *pbvh = data->pbvh;
+  BB *cb = tls->userdata_chunk;
+  BBC *bbc = &data->prim_bbc[n];
+
+  BB_reset((BB *)bbc);
+
+  if (pbvh->type == PBVH_FACES) {
+    const MLoopTri *lt = &pbvh->looptri[n];
+    const int sides = 3;
+
+    for (int j = 0; j < sides; j++) {
+      BB_expand((BB *)bbc, pbvh->verts[pbvh->mloop[lt->tri[j]].v].co);
+    }
+  }
+  else {
+    const CCGKey *key = &pbvh->gridkey;
+    CCGElem *grid = pbvh->grids[n];
+
+    for (int j = 0; j < key->grid_area; j++) {
+      BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
+    }
+  }
+
+  BBC_update_centroid(bbc);
+
+  BB_expand(cb, bbc->bcentroid);
+}
+
+static void pbvh_prim_bounds_reduce(const void *__restrict UNUSED(userdata),
+                                    void *__restrict chunk_join,
+                                    void *__restrict chunk)
+{
+  BB_expand_with_bb(chunk_join, chunk);
+}
+
+/* For each primitive, store the AABB and the AABB centroid, and the bounds of all centroids. */
+static void pbvh_calc_prim_bounds(const PBVH *pbvh, BBC *prim_bbc, int totprim, BB *r_cb)
+{
+  PBVHPrimBoundsData data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+  };
+  BB_reset(r_cb);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = totprim > 1;
+  settings.min_iter_per_thread = pbvh->type == PBVH_FACES ? 1024 : 1;
+  settings.userdata_chunk = r_cb;
+  settings.userdata_chunk_size = sizeof(*r_cb);
+  settings.func_reduce = pbvh_prim_bounds_reduce;
+  BLI_task_parallel_range(0, totprim, &data, pbvh_prim_bounds_task_cb, &settings);
 }
 
 void BKE_pbvh_build_mesh(PBVH *pbvh,
@@ -584,26 +876,9 @@ void BKE_pbvh_build_mesh(PBVH *pbvh,
   pbvh->face_sets_color_seed = mesh->face_sets_color_seed;
   pbvh->face_sets_color_default = mesh->face_sets_color_default;
 
-  BB_reset(&cb);
-
   /* For each face, store the AABB and the AABB centroid */
   prim_bbc = MEM_mallocN(sizeof(BBC) * looptri_num, "prim_bbc");
-
-  for (int i = 0; i < looptri_num; i++) {
-    const MLoopTri *lt = &looptri[i];
-    const int sides = 3;
-    BBC *bbc = prim_bbc + i;
-
-    BB_reset((BB *)bbc);
-
-    for (int j = 0; j < sides; j++) {
-      BB_expand((BB *)bbc, verts[pbvh->mloop[lt->tri[j]].v].co);
-    }
-
-    BBC_update_centroid(bbc);
-
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  pbvh_calc_prim_bounds(pbvh, prim_bbc, looptri_num, &cb);
 
   if (looptri_num) {
     pbvh_build(pbvh, &cb, prim_bbc, looptri_num);
@@ -633,25 +908,10 @@ void BKE_pbvh_build_grids(PBVH *pbvh,
   pbvh->leaf_limit = max_ii(LEAF_LIMIT / (gridsize * gridsize), 1);
 
   BB cb;
-  BB_reset(&cb);
 
   /* For each grid, store the AABB and the AABB centroid */
   BBC *prim_bbc = MEM_mallocN(sizeof(BBC) * totgrid, "prim_bbc");
-
-  for (int i = 0; i < totgrid; i++) {
-    CCGElem *grid = grids[i];
-    BBC *bbc = prim_bbc + i;
-
-    BB_reset((BB *)bbc);
-
-    for (int j = 0; j < gridsize * gridsize; j++) {
-      BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
-    }
-
-    BBC_update_centroid(bbc);
-
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  pbvh_calc_prim_bounds(pbvh, prim_bbc, totgrid, &cb);
 
   if (totgrid) {
     pbvh_build(pbvh, &cb, prim_bbc, totgrid);
@@ -0,0 +1,225 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
+#include "BLI_bitmap.h"
+#include "BLI_math.h"
+#include "BLI_vector.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_ccg.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+#include "BKE_pbvh.h"
+
+#include "bmesh.h"
+
+#include "pbvh_intern.h"
+
+#include "tests/BKE_mesh_test_utils.hh"
+
+namespace blender::bke::tests {
+
+class PBVHTest : public MeshTest {
+};
+
+/* Large enough for several leaves, and for the threaded build of the upper levels. */
+static const int grid_res = 200;
+
+/**
+ * Create a wavy grid of `res * res` quads. The material index changes every `mat_stride`
+ * columns, so that leaves have to be split by material as well.
+ */
+static Mesh *test_grid_mesh_create(const int res, const int mat_stride)
+{
+  Mesh *mesh = mesh_grid_create(res);
+  for (int y = 0; y <= res; y++) {
+    for (int x = 0; x <= res; x++) {
+      mesh->mvert[y * (res + 1) + x].co[2] = float((x * 7 + y * 13) % 5) * 0.1f;
+    }
+  }
+  for (int y = 0; y < res; y++) {
+    for (int x = 0; x < res; x++) {
+      mesh->mpoly[y * res + x].mat_nr = short(x / mat_stride);
+    }
+  }
+  return mesh;
+}
+
+struct TestPBVHMesh {
+  Mesh *mesh;
+  MLoopTri *looptri;
+  int looptri_num;
+  PBVH *pbvh;
+
+  TestPBVHMesh(const int res, const int mat_stride)
+  {
+    mesh = test_grid_mesh_create(res, mat_stride);
+    looptri_num = poly_to_tri_count(mesh->totpoly, mesh->totloop);
+    looptri = static_cast<MLoopTri *>(
+        MEM_malloc_arrayN(looptri_num, sizeof(*looptri), __func__));
+    BKE_mesh_recalc_looptri(
+        mesh->mloop, mesh->mpoly, mesh->mvert, mesh->totloop, mesh->totpoly, looptri);
+    pbvh = build();
+  }
+
+  ~TestPBVHMesh()
+  {
+    BKE_pbvh_free(pbvh);
+    MEM_freeN(looptri);
+    BKE_id_free(nullptr, mesh);
+  }
+
+  PBVH *build()
+  {
+    PBVH *pbvh = BKE_pbvh_new();
+    /* The PBVH takes ownership of the triangles. */
+    BKE_pbvh_build_mesh(pbvh,
+                        mesh,
+                        mesh->mpoly,
+                        mesh->mloop,
+                        mesh->mvert,
+                        mesh->totvert,
+                        &mesh->vdata,
+                        &mesh->ldata,
+                        &mesh->pdata,
+                        static_cast<MLoopTri *>(MEM_dupallocN(looptri)),
+                        looptri_num);
+    return pbvh;
+  }
+};
+
+static Vector<PBVHNode *> test_pbvh_leaves(PBVH *pbvh)
+{
+  Vector<PBVHNode *> leaves;
+  for (int i = 0; i < pbvh->totnode; i++) {
+    if (pbvh->nodes[i].flag & PBVH_Leaf) {
+      leaves.append(&pbvh->nodes[i]);
+    }
+  }
+  return leaves;
+}
+
+static void test_bb_expect_contains(const BB &bb, const float co[3])
+{
+  for (int axis = 0; axis < 3; axis++) {
+    EXPECT_LE(bb.bmin[axis], co[axis]);
+    EXPECT_GE(bb.bmax[axis], co[axis]);
+  }
+}
+
+TEST_F(PBVHTest, build_mesh_leaves)
+{
+  TestPBVHMesh test(grid_res, 64);
+  PBVH *pbvh = test.pbvh;
+  const Mesh *mesh = test.mesh;
+
+  const Vector<PBVHNode *> leaves = test_pbvh_leaves(pbvh);
+  EXPECT_GT(leaves.size(), 4);
+
+  Array<int> prim_users(test.looptri_num, 0);
+  Array<int> unique_vert_users(mesh->totvert, 0);
+  for (PBVHNode *node : leaves) {
+    EXPECT_GT(node->totprim, 0u);
+    EXPECT_LE(int(node->totprim), pbvh->leaf_limit);
+
+    const MPoly *mp_first = &mesh->mpoly[test.looptri[node->prim_indices[0]].poly];
+    for (int i = 0; i < int(node->totprim); i++) {
+      const int prim = node->prim_indices[i];
+      prim_users[prim]++;
+
+      const MLoopTri *lt = &test.looptri[prim];
+      EXPECT_EQ(mesh->mpoly[lt->poly].mat_nr, mp_first->mat_nr);
+      for (int j = 0; j < 3; j++) {
+        const int v = mesh->mloop[lt->tri[j]].v;
+        EXPECT_EQ(node->vert_indices[node->face_vert_indices[i][j]], v);
+        test_bb_expect_contains(node->vb, mesh->mvert[v].co);
+      }
+    }
+
+    int uniq_verts, totvert;
+    BKE_pbvh_node_num_verts(pbvh, node, &uniq_verts, &totvert);
+    for (int i = 0; i < uniq_verts; i++) {
+      unique_vert_users[node->vert_indices[i]]++;
+    }
+  }
+
+  /* Every triangle is in exactly one leaf, and every vertex is unique to exactly one leaf. */
+  for (const int users : prim_users) {
+    EXPECT_EQ(users, 1);
+  }
+  for (const int users : unique_vert_users) {
+    EXPECT_EQ(users, 1);
+  }
+}
+
+TEST_F(PBVHTest, build_mesh_bounds)
+{
+  TestPBVHMesh test(grid_res, 64);
+  PBVH *pbvh = test.pbvh;
+
+  for (int i = 0; i < pbvh->totnode; i++) {
+    const PBVHNode *node = &pbvh->nodes[i];
+    if (node->flag & PBVH_Leaf) {
+      continue;
+    }
+    /* Children are stored after their parent and their bounds are contained in it. */
+    for (int c = 0; c < 2; c++) {
+      const int child_index = node->children_offset + c;
+      ASSERT_GT(child_index, i);
+      ASSERT_LT(child_index, pbvh->totnode);
+      const PBVHNode *child = &pbvh->nodes[child_index];
+      test_bb_expect_contains(node->vb, child->vb.bmin);
+      test_bb_expect_contains(node->vb, child->vb.bmax);
+    }
+  }
+}
+
+TEST_F(PBVHTest, build_mesh_repeatable)
+{
+  TestPBVHMesh test(grid_res, 64);
+  PBVH *pbvh_a = test.pbvh;
+  PBVH *pbvh_b = test.build();
+
+  ASSERT_EQ(pbvh_a->totnode, pbvh_b->totnode);
+  for (int i = 0; i < pbvh_a->totnode; i++) {
+    const PBVHNode *node_a = &pbvh_a->nodes[i];
+    const PBVHNode *node_b = &pbvh_b->nodes[i];
+    ASSERT_EQ(node_a->flag & PBVH_Leaf, node_b->flag & PBVH_Leaf);
+    if (!(node_a->flag & PBVH_Leaf)) {
+      EXPECT_EQ(node_a->children_offset, node_b->children_offset);
+      continue;
+    }
+    ASSERT_EQ(node_a->totprim, node_b->totprim);
+    for (int j = 0; j < int(node_a->totprim); j++) {
+      EXPECT_EQ(node_a->prim_indices[j], node_b->prim_indices[j]);
+    }
+    ASSERT_EQ(node_a->uniq_verts, node_b->uniq_verts);
+    ASSERT_EQ(node_a->face_verts, node_b->face_verts);
+    for (int j = 0; j < int(node_a->uniq_verts + node_a->face_verts); j++) {
+      EXPECT_EQ(node_a->vert_indices[j], node_b->vert_indices[j]);
+    }
+  }
+
+  BKE_pbvh_free(pbvh_b);
+}
+
+}  // namespace blender::bke::tests
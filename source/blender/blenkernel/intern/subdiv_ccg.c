@@ -40,6 +40,7 @@
 #include "BKE_subdiv.h"
 #include "BKE_subdiv_eval.h"
 
+#include "opensubdiv_capi_type.h"
 #include "opensubdiv_topology_refiner_capi.h"
 
 /* -------------------------------------------------------------------- */
@@ -236,16 +237,74 @@ static void subdiv_ccg_eval_grid_element(CCGEvalGridsData *data,
   subdiv_ccg_eval_grid_element_mask(data, ptex_face_index, u, v, element);
 }
 
+/* Evaluate limit surface of all grid elements at once, which is much faster than evaluating
+ * them one by one. Only used when there is no displacement. */
+static void subdiv_ccg_eval_grid_elements_limit(CCGEvalGridsData *data,
+                                                const OpenSubdiv_PatchCoord *patch_coords,
+                                                const int num_elements,
+                                                unsigned char *grid)
+{
+  SubdivCCG *subdiv_ccg = data->subdiv_ccg;
+  const int element_size = element_size_bytes_get(subdiv_ccg);
+  const bool has_normal = subdiv_ccg->has_normal;
+  float(*P)[3] = MEM_malloc_arrayN(
+      (size_t)num_elements * (has_normal ? 3 : 1), sizeof(*P), "subdiv ccg grid limit");
+  float(*dPdu)[3] = has_normal ? P + num_elements : NULL;
+  float(*dPdv)[3] = has_normal ? P + 2 * num_elements : NULL;
+  BKE_subdiv_eval_limit_patch_coords(data->subdiv, patch_coords, num_elements, P, dPdu, dPdv);
+  for (int i = 0; i < num_elements; i++) {
+    unsigned char *element = &grid[(size_t)i * element_size];
+    copy_v3_v3((float *)element, P[i]);
+    if (has_normal) {
+      float *N = (float *)(element + subdiv_ccg->normal_offset);
+      cross_v3_v3v3(N, dPdu[i], dPdv[i]);
+      normalize_v3(N);
+    }
+  }
+  MEM_freeN(P);
+}
+
+static void subdiv_ccg_eval_grid_elements(CCGEvalGridsData *data,
+                                          const OpenSubdiv_PatchCoord *patch_coords,
+                                          const int num_elements,
+                                          unsigned char *grid)
+{
+  const int element_size = element_size_bytes_get(data->subdiv_ccg);
+  if (data->subdiv->displacement_evaluator != NULL) {
+    /* Displacement is evaluated point by point. */
+    for (int i = 0; i < num_elements; i++) {
+      const OpenSubdiv_PatchCoord *patch_coord = &patch_coords[i];
+      subdiv_ccg_eval_grid_element(data,
+                                   patch_coord->ptex_face,
+                                   patch_coord->u,
+                                   patch_coord->v,
+                                   &grid[(size_t)i * element_size]);
+    }
+    return;
+  }
+  subdiv_ccg_eval_grid_elements_limit(data, patch_coords, num_elements, grid);
+  for (int i = 0; i < num_elements; i++) {
+    const OpenSubdiv_PatchCoord *patch_coord = &patch_coords[i];
+    subdiv_ccg_eval_grid_element_mask(data,
+                                      patch_coord->ptex_face,
+                                      patch_coord->u,
+                                      patch_coord->v,
+                                      &grid[(size_t)i * element_size]);
+  }
+}
+
 static void subdiv_ccg_eval_regular_grid(CCGEvalGridsData *data, const int face_index)
 {
   SubdivCCG *subdiv_ccg = data->subdiv_ccg;
   const int ptex_face_index = data->face_ptex_offset[face_index];
   const int grid_size = subdiv_ccg->grid_size;
+  const int grid_area = grid_size * grid_size;
   const float grid_size_1_inv = 1.0f / (grid_size - 1);
-  const int element_size = element_size_bytes_get(subdiv_ccg);
   SubdivCCGFace *faces = subdiv_ccg->faces;
   SubdivCCGFace **grid_faces = subdiv_ccg->grid_faces;
   const SubdivCCGFace *face = &faces[face_index];
+  OpenSubdiv_PatchCoord *patch_coords = MEM_malloc_arrayN(
+      grid_area, sizeof(*patch_coords), "subdiv ccg grid patch coords");
   for (int corner = 0; corner < face->num_grids; corner++) {
     const int grid_index = face->start_grid_index + corner;
     unsigned char *grid = (unsigned char *)subdiv_ccg->grids[grid_index];
@@ -253,30 +312,33 @@ static void subdiv_ccg_eval_regular_grid(CCGEvalGridsData *data, const int face_
       const float grid_v = y * grid_size_1_inv;
       for (int x = 0; x < grid_size; x++) {
         const float grid_u = x * grid_size_1_inv;
-        float u, v;
-        BKE_subdiv_rotate_grid_to_quad(corner, grid_u, grid_v, &u, &v);
-        const size_t grid_element_index = (size_t)y * grid_size + x;
-        const size_t grid_element_offset = grid_element_index * element_size;
-        subdiv_ccg_eval_grid_element(data, ptex_face_index, u, v, &grid[grid_element_offset]);
+        OpenSubdiv_PatchCoord *patch_coord = &patch_coords[y * grid_size + x];
+        patch_coord->ptex_face = ptex_face_index;
+        BKE_subdiv_rotate_grid_to_quad(
+            corner, grid_u, grid_v, &patch_coord->u, &patch_coord->v);
       }
     }
+    subdiv_ccg_eval_grid_elements(data, patch_coords, grid_area, grid);
     /* Assign grid's face. */
     grid_faces[grid_index] = &faces[face_index];
     /* Assign material flags. */
     subdiv_ccg->grid_flag_mats[grid_index] = data->material_flags_evaluator->eval_material_flags(
         data->material_flags_evaluator, face_index);
   }
+  MEM_freeN(patch_coords);
 }
 
 static void subdiv_ccg_eval_special_grid(CCGEvalGridsData *data, const int face_index)
 {
   SubdivCCG *subdiv_ccg = data->subdiv_ccg;
   const int grid_size = subdiv_ccg->grid_size;
+  const int grid_area = grid_size * grid_size;
   const float grid_size_1_inv = 1.0f / (grid_size - 1);
-  const int element_size = element_size_bytes_get(subdiv_ccg);
   SubdivCCGFace *faces = subdiv_ccg->faces;
   SubdivCCGFace **grid_faces = subdiv_ccg->grid_faces;
   const SubdivCCGFace *face = &faces[face_index];
+  OpenSubdiv_PatchCoord *patch_coords = MEM_malloc_arrayN(
+      grid_area, sizeof(*patch_coords), "subdiv ccg grid patch coords");
   for (int corner = 0; corner < face->num_grids; corner++) {
     const int grid_index = face->start_grid_index + corner;
     const int ptex_face_index = data->face_ptex_offset[face_index] + corner;
@@ -285,17 +347,20 @@ static void subdiv_ccg_eval_special_grid(CCGEvalGridsData *data, const int face_
       const float u = 1.0f - (y * grid_size_1_inv);
       for (int x = 0; x < grid_size; x++) {
         const float v = 1.0f - (x * grid_size_1_inv);
-        const size_t grid_element_index = (size_t)y * grid_size + x;
-        const size_t grid_element_offset = grid_element_index * element_size;
-        subdiv_ccg_eval_grid_element(data, ptex_face_index, u, v, &grid[grid_element_offset]);
+        OpenSubdiv_PatchCoord *patch_coord = &patch_coords[y * grid_size + x];
+        patch_coord->ptex_face = ptex_face_index;
+        patch_coord->u = u;
+        patch_coord->v = v;
       }
     }
+    subdiv_ccg_eval_grid_elements(data, patch_coords, grid_area, grid);
     /* Assign grid's face. */
     grid_faces[grid_index] = &faces[face_index];
     /* Assign material flags. */
     subdiv_ccg->grid_flag_mats[grid_index] = data->material_flags_evaluator->eval_material_flags(
         data->material_flags_evaluator, face_index);
   }
+  MEM_freeN(patch_coords);
 }
 
 static void subdiv_ccg_eval_grids_task(void *__restrict userdata_v,
@@ -27,6 +27,7 @@
 #include "DNA_meshdata_types.h"
 
 #include "BLI_bitmap.h"
+#include "BLI_math_base.h"
 #include "BLI_math_vector.h"
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
@@ -36,6 +37,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_capi_type.h"
 #include "opensubdiv_evaluator_capi.h"
 #include "opensubdiv_topology_refiner_capi.h"
 
@@ -244,6 +246,35 @@ void BKE_subdiv_eval_init_displacement(Subdiv *subdiv)
 
 /* ========================== Single point queries ========================== */
 
+/* NOTE: In a very rare occasions derivatives are evaluated to zeros or are exactly equal.
+ * This happens, for example, in single vertex on Suzannne's nose (where two quads have 2 common
+ * edges).
+ *
+ * This makes tangent space displacement (such as multi-resolution) impossible to be used in
+ * those vertices, so those needs to be addressed in one way or another.
+ *
+ * Simplest thing to do: step inside of the face a little bit, where there is known patch at
+ * which there must be proper derivatives. This might break continuity of normals, but is better
+ * that giving totally unusable derivatives. */
+static void subdiv_eval_ensure_valid_derivatives(Subdiv *subdiv,
+                                                 const int ptex_face_index,
+                                                 const float u,
+                                                 const float v,
+                                                 float r_P[3],
+                                                 float r_dPdu[3],
+                                                 float r_dPdv[3])
+{
+  if ((is_zero_v3(r_dPdu) || is_zero_v3(r_dPdv)) || equals_v3v3(r_dPdu, r_dPdv)) {
+    subdiv->evaluator->evaluateLimit(subdiv->evaluator,
+                                     ptex_face_index,
+                                     u * 0.999f + 0.0005f,
+                                     v * 0.999f + 0.0005f,
+                                     r_P,
+                                     r_dPdu,
+                                     r_dPdv);
+  }
+}
+
 void BKE_subdiv_eval_limit_point(
     Subdiv *subdiv, const int ptex_face_index, const float u, const float v, float r_P[3])
 {
@@ -260,27 +291,8 @@ void BKE_subdiv_eval_limit_point_and_derivatives(Subdiv *subdiv,
 {
   subdiv->evaluator->evaluateLimit(subdiv->evaluator, ptex_face_index, u, v, r_P, r_dPdu, r_dPdv);
 
-  /* NOTE: In a very rare occasions derivatives are evaluated to zeros or are exactly equal.
-   * This happens, for example, in single vertex on Suzannne's nose (where two quads have 2 common
-   * edges).
-   *
-   * This makes tangent space displacement (such as multi-resolution) impossible to be used in
-   * those vertices, so those needs to be addressed in one way or another.
-   *
-   * Simplest thing to do: step inside of the face a little bit, where there is known patch at
-   * which there must be proper derivatives. This might break continuity of normals, but is better
-   * that giving totally unusable derivatives. */
-
   if (r_dPdu != NULL && r_dPdv != NULL) {
-    if ((is_zero_v3(r_dPdu) || is_zero_v3(r_dPdv)) || equals_v3v3(r_dPdu, r_dPdv)) {
-      subdiv->evaluator->evaluateLimit(subdiv->evaluator,
-                                       ptex_face_index,
-                                       u * 0.999f + 0.0005f,
-                                       v * 0.999f + 0.0005f,
-                                       r_P,
-                                       r_dPdu,
-                                       r_dPdv);
-    }
+    subdiv_eval_ensure_valid_derivatives(subdiv, ptex_face_index, u, v, r_P, r_dPdu, r_dPdv);
   }
 }
 
@@ -337,3 +349,117 @@ void BKE_subdiv_eval_final_point(
     BKE_subdiv_eval_limit_point(subdiv, ptex_face_index, u, v, r_P);
   }
 }
+
+/* ============================= Batched queries ============================ */
+
+/* Number of patch coordinates evaluated by a single call to the evaluator. Keeps temporary
+ * buffers of the evaluator small, and allows to evaluate chunks from multiple threads. */
+#define SUBDIV_EVAL_BATCH_SIZE 1024
+
+typedef struct SubdivEvalPatchCoordsData {
+  Subdiv *subdiv;
+  const OpenSubdiv_PatchCoord *patch_coords;
+  int num_patch_coords;
+  int face_varying_channel;
+  float (*r_P)[3];
+  float (*r_dPdu)[3];
+  float (*r_dPdv)[3];
+  float (*r_face_varying)[2];
+} SubdivEvalPatchCoordsData;
+
+static void subdiv_eval_limit_patch_coords_task(void *__restrict userdata,
+                                                const int batch_index,
+                                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SubdivEvalPatchCoordsData *data = userdata;
+  Subdiv *subdiv = data->subdiv;
+  const int start = batch_index * SUBDIV_EVAL_BATCH_SIZE;
+  const int num_patch_coords = min_ii(SUBDIV_EVAL_BATCH_SIZE, data->num_patch_coords - start);
+  const OpenSubdiv_PatchCoord *patch_coords = &data->patch_coords[start];
+  float(*r_P)[3] = &data->r_P[start];
+  if (data->r_dPdu == NULL) {
+    subdiv->evaluator->evaluatePatchesLimit(
+        subdiv->evaluator, patch_coords, num_patch_coords, &r_P[0][0], NULL, NULL);
+    return;
+  }
+  float(*r_dPdu)[3] = &data->r_dPdu[start];
+  float(*r_dPdv)[3] = &data->r_dPdv[start];
+  subdiv->evaluator->evaluatePatchesLimit(subdiv->evaluator,
+                                          patch_coords,
+                                          num_patch_coords,
+                                          &r_P[0][0],
+                                          &r_dPdu[0][0],
+                                          &r_dPdv[0][0]);
+  for (int i = 0; i < num_patch_coords; i++) {
+    subdiv_eval_ensure_valid_derivatives(subdiv,
+                                         patch_coords[i].ptex_face,
+                                         patch_coords[i].u,
+                                         patch_coords[i].v,
+                                         r_P[i],
+                                         r_dPdu[i],
+                                         r_dPdv[i]);
+  }
+}
+
+static void subdiv_eval_face_varying_patch_coords_task(
+    void *__restrict userdata,
+    const int batch_index,
+    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SubdivEvalPatchCoordsData *data = userdata;
+  Subdiv *subdiv = data->subdiv;
+  const int start = batch_index * SUBDIV_EVAL_BATCH_SIZE;
+  const int num_patch_coords = min_ii(SUBDIV_EVAL_BATCH_SIZE, data->num_patch_coords - start);
+  subdiv->evaluator->evaluatePatchesFaceVarying(subdiv->evaluator,
+                                                data->face_varying_channel,
+                                                &data->patch_coords[start],
+                                                num_patch_coords,
+                                                &data->r_face_varying[start][0]);
+}
+
+static void subdiv_eval_patch_coords_batches(SubdivEvalPatchCoordsData *data,
+                                             TaskParallelRangeFunc func)
+{
+  const int num_batches = (data->num_patch_coords + SUBDIV_EVAL_BATCH_SIZE - 1) /
+                          SUBDIV_EVAL_BATCH_SIZE;
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (num_batches > 1);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, num_batches, data, func, &settings);
+}
+
+void BKE_subdiv_eval_limit_patch_coords(Subdiv *subdiv,
+                                        const OpenSubdiv_PatchCoord *patch_coords,
+                                        const int num_patch_coords,
+                                        float (*r_P)[3],
+                                        float (*r_dPdu)[3],
+                                        float (*r_dPdv)[3])
+{
+  BLI_assert((r_dPdu == NULL) == (r_dPdv == NULL));
+  SubdivEvalPatchCoordsData data = {
+      .subdiv = subdiv,
+      .patch_coords = patch_coords,
+      .num_patch_coords = num_patch_coords,
+      .r_P = r_P,
+      .r_dPdu = r_dPdu,
+      .r_dPdv = r_dPdv,
+  };
+  subdiv_eval_patch_coords_batches(&data, subdiv_eval_limit_patch_coords_task);
+}
+
+void BKE_subdiv_eval_face_varying_patch_coords(Subdiv *subdiv,
+                                               const int face_varying_channel,
+                                               const OpenSubdiv_PatchCoord *patch_coords,
+                                               const int num_patch_coords,
+                                               float (*r_face_varying)[2])
+{
+  SubdivEvalPatchCoordsData data = {
+      .subdiv = subdiv,
+      .patch_coords = patch_coords,
+      .num_patch_coords = num_patch_coords,
+      .face_varying_channel = face_varying_channel,
+      .r_face_varying = r_face_varying,
+  };
+  subdiv_eval_patch_coords_batches(&data, subdiv_eval_face_varying_patch_coords_task);
+}
@@ -42,6 +42,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_capi_type.h"
+
 /* -------------------------------------------------------------------- */
 /** \name Subdivision Context
  * \{ */
@@ -62,6 +64,11 @@ typedef struct SubdivMeshContext {
   /* Per-subdivided vertex counter of averaged values. */
   int *accumulated_counters;
   bool have_displacement;
+  /* Limit surface coordinates of subdivided vertices and loops. Positions and UVs are evaluated
+   * for all of them at once after the traversal, which is much faster than evaluating them one
+   * by one. Vertices which are not evaluated this way have a negative ptex face index. */
+  OpenSubdiv_PatchCoord *vertex_patch_coords;
+  OpenSubdiv_PatchCoord *loop_patch_coords;
 } SubdivMeshContext;
 
 static void subdiv_mesh_ctx_cache_uv_layers(SubdivMeshContext *ctx)
@@ -92,9 +99,36 @@ static void subdiv_mesh_prepare_accumulator(SubdivMeshContext *ctx, int num_vert
       num_vertices, sizeof(*ctx->accumulated_counters), "subdiv accumulated counters");
 }
 
+static void subdiv_mesh_prepare_patch_coords(SubdivMeshContext *ctx,
+                                             int num_vertices,
+                                             int num_loops)
+{
+  ctx->vertex_patch_coords = MEM_malloc_arrayN(
+      num_vertices, sizeof(*ctx->vertex_patch_coords), "subdiv vertex patch coords");
+  for (int i = 0; i < num_vertices; i++) {
+    ctx->vertex_patch_coords[i].ptex_face = -1;
+  }
+  if (ctx->num_uv_layers != 0) {
+    ctx->loop_patch_coords = MEM_malloc_arrayN(
+        num_loops, sizeof(*ctx->loop_patch_coords), "subdiv loop patch coords");
+  }
+}
+
 static void subdiv_mesh_context_free(SubdivMeshContext *ctx)
 {
   MEM_SAFE_FREE(ctx->accumulated_counters);
+  MEM_SAFE_FREE(ctx->vertex_patch_coords);
+  MEM_SAFE_FREE(ctx->loop_patch_coords);
+}
+
+static void subdiv_mesh_patch_coord_set(OpenSubdiv_PatchCoord *patch_coord,
+                                        const int ptex_face_index,
+                                        const float u,
+                                        const float v)
+{
+  patch_coord->ptex_face = ptex_face_index;
+  patch_coord->u = u;
+  patch_coord->v = v;
 }
 
 /** \} */
@@ -480,6 +514,7 @@ static bool subdiv_mesh_topology_info(const SubdivForeachContext *foreach_contex
       subdiv_context->coarse_mesh, num_vertices, num_edges, 0, num_loops, num_polygons, mask);
   subdiv_mesh_ctx_cache_custom_data_layers(subdiv_context);
   subdiv_mesh_prepare_accumulator(subdiv_context, num_vertices);
+  subdiv_mesh_prepare_patch_coords(subdiv_context, num_vertices, num_loops);
   return true;
 }
 
@@ -537,11 +572,11 @@ static void evaluate_vertex_and_apply_displacement_copy(const SubdivMeshContext
     copy_v3_v3(D, subdiv_vert->co);
     mul_v3_fl(D, inv_num_accumulated);
   }
-  /* Copy custom data and evaluate position. */
+  /* Copy custom data and store displacement, limit position is added to it later. */
   subdiv_vertex_data_copy(ctx, coarse_vert, subdiv_vert);
-  BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_vert->co);
-  /* Apply displacement. */
-  add_v3_v3(subdiv_vert->co, D);
+  copy_v3_v3(subdiv_vert->co, D);
+  subdiv_mesh_patch_coord_set(
+      &ctx->vertex_patch_coords[subdiv_vertex_index], ptex_face_index, u, v);
   /* Remove facedot flag. This can happen if there is more than one subsurf modifier. */
   subdiv_vert->flag &= ~ME_VERT_FACEDOT;
 }
@@ -563,11 +598,11 @@ static void evaluate_vertex_and_apply_displacement_interpolate(
     copy_v3_v3(D, subdiv_vert->co);
     mul_v3_fl(D, inv_num_accumulated);
   }
-  /* Interpolate custom data and evaluate position. */
+  /* Interpolate custom data and store displacement, limit position is added to it later. */
   subdiv_vertex_data_interpolate(ctx, subdiv_vert, vertex_interpolation, u, v);
-  BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_vert->co);
-  /* Apply displacement. */
-  add_v3_v3(subdiv_vert->co, D);
+  copy_v3_v3(subdiv_vert->co, D);
+  subdiv_mesh_patch_coord_set(
+      &ctx->vertex_patch_coords[subdiv_vertex_index], ptex_face_index, u, v);
 }
 
 static void subdiv_mesh_vertex_every_corner_or_edge(const SubdivForeachContext *foreach_context,
@@ -730,7 +765,14 @@ static void subdiv_mesh_vertex_inner(const SubdivForeachContext *foreach_context
   MVert *subdiv_vert = &subdiv_mvert[subdiv_vertex_index];
   subdiv_mesh_ensure_vertex_interpolation(ctx, tls, coarse_poly, coarse_corner);
   subdiv_vertex_data_interpolate(ctx, subdiv_vert, &tls->vertex_interpolation, u, v);
-  BKE_subdiv_eval_final_point(subdiv, ptex_face_index, u, v, subdiv_vert->co);
+  if (ctx->have_displacement) {
+    BKE_subdiv_eval_final_point(subdiv, ptex_face_index, u, v, subdiv_vert->co);
+  }
+  else {
+    zero_v3(subdiv_vert->co);
+    subdiv_mesh_patch_coord_set(
+        &ctx->vertex_patch_coords[subdiv_vertex_index], ptex_face_index, u, v);
+  }
   subdiv_mesh_tag_center_vertex(coarse_poly, subdiv_vert, u, v);
 }
 
@@ -818,12 +860,9 @@ static void subdiv_eval_uv_layer(SubdivMeshContext *ctx,
   if (ctx->num_uv_layers == 0) {
     return;
   }
-  Subdiv *subdiv = ctx->subdiv;
+  /* UV layers are evaluated later for all loops at once. */
   const int mloop_index = subdiv_loop - ctx->subdiv_mesh->mloop;
-  for (int layer_index = 0; layer_index < ctx->num_uv_layers; layer_index++) {
-    MLoopUV *subdiv_loopuv = &ctx->uv_layers[layer_index][mloop_index];
-    BKE_subdiv_eval_face_varying(subdiv, layer_index, ptex_face_index, u, v, subdiv_loopuv->uv);
-  }
+  subdiv_mesh_patch_coord_set(&ctx->loop_patch_coords[mloop_index], ptex_face_index, u, v);
 }
 
 static void subdiv_mesh_ensure_loop_interpolation(SubdivMeshContext *ctx,
@@ -1072,6 +1111,9 @@ static void subdiv_mesh_vertex_of_loose_edge(const struct SubdivForeachContext *
     key_curve_position_weights(u, weights, KEY_BSPLINE);
     interp_v3_v3v3v3v3(subdiv_vertex->co, points[0], points[1], points[2], points[3], weights);
   }
+  /* End points can be shared with polygons, their coordinate is final now and must not get the
+   * limit surface position added to it. */
+  ctx->vertex_patch_coords[subdiv_vertex_index].ptex_face = -1;
   /* Reset flags and such. */
   subdiv_vertex->flag = 0;
   /* TODO(sergey): This matches old behavior, but we can as well interpolate
@@ -1081,6 +1123,62 @@ static void subdiv_mesh_vertex_of_loose_edge(const struct SubdivForeachContext *
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Batched limit surface evaluation
+ * \{ */
+
+static void subdiv_mesh_evaluate_vertices(SubdivMeshContext *ctx)
+{
+  Mesh *subdiv_mesh = ctx->subdiv_mesh;
+  MVert *subdiv_mvert = subdiv_mesh->mvert;
+  /* Gather vertices which are on the limit surface, the rest is already calculated. */
+  int *vertex_indices = MEM_malloc_arrayN(
+      subdiv_mesh->totvert, sizeof(*vertex_indices), "subdiv evaluated vertices");
+  OpenSubdiv_PatchCoord *patch_coords = MEM_malloc_arrayN(
+      subdiv_mesh->totvert, sizeof(*patch_coords), "subdiv evaluated patch coords");
+  int num_patch_coords = 0;
+  for (int i = 0; i < subdiv_mesh->totvert; i++) {
+    if (ctx->vertex_patch_coords[i].ptex_face >= 0) {
+      vertex_indices[num_patch_coords] = i;
+      patch_coords[num_patch_coords] = ctx->vertex_patch_coords[i];
+      num_patch_coords++;
+    }
+  }
+  if (num_patch_coords != 0) {
+    float(*positions)[3] = MEM_malloc_arrayN(
+        num_patch_coords, sizeof(*positions), "subdiv evaluated positions");
+    BKE_subdiv_eval_limit_patch_coords(
+        ctx->subdiv, patch_coords, num_patch_coords, positions, NULL, NULL);
+    /* Vertex coordinates contain displacement at this point. */
+    for (int i = 0; i < num_patch_coords; i++) {
+      add_v3_v3(subdiv_mvert[vertex_indices[i]].co, positions[i]);
+    }
+    MEM_freeN(positions);
+  }
+  MEM_freeN(patch_coords);
+  MEM_freeN(vertex_indices);
+}
+
+static void subdiv_mesh_evaluate_uv_layers(SubdivMeshContext *ctx)
+{
+  if (ctx->num_uv_layers == 0) {
+    return;
+  }
+  const int num_loops = ctx->subdiv_mesh->totloop;
+  float(*uvs)[2] = MEM_malloc_arrayN(num_loops, sizeof(*uvs), "subdiv evaluated uvs");
+  for (int layer_index = 0; layer_index < ctx->num_uv_layers; layer_index++) {
+    BKE_subdiv_eval_face_varying_patch_coords(
+        ctx->subdiv, layer_index, ctx->loop_patch_coords, num_loops, uvs);
+    MLoopUV *subdiv_loopuv = ctx->uv_layers[layer_index];
+    for (int i = 0; i < num_loops; i++) {
+      copy_v2_v2(subdiv_loopuv[i].uv, uvs[i]);
+    }
+  }
+  MEM_freeN(uvs);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Initialization
  * \{ */
@@ -1151,6 +1249,8 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
   foreach_context.user_data_tls_size = sizeof(SubdivMeshTLS);
   foreach_context.user_data_tls = &tls;
   BKE_subdiv_foreach_subdiv_geometry(subdiv, &foreach_context, settings, coarse_mesh);
+  subdiv_mesh_evaluate_vertices(&subdiv_context);
+  subdiv_mesh_evaluate_uv_layers(&subdiv_context);
   BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_GEOMETRY);
   Mesh *result = subdiv_context.subdiv_mesh;
   // BKE_mesh_validate(result, true, true);
@@ -0,0 +1,125 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+#include "BKE_subdiv.h"
+#include "BKE_subdiv_mesh.h"
+
+#include "BLI_math.h"
+
+#include "tests/BKE_mesh_test_utils.hh"
+
+namespace blender::bke::tests {
+
+class SubdivMeshTest : public MeshTest {
+};
+
+/**
+ * Create a quad away from the origin, with a loose edge going out of its second corner.
+ */
+static Mesh *test_quad_with_loose_edge_create()
+{
+  Mesh *mesh = BKE_mesh_new_nomain(5, 5, 0, 4, 1);
+  const float coords[5][3] = {
+      {10.0f, 0.0f, 0.0f},
+      {12.0f, 0.0f, 0.0f},
+      {12.0f, 2.0f, 0.0f},
+      {10.0f, 2.0f, 0.0f},
+      {14.0f, 0.0f, 1.0f},
+  };
+  for (int i = 0; i < 5; i++) {
+    copy_v3_v3(mesh->mvert[i].co, coords[i]);
+  }
+  for (int i = 0; i < 4; i++) {
+    mesh->medge[i].v1 = i;
+    mesh->medge[i].v2 = (i + 1) % 4;
+    mesh->mloop[i].v = i;
+    mesh->mloop[i].e = i;
+  }
+  mesh->medge[4].v1 = 1;
+  mesh->medge[4].v2 = 4;
+  mesh->medge[4].flag = ME_LOOSEEDGE;
+  mesh->mpoly[0].loopstart = 0;
+  mesh->mpoly[0].totloop = 4;
+  return mesh;
+}
+
+static Mesh *test_subdiv_to_mesh(const Mesh *coarse_mesh, const bool is_simple)
+{
+  SubdivSettings subdiv_settings;
+  subdiv_settings.is_simple = is_simple;
+  subdiv_settings.is_adaptive = false;
+  subdiv_settings.use_creases = false;
+  subdiv_settings.level = 2;
+  subdiv_settings.vtx_boundary_interpolation = SUBDIV_VTX_BOUNDARY_EDGE_ONLY;
+  subdiv_settings.fvar_linear_interpolation = SUBDIV_FVAR_LINEAR_INTERPOLATION_BOUNDARIES;
+  Subdiv *subdiv = BKE_subdiv_new_from_mesh(&subdiv_settings, coarse_mesh);
+  if (subdiv == nullptr) {
+    return nullptr;
+  }
+
+  SubdivToMeshSettings mesh_settings;
+  mesh_settings.resolution = (1 << subdiv_settings.level) + 1;
+  mesh_settings.use_optimal_display = false;
+  Mesh *result = BKE_subdiv_to_mesh(subdiv, &mesh_settings, coarse_mesh);
+  BKE_subdiv_free(subdiv);
+  return result;
+}
+
+TEST_F(SubdivMeshTest, loose_edge_attached_to_face_simple)
+{
+  Mesh *coarse_mesh = test_quad_with_loose_edge_create();
+  Mesh *result = test_subdiv_to_mesh(coarse_mesh, true);
+  ASSERT_NE(result, nullptr);
+
+  /* Subdivided vertices of coarse corners come first, with simple subdivision they keep the
+   * coarse positions, including the one shared by the polygon and the loose edge. */
+  for (int i = 0; i < coarse_mesh->totvert; i++) {
+    EXPECT_V3_NEAR(result->mvert[i].co, coarse_mesh->mvert[i].co, 1e-5f);
+  }
+
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, coarse_mesh);
+}
+
+TEST_F(SubdivMeshTest, loose_edge_attached_to_face_smooth)
+{
+  Mesh *coarse_mesh = test_quad_with_loose_edge_create();
+  Mesh *result = test_subdiv_to_mesh(coarse_mesh, false);
+  ASSERT_NE(result, nullptr);
+
+  /* Smoothing never moves vertices outside of the coarse bounds. */
+  float min[3], max[3];
+  INIT_MINMAX(min, max);
+  BKE_mesh_minmax(coarse_mesh, min, max);
+  for (int i = 0; i < result->totvert; i++) {
+    const float *co = result->mvert[i].co;
+    for (int axis = 0; axis < 3; axis++) {
+      EXPECT_GE(co[axis], min[axis] - 1e-5f);
+      EXPECT_LE(co[axis], max[axis] + 1e-5f);
+    }
+  }
+
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, coarse_mesh);
+}
+
+}  // namespace blender::bke::tests
@@ -155,7 +155,9 @@ static bool undosys_step_encode(bContext *C, Main *bmain, UndoStack *ustack, Und
 {
   CLOG_INFO(&LOG, 2, "addr=%p, name='%s', type='%s'", us, us->name, us->type->name);
   UNDO_NESTED_CHECK_BEGIN;
+  const eMemDomain previous_memory_domain = MEM_domain_begin(MEM_DOMAIN_UNDO);
   bool ok = us->type->step_encode(C, bmain, us);
+  MEM_domain_end(previous_memory_domain);
   UNDO_NESTED_CHECK_END;
   if (ok) {
     if (us->type->step_foreach_ID_ref != NULL) {
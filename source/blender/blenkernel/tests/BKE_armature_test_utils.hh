@@ -0,0 +1,204 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bke
+ *
+ * Armature and weighted mesh setup shared by the armature deform tests and benchmarks.
+ */
+
+#include <cstring>
+
+#include "DNA_action_types.h"
+#include "DNA_armature_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_armature.h"
+#include "BKE_customdata.h"
+#include "BKE_deform.h"
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+#include "BKE_object_deform.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_listbase.h"
+#include "BLI_math.h"
+#include "BLI_rand.hh"
+#include "BLI_string.h"
+
+namespace blender::bke::tests {
+
+/** Armature object deforming a mesh object, which aren't in a #Main database. */
+struct ArmatureDeformTestContext {
+  bArmature arm;
+  Object ob_arm;
+  Mesh *mesh;
+  Object ob_mesh;
+  /** Original vertex coordinates. */
+  float (*coords)[3];
+};
+
+inline void test_random_rigid_transform(RandomNumberGenerator &rng, float r_mat[4][4])
+{
+  const float loc[3] = {rng.get_float() - 0.5f, rng.get_float() - 0.5f, rng.get_float() - 0.5f};
+  const float eul[3] = {rng.get_float(), rng.get_float(), rng.get_float()};
+  const float size[3] = {1.0f, 1.0f, 1.0f};
+  loc_eul_size_to_mat4(r_mat, loc, eul, size);
+}
+
+/**
+ * Create an armature with `bones_len` posed bones and a mesh with random weights for them.
+ * Some bones are B-Bones, multiply the weights with their envelope or don't deform.
+ */
+inline void test_armature_deform_init(ArmatureDeformTestContext *ctx,
+                                      const int bones_len,
+                                      const int verts_len)
+{
+  RandomNumberGenerator rng;
+  float unit_mat[4][4];
+  unit_m4(unit_mat);
+
+  IDType_ID_AR.init_data(&ctx->arm.id);
+  STRNCPY(ctx->arm.id.name, "ARArmature");
+  IDType_ID_OB.init_data(&ctx->ob_arm.id);
+  STRNCPY(ctx->ob_arm.id.name, "OBArmature");
+  ctx->ob_arm.type = OB_ARMATURE;
+  ctx->ob_arm.data = &ctx->arm;
+  unit_m4(ctx->ob_arm.obmat);
+  ctx->ob_arm.pose = (bPose *)MEM_callocN(sizeof(bPose), __func__);
+
+  for (int i = 0; i < bones_len; i++) {
+    Bone *bone = (Bone *)MEM_callocN(sizeof(Bone), __func__);
+    BLI_snprintf(bone->name, sizeof(bone->name), "Bone %d", i);
+    zero_v3(bone->arm_head);
+    copy_v3_fl3(bone->arm_tail, 0.0f, 1.0f, 0.0f);
+    bone->length = 1.0f;
+    bone->rad_head = bone->rad_tail = 0.5f;
+    bone->dist = 0.25f;
+    bone->weight = 1.0f;
+    bone->segments = 1;
+    if (i % 5 == 1) {
+      bone->flag |= BONE_MULT_VG_ENV;
+    }
+    if (i % 7 == 2) {
+      bone->flag |= BONE_NO_DEFORM;
+    }
+    BLI_addtail(&ctx->arm.bonebase, bone);
+
+    bPoseChannel *pchan = (bPoseChannel *)MEM_callocN(sizeof(bPoseChannel), __func__);
+    STRNCPY(pchan->name, bone->name);
+    pchan->bone = bone;
+    test_random_rigid_transform(rng, pchan->chan_mat);
+    mat4_to_dquat(&pchan->runtime.deform_dual_quat, unit_mat, pchan->chan_mat);
+    if (i % 3 == 0) {
+      const int segments = 4;
+      bone->segments = segments;
+      pchan->runtime.bbone_segments = segments;
+      pchan->runtime.bbone_deform_mats = (Mat4 *)MEM_malloc_arrayN(
+          segments + 2, sizeof(Mat4), __func__);
+      pchan->runtime.bbone_dual_quats = (DualQuat *)MEM_malloc_arrayN(
+          segments + 1, sizeof(DualQuat), __func__);
+      unit_m4(pchan->runtime.bbone_deform_mats[0].mat);
+      for (int segment = 0; segment <= segments; segment++) {
+        float(*mat)[4] = pchan->runtime.bbone_deform_mats[segment + 1].mat;
+        test_random_rigid_transform(rng, mat);
+        mat4_to_dquat(&pchan->runtime.bbone_dual_quats[segment], unit_mat, mat);
+      }
+    }
+    BLI_addtail(&ctx->ob_arm.pose->chanbase, pchan);
+  }
+
+  ctx->mesh = BKE_mesh_new_nomain(verts_len, 0, 0, 0, 0);
+  IDType_ID_OB.init_data(&ctx->ob_mesh.id);
+  STRNCPY(ctx->ob_mesh.id.name, "OBMesh");
+  ctx->ob_mesh.type = OB_MESH;
+  ctx->ob_mesh.data = ctx->mesh;
+  unit_m4(ctx->ob_mesh.obmat);
+
+  LISTBASE_FOREACH (Bone *, bone, &ctx->arm.bonebase) {
+    BKE_object_defgroup_add_name(&ctx->ob_mesh, bone->name);
+  }
+  /* A vertex group without a bone, such as a soft-body group. */
+  BKE_object_defgroup_add_name(&ctx->ob_mesh, "Other");
+
+  ctx->mesh->dvert = (MDeformVert *)CustomData_add_layer(
+      &ctx->mesh->vdata, CD_MDEFORMVERT, CD_CALLOC, nullptr, verts_len);
+  ctx->coords = (float(*)[3])MEM_malloc_arrayN(verts_len, sizeof(float[3]), __func__);
+  for (int i = 0; i < verts_len; i++) {
+    float *co = ctx->mesh->mvert[i].co;
+    co[0] = rng.get_float() - 0.5f;
+    co[1] = rng.get_float();
+    co[2] = rng.get_float() - 0.5f;
+    copy_v3_v3(ctx->coords[i], co);
+
+    /* Leave some vertices to the envelopes. */
+    const int weights_len = (i % 11 == 0) ? 0 : 1 + rng.get_int32(4);
+    for (int j = 0; j < weights_len; j++) {
+      const int def_nr = rng.get_int32(bones_len + 1);
+      BKE_defvert_add_index_notest(&ctx->mesh->dvert[i], def_nr, rng.get_float());
+    }
+  }
+}
+
+inline void test_armature_deform_free(ArmatureDeformTestContext *ctx)
+{
+  ctx->mesh->id.tag &= ~LIB_TAG_COPIED_ON_WRITE;
+  BKE_id_free(nullptr, ctx->mesh);
+  MEM_freeN(ctx->coords);
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &ctx->ob_arm.pose->chanbase) {
+    MEM_SAFE_FREE(pchan->runtime.bbone_deform_mats);
+    MEM_SAFE_FREE(pchan->runtime.bbone_dual_quats);
+  }
+  BLI_freelistN(&ctx->ob_arm.pose->chanbase);
+  MEM_freeN(ctx->ob_arm.pose);
+  ctx->ob_arm.pose = nullptr;
+  BLI_freelistN(&ctx->arm.bonebase);
+  IDType_ID_OB.free_data(&ctx->ob_arm.id);
+  IDType_ID_OB.free_data(&ctx->ob_mesh.id);
+}
+
+/** Deform a copy of the original coordinates and optionally compute the deform matrices. */
+inline void test_armature_deform(ArmatureDeformTestContext *ctx,
+                                 const int deformflag,
+                                 float (*r_coords)[3],
+                                 float (*r_deform_mats)[3][3])
+{
+  const int verts_len = ctx->mesh->totvert;
+  memcpy(r_coords, ctx->coords, sizeof(float[3]) * verts_len);
+  if (r_deform_mats) {
+    for (int i = 0; i < verts_len; i++) {
+      unit_m3(r_deform_mats[i]);
+    }
+  }
+  BKE_armature_deform_coords_with_mesh(&ctx->ob_arm,
+                                       &ctx->ob_mesh,
+                                       r_coords,
+                                       r_deform_mats,
+                                       verts_len,
+                                       deformflag,
+                                       nullptr,
+                                       "",
+                                       nullptr);
+}
+
+}  // namespace blender::bke::tests
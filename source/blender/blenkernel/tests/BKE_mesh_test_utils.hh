@@ -0,0 +1,85 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bke
+ *
+ * Utilities shared by tests of modules creating and processing meshes.
+ */
+
+#include "testing/testing.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BLI_math_vec_types.hh"
+#include "BLI_math_vector.h"
+
+#include "BKE_idtype.h"
+#include "BKE_mesh.h"
+
+namespace blender::bke::tests {
+
+/** Base fixture for tests creating data-blocks, which requires the ID types to be registered. */
+class MeshTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+/**
+ * Create a planar grid of `res * res` quads of `size` on the XY plane, starting at `offset`.
+ *
+ * The vertex at column `x` and row `y` has index `y * (res + 1) + x`, the quad starting there has
+ * index `y * res + x`. Its loops go counter-clockwise from that vertex.
+ */
+inline Mesh *mesh_grid_create(const int res,
+                              const float size = 1.0f,
+                              const float3 offset = float3(0.0f))
+{
+  const int verts_len = (res + 1) * (res + 1);
+  const int polys_len = res * res;
+  Mesh *mesh = BKE_mesh_new_nomain(verts_len, 0, 0, polys_len * 4, polys_len);
+
+  for (int y = 0; y <= res; y++) {
+    for (int x = 0; x <= res; x++) {
+      const float3 co = float3(float(x) * size, float(y) * size, 0.0f) + offset;
+      copy_v3_v3(mesh->mvert[y * (res + 1) + x].co, co);
+    }
+  }
+  for (int y = 0; y < res; y++) {
+    for (int x = 0; x < res; x++) {
+      const int poly_index = y * res + x;
+      const int v = y * (res + 1) + x;
+      MPoly *mp = &mesh->mpoly[poly_index];
+      mp->loopstart = poly_index * 4;
+      mp->totloop = 4;
+      MLoop *ml = &mesh->mloop[mp->loopstart];
+      ml[0].v = v;
+      ml[1].v = v + 1;
+      ml[2].v = v + res + 2;
+      ml[3].v = v + res + 1;
+    }
+  }
+  BKE_mesh_calc_edges(mesh, false, false);
+  return mesh;
+}
+
+}  // namespace blender::bke::tests
@@ -0,0 +1,81 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <cfloat>
+#include <cstdio>
+
+#include "DNA_armature_types.h"
+#include "DNA_mesh_types.h"
+
+#include "BKE_armature.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_math_base.h"
+
+#include "PIL_time.h"
+
+#include "tests/BKE_armature_test_utils.hh"
+#include "tests/BKE_mesh_test_utils.hh"
+
+#define NUM_RUN_BEST_OF 10
+
+namespace blender::bke::tests {
+
+class ArmatureDeformPerformanceTest : public MeshTest {
+};
+
+static double armature_deform_time(ArmatureDeformTestContext *ctx,
+                                   const int deformflag,
+                                   float (*coords)[3])
+{
+  const double time_start = PIL_check_seconds_timer();
+  test_armature_deform(ctx, deformflag, coords, nullptr);
+  return PIL_check_seconds_timer() - time_start;
+}
+
+/**
+ * Compare deforming an original mesh, which reads the vertex groups, with an evaluated mesh,
+ * which caches a skinning table for linear blending.
+ */
+static void armature_deform_benchmark(const int bones_len, const int verts_len)
+{
+  ArmatureDeformTestContext ctx = {};
+  test_armature_deform_init(&ctx, bones_len, verts_len);
+  float(*coords)[3] = (float(*)[3])MEM_malloc_arrayN(verts_len, sizeof(float[3]), __func__);
+
+  printf("%d vertices, %d bones, best of %d runs:\n", verts_len, bones_len, NUM_RUN_BEST_OF);
+
+  const int deformflags[2] = {ARM_DEF_VGROUP, ARM_DEF_VGROUP | ARM_DEF_QUATERNION};
+  for (const int deformflag : deformflags) {
+    /* Alternate between original and evaluated meshes, so both run in the same conditions. */
+    double time_orig = DBL_MAX, time_eval = DBL_MAX;
+    for (int i = 0; i < NUM_RUN_BEST_OF; i++) {
+      ctx.mesh->id.tag &= ~LIB_TAG_COPIED_ON_WRITE;
+      time_orig = min_dd(time_orig, armature_deform_time(&ctx, deformflag, coords));
+      ctx.mesh->id.tag |= LIB_TAG_COPIED_ON_WRITE;
+      time_eval = min_dd(time_eval, armature_deform_time(&ctx, deformflag, coords));
+    }
+    printf("  %s: original mesh %.3f ms, evaluated mesh %.3f ms (%.2fx)\n",
+           (deformflag & ARM_DEF_QUATERNION) ? "Dual quaternion" : "Linear",
+           time_orig * 1000.0,
+           time_eval * 1000.0,
+           time_orig / time_eval);
+  }
+
+  MEM_freeN(coords);
+  test_armature_deform_free(&ctx);
+}
+
+TEST_F(ArmatureDeformPerformanceTest, Verts200kBones100)
+{
+  armature_deform_benchmark(100, 200000);
+}
+
+TEST_F(ArmatureDeformPerformanceTest, Verts1mBones20)
+{
+  armature_deform_benchmark(20, 1000000);
+}
+
+}  // namespace blender::bke::tests
@@ -1077,6 +1077,9 @@ static bool read_file_dna(FileData *fd, const char **r_error_message)
         fd->compflags = DNA_struct_get_compareflags(fd->filesdna, fd->memsdna);
         fd->reconstruct_info = DNA_reconstruct_info_create(
             fd->filesdna, fd->memsdna, fd->compflags);
+        if (do_endian_swap) {
+          DNA_reconstruct_info_ensure_endian_switch(fd->reconstruct_info);
+        }
         /* used to retrieve ID names from (bhead+1) */
         fd->id_name_offset = DNA_elem_offset(fd->filesdna, "ID", "char", "name[]");
         BLI_assert(fd->id_name_offset != -1);
@@ -1845,20 +1848,11 @@ void blo_cache_storage_end(FileData *fd)
 /** \name DNA Struct Loading
  * \{ */
 
-static void switch_endian_structs(const struct SDNA *filesdna, BHead *bhead)
+static void switch_endian_structs(const struct DNA_ReconstructInfo *reconstruct_info,
+                                  BHead *bhead)
 {
-  int blocksize, nblocks;
-  char *data;
-
-  data = (char *)(bhead + 1);
-  blocksize = filesdna->types_size[filesdna->structs[bhead->SDNAnr]->type];
-
-  nblocks = bhead->nr;
-  while (nblocks--) {
-    DNA_struct_switch_endian(filesdna, bhead->SDNAnr, data);
-
-    data += blocksize;
-  }
+  DNA_struct_switch_endian_blocks(
+      reconstruct_info, bhead->SDNAnr, bhead->nr, (char *)(bhead + 1));
 }
 
 static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
@@ -1881,7 +1875,7 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
         }
       }
 #endif
-      switch_endian_structs(fd->filesdna, bh);
+      switch_endian_structs(fd->reconstruct_info, bh);
     }
 
     if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
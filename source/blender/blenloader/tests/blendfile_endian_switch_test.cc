@@ -0,0 +1,110 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include <cstring>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
+#include "BLI_rand.hh"
+
+#include "DNA_genfile.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_sdna_types.h"
+
+namespace blender::blenloader::tests {
+
+class BlendfileEndianSwitchTest : public testing::Test {
+ protected:
+  SDNA *sdna_ = nullptr;
+  const char *compare_flags_ = nullptr;
+  DNA_ReconstructInfo *reconstruct_info_ = nullptr;
+
+  void SetUp() override
+  {
+    /* Both sides use the current SDNA, as when reading a file saved with the other endianness by
+     * the same Blender version. */
+    sdna_ = DNA_sdna_from_data(DNAstr, DNAlen, false, false, nullptr);
+    ASSERT_NE(sdna_, nullptr);
+    compare_flags_ = DNA_struct_get_compareflags(sdna_, sdna_);
+    reconstruct_info_ = DNA_reconstruct_info_create(sdna_, sdna_, compare_flags_);
+    DNA_reconstruct_info_ensure_endian_switch(reconstruct_info_);
+  }
+
+  void TearDown() override
+  {
+    DNA_reconstruct_info_free(reconstruct_info_);
+    MEM_freeN((void *)compare_flags_);
+    DNA_sdna_free(sdna_);
+  }
+
+  int struct_size(const int struct_nr) const
+  {
+    return sdna_->types_size[sdna_->structs[struct_nr]->type];
+  }
+};
+
+TEST_F(BlendfileEndianSwitchTest, blocks_match_per_struct_switch)
+{
+  const int blocks = 3;
+  RandomNumberGenerator rng(0);
+
+  for (int struct_nr = 0; struct_nr < sdna_->structs_len; struct_nr++) {
+    const int size = struct_size(struct_nr);
+    Array<char> original(size_t(size) * blocks);
+    for (char &value : original) {
+      value = char(rng.get_uint32());
+    }
+
+    Array<char> expected = original;
+    for (int i = 0; i < blocks; i++) {
+      DNA_struct_switch_endian(sdna_, struct_nr, expected.data() + size_t(size) * i);
+    }
+
+    Array<char> switched = original;
+    DNA_struct_switch_endian_blocks(reconstruct_info_, struct_nr, blocks, switched.data());
+    EXPECT_EQ(memcmp(switched.data(), expected.data(), switched.size()), 0)
+        << sdna_->types[sdna_->structs[struct_nr]->type];
+
+    /* Switching a second time gives back the original bytes. */
+    DNA_struct_switch_endian_blocks(reconstruct_info_, struct_nr, blocks, switched.data());
+    EXPECT_EQ(memcmp(switched.data(), original.data(), switched.size()), 0)
+        << sdna_->types[sdna_->structs[struct_nr]->type];
+  }
+}
+
+TEST_F(BlendfileEndianSwitchTest, blocks_byte_swapped)
+{
+  const int struct_nr = DNA_struct_find_nr(sdna_, "MLoop");
+  ASSERT_GE(struct_nr, 0);
+  ASSERT_EQ(struct_size(struct_nr), int(sizeof(MLoop)));
+
+  MLoop loops[2] = {{0x01020304, 0x0a0b0c0d}, {0x11121314, 0x1a1b1c1d}};
+  DNA_struct_switch_endian_blocks(reconstruct_info_, struct_nr, 2, (char *)loops);
+  EXPECT_EQ(loops[0].v, 0x04030201u);
+  EXPECT_EQ(loops[0].e, 0x0d0c0b0au);
+  EXPECT_EQ(loops[1].v, 0x14131211u);
+  EXPECT_EQ(loops[1].e, 0x1d1c1b1au);
+
+  DNA_struct_switch_endian_blocks(reconstruct_info_, struct_nr, 2, (char *)loops);
+  EXPECT_EQ(loops[0].v, 0x01020304u);
+  EXPECT_EQ(loops[0].e, 0x0a0b0c0du);
+  EXPECT_EQ(loops[1].v, 0x11121314u);
+  EXPECT_EQ(loops[1].e, 0x1a1b1c1du);
+}
+
+}  // namespace blender::blenloader::tests
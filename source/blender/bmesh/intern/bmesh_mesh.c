@@ -77,6 +77,16 @@ static void bm_mempool_init_ex(const BMAllocTemplate *allocsize,
   }
 }
 
+void BM_mesh_mempool_create(const BMAllocTemplate *allocsize,
+                            const bool use_toolflags,
+                            BLI_mempool **r_vpool,
+                            BLI_mempool **r_epool,
+                            BLI_mempool **r_lpool,
+                            BLI_mempool **r_fpool)
+{
+  bm_mempool_init_ex(allocsize, use_toolflags, r_vpool, r_epool, r_lpool, r_fpool);
+}
+
 static void bm_mempool_init(BMesh *bm, const BMAllocTemplate *allocsize, const bool use_toolflags)
 {
   bm_mempool_init_ex(allocsize, use_toolflags, &bm->vpool, &bm->epool, &bm->lpool, &bm->fpool);
@@ -1044,16 +1054,31 @@ void BM_mesh_rebuild(BMesh *bm,
   const char remap = (vpool_dst ? BM_VERT : 0) | (epool_dst ? BM_EDGE : 0) |
                      (lpool_dst ? BM_LOOP : 0) | (fpool_dst ? BM_FACE : 0);
 
-  BMVert **vtable_dst = (remap & BM_VERT) ? MEM_mallocN(bm->totvert * sizeof(BMVert *), __func__) :
-                                            NULL;
-  BMEdge **etable_dst = (remap & BM_EDGE) ? MEM_mallocN(bm->totedge * sizeof(BMEdge *), __func__) :
-                                            NULL;
+  /* Elements referencing re-allocated elements need to be updated: vertices reference an edge,
+   * edges reference vertices, edges and a loop, faces reference their loops, which reference all
+   * element types. */
+  const bool update_verts = (remap & BM_EDGE) != 0;
+  const bool update_edges = (remap & (BM_VERT | BM_EDGE | BM_LOOP)) != 0;
+  const bool update_faces = remap != 0;
+
+  /* Tables of the elements to update, filled with the existing elements when they aren't
+   * re-allocated. */
+  BMVert **vtable_dst = ((remap & BM_VERT) || update_verts) ?
+                            MEM_mallocN(bm->totvert * sizeof(BMVert *), __func__) :
+                            NULL;
+  BMEdge **etable_dst = ((remap & BM_EDGE) || update_edges) ?
+                            MEM_mallocN(bm->totedge * sizeof(BMEdge *), __func__) :
+                            NULL;
   BMLoop **ltable_dst = (remap & BM_LOOP) ? MEM_mallocN(bm->totloop * sizeof(BMLoop *), __func__) :
                                             NULL;
-  BMFace **ftable_dst = (remap & BM_FACE) ? MEM_mallocN(bm->totface * sizeof(BMFace *), __func__) :
-                                            NULL;
+  BMFace **ftable_dst = ((remap & BM_FACE) || update_faces) ?
+                            MEM_mallocN(bm->totface * sizeof(BMFace *), __func__) :
+                            NULL;
 
   const bool use_toolflags = params->use_toolflags;
+  /* Keep the existing tool flags, only allocate new ones when they are being enabled. */
+  const bool use_toolflags_keep = use_toolflags && bm->use_toolflags;
+  const bool use_toolflags_alloc = use_toolflags && !bm->use_toolflags;
 
   if (remap & BM_VERT) {
     BMIter iter;
@@ -1061,8 +1086,8 @@ void BM_mesh_rebuild(BMesh *bm,
     BMVert *v_src;
     BM_ITER_MESH_INDEX (v_src, &iter, bm, BM_VERTS_OF_MESH, index) {
       BMVert *v_dst = BLI_mempool_alloc(vpool_dst);
-      memcpy(v_dst, v_src, sizeof(BMVert));
-      if (use_toolflags) {
+      memcpy(v_dst, v_src, use_toolflags_keep ? sizeof(BMVert_OFlag) : sizeof(BMVert));
+      if (use_toolflags_alloc) {
         ((BMVert_OFlag *)v_dst)->oflags = bm->vtoolflagpool ?
                                               BLI_mempool_calloc(bm->vtoolflagpool) :
                                               NULL;
@@ -1072,6 +1097,9 @@ void BM_mesh_rebuild(BMesh *bm,
       BM_elem_index_set(v_src, index); /* set_ok */
     }
   }
+  else if (vtable_dst) {
+    BM_iter_as_array(bm, BM_VERTS_OF_MESH, NULL, (void **)vtable_dst, bm->totvert);
+  }
 
   if (remap & BM_EDGE) {
     BMIter iter;
@@ -1079,8 +1107,8 @@ void BM_mesh_rebuild(BMesh *bm,
     BMEdge *e_src;
     BM_ITER_MESH_INDEX (e_src, &iter, bm, BM_EDGES_OF_MESH, index) {
       BMEdge *e_dst = BLI_mempool_alloc(epool_dst);
-      memcpy(e_dst, e_src, sizeof(BMEdge));
-      if (use_toolflags) {
+      memcpy(e_dst, e_src, use_toolflags_keep ? sizeof(BMEdge_OFlag) : sizeof(BMEdge));
+      if (use_toolflags_alloc) {
         ((BMEdge_OFlag *)e_dst)->oflags = bm->etoolflagpool ?
                                               BLI_mempool_calloc(bm->etoolflagpool) :
                                               NULL;
@@ -1090,6 +1118,9 @@ void BM_mesh_rebuild(BMesh *bm,
       BM_elem_index_set(e_src, index); /* set_ok */
     }
   }
+  else if (etable_dst) {
+    BM_iter_as_array(bm, BM_EDGES_OF_MESH, NULL, (void **)etable_dst, bm->totedge);
+  }
 
   if (remap & (BM_LOOP | BM_FACE)) {
     BMIter iter;
@@ -1099,8 +1130,8 @@ void BM_mesh_rebuild(BMesh *bm,
 
       if (remap & BM_FACE) {
         BMFace *f_dst = BLI_mempool_alloc(fpool_dst);
-        memcpy(f_dst, f_src, sizeof(BMFace));
-        if (use_toolflags) {
+        memcpy(f_dst, f_src, use_toolflags_keep ? sizeof(BMFace_OFlag) : sizeof(BMFace));
+        if (use_toolflags_alloc) {
           ((BMFace_OFlag *)f_dst)->oflags = bm->ftoolflagpool ?
                                                 BLI_mempool_calloc(bm->ftoolflagpool) :
                                                 NULL;
@@ -1109,6 +1140,9 @@ void BM_mesh_rebuild(BMesh *bm,
         ftable_dst[index] = f_dst;
         BM_elem_index_set(f_src, index); /* set_ok */
       }
+      else {
+        ftable_dst[index] = f_src;
+      }
 
       /* handle loops */
       if (remap & BM_LOOP) {
@@ -1159,7 +1193,7 @@ void BM_mesh_rebuild(BMesh *bm,
   ((void)0)
 
   /* verts */
-  {
+  if (update_verts) {
     for (int i = 0; i < bm->totvert; i++) {
       BMVert *v = vtable_dst[i];
       if (v->e) {
@@ -1169,7 +1203,7 @@ void BM_mesh_rebuild(BMesh *bm,
   }
 
   /* edges */
-  {
+  if (update_edges) {
     for (int i = 0; i < bm->totedge; i++) {
       BMEdge *e = etable_dst[i];
       REMAP_VERT(e->v1);
@@ -1185,7 +1219,7 @@ void BM_mesh_rebuild(BMesh *bm,
   }
 
   /* faces */
-  {
+  if (update_faces) {
     for (int i = 0; i < bm->totface; i++) {
       BMFace *f = ftable_dst[i];
       REMAP_LOOP(f->l_first);
@@ -1254,6 +1288,9 @@ void BM_mesh_rebuild(BMesh *bm,
     BLI_mempool_destroy(bm->vpool);
     bm->vpool = vpool_dst;
   }
+  else if (vtable_dst) {
+    MEM_freeN(vtable_dst);
+  }
 
   if (remap & BM_EDGE) {
     if (bm->etable) {
@@ -1265,6 +1302,9 @@ void BM_mesh_rebuild(BMesh *bm,
     BLI_mempool_destroy(bm->epool);
     bm->epool = epool_dst;
   }
+  else if (etable_dst) {
+    MEM_freeN(etable_dst);
+  }
 
   if (remap & BM_LOOP) {
     /* no loop table */
@@ -1283,6 +1323,9 @@ void BM_mesh_rebuild(BMesh *bm,
     BLI_mempool_destroy(bm->fpool);
     bm->fpool = fpool_dst;
   }
+  else if (ftable_dst) {
+    MEM_freeN(ftable_dst);
+  }
 }
 
 void BM_mesh_toolflags_set(BMesh *bm, bool use_toolflags)
@@ -191,6 +191,17 @@ typedef struct BMAllocTemplate {
 extern const BMAllocTemplate bm_mesh_allocsize_default;
 extern const BMAllocTemplate bm_mesh_chunksize_default;
 
+/**
+ * Create element memory pools, sized for \a allocsize, as used by #BM_mesh_rebuild.
+ * Pools are only created for the non-NULL return arguments.
+ */
+void BM_mesh_mempool_create(const BMAllocTemplate *allocsize,
+                            bool use_toolflags,
+                            struct BLI_mempool **r_vpool,
+                            struct BLI_mempool **r_epool,
+                            struct BLI_mempool **r_lpool,
+                            struct BLI_mempool **r_fpool);
+
 #define BMALLOC_TEMPLATE_FROM_BM(bm) \
   { \
     (CHECK_TYPE_INLINE(bm, BMesh *), (bm)->totvert), (bm)->totedge, (bm)->totloop, (bm)->totface \
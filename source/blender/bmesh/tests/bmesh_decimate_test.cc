@@ -0,0 +1,251 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BLI_kdtree.h"
+#include "BLI_math.h"
+
+#include "BKE_lib_id.h"
+
+#include "bmesh.h"
+#include "bmesh_tools.h"
+
+#include "tests/BKE_mesh_test_utils.hh"
+
+namespace blender::bmesh::tests {
+
+class BMeshDecimateTest : public bke::tests::MeshTest {
+};
+
+/**
+ * Create a grid of `size` x `size` quads centered around the origin on the X axis,
+ * displaced into a (symmetrical) wave so the quadric error isn't the same everywhere.
+ */
+static BMesh *create_grid_bmesh(const int size, const bool use_toolflags = false)
+{
+  Mesh *mesh = bke::tests::mesh_grid_create(size, 1.0f, float3(-(float)size * 0.5f, 0.0f, 0.0f));
+  for (int i = 0; i < mesh->totvert; i++) {
+    float *co = mesh->mvert[i].co;
+    co[2] = cosf(co[0] * 0.2f) * cosf(co[1] * 0.1f) * 2.0f;
+  }
+
+  const BMAllocTemplate allocsize = BMALLOC_TEMPLATE_FROM_ME(mesh);
+  BMeshCreateParams create_params{};
+  create_params.use_toolflags = use_toolflags;
+  BMesh *bm = BM_mesh_create(&allocsize, &create_params);
+  BMeshFromMeshParams convert_params{};
+  convert_params.calc_face_normal = true;
+  BM_mesh_bm_from_me(bm, mesh, &convert_params);
+  BKE_id_free(nullptr, mesh);
+
+  BM_mesh_normals_update(bm);
+  BM_mesh_elem_index_ensure(bm, BM_VERT | BM_EDGE | BM_FACE);
+  return bm;
+}
+
+/**
+ * Decimation only collapses edges between triangles,
+ * check that didn't leave any degenerate or non-manifold geometry.
+ */
+static bool is_manifold_triangle_mesh(BMesh *bm)
+{
+  BMIter iter;
+  BMEdge *e;
+  BMFace *f;
+  BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+    if (!(BM_edge_is_manifold(e) || BM_edge_is_boundary(e)) || BM_edge_find_double(e)) {
+      return false;
+    }
+  }
+  BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+    if (f->len != 3) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** Count vertices with an X coordinate below `x`. */
+static int count_verts_below_x(BMesh *bm, const float x)
+{
+  BMIter iter;
+  BMVert *v;
+  int count = 0;
+  BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+    count += (v->co[0] < x);
+  }
+  return count;
+}
+
+static void decimate(BMesh *bm,
+                     const float factor,
+                     float *vweights,
+                     const int symmetry_axis,
+                     const bool use_parallel)
+{
+  BM_mesh_decimate_collapse_ex(
+      bm, factor, vweights, 1.0f, true, symmetry_axis, 0.00002f, use_parallel);
+}
+
+TEST_F(BMeshDecimateTest, collapse_parallel)
+{
+  /* Large enough to be split into multiple partitions. */
+  const int size = 256;
+  const float factor = 0.1f;
+
+  BMesh *bm_serial = create_grid_bmesh(size);
+  BMesh *bm_parallel = create_grid_bmesh(size);
+  const int face_tot_target = (int)((float)bm_serial->totface * 2 * factor);
+
+  decimate(bm_serial, factor, nullptr, -1, false);
+  decimate(bm_parallel, factor, nullptr, -1, true);
+
+  EXPECT_TRUE(is_manifold_triangle_mesh(bm_parallel));
+
+  /* Both reach the target (as triangles), neither over-collapses. */
+  EXPECT_LE(bm_serial->totface, face_tot_target);
+  EXPECT_LE(bm_parallel->totface, face_tot_target);
+  EXPECT_GE(bm_parallel->totface, face_tot_target - 2);
+  EXPECT_NEAR(bm_parallel->totvert, bm_serial->totvert, bm_serial->totvert / 100);
+
+  BM_mesh_free(bm_serial);
+  BM_mesh_free(bm_parallel);
+}
+
+/** Compare vertex coordinates and faces, including their order. */
+static void expect_bmesh_equal(BMesh *bm_a, BMesh *bm_b)
+{
+  ASSERT_EQ(bm_a->totvert, bm_b->totvert);
+  ASSERT_EQ(bm_a->totface, bm_b->totface);
+  BM_mesh_elem_index_ensure(bm_a, BM_VERT);
+  BM_mesh_elem_index_ensure(bm_b, BM_VERT);
+
+  BMIter iter_a, iter_b;
+  BMVert *v_a = static_cast<BMVert *>(BM_iter_new(&iter_a, bm_a, BM_VERTS_OF_MESH, nullptr));
+  BMVert *v_b = static_cast<BMVert *>(BM_iter_new(&iter_b, bm_b, BM_VERTS_OF_MESH, nullptr));
+  for (; v_a && v_b; v_a = static_cast<BMVert *>(BM_iter_step(&iter_a)),
+                     v_b = static_cast<BMVert *>(BM_iter_step(&iter_b))) {
+    EXPECT_V3_NEAR(v_a->co, v_b->co, 0.0f);
+  }
+
+  BMFace *f_a = static_cast<BMFace *>(BM_iter_new(&iter_a, bm_a, BM_FACES_OF_MESH, nullptr));
+  BMFace *f_b = static_cast<BMFace *>(BM_iter_new(&iter_b, bm_b, BM_FACES_OF_MESH, nullptr));
+  for (; f_a && f_b; f_a = static_cast<BMFace *>(BM_iter_step(&iter_a)),
+                     f_b = static_cast<BMFace *>(BM_iter_step(&iter_b))) {
+    ASSERT_EQ(f_a->len, f_b->len);
+    BMLoop *l_a = BM_FACE_FIRST_LOOP(f_a);
+    BMLoop *l_b = BM_FACE_FIRST_LOOP(f_b);
+    for (int i = 0; i < f_a->len; i++, l_a = l_a->next, l_b = l_b->next) {
+      EXPECT_EQ(BM_elem_index_get(l_a->v), BM_elem_index_get(l_b->v));
+    }
+  }
+}
+
+TEST_F(BMeshDecimateTest, collapse_parallel_repeatable)
+{
+  const int size = 256;
+  const float factor = 0.25f;
+
+  for (const bool do_triangulate : {true, false}) {
+    BMesh *bm_a = create_grid_bmesh(size);
+    BMesh *bm_b = create_grid_bmesh(size);
+    BM_mesh_decimate_collapse_ex(bm_a, factor, nullptr, 1.0f, do_triangulate, -1, 0.0f, true);
+    BM_mesh_decimate_collapse_ex(bm_b, factor, nullptr, 1.0f, do_triangulate, -1, 0.0f, true);
+
+    expect_bmesh_equal(bm_a, bm_b);
+
+    BM_mesh_free(bm_a);
+    BM_mesh_free(bm_b);
+  }
+}
+
+TEST_F(BMeshDecimateTest, collapse_parallel_symmetry)
+{
+  const int size = 256;
+  const float factor = 0.2f;
+
+  BMesh *bm = create_grid_bmesh(size);
+  decimate(bm, factor, nullptr, 0, true);
+
+  EXPECT_TRUE(is_manifold_triangle_mesh(bm));
+  EXPECT_LE(bm->totface, (int)((float)size * size * 2 * factor));
+
+  /* Every vertex has a mirrored counterpart. */
+  KDTree_3d *tree = BLI_kdtree_3d_new(bm->totvert);
+  BMIter iter;
+  BMVert *v;
+  int i;
+  BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+    BLI_kdtree_3d_insert(tree, i, v->co);
+  }
+  BLI_kdtree_3d_balance(tree);
+
+  int unmatched = 0;
+  BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+    const float co_mirr[3] = {-v->co[0], v->co[1], v->co[2]};
+    KDTreeNearest_3d nearest;
+    BLI_kdtree_3d_find_nearest(tree, co_mirr, &nearest);
+    unmatched += (nearest.dist > 1e-3f);
+  }
+  BLI_kdtree_3d_free(tree);
+  EXPECT_EQ(unmatched, 0);
+
+  BM_mesh_free(bm);
+}
+
+TEST_F(BMeshDecimateTest, collapse_parallel_vertex_weights)
+{
+  const int size = 256;
+  const float factor = 0.2f;
+
+  BMesh *bm = create_grid_bmesh(size);
+  /* Leave a margin, vertices next to the fixed ones may still move towards them. */
+  const float x_fixed = -(float)size * 0.25f - 2.0f;
+  const int verts_fixed_tot = count_verts_below_x(bm, x_fixed);
+
+  /* Zero weights keep the left quarter of the grid as-is. */
+  float *vweights = static_cast<float *>(MEM_mallocN(sizeof(float) * bm->totvert, __func__));
+  BMIter iter;
+  BMVert *v;
+  int i;
+  BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+    vweights[i] = (v->co[0] < -(float)size * 0.25f) ? 0.0f : 1.0f;
+  }
+
+  decimate(bm, factor, vweights, -1, true);
+
+  EXPECT_TRUE(is_manifold_triangle_mesh(bm));
+  EXPECT_EQ(count_verts_below_x(bm, x_fixed), verts_fixed_tot);
+
+  MEM_freeN(vweights);
+  BM_mesh_free(bm);
+}
+
+TEST_F(BMeshDecimateTest, collapse_parallel_toolflags)
+{
+  /* As used in edit-mode, faces are moved into a new pool after decimating. */
+  const int size = 256;
+  const float factor = 0.2f;
+
+  BMesh *bm = create_grid_bmesh(size, true);
+  BM_mesh_elem_toolflags_ensure(bm);
+  decimate(bm, factor, nullptr, -1, true);
+
+  EXPECT_TRUE(is_manifold_triangle_mesh(bm));
+  /* Faces keep their tool flags instead of allocating new ones. */
+  EXPECT_EQ(BLI_mempool_len(bm->ftoolflagpool), bm->totface);
+  BMIter iter;
+  BMFace *f;
+  BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+    EXPECT_NE(((BMFace_OFlag *)f)->oflags, nullptr);
+  }
+
+  BM_mesh_free(bm);
+}
+
+}  // namespace blender::bmesh::tests
@@ -0,0 +1,143 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+
+#include "BLI_math.h"
+
+#include "BKE_customdata.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "bmesh.h"
+
+#include "tests/BKE_mesh_test_utils.hh"
+
+namespace blender::bmesh::tests {
+
+class BMeshConvertTest : public bke::tests::MeshTest {
+};
+
+/** Create a grid of `size` x `size` quads, with a float attribute on vertices and faces. */
+static Mesh *create_grid_mesh(const int size)
+{
+  Mesh *mesh = bke::tests::mesh_grid_create(size);
+  for (int y = 0; y <= size; y++) {
+    for (int x = 0; x <= size; x++) {
+      MVert &mv = mesh->mvert[y * (size + 1) + x];
+      mv.co[2] = (float)((x * y) % 7);
+      mv.flag = (x + y) % 3 == 0 ? SELECT : 0;
+    }
+  }
+  for (int i = 0; i < mesh->totpoly; i++) {
+    mesh->mpoly[i].mat_nr = i % 3;
+  }
+
+  float *vert_weights = (float *)CustomData_add_layer_named(
+      &mesh->vdata, CD_PROP_FLOAT, CD_CALLOC, nullptr, mesh->totvert, "weight");
+  for (int i = 0; i < mesh->totvert; i++) {
+    vert_weights[i] = i * 0.5f;
+  }
+  float *poly_weights = (float *)CustomData_add_layer_named(
+      &mesh->pdata, CD_PROP_FLOAT, CD_CALLOC, nullptr, mesh->totpoly, "weight");
+  for (int i = 0; i < mesh->totpoly; i++) {
+    poly_weights[i] = i * 0.25f;
+  }
+
+  return mesh;
+}
+
+static BMesh *bmesh_from_mesh(const Mesh *mesh)
+{
+  const BMAllocTemplate allocsize = BMALLOC_TEMPLATE_FROM_ME(mesh);
+  BMeshCreateParams create_params{};
+  create_params.use_toolflags = false;
+  BMesh *bm = BM_mesh_create(&allocsize, &create_params);
+
+  BMeshFromMeshParams convert_params{};
+  convert_params.calc_face_normal = true;
+  BM_mesh_bm_from_me(bm, mesh, &convert_params);
+  return bm;
+}
+
+static Mesh *mesh_from_bmesh(BMesh *bm)
+{
+  Mesh *mesh = BKE_mesh_new_nomain(0, 0, 0, 0, 0);
+  BMeshToMeshParams convert_params{};
+  BM_mesh_bm_to_me(nullptr, bm, mesh, &convert_params);
+  return mesh;
+}
+
+TEST_F(BMeshConvertTest, round_trip)
+{
+  Mesh *mesh = create_grid_mesh(48);
+  mesh->act_face = 17;
+
+  BMesh *bm = bmesh_from_mesh(mesh);
+  EXPECT_EQ(bm->totvert, mesh->totvert);
+  EXPECT_EQ(bm->totedge, mesh->totedge);
+  EXPECT_EQ(bm->totface, mesh->totpoly);
+  EXPECT_EQ(bm->totloop, mesh->totloop);
+
+  BM_mesh_elem_table_ensure(bm, BM_VERT | BM_FACE);
+  const int cd_weight_offset = CustomData_get_offset(&bm->vdata, CD_PROP_FLOAT);
+  ASSERT_NE(cd_weight_offset, -1);
+  for (int i = 0; i < bm->totvert; i++) {
+    const BMVert *v = BM_vert_at_index(bm, i);
+    EXPECT_V3_NEAR(v->co, mesh->mvert[i].co, 0.0f);
+    EXPECT_EQ(BM_ELEM_CD_GET_FLOAT(v, cd_weight_offset), i * 0.5f);
+    EXPECT_EQ(BM_elem_flag_test_bool(v, BM_ELEM_SELECT), (mesh->mvert[i].flag & SELECT) != 0);
+  }
+  for (int i = 0; i < bm->totface; i++) {
+    const BMFace *f = BM_face_at_index(bm, i);
+    EXPECT_EQ(f->mat_nr, mesh->mpoly[i].mat_nr);
+    float no[3];
+    BM_face_calc_normal(f, no);
+    EXPECT_V3_NEAR(f->no, no, 1e-6f);
+  }
+  EXPECT_EQ(bm->act_face, BM_face_at_index(bm, 17));
+
+  Mesh *result = mesh_from_bmesh(bm);
+  BM_mesh_free(bm);
+
+  ASSERT_EQ(result->totvert, mesh->totvert);
+  ASSERT_EQ(result->totedge, mesh->totedge);
+  ASSERT_EQ(result->totpoly, mesh->totpoly);
+  ASSERT_EQ(result->totloop, mesh->totloop);
+  EXPECT_EQ(result->act_face, 17);
+
+  const float *vert_weights = (const float *)CustomData_get_layer_named(
+      &result->vdata, CD_PROP_FLOAT, "weight");
+  const float *poly_weights = (const float *)CustomData_get_layer_named(
+      &result->pdata, CD_PROP_FLOAT, "weight");
+  ASSERT_NE(vert_weights, nullptr);
+  ASSERT_NE(poly_weights, nullptr);
+
+  for (int i = 0; i < result->totvert; i++) {
+    EXPECT_V3_NEAR(result->mvert[i].co, mesh->mvert[i].co, 0.0f);
+    EXPECT_EQ(result->mvert[i].flag & SELECT, mesh->mvert[i].flag & SELECT);
+    EXPECT_EQ(vert_weights[i], i * 0.5f);
+  }
+  for (int i = 0; i < result->totedge; i++) {
+    EXPECT_EQ(result->medge[i].v1, mesh->medge[i].v1);
+    EXPECT_EQ(result->medge[i].v2, mesh->medge[i].v2);
+  }
+  for (int i = 0; i < result->totpoly; i++) {
+    EXPECT_EQ(result->mpoly[i].loopstart, mesh->mpoly[i].loopstart);
+    EXPECT_EQ(result->mpoly[i].totloop, mesh->mpoly[i].totloop);
+    EXPECT_EQ(result->mpoly[i].mat_nr, mesh->mpoly[i].mat_nr);
+    EXPECT_EQ(poly_weights[i], i * 0.25f);
+  }
+  for (int i = 0; i < result->totloop; i++) {
+    EXPECT_EQ(result->mloop[i].v, mesh->mloop[i].v);
+    EXPECT_EQ(result->mloop[i].e, mesh->mloop[i].e);
+  }
+
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bmesh::tests
@@ -0,0 +1,89 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <cstdio>
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BLI_math.h"
+
+#include "BKE_lib_id.h"
+
+#include "PIL_time.h"
+
+#include "bmesh.h"
+#include "bmesh_tools.h"
+
+#include "tests/BKE_mesh_test_utils.hh"
+
+namespace blender::bmesh::tests {
+
+class BMeshDecimatePerformanceTest : public bke::tests::MeshTest {
+};
+
+/** A grid of `size` x `size` quads, displaced into a wave so the quadric error varies. */
+static BMesh *create_grid_bmesh(const int size)
+{
+  Mesh *mesh = bke::tests::mesh_grid_create(size, 1.0f, float3(-(float)size * 0.5f, 0.0f, 0.0f));
+  for (int i = 0; i < mesh->totvert; i++) {
+    float *co = mesh->mvert[i].co;
+    co[2] = cosf(co[0] * 0.2f) * cosf(co[1] * 0.1f) * 2.0f;
+  }
+
+  const BMAllocTemplate allocsize = BMALLOC_TEMPLATE_FROM_ME(mesh);
+  BMeshCreateParams create_params{};
+  BMesh *bm = BM_mesh_create(&allocsize, &create_params);
+  BMeshFromMeshParams convert_params{};
+  convert_params.calc_face_normal = true;
+  BM_mesh_bm_from_me(bm, mesh, &convert_params);
+  BKE_id_free(nullptr, mesh);
+
+  BM_mesh_normals_update(bm);
+  return bm;
+}
+
+/** Time decimating the grid, returning the number of faces left in `r_face_tot`. */
+static double decimate_benchmark(const int size,
+                                 const float factor,
+                                 const bool use_parallel,
+                                 int *r_face_tot)
+{
+  BMesh *bm = create_grid_bmesh(size);
+
+  const double time_start = PIL_check_seconds_timer();
+  BM_mesh_decimate_collapse_ex(bm, factor, nullptr, 1.0f, true, -1, 0.00002f, use_parallel);
+  const double time = PIL_check_seconds_timer() - time_start;
+
+  *r_face_tot = bm->totface;
+  BM_mesh_free(bm);
+  return time;
+}
+
+static void decimate_benchmark_grid(const int size, const float factor)
+{
+  int face_tot_serial, face_tot_parallel;
+  const double time_serial = decimate_benchmark(size, factor, false, &face_tot_serial);
+  const double time_parallel = decimate_benchmark(size, factor, true, &face_tot_parallel);
+
+  printf("Grid %dx%d (%d faces, factor %.2f):\n", size, size, size * size, factor);
+  printf("  Serial:   %.3f ms, %d faces\n", time_serial * 1000.0, face_tot_serial);
+  printf("  Parallel: %.3f ms, %d faces (%.2fx serial time, %+d faces)\n",
+         time_parallel * 1000.0,
+         face_tot_parallel,
+         time_parallel / time_serial,
+         face_tot_parallel - face_tot_serial);
+}
+
+TEST_F(BMeshDecimatePerformanceTest, Grid256)
+{
+  decimate_benchmark_grid(256, 0.1f);
+}
+
+TEST_F(BMeshDecimatePerformanceTest, Grid512)
+{
+  decimate_benchmark_grid(512, 0.1f);
+}
+
+}  // namespace blender::bmesh::tests
@@ -0,0 +1,118 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <cstdio>
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BLI_task.hh"
+#include "BLI_utildefines.h"
+
+#include "BKE_customdata.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "PIL_time.h"
+
+#include "bmesh.h"
+
+#include "tests/BKE_mesh_test_utils.hh"
+
+#define NUM_RUN_AVERAGED 5
+
+namespace blender::bmesh::tests {
+
+class BMeshConvertPerformanceTest : public bke::tests::MeshTest {
+};
+
+/** Run `fn` on a single thread, or using all threads when `use_threading` is set. */
+template<typename Fn> static void run_threaded(const bool use_threading, const Fn &fn)
+{
+#ifdef WITH_TBB
+  tbb::task_arena arena(use_threading ? tbb::task_arena::automatic : 1);
+  arena.execute(fn);
+#else
+  UNUSED_VARS(use_threading);
+  fn();
+#endif
+}
+
+/** A grid of `size` x `size` quads with a float attribute on vertices, to copy custom data. */
+static Mesh *create_grid_mesh(const int size)
+{
+  Mesh *mesh = bke::tests::mesh_grid_create(size);
+  float *weights = (float *)CustomData_add_layer_named(
+      &mesh->vdata, CD_PROP_FLOAT, CD_CALLOC, nullptr, mesh->totvert, "weight");
+  for (int i = 0; i < mesh->totvert; i++) {
+    weights[i] = i * 0.5f;
+  }
+  return mesh;
+}
+
+static void convert_benchmark(const Mesh *mesh, const bool use_threading)
+{
+  double time_from_mesh = 0.0;
+  double time_to_mesh = 0.0;
+
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    const BMAllocTemplate allocsize = BMALLOC_TEMPLATE_FROM_ME(mesh);
+    BMeshCreateParams create_params{};
+    BMesh *bm = BM_mesh_create(&allocsize, &create_params);
+    Mesh *result = BKE_mesh_new_nomain(0, 0, 0, 0, 0);
+
+    double time_start = PIL_check_seconds_timer();
+    run_threaded(use_threading, [&]() {
+      BMeshFromMeshParams convert_params{};
+      convert_params.calc_face_normal = true;
+      BM_mesh_bm_from_me(bm, mesh, &convert_params);
+    });
+    time_from_mesh += PIL_check_seconds_timer() - time_start;
+
+    time_start = PIL_check_seconds_timer();
+    run_threaded(use_threading, [&]() {
+      BMeshToMeshParams convert_params{};
+      BM_mesh_bm_to_me(nullptr, bm, result, &convert_params);
+    });
+    time_to_mesh += PIL_check_seconds_timer() - time_start;
+
+    BM_mesh_free(bm);
+    BKE_id_free(nullptr, result);
+  }
+
+  printf("%s: Mesh to BMesh %.3f ms, BMesh to Mesh %.3f ms\n",
+         use_threading ? "Parallel" : "Serial",
+         time_from_mesh * 1000.0 / NUM_RUN_AVERAGED,
+         time_to_mesh * 1000.0 / NUM_RUN_AVERAGED);
+}
+
+static void convert_benchmark_grid(const int size)
+{
+  Mesh *mesh = create_grid_mesh(size);
+  printf("Grid %dx%d (%d faces), averaged over %d runs:\n",
+         size,
+         size,
+         mesh->totpoly,
+         NUM_RUN_AVERAGED);
+  convert_benchmark(mesh, false);
+  convert_benchmark(mesh, true);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(BMeshConvertPerformanceTest, Grid256)
+{
+  convert_benchmark_grid(256);
+}
+
+TEST_F(BMeshConvertPerformanceTest, Grid512)
+{
+  convert_benchmark_grid(512);
+}
+
+TEST_F(BMeshConvertPerformanceTest, Grid1024)
+{
+  convert_benchmark_grid(1024);
+}
+
+}  // namespace blender::bmesh::tests
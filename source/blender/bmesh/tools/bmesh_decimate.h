@@ -33,6 +33,7 @@
  * - Vertex normals are maintained while decimating,
  *   although they won't necessarily match the final recalculated normals.
  * - Face normals are not maintained at all.
+ * - See #BM_mesh_decimate_collapse_ex to decimate large meshes in parallel.
  */
 void BM_mesh_decimate_collapse(BMesh *bm,
                                float factor,
@@ -41,6 +42,19 @@ void BM_mesh_decimate_collapse(BMesh *bm,
                                bool do_triangulate,
                                int symmetry_axis,
                                float symmetry_eps);
+/**
+ * \param use_parallel: Decimate spatial partitions of large meshes in parallel,
+ * edges on the borders between partitions are decimated afterwards.
+ * Results differ from (but are of similar quality to) the serial version.
+ */
+void BM_mesh_decimate_collapse_ex(BMesh *bm,
+                                  float factor,
+                                  float *vweights,
+                                  float vweight_factor,
+                                  bool do_triangulate,
+                                  int symmetry_axis,
+                                  float symmetry_eps,
+                                  bool use_parallel);
 
 /**
  * \param tag_only: so we can call this from an operator */
@@ -27,11 +27,14 @@
 #include "BLI_alloca.h"
 #include "BLI_heap.h"
 #include "BLI_linklist.h"
+#include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_polyfill_2d.h"
 #include "BLI_polyfill_2d_beautify.h"
 #include "BLI_quadric.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines_stack.h"
 
 #include "BKE_customdata.h"
@@ -67,37 +70,138 @@
 #define OPTIMIZE_EPS 1e-8
 #define COST_INVALID FLT_MAX
 
+/**
+ * Parallel decimation splits the mesh into slabs holding (roughly) this many faces each,
+ * the partitioning doesn't depend on the number of threads so results are repeatable.
+ */
+#define PARTITION_FACE_TOT (1 << 15)
+#define PARTITION_MAX 64
+/** Resolution of the histogram used to find slab boundaries with similar vertex counts. */
+#define PARTITION_HISTOGRAM_RES 4096
+
 typedef enum CD_UseFlag {
   CD_DO_VERT = (1 << 0),
   CD_DO_EDGE = (1 << 1),
   CD_DO_LOOP = (1 << 2),
 } CD_UseFlag;
 
+/**
+ * A spatial slab of the mesh, decimated on its own heap in parallel with the other partitions.
+ *
+ * Only edges whose vertices (and their neighbors) all belong to the partition may be collapsed,
+ * so partitions never read or write each others geometry. Edges on the borders between
+ * partitions are left for a final (serial) pass over the whole mesh.
+ */
+typedef struct DecimPartition {
+  int index;
+  /** Vertex index aligned partitions, -1 for vertices with neighbors in other partitions. */
+  const int *vert_partition;
+  /** Edge index aligned partitions, -1 for edges not fully inside a partition. */
+  const int *edge_partition;
+  /** Element pools are shared, topology changes are serialized using this lock. */
+  SpinLock *bm_lock;
+
+  /** Edges of this partition (a slice of an array shared by all partitions). */
+  BMEdge **edges;
+  int edges_len;
+
+  /** Number of faces fully inside this partition, decremented while collapsing. */
+  int face_tot;
+  int face_tot_target;
+} DecimPartition;
+
 /* BMesh Helper Functions
  * ********************** */
 
+static void bm_decim_face_quadric(const BMFace *f, Quadric *r_q)
+{
+  float center[3];
+  double plane_db[4];
+
+  BM_face_calc_center_median(f, center);
+  copy_v3db_v3fl(plane_db, f->no);
+  plane_db[3] = -dot_v3db_v3fl(plane_db, center);
+
+  BLI_quadric_from_plane(r_q, plane_db);
+}
+
+/**
+ * \return false when the boundary edge is degenerate and adds nothing.
+ */
+static bool bm_decim_edge_boundary_quadric(const BMEdge *e, Quadric *r_q)
+{
+  float edge_vector[3];
+  float edge_plane[3];
+  double edge_plane_db[4];
+  sub_v3_v3v3(edge_vector, e->v2->co, e->v1->co);
+
+  cross_v3_v3v3(edge_plane, edge_vector, e->l->f->no);
+  copy_v3db_v3fl(edge_plane_db, edge_plane);
+
+  if (normalize_v3_db(edge_plane_db) > (double)FLT_EPSILON) {
+    float center[3];
+
+    mid_v3_v3v3(center, e->v1->co, e->v2->co);
+
+    edge_plane_db[3] = -dot_v3db_v3fl(edge_plane_db, center);
+    BLI_quadric_from_plane(r_q, edge_plane_db);
+    BLI_quadric_mul(r_q, BOUNDARY_PRESERVE_WEIGHT);
+    return true;
+  }
+  return false;
+}
+
+static void bm_decim_build_quadrics_vert_cb(void *userdata,
+                                            MempoolIterData *iter,
+                                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  Quadric *vquadrics = userdata;
+  BMVert *v = (BMVert *)iter;
+  Quadric *q_vert = &vquadrics[BM_elem_index_get(v)];
+  BMIter liter;
+  BMLoop *l;
+  BMIter eiter;
+  BMEdge *e;
+
+  BM_ITER_ELEM (l, &liter, v, BM_LOOPS_OF_VERT) {
+    Quadric q;
+    bm_decim_face_quadric(l->f, &q);
+    BLI_quadric_add_qu_qu(q_vert, &q);
+  }
+
+  /* boundary edges */
+  BM_ITER_ELEM (e, &eiter, v, BM_EDGES_OF_VERT) {
+    Quadric q;
+    if (UNLIKELY(BM_edge_is_boundary(e)) && bm_decim_edge_boundary_quadric(e, &q)) {
+      BLI_quadric_add_qu_qu(q_vert, &q);
+    }
+  }
+}
+
 /**
  * \param vquadrics: must be calloc'd
+ * \param use_threading: Accumulate the quadrics per vertex in parallel,
+ * this sums them in a different order so results differ slightly from the serial version.
  */
-static void bm_decim_build_quadrics(BMesh *bm, Quadric *vquadrics)
+static void bm_decim_build_quadrics(BMesh *bm, Quadric *vquadrics, const bool use_threading)
 {
   BMIter iter;
   BMFace *f;
   BMEdge *e;
 
+  if (use_threading) {
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    BM_iter_parallel(bm, BM_VERTS_OF_MESH, bm_decim_build_quadrics_vert_cb, vquadrics, &settings);
+    return;
+  }
+
   BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
     BMLoop *l_first;
     BMLoop *l_iter;
-
-    float center[3];
-    double plane_db[4];
     Quadric q;
 
-    BM_face_calc_center_median(f, center);
-    copy_v3db_v3fl(plane_db, f->no);
-    plane_db[3] = -dot_v3db_v3fl(plane_db, center);
-
-    BLI_quadric_from_plane(&q, plane_db);
+    bm_decim_face_quadric(f, &q);
 
     l_iter = l_first = BM_FACE_FIRST_LOOP(f);
     do {
@@ -108,25 +212,8 @@ static void bm_decim_build_quadrics(BMesh *bm, Quadric *vquadrics)
   /* boundary edges */
   BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
     if (UNLIKELY(BM_edge_is_boundary(e))) {
-      float edge_vector[3];
-      float edge_plane[3];
-      double edge_plane_db[4];
-      sub_v3_v3v3(edge_vector, e->v2->co, e->v1->co);
-      f = e->l->f;
-
-      cross_v3_v3v3(edge_plane, edge_vector, f->no);
-      copy_v3db_v3fl(edge_plane_db, edge_plane);
-
-      if (normalize_v3_db(edge_plane_db) > (double)FLT_EPSILON) {
-        Quadric q;
-        float center[3];
-
-        mid_v3_v3v3(center, e->v1->co, e->v2->co);
-
-        edge_plane_db[3] = -dot_v3db_v3fl(edge_plane_db, center);
-        BLI_quadric_from_plane(&q, edge_plane_db);
-        BLI_quadric_mul(&q, BOUNDARY_PRESERVE_WEIGHT);
-
+      Quadric q;
+      if (bm_decim_edge_boundary_quadric(e, &q)) {
         BLI_quadric_add_qu_qu(&vquadrics[BM_elem_index_get(e->v1)], &q);
         BLI_quadric_add_qu_qu(&vquadrics[BM_elem_index_get(e->v2)], &q);
       }
@@ -349,11 +436,11 @@ static void bm_decim_build_edge_cost(BMesh *bm,
 {
   BMIter iter;
   BMEdge *e;
-  uint i;
 
-  BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
-    /* keep sanity check happy */
-    eheap_table[i] = NULL;
+  BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+    /* Keep sanity check happy, edges may have been collapsed (leaving gaps in the indices)
+     * when the table is built after parallel decimation. */
+    eheap_table[BM_elem_index_get(e)] = NULL;
     bm_decim_build_edge_cost_single(e, vquadrics, vweights, vweight_factor, eheap, eheap_table);
   }
 }
@@ -934,6 +1021,22 @@ static bool bm_edge_collapse_is_degenerate_topology(BMEdge *e_first)
   return false;
 }
 
+#ifdef USE_SYMMETRY
+/**
+ * Check the mirror of edge \a e_index can be updated, while decimating a partition
+ * a stale mirror index is harmless (it's only used to find a heap node that was removed),
+ * writing to the mirror of an edge outside the partition is not.
+ */
+BLI_INLINE bool bm_edge_symmetry_map_test(const int *edge_symmetry_map,
+                                          const int e_index,
+                                          const DecimPartition *part)
+{
+  const int e_index_mirr = edge_symmetry_map[e_index];
+  return (e_index_mirr != -1) &&
+         ((part == NULL) || (part->edge_partition[e_index_mirr] == part->index));
+}
+#endif
+
 /**
  * Special, highly limited edge collapse function
  * intended for speed over flexibility.
@@ -943,6 +1046,7 @@ static bool bm_edge_collapse_is_degenerate_topology(BMEdge *e_first)
  *
  * \param r_e_clear_other: Let caller know what edges we remove besides \a e_clear
  * \param customdata_flag: Merge factor, scales from 0 - 1 ('v_clear' -> 'v_other')
+ * \param part: When decimating a partition, mirror edges outside of it are left untouched.
  */
 static bool bm_edge_collapse(BMesh *bm,
                              BMEdge *e_clear,
@@ -950,6 +1054,7 @@ static bool bm_edge_collapse(BMesh *bm,
                              int r_e_clear_other[2],
 #ifdef USE_SYMMETRY
                              int *edge_symmetry_map,
+                             const DecimPartition *part,
 #endif
 #ifdef USE_CUSTOMDATA
                              const CD_UseFlag customdata_flag,
@@ -1044,10 +1149,10 @@ static bool bm_edge_collapse(BMesh *bm,
 #ifdef USE_SYMMETRY
     /* update mirror map */
     if (edge_symmetry_map) {
-      if (edge_symmetry_map[r_e_clear_other[0]] != -1) {
+      if (bm_edge_symmetry_map_test(edge_symmetry_map, r_e_clear_other[0], part)) {
         edge_symmetry_map[edge_symmetry_map[r_e_clear_other[0]]] = BM_elem_index_get(e_a_other[1]);
       }
-      if (edge_symmetry_map[r_e_clear_other[1]] != -1) {
+      if (bm_edge_symmetry_map_test(edge_symmetry_map, r_e_clear_other[1], part)) {
         edge_symmetry_map[edge_symmetry_map[r_e_clear_other[1]]] = BM_elem_index_get(e_b_other[1]);
       }
     }
@@ -1103,7 +1208,7 @@ static bool bm_edge_collapse(BMesh *bm,
 #ifdef USE_SYMMETRY
     /* update mirror map */
     if (edge_symmetry_map) {
-      if (edge_symmetry_map[r_e_clear_other[0]] != -1) {
+      if (bm_edge_symmetry_map_test(edge_symmetry_map, r_e_clear_other[0], part)) {
         edge_symmetry_map[edge_symmetry_map[r_e_clear_other[0]]] = BM_elem_index_get(e_a_other[1]);
       }
     }
@@ -1119,6 +1224,7 @@ static bool bm_edge_collapse(BMesh *bm,
 /**
  * Collapse e the edge, removing e->v2
  *
+ * \param part: The partition being decimated or NULL when decimating the whole mesh.
  * \return true when the edge was collapsed.
  */
 static bool bm_decim_edge_collapse(BMesh *bm,
@@ -1133,7 +1239,8 @@ static bool bm_decim_edge_collapse(BMesh *bm,
 #endif
                                    const CD_UseFlag customdata_flag,
                                    float optimize_co[3],
-                                   bool optimize_co_calc)
+                                   bool optimize_co_calc,
+                                   DecimPartition *part)
 {
   int e_clear_other[2];
   BMVert *v_other = e->v1;
@@ -1181,15 +1288,31 @@ static bool bm_decim_edge_collapse(BMesh *bm,
     customdata_fac = 0.5f;
   }
 
-  if (bm_edge_collapse(bm,
-                       e,
-                       e->v2,
-                       e_clear_other,
+  /* Element pools are shared between partitions. */
+  int face_tot_prev = 0;
+  if (part) {
+    BLI_spin_lock(part->bm_lock);
+    face_tot_prev = bm->totface;
+  }
+
+  const bool collapsed = bm_edge_collapse(bm,
+                                         e,
+                                         e->v2,
+                                         e_clear_other,
 #ifdef USE_SYMMETRY
-                       edge_symmetry_map,
+                                         edge_symmetry_map,
+                                         part,
 #endif
-                       customdata_flag,
-                       customdata_fac)) {
+                                         customdata_flag,
+                                         customdata_fac);
+
+  if (part) {
+    /* Only faces inside the partition can be removed here. */
+    part->face_tot -= face_tot_prev - bm->totface;
+    BLI_spin_unlock(part->bm_lock);
+  }
+
+  if (collapsed) {
     /* update collapse info */
     int i;
 
@@ -1274,16 +1397,477 @@ static bool bm_decim_edge_collapse(BMesh *bm,
   return false;
 }
 
+static bool bm_decim_partition_vert_is_interior(const DecimPartition *part, BMVert *v)
+{
+  /* Check the vertex itself first, the disk cycle of border vertices may be changed
+   * by other partitions. */
+  if (part->vert_partition[BM_elem_index_get(v)] != part->index) {
+    return false;
+  }
+  if (v->e) {
+    BMEdge *e_iter, *e_first;
+    e_iter = e_first = v->e;
+    do {
+      BMVert *v_other = BM_edge_other_vert(e_iter, v);
+      if (part->vert_partition[BM_elem_index_get(v_other)] != part->index) {
+        return false;
+      }
+    } while ((e_iter = bmesh_disk_edge_next(e_iter, v)) != e_first);
+  }
+  return true;
+}
+
+/**
+ * Collapsing \a e may only read and write geometry of this partition,
+ * this is the case when both vertices and all of their neighbors are inside it.
+ */
+static bool bm_decim_partition_edge_is_interior(const DecimPartition *part, BMEdge *e)
+{
+  return (bm_decim_partition_vert_is_interior(part, e->v1) &&
+          bm_decim_partition_vert_is_interior(part, e->v2));
+}
+
+#ifdef USE_SYMMETRY
+/**
+ * Collapse \a e (already popped from \a eheap) together with its mirror edge.
+ *
+ * \note
+ * - `eheap_table[e_index_mirr]` is only removed from the heap at the last moment
+ *   since its possible (in theory) for collapsing `e` to remove `e_mirr`.
+ * - edges sharing a vertex are ignored, so the pivot vertex isn't moved to one side.
+ */
+static void bm_decim_edge_collapse_symmetric(BMesh *bm,
+                                             BMEdge *e,
+                                             Quadric *vquadrics,
+                                             float *vweights,
+                                             const float vweight_factor,
+                                             Heap *eheap,
+                                             HeapNode **eheap_table,
+                                             int *edge_symmetry_map,
+                                             const int symmetry_axis,
+                                             const CD_UseFlag customdata_flag,
+                                             DecimPartition *part)
+{
+  const int e_index = BM_elem_index_get(e);
+  const int e_index_mirr = edge_symmetry_map[e_index];
+  BMEdge *e_mirr = NULL;
+  float optimize_co[3];
+  char e_invalidate = 0;
+
+  eheap_table[e_index] = NULL;
+
+  if (e_index_mirr != -1) {
+    if (e_index_mirr == e_index) {
+      /* pass */
+    }
+    else if (part && (part->edge_partition[e_index_mirr] != part->index)) {
+      /* The mirror edge belongs to another partition, leave both for the final pass. */
+      e_invalidate |= 1;
+      goto invalidate;
+    }
+    else if (eheap_table[e_index_mirr]) {
+      e_mirr = BLI_heap_node_ptr(eheap_table[e_index_mirr]);
+      /* for now ignore edges with a shared vertex */
+      if (BM_edge_share_vert_check(e, e_mirr)) {
+        /* ignore permanently!
+         * Otherwise we would keep re-evaluating and attempting to collapse. */
+        // e_invalidate |= (1 | 2);
+        goto invalidate;
+      }
+      if (part && !bm_decim_partition_edge_is_interior(part, e_mirr)) {
+        e_invalidate |= 1;
+        goto invalidate;
+      }
+    }
+    else {
+      /* mirror edge can't be operated on (happens with asymmetrical meshes) */
+      e_invalidate |= 1;
+      goto invalidate;
+    }
+  }
+
+  /* when false, use without degenerate checks */
+  {
+    /* run both before checking (since they invalidate surrounding geometry) */
+    bool ok_a, ok_b;
+
+    ok_a = !bm_edge_collapse_is_degenerate_topology(e);
+    ok_b = e_mirr ? !bm_edge_collapse_is_degenerate_topology(e_mirr) : true;
+
+    /* disallow collapsing which results in degenerate cases */
+
+    if (UNLIKELY(!ok_a || !ok_b)) {
+      e_invalidate |= (1 | (e_mirr ? 2 : 0));
+      goto invalidate;
+    }
+
+    bm_decim_calc_target_co_fl(e, optimize_co, vquadrics);
+
+    if (e_index_mirr == e_index) {
+      optimize_co[symmetry_axis] = 0.0f;
+    }
+
+    /* check if this would result in an overlapping face */
+    if (UNLIKELY(bm_edge_collapse_is_degenerate_flip(e, optimize_co))) {
+      e_invalidate |= (1 | (e_mirr ? 2 : 0));
+      goto invalidate;
+    }
+  }
+
+  if (bm_decim_edge_collapse(bm,
+                             e,
+                             vquadrics,
+                             vweights,
+                             vweight_factor,
+                             eheap,
+                             eheap_table,
+                             edge_symmetry_map,
+                             customdata_flag,
+                             optimize_co,
+                             false,
+                             part)) {
+    if (e_mirr && (eheap_table[e_index_mirr])) {
+      BLI_assert(e_index_mirr != e_index);
+      BLI_heap_remove(eheap, eheap_table[e_index_mirr]);
+      eheap_table[e_index_mirr] = NULL;
+      optimize_co[symmetry_axis] *= -1.0f;
+      bm_decim_edge_collapse(bm,
+                             e_mirr,
+                             vquadrics,
+                             vweights,
+                             vweight_factor,
+                             eheap,
+                             eheap_table,
+                             edge_symmetry_map,
+                             customdata_flag,
+                             optimize_co,
+                             false,
+                             part);
+    }
+  }
+  else {
+    if (e_mirr && (eheap_table[e_index_mirr])) {
+      e_invalidate |= 2;
+      goto invalidate;
+    }
+  }
+
+  BLI_assert(e_invalidate == 0);
+  return;
+
+invalidate:
+  if (e_invalidate & 1) {
+    bm_decim_invalid_edge_cost_single(e, eheap, eheap_table);
+  }
+
+  if (e_invalidate & 2) {
+    BLI_assert(eheap_table[e_index_mirr] != NULL);
+    BLI_heap_remove(eheap, eheap_table[e_index_mirr]);
+    eheap_table[e_index_mirr] = NULL;
+    bm_decim_invalid_edge_cost_single(e_mirr, eheap, eheap_table);
+  }
+}
+#endif /* USE_SYMMETRY */
+
+/* Parallel Decimation
+ * ******************* */
+
+typedef struct DecimPartitions {
+  DecimPartition *partitions;
+  int partitions_len;
+
+  /** Vertex index aligned partitions including border vertices, only used for initializing. */
+  int *vert_partition_all;
+  int *vert_partition;
+  int *edge_partition;
+  BMEdge **edges;
+
+  SpinLock bm_lock;
+} DecimPartitions;
+
+static void bm_decim_partitions_vert_border_cb(void *userdata,
+                                               MempoolIterData *iter,
+                                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  DecimPartitions *partitions = userdata;
+  BMVert *v = (BMVert *)iter;
+  const int v_index = BM_elem_index_get(v);
+  const int v_partition = partitions->vert_partition_all[v_index];
+
+  partitions->vert_partition[v_index] = v_partition;
+  if (v->e) {
+    BMEdge *e_iter, *e_first;
+    e_iter = e_first = v->e;
+    do {
+      BMVert *v_other = BM_edge_other_vert(e_iter, v);
+      if (partitions->vert_partition_all[BM_elem_index_get(v_other)] != v_partition) {
+        partitions->vert_partition[v_index] = -1;
+        break;
+      }
+    } while ((e_iter = bmesh_disk_edge_next(e_iter, v)) != e_first);
+  }
+}
+
+/**
+ * Split the (triangulated) mesh into slabs along its longest axis,
+ * each holding a similar number of vertices.
+ *
+ * \param symmetry_axis: Never split along this axis, so mirrored edges end up in one partition.
+ * \return false when the mesh is too small to be split.
+ */
+static bool bm_decim_partitions_init(BMesh *bm,
+                                     const float factor,
+                                     const int symmetry_axis,
+                                     DecimPartitions *partitions)
+{
+  const int partitions_len = min_ii(bm->totface / PARTITION_FACE_TOT, PARTITION_MAX);
+  BMIter iter;
+  BMVert *v;
+  BMEdge *e;
+  BMFace *f;
+  int i;
+
+  memset(partitions, 0, sizeof(*partitions));
+  if (partitions_len < 2) {
+    return false;
+  }
+
+  /* Find the axis to split along. */
+  float min[3], max[3];
+  INIT_MINMAX(min, max);
+  BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+    minmax_v3v3_v3(min, max, v->co);
+  }
+  float size[3];
+  sub_v3_v3v3(size, max, min);
+  if (symmetry_axis != -1) {
+    size[symmetry_axis] = 0.0f;
+  }
+  const int axis = axis_dominant_v3_single(size);
+  if (size[axis] <= 0.0f) {
+    return false;
+  }
+
+  /* Histogram of vertex positions, used to place slab boundaries. */
+  int *vert_partition_all = MEM_mallocN(sizeof(*vert_partition_all) * (size_t)bm->totvert,
+                                        __func__);
+  int *histogram = MEM_callocN(sizeof(*histogram) * PARTITION_HISTOGRAM_RES, __func__);
+  const float histogram_scale = (float)PARTITION_HISTOGRAM_RES / size[axis];
+
+  BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+    const int bin = clamp_i(
+        (int)((v->co[axis] - min[axis]) * histogram_scale), 0, PARTITION_HISTOGRAM_RES - 1);
+    /* Temporarily store the bin, converted to a partition below. */
+    vert_partition_all[i] = bin;
+    histogram[bin]++;
+  }
+
+  /* Convert bins to partitions (in place). */
+  int vert_tot = 0;
+  for (int bin = 0; bin < PARTITION_HISTOGRAM_RES; bin++) {
+    const int bin_vert_tot = histogram[bin];
+    histogram[bin] = (int)(((int64_t)vert_tot * partitions_len) / bm->totvert);
+    vert_tot += bin_vert_tot;
+  }
+  for (i = 0; i < bm->totvert; i++) {
+    vert_partition_all[i] = histogram[vert_partition_all[i]];
+  }
+  MEM_freeN(histogram);
+
+  partitions->partitions_len = partitions_len;
+  partitions->partitions = MEM_callocN(sizeof(*partitions->partitions) * (size_t)partitions_len,
+                                       __func__);
+  partitions->vert_partition_all = vert_partition_all;
+  partitions->vert_partition = MEM_mallocN(sizeof(*partitions->vert_partition) *
+                                               (size_t)bm->totvert,
+                                           __func__);
+  partitions->edge_partition = MEM_mallocN(sizeof(*partitions->edge_partition) *
+                                               (size_t)bm->totedge,
+                                           __func__);
+  partitions->edges = MEM_mallocN(sizeof(*partitions->edges) * (size_t)bm->totedge, __func__);
+  BLI_spin_init(&partitions->bm_lock);
+
+  /* Vertices connected to other partitions can't be touched while decimating in parallel. */
+  {
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    BM_iter_parallel(
+        bm, BM_VERTS_OF_MESH, bm_decim_partitions_vert_border_cb, partitions, &settings);
+  }
+  MEM_freeN(partitions->vert_partition_all);
+  partitions->vert_partition_all = NULL;
+  const int *vert_partition = partitions->vert_partition;
+
+  BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
+    const int v1_partition = vert_partition[BM_elem_index_get(e->v1)];
+    const int v2_partition = vert_partition[BM_elem_index_get(e->v2)];
+    const int e_partition = (v1_partition == v2_partition) ? v1_partition : -1;
+    partitions->edge_partition[i] = e_partition;
+    if (e_partition != -1) {
+      partitions->partitions[e_partition].edges_len++;
+    }
+  }
+
+  BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+    BMLoop *l_iter, *l_first;
+    const int f_partition = vert_partition[BM_elem_index_get(BM_FACE_FIRST_LOOP(f)->v)];
+    if (f_partition == -1) {
+      continue;
+    }
+    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+    while (((l_iter = l_iter->next) != l_first) &&
+           (vert_partition[BM_elem_index_get(l_iter->v)] == f_partition)) {
+      /* pass */
+    }
+    if (l_iter == l_first) {
+      partitions->partitions[f_partition].face_tot++;
+    }
+  }
+
+  int edges_offset = 0;
+  for (i = 0; i < partitions_len; i++) {
+    DecimPartition *part = &partitions->partitions[i];
+    part->index = i;
+    part->vert_partition = partitions->vert_partition;
+    part->edge_partition = partitions->edge_partition;
+    part->bm_lock = &partitions->bm_lock;
+    part->edges = &partitions->edges[edges_offset];
+    part->face_tot_target = (int)((float)part->face_tot * factor);
+    edges_offset += part->edges_len;
+    /* Used as a counter while filling in the edges. */
+    part->edges_len = 0;
+  }
+
+  BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
+    const int e_partition = partitions->edge_partition[i];
+    if (e_partition != -1) {
+      DecimPartition *part = &partitions->partitions[e_partition];
+      part->edges[part->edges_len++] = e;
+    }
+  }
+
+  return true;
+}
+
+static void bm_decim_partitions_free(DecimPartitions *partitions)
+{
+  MEM_freeN(partitions->partitions);
+  MEM_freeN(partitions->vert_partition);
+  MEM_freeN(partitions->edge_partition);
+  MEM_freeN(partitions->edges);
+  BLI_spin_end(&partitions->bm_lock);
+}
+
+typedef struct DecimPartitionTaskData {
+  BMesh *bm;
+  DecimPartitions *partitions;
+  Quadric *vquadrics;
+  float *vweights;
+  float vweight_factor;
+  HeapNode **eheap_table;
+#ifdef USE_SYMMETRY
+  int *edge_symmetry_map;
+  int symmetry_axis;
+#endif
+  CD_UseFlag customdata_flag;
+} DecimPartitionTaskData;
+
+static void bm_decim_partition_collapse_cb(void *__restrict userdata,
+                                           const int index,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  DecimPartitionTaskData *data = userdata;
+  DecimPartition *part = &data->partitions->partitions[index];
+  HeapNode **eheap_table = data->eheap_table;
+  Heap *eheap = BLI_heap_new_ex((uint)part->edges_len);
+
+  for (int i = 0; i < part->edges_len; i++) {
+    bm_decim_build_edge_cost_single(
+        part->edges[i], data->vquadrics, data->vweights, data->vweight_factor, eheap, eheap_table);
+  }
+
+  while ((part->face_tot > part->face_tot_target) && (BLI_heap_is_empty(eheap) == false) &&
+         (BLI_heap_top_value(eheap) != COST_INVALID)) {
+    BMEdge *e = BLI_heap_pop_min(eheap);
+    eheap_table[BM_elem_index_get(e)] = NULL;
+
+    /* Edges near other partitions are left for the final pass over the whole mesh. */
+    if (!bm_decim_partition_edge_is_interior(part, e)) {
+      continue;
+    }
+
+#ifdef USE_SYMMETRY
+    if (data->edge_symmetry_map) {
+      bm_decim_edge_collapse_symmetric(data->bm,
+                                       e,
+                                       data->vquadrics,
+                                       data->vweights,
+                                       data->vweight_factor,
+                                       eheap,
+                                       eheap_table,
+                                       data->edge_symmetry_map,
+                                       data->symmetry_axis,
+                                       data->customdata_flag,
+                                       part);
+      continue;
+    }
+#endif
+
+    float optimize_co[3];
+    bm_decim_edge_collapse(data->bm,
+                           e,
+                           data->vquadrics,
+                           data->vweights,
+                           data->vweight_factor,
+                           eheap,
+                           eheap_table,
+#ifdef USE_SYMMETRY
+                           NULL,
+#endif
+                           data->customdata_flag,
+                           optimize_co,
+                           true,
+                           part);
+  }
+
+  /* Edges left in the heap are added again for the final pass. */
+  BLI_heap_free(eheap, NULL);
+}
+
+/**
+ * Move the faces into a new memory pool, keeping their order.
+ *
+ * Partitions free faces in the order they happen to be scheduled in, faces created afterwards
+ * (joining triangles back into quads) would re-use those slots in that order too.
+ * Packing the pool keeps the resulting face order the same for every run.
+ */
+static void bm_decim_faces_repack(BMesh *bm)
+{
+  const BMAllocTemplate allocsize = {0, 0, 0, bm->totface};
+  BLI_mempool *fpool_dst = NULL;
+  BM_mesh_mempool_create(&allocsize, bm->use_toolflags, NULL, NULL, NULL, &fpool_dst);
+
+  BM_mesh_rebuild(bm,
+                  &((struct BMeshCreateParams){
+                      .use_toolflags = bm->use_toolflags,
+                  }),
+                  NULL,
+                  NULL,
+                  NULL,
+                  fpool_dst);
+}
+
 /* Main Decimate Function
  * ********************** */
 
-void BM_mesh_decimate_collapse(BMesh *bm,
-                               const float factor,
-                               float *vweights,
-                               float vweight_factor,
-                               const bool do_triangulate,
-                               const int symmetry_axis,
-                               const float symmetry_eps)
+void BM_mesh_decimate_collapse_ex(BMesh *bm,
+                                  const float factor,
+                                  float *vweights,
+                                  float vweight_factor,
+                                  const bool do_triangulate,
+                                  const int symmetry_axis,
+                                  const float symmetry_eps,
+                                  const bool use_parallel)
 {
   /* edge heap */
   Heap *eheap;
@@ -1296,6 +1880,9 @@ void BM_mesh_decimate_collapse(BMesh *bm,
 
   CD_UseFlag customdata_flag = 0;
 
+  DecimPartitions partitions;
+  bool use_partitions = false;
+
 #ifdef USE_SYMMETRY
   bool use_symmetry = (symmetry_axis != -1);
   int *edge_symmetry_map;
@@ -1311,15 +1898,15 @@ void BM_mesh_decimate_collapse(BMesh *bm,
 
   /* Allocate variables. */
   vquadrics = MEM_callocN(sizeof(Quadric) * bm->totvert, __func__);
-  /* Since some edges may be degenerate, we might be over allocating a little here. */
-  eheap = BLI_heap_new_ex(bm->totedge);
-  eheap_table = MEM_mallocN(sizeof(HeapNode *) * bm->totedge, __func__);
+  eheap_table = MEM_callocN(sizeof(HeapNode *) * bm->totedge, __func__);
   tot_edge_orig = bm->totedge;
 
-  /* build initial edge collapse cost data */
-  bm_decim_build_quadrics(bm, vquadrics);
+  if (use_parallel) {
+    use_partitions = bm_decim_partitions_init(bm, factor, symmetry_axis, &partitions);
+  }
 
-  bm_decim_build_edge_cost(bm, vquadrics, vweights, vweight_factor, eheap, eheap_table);
+  /* build initial edge collapse cost data */
+  bm_decim_build_quadrics(bm, vquadrics, use_partitions);
 
   face_tot_target = bm->totface * factor;
   bm->elem_index_dirty |= BM_ALL;
@@ -1344,6 +1931,40 @@ void BM_mesh_decimate_collapse(BMesh *bm,
   }
 #endif
 
+  if (use_partitions) {
+    /* Decimate the inside of all partitions in parallel, the remaining edges
+     * (mostly on the borders between partitions) are handled below. */
+    DecimPartitionTaskData data = {
+        .bm = bm,
+        .partitions = &partitions,
+        .vquadrics = vquadrics,
+        .vweights = vweights,
+        .vweight_factor = vweight_factor,
+        .eheap_table = eheap_table,
+#ifdef USE_SYMMETRY
+        .edge_symmetry_map = edge_symmetry_map,
+        .symmetry_axis = symmetry_axis,
+#endif
+        .customdata_flag = customdata_flag,
+    };
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(
+        0, partitions.partitions_len, &data, bm_decim_partition_collapse_cb, &settings);
+
+    bm_decim_partitions_free(&partitions);
+
+    /* The partition heaps have been freed. */
+    memset(eheap_table, 0, sizeof(*eheap_table) * tot_edge_orig);
+
+    bm_decim_faces_repack(bm);
+  }
+
+  /* Since some edges may be degenerate, we might be over allocating a little here. */
+  eheap = BLI_heap_new_ex(bm->totedge);
+  bm_decim_build_edge_cost(bm, vquadrics, vweights, vweight_factor, eheap, eheap_table);
+
   /* iterative edge collapse and maintain the eheap */
 #ifdef USE_SYMMETRY
   if (use_symmetry == false)
@@ -1374,130 +1995,29 @@ void BM_mesh_decimate_collapse(BMesh *bm,
 #endif
                              customdata_flag,
                              optimize_co,
-                             true);
+                             true,
+                             NULL);
     }
   }
 #ifdef USE_SYMMETRY
   else {
     while ((bm->totface > face_tot_target) && (BLI_heap_is_empty(eheap) == false) &&
            (BLI_heap_top_value(eheap) != COST_INVALID)) {
-      /**
-       * \note
-       * - `eheap_table[e_index_mirr]` is only removed from the heap at the last moment
-       *   since its possible (in theory) for collapsing `e` to remove `e_mirr`.
-       * - edges sharing a vertex are ignored, so the pivot vertex isn't moved to one side.
-       */
-
       BMEdge *e = BLI_heap_pop_min(eheap);
-      const int e_index = BM_elem_index_get(e);
-      const int e_index_mirr = edge_symmetry_map[e_index];
-      BMEdge *e_mirr = NULL;
-      float optimize_co[3];
-      char e_invalidate = 0;
-
-      BLI_assert(e_index < tot_edge_orig);
-
-      eheap_table[e_index] = NULL;
 
-      if (e_index_mirr != -1) {
-        if (e_index_mirr == e_index) {
-          /* pass */
-        }
-        else if (eheap_table[e_index_mirr]) {
-          e_mirr = BLI_heap_node_ptr(eheap_table[e_index_mirr]);
-          /* for now ignore edges with a shared vertex */
-          if (BM_edge_share_vert_check(e, e_mirr)) {
-            /* ignore permanently!
-             * Otherwise we would keep re-evaluating and attempting to collapse. */
-            // e_invalidate |= (1 | 2);
-            goto invalidate;
-          }
-        }
-        else {
-          /* mirror edge can't be operated on (happens with asymmetrical meshes) */
-          e_invalidate |= 1;
-          goto invalidate;
-        }
-      }
-
-      /* when false, use without degenerate checks */
-      {
-        /* run both before checking (since they invalidate surrounding geometry) */
-        bool ok_a, ok_b;
-
-        ok_a = !bm_edge_collapse_is_degenerate_topology(e);
-        ok_b = e_mirr ? !bm_edge_collapse_is_degenerate_topology(e_mirr) : true;
-
-        /* disallow collapsing which results in degenerate cases */
-
-        if (UNLIKELY(!ok_a || !ok_b)) {
-          e_invalidate |= (1 | (e_mirr ? 2 : 0));
-          goto invalidate;
-        }
-
-        bm_decim_calc_target_co_fl(e, optimize_co, vquadrics);
-
-        if (e_index_mirr == e_index) {
-          optimize_co[symmetry_axis] = 0.0f;
-        }
-
-        /* check if this would result in an overlapping face */
-        if (UNLIKELY(bm_edge_collapse_is_degenerate_flip(e, optimize_co))) {
-          e_invalidate |= (1 | (e_mirr ? 2 : 0));
-          goto invalidate;
-        }
-      }
-
-      if (bm_decim_edge_collapse(bm,
-                                 e,
-                                 vquadrics,
-                                 vweights,
-                                 vweight_factor,
-                                 eheap,
-                                 eheap_table,
-                                 edge_symmetry_map,
-                                 customdata_flag,
-                                 optimize_co,
-                                 false)) {
-        if (e_mirr && (eheap_table[e_index_mirr])) {
-          BLI_assert(e_index_mirr != e_index);
-          BLI_heap_remove(eheap, eheap_table[e_index_mirr]);
-          eheap_table[e_index_mirr] = NULL;
-          optimize_co[symmetry_axis] *= -1.0f;
-          bm_decim_edge_collapse(bm,
-                                 e_mirr,
-                                 vquadrics,
-                                 vweights,
-                                 vweight_factor,
-                                 eheap,
-                                 eheap_table,
-                                 edge_symmetry_map,
-                                 customdata_flag,
-                                 optimize_co,
-                                 false);
-        }
-      }
-      else {
-        if (e_mirr && (eheap_table[e_index_mirr])) {
-          e_invalidate |= 2;
-          goto invalidate;
-        }
-      }
-
-      BLI_assert(e_invalidate == 0);
-      continue;
-
-    invalidate:
-      if (e_invalidate & 1) {
-        bm_decim_invalid_edge_cost_single(e, eheap, eheap_table);
-      }
+      BLI_assert(BM_elem_index_get(e) < tot_edge_orig);
 
-      if (e_invalidate & 2) {
-        BLI_assert(eheap_table[e_index_mirr] != NULL);
-        BLI_heap_remove(eheap, eheap_table[e_index_mirr]);
-        eheap_table[e_index_mirr] = NULL;
-        bm_decim_invalid_edge_cost_single(e_mirr, eheap, eheap_table);
-      }
+      bm_decim_edge_collapse_symmetric(bm,
+                                       e,
+                                       vquadrics,
+                                       vweights,
+                                       vweight_factor,
+                                       eheap,
+                                       eheap_table,
+                                       edge_symmetry_map,
+                                       symmetry_axis,
+                                       customdata_flag,
+                                       NULL);
     }
 
     MEM_freeN((void *)edge_symmetry_map);
@@ -1525,3 +2045,15 @@ void BM_mesh_decimate_collapse(BMesh *bm,
   /* quiet release build warning */
   (void)tot_edge_orig;
 }
+
+void BM_mesh_decimate_collapse(BMesh *bm,
+                               const float factor,
+                               float *vweights,
+                               float vweight_factor,
+                               const bool do_triangulate,
+                               const int symmetry_axis,
+                               const float symmetry_eps)
+{
+  BM_mesh_decimate_collapse_ex(
+      bm, factor, vweights, vweight_factor, do_triangulate, symmetry_axis, symmetry_eps, false);
+}
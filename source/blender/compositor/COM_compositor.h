@@ -339,6 +339,11 @@ extern "C" {
  * \param display_settings:
  *   reference to display settings used for color management
  *
+ * \param viewer_region:
+ *   Normalized area of the viewer image visible in editors, may be null. When the node tree
+ *   uses #NTREE_COM_VIEWER_REGION_FIRST, viewers are computed for this area before the full
+ *   execution, so that it's updated as soon as possible.
+ *
  * OCIO_TODO: this options only used in rare cases, namely in output file node,
  *            so probably this settings could be passed in a nicer way.
  *            should be checked further, probably it'll be also needed for preview
@@ -352,7 +357,8 @@ void COM_execute(RenderData *render_data,
                  int rendering,
                  const ColorManagedViewSettings *view_settings,
                  const ColorManagedDisplaySettings *display_settings,
-                 const char *view_name);
+                 const char *view_name,
+                 const rctf *viewer_region);
 
 /**
  * \brief Deinitialize the compositor caches and allocated memory.
@@ -127,4 +127,12 @@ constexpr float COM_BLUR_BOKEH_PIXELS = 512;
 constexpr rcti COM_AREA_NONE = {0, 0, 0, 0};
 constexpr rcti COM_CONSTANT_INPUT_AREA_OF_INTEREST = COM_AREA_NONE;
 
+/** Memory limit of buffers kept across executions for re-using operations results. */
+constexpr size_t COM_BUFFERS_CACHE_MEMORY_LIMIT = size_t(1024) * 1024 * 1024;
+/**
+ * Operations rendering faster than this time (in seconds) are not cached, re-rendering them is
+ * cheaper than the memory they would take.
+ */
+constexpr double COM_BUFFERS_CACHE_MIN_RENDER_TIME = 0.005;
+
 }  // namespace blender::compositor
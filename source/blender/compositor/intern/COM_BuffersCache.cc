@@ -0,0 +1,140 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2022, Blender Foundation.
+ */
+
+#include <algorithm>
+
+#include "BLI_rect.h"
+
+#include "COM_BuffersCache.h"
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor {
+
+BuffersCache::BuffersCache(const size_t memory_limit)
+    : memory_limit_(memory_limit), memory_in_use_(0), execution_(0)
+{
+}
+
+BuffersCache::~BuffersCache()
+{
+  clear();
+}
+
+void BuffersCache::begin_execution()
+{
+  execution_++;
+}
+
+void BuffersCache::end_execution()
+{
+  /* Buffers of the finished execution may be freed too. */
+  execution_++;
+  free_least_recently_used(memory_limit_);
+}
+
+MemoryBuffer *BuffersCache::lookup(const size_t result_hash, Span<rcti> areas)
+{
+  CachedBuffer *cached = buffers_.lookup_ptr(result_hash);
+  if (cached == nullptr) {
+    return nullptr;
+  }
+
+  for (const rcti &area : areas) {
+    if (BLI_rcti_is_empty(&area)) {
+      continue;
+    }
+    const bool is_rendered = std::any_of(
+        cached->render_areas.begin(), cached->render_areas.end(), [&](const rcti &rendered) {
+          return BLI_rcti_inside_rcti(&rendered, &area);
+        });
+    if (!is_rendered) {
+      return nullptr;
+    }
+  }
+
+  cached->last_used_execution = execution_;
+  return cached->buffer.get();
+}
+
+bool BuffersCache::ensure_available_memory(const size_t memory_size)
+{
+  if (memory_size > memory_limit_) {
+    return false;
+  }
+  if (memory_in_use_ + memory_size > memory_limit_) {
+    free_least_recently_used(memory_limit_ - memory_size);
+  }
+  return memory_in_use_ + memory_size <= memory_limit_;
+}
+
+void BuffersCache::add(const size_t result_hash,
+                       std::unique_ptr<MemoryBuffer> buffer,
+                       Span<rcti> render_areas)
+{
+  CachedBuffer *existing = buffers_.lookup_ptr(result_hash);
+  if (existing) {
+    /* May only be replaced when not used in current execution, it could still be read. */
+    BLI_assert(existing->last_used_execution != execution_);
+    memory_in_use_ -= existing->memory_size;
+    buffers_.remove(result_hash);
+  }
+
+  CachedBuffer cached;
+  cached.memory_size = get_buffer_memory_size(*buffer);
+  cached.buffer = std::move(buffer);
+  cached.render_areas.extend(render_areas);
+  cached.last_used_execution = execution_;
+  memory_in_use_ += cached.memory_size;
+  buffers_.add_new(result_hash, std::move(cached));
+}
+
+void BuffersCache::clear()
+{
+  buffers_.clear();
+  memory_in_use_ = 0;
+}
+
+size_t BuffersCache::get_buffer_memory_size(const MemoryBuffer &buffer)
+{
+  return buffer.get_memory_size();
+}
+
+void BuffersCache::free_least_recently_used(const size_t memory_limit)
+{
+  if (memory_in_use_ <= memory_limit) {
+    return;
+  }
+
+  Vector<std::pair<int, size_t>> unused_buffers;
+  for (auto item : buffers_.items()) {
+    if (item.value.last_used_execution != execution_) {
+      unused_buffers.append({item.value.last_used_execution, item.key});
+    }
+  }
+  std::sort(unused_buffers.begin(), unused_buffers.end());
+
+  for (const std::pair<int, size_t> &unused : unused_buffers) {
+    if (memory_in_use_ <= memory_limit) {
+      break;
+    }
+    memory_in_use_ -= buffers_.lookup(unused.second).memory_size;
+    buffers_.remove(unused.second);
+  }
+}
+
+}  // namespace blender::compositor
@@ -0,0 +1,109 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2022, Blender Foundation.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "BLI_map.hh"
+#include "BLI_span.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_vec_types.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+namespace blender::compositor {
+
+class MemoryBuffer;
+
+/**
+ * Keeps operations rendered buffers across executions, identified by the operations result
+ * hashes (see #NodeOperation::generate_result_hash). When a tree is executed again, operations
+ * with an unchanged result hash re-use their cached buffer instead of being rendered, together
+ * with all their input operations.
+ *
+ * Least recently used buffers are freed when exceeding the memory limit. Buffers used in the
+ * current execution are never freed until it ends, as they may still be read.
+ */
+class BuffersCache {
+ private:
+  struct CachedBuffer {
+    std::unique_ptr<MemoryBuffer> buffer;
+    Vector<rcti> render_areas;
+    size_t memory_size;
+    int last_used_execution;
+  };
+  Map<size_t, CachedBuffer> buffers_;
+  size_t memory_limit_;
+  size_t memory_in_use_;
+  int execution_;
+
+ public:
+  BuffersCache(size_t memory_limit);
+  ~BuffersCache();
+
+  /**
+   * Starts a new execution, buffers used from now on are kept until #end_execution.
+   */
+  void begin_execution();
+  /**
+   * Frees least recently used buffers until being within the memory limit.
+   */
+  void end_execution();
+
+  /**
+   * Get the cached buffer of given result hash if it has all given areas rendered, otherwise
+   * nullptr is returned. Returned buffer is owned by the cache and valid until the execution ends.
+   */
+  MemoryBuffer *lookup(size_t result_hash, Span<rcti> areas);
+  /**
+   * Whether a buffer of given size may be cached in current execution without exceeding the
+   * memory limit. Buffers not used in current execution are freed to make room if needed.
+   */
+  bool ensure_available_memory(size_t memory_size);
+  /**
+   * Caches given rendered buffer, replacing any buffer with the same result hash.
+   * \param render_areas: Areas of the buffer that have been rendered.
+   */
+  void add(size_t result_hash, std::unique_ptr<MemoryBuffer> buffer, Span<rcti> render_areas);
+
+  void clear();
+
+  size_t get_memory_in_use() const
+  {
+    return memory_in_use_;
+  }
+
+  static size_t get_buffer_memory_size(const MemoryBuffer &buffer);
+
+ private:
+  /**
+   * Frees least recently used buffers, until given memory limit is met or only buffers used in
+   * current execution remain.
+   */
+  void free_least_recently_used(size_t memory_limit);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:BuffersCache")
+#endif
+};
+
+}  // namespace blender::compositor
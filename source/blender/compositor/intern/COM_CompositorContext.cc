@@ -30,6 +30,7 @@ CompositorContext::CompositorContext()
   view_settings_ = nullptr;
   display_settings_ = nullptr;
   bnodetree_ = nullptr;
+  viewer_region_ = nullptr;
 }
 
 int CompositorContext::get_framenumber() const
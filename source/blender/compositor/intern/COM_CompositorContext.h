@@ -88,6 +88,11 @@ class CompositorContext {
    */
   const char *view_name_;
 
+  /**
+   * Normalized area of the viewer image to compute exclusively, null to compute all outputs.
+   */
+  const rctf *viewer_region_;
+
  public:
   /**
    * \brief constructor initializes the context with default values.
@@ -258,6 +263,20 @@ class CompositorContext {
     view_name_ = view_name;
   }
 
+  void set_viewer_region(const rctf *viewer_region)
+  {
+    viewer_region_ = viewer_region;
+  }
+
+  /**
+   * Get normalized area of the viewer image to compute exclusively. When set, other output
+   * operations are not computed. Only supported by the full frame execution model.
+   */
+  const rctf *get_viewer_region() const
+  {
+    return viewer_region_;
+  }
+
   int get_chunksize() const
   {
     return this->get_bnodetree()->chunksize;
@@ -275,6 +294,10 @@ class CompositorContext {
   {
     return (this->get_bnodetree()->flag & NTREE_COM_GROUPNODE_BUFFER) != 0;
   }
+  bool is_half_float_buffers_enabled() const
+  {
+    return (this->get_bnodetree()->flag & NTREE_COM_HALF_FLOAT_BUFFERS) != 0;
+  }
 
   /**
    * \brief Get the render percentage as a factor.
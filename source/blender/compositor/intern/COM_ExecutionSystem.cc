@@ -40,7 +40,9 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
                                  bool fastcalculation,
                                  const ColorManagedViewSettings *view_settings,
                                  const ColorManagedDisplaySettings *display_settings,
-                                 const char *view_name)
+                                 const char *view_name,
+                                 BuffersCache *buffers_cache,
+                                 const rctf *viewer_region)
 {
   num_work_threads_ = WorkScheduler::get_num_cpu_threads();
   context_.set_view_name(view_name);
@@ -48,6 +50,7 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
   context_.set_bnodetree(editingtree);
   context_.set_preview_hash(editingtree->previews);
   context_.set_fast_calculation(fastcalculation);
+  context_.set_viewer_region(viewer_region);
   /* initialize the CompositorContext */
   if (rendering) {
     context_.set_quality((eCompositorQuality)editingtree->render_quality);
@@ -76,7 +79,8 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
       execution_model_ = new TiledExecutionModel(context_, operations_, groups_);
       break;
     case eExecutionModel::FullFrame:
-      execution_model_ = new FullFrameExecutionModel(context_, active_buffers_, operations_);
+      execution_model_ = new FullFrameExecutionModel(
+          context_, active_buffers_, buffers_cache, operations_);
       break;
     default:
       BLI_assert_msg(0, "Non implemented execution model");
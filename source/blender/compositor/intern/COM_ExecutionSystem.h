@@ -119,6 +119,7 @@ namespace blender::compositor {
  */
 
 /* Forward declarations. */
+class BuffersCache;
 class ExecutionGroup;
 class ExecutionModel;
 class NodeOperation;
@@ -169,6 +170,7 @@ class ExecutionSystem {
    *
    * \param editingtree: [bNodeTree *]
    * \param rendering: [true false]
+   * \param buffers_cache: Buffers kept across executions to re-use results from, may be null.
    */
   ExecutionSystem(RenderData *rd,
                   Scene *scene,
@@ -177,7 +179,9 @@ class ExecutionSystem {
                   bool fastcalculation,
                   const ColorManagedViewSettings *view_settings,
                   const ColorManagedDisplaySettings *display_settings,
-                  const char *view_name);
+                  const char *view_name,
+                  BuffersCache *buffers_cache = nullptr,
+                  const rctf *viewer_region = nullptr);
 
   /**
    * Destructor
@@ -0,0 +1,441 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2022, Blender Foundation.
+ */
+
+#include "COM_FFTConvolution.h"
+#include "COM_MemoryBuffer.h"
+
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+namespace blender::compositor {
+
+/*
+ *  2D Fast Hartley Transform, used for convolution
+ */
+
+using fREAL = float;
+
+/* Returns next highest power of 2 of x, as well its log2 in L2. */
+static unsigned int next_pow2(unsigned int x, unsigned int *L2)
+{
+  unsigned int pw, x_notpow2 = x & (x - 1);
+  *L2 = 0;
+  while (x >>= 1) {
+    ++(*L2);
+  }
+  pw = 1 << (*L2);
+  if (x_notpow2) {
+    (*L2)++;
+    pw <<= 1;
+  }
+  return pw;
+}
+
+/* From FXT library by Joerg Arndt, faster in order bit-reversal
+ * use: `r = revbin_upd(r, h)` where `h = N>>1`. */
+static unsigned int revbin_upd(unsigned int r, unsigned int h)
+{
+  while (!((r ^= h) & h)) {
+    h >>= 1;
+  }
+  return r;
+}
+static void FHT(fREAL *data, unsigned int M, unsigned int inverse)
+{
+  double tt, fc, dc, fs, ds, a = M_PI;
+  fREAL t1, t2;
+  int n2, bd, bl, istep, k, len = 1 << M, n = 1;
+
+  int i, j = 0;
+  unsigned int Nh = len >> 1;
+  for (i = 1; i < (len - 1); i++) {
+    j = revbin_upd(j, Nh);
+    if (j > i) {
+      t1 = data[i];
+      data[i] = data[j];
+      data[j] = t1;
+    }
+  }
+
+  do {
+    fREAL *data_n = &data[n];
+
+    istep = n << 1;
+    for (k = 0; k < len; k += istep) {
+      t1 = data_n[k];
+      data_n[k] = data[k] - t1;
+      data[k] += t1;
+    }
+
+    n2 = n >> 1;
+    if (n > 2) {
+      fc = dc = cos(a);
+      fs = ds = sqrt(1.0 - fc * fc);  // sin(a);
+      bd = n - 2;
+      for (bl = 1; bl < n2; bl++) {
+        fREAL *data_nbd = &data_n[bd];
+        fREAL *data_bd = &data[bd];
+        for (k = bl; k < len; k += istep) {
+          t1 = fc * (double)data_n[k] + fs * (double)data_nbd[k];
+          t2 = fs * (double)data_n[k] - fc * (double)data_nbd[k];
+          data_n[k] = data[k] - t1;
+          data_nbd[k] = data_bd[k] - t2;
+          data[k] += t1;
+          data_bd[k] += t2;
+        }
+        tt = fc * dc - fs * ds;
+        fs = fs * dc + fc * ds;
+        fc = tt;
+        bd -= 2;
+      }
+    }
+
+    if (n > 1) {
+      for (k = n2; k < len; k += istep) {
+        t1 = data_n[k];
+        data_n[k] = data[k] - t1;
+        data[k] += t1;
+      }
+    }
+
+    n = istep;
+    a *= 0.5;
+  } while (n < len);
+
+  if (inverse) {
+    fREAL sc = (fREAL)1 / (fREAL)len;
+    for (k = 0; k < len; k++) {
+      data[k] *= sc;
+    }
+  }
+}
+/* 2D Fast Hartley Transform, Mx/My -> log2 of width/height,
+ * nzp -> the row where zero pad data starts,
+ * inverse -> see above. */
+static void FHT2D(
+    fREAL *data, unsigned int Mx, unsigned int My, unsigned int nzp, unsigned int inverse)
+{
+  unsigned int i, j, Nx, Ny, maxy;
+
+  Nx = 1 << Mx;
+  Ny = 1 << My;
+
+  /* Rows (forward transform skips 0 pad data). */
+  maxy = inverse ? Ny : nzp;
+  for (j = 0; j < maxy; j++) {
+    FHT(&data[Nx * j], Mx, inverse);
+  }
+
+  /* Transpose data. */
+  if (Nx == Ny) { /* Square. */
+    for (j = 0; j < Ny; j++) {
+      for (i = j + 1; i < Nx; i++) {
+        unsigned int op = i + (j << Mx), np = j + (i << My);
+        SWAP(fREAL, data[op], data[np]);
+      }
+    }
+  }
+  else { /* Rectangular. */
+    unsigned int k, Nym = Ny - 1, stm = 1 << (Mx + My);
+    for (i = 0; stm > 0; i++) {
+#define PRED(k) (((k & Nym) << Mx) + (k >> My))
+      for (j = PRED(i); j > i; j = PRED(j)) {
+        /* Pass. */
+      }
+      if (j < i) {
+        continue;
+      }
+      for (k = i, j = PRED(i); j != i; k = j, j = PRED(j), stm--) {
+        SWAP(fREAL, data[j], data[k]);
+      }
+#undef PRED
+      stm--;
+    }
+  }
+
+  SWAP(unsigned int, Nx, Ny);
+  SWAP(unsigned int, Mx, My);
+
+  /* Now columns == transposed rows. */
+  for (j = 0; j < Ny; j++) {
+    FHT(&data[Nx * j], Mx, inverse);
+  }
+
+  /* Finalize. */
+  for (j = 0; j <= (Ny >> 1); j++) {
+    unsigned int jm = (Ny - j) & (Ny - 1);
+    unsigned int ji = j << Mx;
+    unsigned int jmi = jm << Mx;
+    for (i = 0; i <= (Nx >> 1); i++) {
+      unsigned int im = (Nx - i) & (Nx - 1);
+      fREAL A = data[ji + i];
+      fREAL B = data[jmi + i];
+      fREAL C = data[ji + im];
+      fREAL D = data[jmi + im];
+      fREAL E = (fREAL)0.5 * ((A + D) - (B + C));
+      data[ji + i] = A - E;
+      data[jmi + i] = B + E;
+      data[ji + im] = C + E;
+      data[jmi + im] = D - E;
+    }
+  }
+}
+
+/* 2D convolution calc, d1 *= d2, M/N - > log2 of width/height. */
+static void fht_convolve(fREAL *d1, const fREAL *d2, unsigned int M, unsigned int N)
+{
+  fREAL a, b;
+  unsigned int i, j, k, L, mj, mL;
+  unsigned int m = 1 << M, n = 1 << N;
+  unsigned int m2 = 1 << (M - 1), n2 = 1 << (N - 1);
+  unsigned int mn2 = m << (N - 1);
+
+  d1[0] *= d2[0];
+  d1[mn2] *= d2[mn2];
+  d1[m2] *= d2[m2];
+  d1[m2 + mn2] *= d2[m2 + mn2];
+  for (i = 1; i < m2; i++) {
+    k = m - i;
+    a = d1[i] * d2[i] - d1[k] * d2[k];
+    b = d1[k] * d2[i] + d1[i] * d2[k];
+    d1[i] = (b + a) * (fREAL)0.5;
+    d1[k] = (b - a) * (fREAL)0.5;
+    a = d1[i + mn2] * d2[i + mn2] - d1[k + mn2] * d2[k + mn2];
+    b = d1[k + mn2] * d2[i + mn2] + d1[i + mn2] * d2[k + mn2];
+    d1[i + mn2] = (b + a) * (fREAL)0.5;
+    d1[k + mn2] = (b - a) * (fREAL)0.5;
+  }
+  for (j = 1; j < n2; j++) {
+    L = n - j;
+    mj = j << M;
+    mL = L << M;
+    a = d1[mj] * d2[mj] - d1[mL] * d2[mL];
+    b = d1[mL] * d2[mj] + d1[mj] * d2[mL];
+    d1[mj] = (b + a) * (fREAL)0.5;
+    d1[mL] = (b - a) * (fREAL)0.5;
+    a = d1[m2 + mj] * d2[m2 + mj] - d1[m2 + mL] * d2[m2 + mL];
+    b = d1[m2 + mL] * d2[m2 + mj] + d1[m2 + mj] * d2[m2 + mL];
+    d1[m2 + mj] = (b + a) * (fREAL)0.5;
+    d1[m2 + mL] = (b - a) * (fREAL)0.5;
+  }
+  for (i = 1; i < m2; i++) {
+    k = m - i;
+    for (j = 1; j < n2; j++) {
+      L = n - j;
+      mj = j << M;
+      mL = L << M;
+      a = d1[i + mj] * d2[i + mj] - d1[k + mL] * d2[k + mL];
+      b = d1[k + mL] * d2[i + mj] + d1[i + mj] * d2[k + mL];
+      d1[i + mj] = (b + a) * (fREAL)0.5;
+      d1[k + mL] = (b - a) * (fREAL)0.5;
+      a = d1[i + mL] * d2[i + mL] - d1[k + mj] * d2[k + mj];
+      b = d1[k + mj] * d2[i + mL] + d1[i + mL] * d2[k + mj];
+      d1[i + mL] = (b + a) * (fREAL)0.5;
+      d1[k + mj] = (b - a) * (fREAL)0.5;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+
+/** Minimum transform size, smaller transforms don't pay off the overhead per block. */
+constexpr int FFT_MIN_SIZE = 128;
+
+FFTConvolution::FFTConvolution(const MemoryBuffer &kernel, const int channels_num)
+{
+  BLI_assert(!kernel.is_a_single_elem());
+  kernel_width_ = kernel.get_width();
+  kernel_height_ = kernel.get_height();
+  kernel_channels_ = kernel.get_num_channels() == 1 ? 1 : channels_num;
+  channels_num_ = channels_num;
+  BLI_assert(kernel_channels_ <= kernel.get_num_channels());
+
+  /* Result of a block convolution is `block + kernel - 1` wide, it must fit the transform. The
+   * transform being at least twice the kernel size ensures the result of a block only overlaps
+   * its adjacent blocks. */
+  fft_width_ = next_pow2(MAX2(2 * kernel_width_ - 1, FFT_MIN_SIZE), &log2_width_);
+  fft_height_ = next_pow2(MAX2(2 * kernel_height_ - 1, FFT_MIN_SIZE), &log2_height_);
+  block_width_ = fft_width_ + 1 - kernel_width_;
+  block_height_ = fft_height_ + 1 - kernel_height_;
+
+  const rcti &kernel_rect = kernel.get_rect();
+  const int64_t fft_size = int64_t(fft_width_) * fft_height_;
+  kernel_fht_ = Array<float>(fft_size * kernel_channels_, 0.0f);
+  threading::parallel_for(IndexRange(kernel_channels_), 1, [&](const IndexRange range) {
+    for (const int64_t c : range) {
+      float *data = &kernel_fht_[fft_size * c];
+      for (int y = 0; y < kernel_height_; y++) {
+        const float *elem = kernel.get_elem(kernel_rect.xmin, kernel_rect.ymin + y);
+        for (int x = 0; x < kernel_width_; x++, elem += kernel.elem_stride) {
+          data[y * fft_width_ + x] = elem[c];
+        }
+      }
+      FHT2D(data, log2_width_, log2_height_, kernel_height_, 0);
+    }
+  });
+
+  const int sums_width = kernel_width_ + 1;
+  const int sums_height = kernel_height_ + 1;
+  kernel_sums_ = Array<double>(int64_t(sums_width) * sums_height * kernel_channels_, 0.0);
+  for (int c = 0; c < kernel_channels_; c++) {
+    double *sums = &kernel_sums_[int64_t(sums_width) * sums_height * c];
+    for (int y = 0; y < kernel_height_; y++) {
+      const float *elem = kernel.get_elem(kernel_rect.xmin, kernel_rect.ymin + y);
+      double row_sum = 0.0;
+      for (int x = 0; x < kernel_width_; x++, elem += kernel.elem_stride) {
+        row_sum += elem[c];
+        sums[(y + 1) * sums_width + x + 1] = sums[y * sums_width + x + 1] + row_sum;
+      }
+    }
+  }
+}
+
+bool FFTConvolution::is_faster_than_direct(const int kernel_width, const int kernel_height)
+{
+  /* Found by measuring both methods on a 4 channel 1080p image. */
+  return int64_t(kernel_width) * kernel_height >= 16 * 16;
+}
+
+void FFTConvolution::get_kernel_coverage(const rcti &image_rect,
+                                         const int x,
+                                         const int y,
+                                         float *r_coverage) const
+{
+  const int half_width = kernel_width_ >> 1;
+  const int half_height = kernel_height_ >> 1;
+  /* Kernel element `(i, j)` is multiplied with image pixel `(x - i + half_width, ...)`. */
+  const int xmin = MAX2(x + half_width - image_rect.xmax + 1, 0);
+  const int xmax = MIN2(x + half_width - image_rect.xmin + 1, kernel_width_);
+  const int ymin = MAX2(y + half_height - image_rect.ymax + 1, 0);
+  const int ymax = MIN2(y + half_height - image_rect.ymin + 1, kernel_height_);
+  const int sums_width = kernel_width_ + 1;
+  for (int c = 0; c < kernel_channels_; c++) {
+    if (xmin >= xmax || ymin >= ymax) {
+      r_coverage[c] = 0.0f;
+      continue;
+    }
+    const double *sums = &kernel_sums_[int64_t(sums_width) * (kernel_height_ + 1) * c];
+    r_coverage[c] = float(sums[ymax * sums_width + xmax] - sums[ymin * sums_width + xmax] -
+                          sums[ymax * sums_width + xmin] + sums[ymin * sums_width + xmin]);
+  }
+}
+
+void FFTConvolution::convolve(const MemoryBuffer &image,
+                              MemoryBuffer &output,
+                              const rcti &area) const
+{
+  BLI_assert(image.get_num_channels() >= channels_num_);
+  BLI_assert(output.get_num_channels() >= channels_num_);
+  BLI_assert(!image.is_a_single_elem());
+
+  const IndexRange rows(area.ymin, BLI_rcti_size_y(&area));
+  threading::parallel_for(rows, 64, [&](const IndexRange range) {
+    for (const int64_t y : range) {
+      float *elem = output.get_elem(area.xmin, y);
+      for (int x = area.xmin; x < area.xmax; x++, elem += output.elem_stride) {
+        memset(elem, 0, sizeof(float) * channels_num_);
+      }
+    }
+  });
+
+  /* Image area contributing to the convolved area. */
+  const int half_width = kernel_width_ >> 1;
+  const int half_height = kernel_height_ >> 1;
+  rcti source_area;
+  BLI_rcti_init(&source_area,
+                area.xmin + half_width - kernel_width_ + 1,
+                area.xmax + half_width,
+                area.ymin + half_height - kernel_height_ + 1,
+                area.ymax + half_height);
+  if (!BLI_rcti_isect(&source_area, &image.get_rect(), &source_area)) {
+    return;
+  }
+
+  const int blocks_x = divide_ceil_u(BLI_rcti_size_x(&source_area), block_width_);
+  const int blocks_y = divide_ceil_u(BLI_rcti_size_y(&source_area), block_height_);
+
+  /* Results of adjacent blocks overlap, convolve non-adjacent blocks in parallel and add their
+   * results in four passes. */
+  for (const int pass_y : IndexRange(2)) {
+    for (const int pass_x : IndexRange(2)) {
+      Vector<rcti> blocks;
+      for (int block_y = pass_y; block_y < blocks_y; block_y += 2) {
+        for (int block_x = pass_x; block_x < blocks_x; block_x += 2) {
+          rcti block;
+          block.xmin = source_area.xmin + block_x * block_width_;
+          block.ymin = source_area.ymin + block_y * block_height_;
+          block.xmax = MIN2(block.xmin + block_width_, source_area.xmax);
+          block.ymax = MIN2(block.ymin + block_height_, source_area.ymax);
+          blocks.append(block);
+        }
+      }
+      threading::parallel_for(blocks.index_range(), 1, [&](const IndexRange range) {
+        Array<float> data(int64_t(fft_width_) * fft_height_);
+        for (const int64_t i : range) {
+          convolve_block(image, output, area, blocks[i], data.data());
+        }
+      });
+    }
+  }
+}
+
+void FFTConvolution::convolve_block(const MemoryBuffer &image,
+                                    MemoryBuffer &output,
+                                    const rcti &area,
+                                    const rcti &block,
+                                    float *data) const
+{
+  const int64_t fft_size = int64_t(fft_width_) * fft_height_;
+  const int width = BLI_rcti_size_x(&block);
+  const int height = BLI_rcti_size_y(&block);
+  const int result_width = width + kernel_width_ - 1;
+  const int result_height = height + kernel_height_ - 1;
+  const int result_xmin = block.xmin - (kernel_width_ >> 1);
+  const int result_ymin = block.ymin - (kernel_height_ >> 1);
+
+  for (int c = 0; c < channels_num_; c++) {
+    memset(data, 0, sizeof(float) * fft_size);
+    for (int y = 0; y < height; y++) {
+      const float *elem = image.get_elem(block.xmin, block.ymin + y);
+      float *row = &data[y * fft_width_];
+      for (int x = 0; x < width; x++, elem += image.elem_stride) {
+        row[x] = elem[c];
+      }
+    }
+
+    /* Forward transform skips the zero padded rows. Transforms transpose the data, so the
+     * convolution is done in transposed space and the inverse transform restores the order. */
+    FHT2D(data, log2_width_, log2_height_, height, 0);
+    const float *kernel_fht = &kernel_fht_[kernel_channels_ == 1 ? 0 : fft_size * c];
+    fht_convolve(data, kernel_fht, log2_height_, log2_width_);
+    FHT2D(data, log2_height_, log2_width_, 0, 1);
+
+    const int xmin = MAX2(result_xmin, area.xmin);
+    const int xmax = MIN2(result_xmin + result_width, area.xmax);
+    const int ymin = MAX2(result_ymin, area.ymin);
+    const int ymax = MIN2(result_ymin + result_height, area.ymax);
+    for (int y = ymin; y < ymax; y++) {
+      const float *result = &data[(y - result_ymin) * fft_width_ + xmin - result_xmin];
+      float *elem = output.get_elem(xmin, y);
+      for (int x = xmin; x < xmax; x++, elem += output.elem_stride, result++) {
+        elem[c] += *result;
+      }
+    }
+  }
+}
+
+}  // namespace blender::compositor
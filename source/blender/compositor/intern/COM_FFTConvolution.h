@@ -0,0 +1,95 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2022, Blender Foundation.
+ */
+
+#pragma once
+
+#include "BLI_array.hh"
+#include "BLI_rect.h"
+
+namespace blender::compositor {
+
+class MemoryBuffer;
+
+/**
+ * Convolves images with a fixed kernel using the 2D Fast Hartley Transform. The image is split
+ * in blocks which are transformed independently and overlap-added to the result, blocks are
+ * processed in parallel.
+ *
+ * Cost per pixel hardly depends on the kernel size, so it is much faster than direct convolution
+ * for large kernels, see #is_faster_than_direct.
+ */
+class FFTConvolution {
+ private:
+  int kernel_width_;
+  int kernel_height_;
+  int kernel_channels_;
+  int channels_num_;
+
+  /** Transform size and its log2. */
+  int fft_width_;
+  int fft_height_;
+  unsigned int log2_width_;
+  unsigned int log2_height_;
+
+  /** Image area convolved by each block. */
+  int block_width_;
+  int block_height_;
+
+  /** Transformed kernel, one transform per kernel channel. */
+  Array<float> kernel_fht_;
+
+  /** Summed area table of the kernel, to compute coverage at the image borders. */
+  Array<double> kernel_sums_;
+
+ public:
+  /**
+   * \param kernel: Convolution kernel, its center is at `(width / 2, height / 2)` relative to its
+   * rect start. A single channel kernel is used for all convolved channels, otherwise each
+   * channel is convolved with its respective kernel channel.
+   * \param channels_num: Number of first image channels to convolve.
+   */
+  FFTConvolution(const MemoryBuffer &kernel, int channels_num);
+
+  /**
+   * Writes convolved \a image channels to \a output \a area. The image is considered zero
+   * outside of its rect. Not convolved output channels are left unmodified.
+   */
+  void convolve(const MemoryBuffer &image, MemoryBuffer &output, const rcti &area) const;
+
+  /**
+   * Gets the sum of the kernel elements that are multiplied with pixels inside \a image_rect
+   * when convolving at given coordinates, one value per kernel channel. Needed by operations
+   * that normalize by the kernel weights covering the image like direct convolution does.
+   */
+  void get_kernel_coverage(const rcti &image_rect, int x, int y, float *r_coverage) const;
+
+  /**
+   * Whether convolving with a kernel of given size is faster using FFT than directly summing
+   * the kernel elements for each pixel.
+   */
+  static bool is_faster_than_direct(int kernel_width, int kernel_height);
+
+ private:
+  void convolve_block(const MemoryBuffer &image,
+                      MemoryBuffer &output,
+                      const rcti &area,
+                      const rcti &block,
+                      float *data) const;
+};
+
+}  // namespace blender::compositor
@@ -18,8 +18,15 @@
 
 #include "COM_FullFrameExecutionModel.h"
 
+#include "BLI_string.h"
+
 #include "BLT_translation.h"
 
+#include "BKE_global.h"
+
+#include "PIL_time.h"
+
+#include "COM_BuffersCache.h"
 #include "COM_Debug.h"
 #include "COM_ViewerOperation.h"
 #include "COM_WorkScheduler.h"
@@ -32,11 +39,14 @@ namespace blender::compositor {
 
 FullFrameExecutionModel::FullFrameExecutionModel(CompositorContext &context,
                                                  SharedOperationBuffers &shared_buffers,
+                                                 BuffersCache *buffers_cache,
                                                  Span<NodeOperation *> operations)
     : ExecutionModel(context, operations),
       active_buffers_(shared_buffers),
+      buffers_cache_(buffers_cache),
       num_operations_finished_(0)
 {
+  active_buffers_.set_use_half_float(context.is_half_float_buffers_enabled());
   priorities_.append(eCompositorPriority::High);
   if (!context.is_fast_calculation()) {
     priorities_.append(eCompositorPriority::Medium);
@@ -51,22 +61,130 @@ void FullFrameExecutionModel::execute(ExecutionSystem &exec_system)
 
   DebugInfo::graphviz(&exec_system, "compositor_prior_rendering");
 
+  if (buffers_cache_) {
+    buffers_cache_->begin_execution();
+    generate_results_hashes();
+    determine_cached_operations();
+  }
+
   determine_areas_to_render_and_reads();
   render_operations();
+
+  if (buffers_cache_) {
+    buffers_cache_->end_execution();
+  }
+
+  report_peak_memory();
+}
+
+void FullFrameExecutionModel::report_peak_memory()
+{
+  char memory_str[15];
+  BLI_str_format_byte_unit(memory_str, active_buffers_.get_peak_memory(), false);
+  if (G.debug & G_DEBUG) {
+    printf("Compositor: buffers peak memory %s\n", memory_str);
+  }
+
+  const bNodeTree *tree = context_.get_bnodetree();
+  char buf[128];
+  BLI_snprintf(buf, sizeof(buf), TIP_("Compositing | Buffers peak memory %s"), memory_str);
+  tree->stats_draw(tree->sdh, buf);
+}
+
+void FullFrameExecutionModel::generate_results_hashes()
+{
+  /* Results depend on the quality too, even if operations don't hash it. */
+  const size_t context_hash = get_default_hash_2(context_.get_quality(),
+                                                 context_.is_fast_calculation());
+
+  /* Hash operations after their inputs, as they are part of the result hash. */
+  Set<NodeOperation *> hashed_ops;
+  Vector<NodeOperation *> stack;
+  for (NodeOperation *op : operations_) {
+    stack.append(op);
+    while (stack.size() > 0) {
+      NodeOperation *operation = stack.last();
+      if (hashed_ops.contains(operation)) {
+        stack.pop_last();
+        continue;
+      }
+
+      bool inputs_hashed = true;
+      for (int i = 0; i < operation->get_number_of_input_sockets(); i++) {
+        NodeOperation *input_op = operation->get_input_operation(i);
+        if (!hashed_ops.contains(input_op)) {
+          stack.append(input_op);
+          inputs_hashed = false;
+        }
+      }
+      if (!inputs_hashed) {
+        continue;
+      }
+
+      stack.pop_last();
+      hashed_ops.add_new(operation);
+      std::optional<size_t> hash = operation->generate_result_hash(results_hashes_);
+      if (hash) {
+        results_hashes_.add_new(operation, BLI_ghashutil_combine_hash(*hash, context_hash));
+      }
+    }
+  }
+}
+
+void FullFrameExecutionModel::determine_cached_operations()
+{
+  /* All areas that would be rendered without cache. */
+  SharedOperationBuffers areas_buffers;
+  rcti area;
+  for (eCompositorPriority priority : priorities_) {
+    for (NodeOperation *op : operations_) {
+      if (is_output_to_render(op) && op->get_render_priority() == priority) {
+        get_output_render_area(op, area);
+        determine_areas_to_render(op, area, areas_buffers);
+      }
+    }
+  }
+
+  for (NodeOperation *op : operations_) {
+    const size_t *hash = results_hashes_.lookup_ptr(op);
+    if (hash == nullptr || op->get_flags().is_constant_operation ||
+        op->get_number_of_output_sockets() == 0) {
+      continue;
+    }
+    Vector<rcti> areas = areas_buffers.get_areas_to_render(op, 0, 0);
+    if (areas.is_empty()) {
+      continue;
+    }
+    MemoryBuffer *cached_buf = buffers_cache_->lookup(*hash, areas);
+    if (cached_buf == nullptr) {
+      continue;
+    }
+
+    /* Guard against hash collisions with buffers that can't be valid. */
+    const DataType data_type = op->get_output_socket()->get_data_type();
+    if (cached_buf->get_width() == op->get_width() &&
+        cached_buf->get_height() == op->get_height() &&
+        cached_buf->get_num_channels() == COM_data_type_num_channels(data_type)) {
+      cached_buffers_.add_new(op, cached_buf);
+    }
+    else {
+      /* Keep the cached buffer, it may not be replaced once used in this execution. */
+      added_results_hashes_.add(*hash);
+    }
+  }
 }
 
 void FullFrameExecutionModel::determine_areas_to_render_and_reads()
 {
-  const bool is_rendering = context_.is_rendering();
   const bNodeTree *node_tree = context_.get_bnodetree();
 
   rcti area;
   for (eCompositorPriority priority : priorities_) {
     for (NodeOperation *op : operations_) {
       op->set_bnodetree(node_tree);
-      if (op->is_output_operation(is_rendering) && op->get_render_priority() == priority) {
+      if (is_output_to_render(op) && op->get_render_priority() == priority) {
         get_output_render_area(op, area);
-        determine_areas_to_render(op, area);
+        determine_areas_to_render(op, area, active_buffers_);
         determine_reads(op);
       }
     }
@@ -108,18 +226,27 @@ MemoryBuffer *FullFrameExecutionModel::create_operation_buffer(NodeOperation *op
 
 void FullFrameExecutionModel::render_operation(NodeOperation *op)
 {
+  MemoryBuffer *cached_buf = cached_buffers_.lookup_default(op, nullptr);
+  if (cached_buf) {
+    render_cached_operation(op, cached_buf);
+    return;
+  }
+
   /* Output has no offset for easier image algorithms implementation on operations. */
   constexpr int output_x = 0;
   constexpr int output_y = 0;
 
   const bool has_outputs = op->get_number_of_output_sockets() > 0;
   MemoryBuffer *op_buf = has_outputs ? create_operation_buffer(op, output_x, output_y) : nullptr;
+  double render_time = 0.0;
   if (op->get_width() > 0 && op->get_height() > 0) {
     Vector<MemoryBuffer *> input_bufs = get_input_buffers(op, output_x, output_y);
     const int op_offset_x = output_x - op->get_canvas().xmin;
     const int op_offset_y = output_y - op->get_canvas().ymin;
     Vector<rcti> areas = active_buffers_.get_areas_to_render(op, op_offset_x, op_offset_y);
+    const double start_time = PIL_check_seconds_timer();
     op->render(op_buf, areas, input_bufs);
+    render_time = PIL_check_seconds_timer() - start_time;
     DebugInfo::operation_rendered(op, op_buf);
 
     for (MemoryBuffer *buf : input_bufs) {
@@ -128,20 +255,62 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
   }
   /* Even if operation has no resolution set the empty buffer. It will be clipped with a
    * TranslateOperation from convert resolutions if linked to an operation with resolution. */
-  active_buffers_.set_rendered_buffer(op, std::unique_ptr<MemoryBuffer>(op_buf));
+  set_rendered_buffer(op, op_buf, render_time);
 
   operation_finished(op);
 }
 
-void FullFrameExecutionModel::render_operations()
+void FullFrameExecutionModel::render_cached_operation(NodeOperation *op, MemoryBuffer *cached_buf)
 {
-  const bool is_rendering = context_.is_rendering();
+  /* Cached buffer is owned by the cache, share it without copying. Inputs are neither rendered
+   * nor read. */
+  active_buffers_.set_rendered_buffer(
+      op,
+      std::make_unique<MemoryBuffer>(cached_buf->get_buffer(),
+                                     cached_buf->get_num_channels(),
+                                     cached_buf->get_rect(),
+                                     cached_buf->is_a_single_elem()));
+
+  num_operations_finished_++;
+  update_progress_bar();
+}
+
+void FullFrameExecutionModel::set_rendered_buffer(NodeOperation *op,
+                                                  MemoryBuffer *op_buf,
+                                                  const double render_time)
+{
+  const size_t *hash = buffers_cache_ && op_buf ? results_hashes_.lookup_ptr(op) : nullptr;
+  const bNodeTree *tree = context_.get_bnodetree();
+  const bool is_cached = hash && !op->get_flags().is_constant_operation &&
+                         render_time >= COM_BUFFERS_CACHE_MIN_RENDER_TIME &&
+                         !added_results_hashes_.contains(*hash) &&
+                         !tree->test_break(tree->tbh) &&
+                         buffers_cache_->ensure_available_memory(
+                             BuffersCache::get_buffer_memory_size(*op_buf));
+  if (!is_cached) {
+    active_buffers_.set_rendered_buffer(op, std::unique_ptr<MemoryBuffer>(op_buf));
+    return;
+  }
+
+  /* Buffer is owned by the cache, it's kept until the execution ends at least. */
+  active_buffers_.set_rendered_buffer(op,
+                                      std::make_unique<MemoryBuffer>(op_buf->get_buffer(),
+                                                                     op_buf->get_num_channels(),
+                                                                     op_buf->get_rect(),
+                                                                     op_buf->is_a_single_elem()));
+  buffers_cache_->add(*hash,
+                      std::unique_ptr<MemoryBuffer>(op_buf),
+                      active_buffers_.get_areas_to_render(op, 0, 0));
+  added_results_hashes_.add_new(*hash);
+}
 
+void FullFrameExecutionModel::render_operations()
+{
   WorkScheduler::start(this->context_);
   for (eCompositorPriority priority : priorities_) {
     for (NodeOperation *op : operations_) {
       const bool has_size = op->get_width() > 0 && op->get_height() > 0;
-      const bool is_priority_output = op->is_output_operation(is_rendering) &&
+      const bool is_priority_output = is_output_to_render(op) &&
                                       op->get_render_priority() == priority;
       if (is_priority_output && has_size) {
         render_output_dependencies(op);
@@ -157,9 +326,10 @@ void FullFrameExecutionModel::render_operations()
 
 /**
  * Returns all dependencies from inputs to outputs. A dependency may be repeated when
- * several operations depend on it.
+ * several operations depend on it. Dependencies of cached operations are skipped.
  */
-static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation)
+static Vector<NodeOperation *> get_operation_dependencies(
+    NodeOperation *operation, const Map<NodeOperation *, MemoryBuffer *> &cached_buffers)
 {
   /* Get dependencies from outputs to inputs. */
   Vector<NodeOperation *> dependencies;
@@ -169,6 +339,9 @@ static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operati
     Vector<NodeOperation *> outputs(next_outputs);
     next_outputs.clear();
     for (NodeOperation *output : outputs) {
+      if (cached_buffers.contains(output)) {
+        continue;
+      }
       for (int i = 0; i < output->get_number_of_input_sockets(); i++) {
         next_outputs.append(output->get_input_operation(i));
       }
@@ -185,7 +358,7 @@ static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operati
 void FullFrameExecutionModel::render_output_dependencies(NodeOperation *output_op)
 {
   BLI_assert(output_op->is_output_operation(context_.is_rendering()));
-  Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op);
+  Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op, cached_buffers_);
   for (NodeOperation *op : dependencies) {
     if (!active_buffers_.is_operation_rendered(op)) {
       render_operation(op);
@@ -194,7 +367,8 @@ void FullFrameExecutionModel::render_output_dependencies(NodeOperation *output_o
 }
 
 void FullFrameExecutionModel::determine_areas_to_render(NodeOperation *output_op,
-                                                        const rcti &output_area)
+                                                        const rcti &output_area,
+                                                        SharedOperationBuffers &buffers)
 {
   BLI_assert(output_op->is_output_operation(context_.is_rendering()));
 
@@ -204,12 +378,14 @@ void FullFrameExecutionModel::determine_areas_to_render(NodeOperation *output_op
     std::pair<NodeOperation *, rcti> pair = stack.pop_last();
     NodeOperation *operation = pair.first;
     const rcti &render_area = pair.second;
-    if (BLI_rcti_is_empty(&render_area) ||
-        active_buffers_.is_area_registered(operation, render_area)) {
+    if (BLI_rcti_is_empty(&render_area) || buffers.is_area_registered(operation, render_area)) {
       continue;
     }
 
-    active_buffers_.register_area(operation, render_area);
+    buffers.register_area(operation, render_area);
+    if (cached_buffers_.contains(operation)) {
+      continue;
+    }
 
     const int num_inputs = operation->get_number_of_input_sockets();
     for (int i = 0; i < num_inputs; i++) {
@@ -233,6 +409,9 @@ void FullFrameExecutionModel::determine_reads(NodeOperation *output_op)
   stack.append(output_op);
   while (stack.size() > 0) {
     NodeOperation *operation = stack.pop_last();
+    if (cached_buffers_.contains(operation)) {
+      continue;
+    }
     const int num_inputs = operation->get_number_of_input_sockets();
     for (int i = 0; i < num_inputs; i++) {
       NodeOperation *input_op = operation->get_input_operation(i);
@@ -244,6 +423,15 @@ void FullFrameExecutionModel::determine_reads(NodeOperation *output_op)
   }
 }
 
+bool FullFrameExecutionModel::is_output_to_render(NodeOperation *op) const
+{
+  if (!op->is_output_operation(context_.is_rendering())) {
+    return false;
+  }
+  /* Only viewers are computed when a viewer region is given. */
+  return context_.get_viewer_region() == nullptr || op->get_flags().is_viewer_operation;
+}
+
 void FullFrameExecutionModel::get_output_render_area(NodeOperation *output_op, rcti &r_area)
 {
   BLI_assert(output_op->is_output_operation(context_.is_rendering()));
@@ -268,6 +456,21 @@ void FullFrameExecutionModel::get_output_render_area(NodeOperation *output_op, r
     r_area.ymin = canvas.ymin + norm_border->ymin * h;
     r_area.ymax = canvas.ymin + norm_border->ymax * h;
   }
+
+  const rctf *viewer_region = context_.get_viewer_region();
+  if (viewer_region && output_op->get_flags().is_viewer_operation) {
+    /* Round outwards to not leave pixels partially visible out. */
+    const int w = output_op->get_width();
+    const int h = output_op->get_height();
+    rcti region;
+    region.xmin = canvas.xmin + floorf(viewer_region->xmin * w);
+    region.xmax = canvas.xmin + ceilf(viewer_region->xmax * w);
+    region.ymin = canvas.ymin + floorf(viewer_region->ymin * h);
+    region.ymax = canvas.ymin + ceilf(viewer_region->ymax * h);
+    if (!BLI_rcti_isect(&r_area, &region, &r_area)) {
+      BLI_rcti_init(&r_area, canvas.xmin, canvas.xmin, canvas.ymin, canvas.ymin);
+    }
+  }
 }
 
 void FullFrameExecutionModel::operation_finished(NodeOperation *operation)
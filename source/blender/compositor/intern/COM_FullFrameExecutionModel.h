@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include "BLI_map.hh"
+#include "BLI_set.hh"
 #include "BLI_vector.hh"
 
 #include "COM_Enums.h"
@@ -30,6 +32,7 @@
 namespace blender::compositor {
 
 /* Forward declarations. */
+class BuffersCache;
 class CompositorContext;
 class ExecutionSystem;
 class MemoryBuffer;
@@ -47,6 +50,26 @@ class FullFrameExecutionModel : public ExecutionModel {
    */
   SharedOperationBuffers &active_buffers_;
 
+  /**
+   * Buffers kept across executions, may be null.
+   */
+  BuffersCache *buffers_cache_;
+
+  /**
+   * Results hashes of operations that can be cached.
+   */
+  Map<NodeOperation *, size_t> results_hashes_;
+
+  /**
+   * Operations whose result is re-used from the cache, their inputs are not rendered.
+   */
+  Map<NodeOperation *, MemoryBuffer *> cached_buffers_;
+
+  /**
+   * Results hashes added to the cache in current execution.
+   */
+  Set<size_t> added_results_hashes_;
+
   /**
    * Number of operations finished.
    */
@@ -60,6 +83,7 @@ class FullFrameExecutionModel : public ExecutionModel {
  public:
   FullFrameExecutionModel(CompositorContext &context,
                           SharedOperationBuffers &shared_buffers,
+                          BuffersCache *buffers_cache,
                           Span<NodeOperation *> operations);
 
   void execute(ExecutionSystem &exec_system) override;
@@ -78,18 +102,38 @@ class FullFrameExecutionModel : public ExecutionModel {
   Vector<MemoryBuffer *> get_input_buffers(NodeOperation *op, int output_x, int output_y);
   MemoryBuffer *create_operation_buffer(NodeOperation *op, int output_x, int output_y);
   void render_operation(NodeOperation *op);
+  void render_cached_operation(NodeOperation *op, MemoryBuffer *cached_buf);
+  /**
+   * Sets the rendered buffer of given operation, keeping it in the cache when worth it.
+   */
+  void set_rendered_buffer(NodeOperation *op, MemoryBuffer *op_buf, double render_time);
 
   void operation_finished(NodeOperation *operation);
 
+  /**
+   * Whether given operation is an output to render in this execution.
+   */
+  bool is_output_to_render(NodeOperation *op) const;
   /**
    * Calculates given output operation area to be rendered taking into account viewer and render
-   * borders.
+   * borders, and the viewer region.
    */
   void get_output_render_area(NodeOperation *output_op, rcti &r_area);
+  /**
+   * Generates results hashes of all operations that can be cached.
+   */
+  void generate_results_hashes();
+  /**
+   * Looks up the operations that can re-use a cached buffer, it must have rendered all areas
+   * needed in this execution.
+   */
+  void determine_cached_operations();
   /**
    * Determines all operations areas needed to render given output area.
    */
-  void determine_areas_to_render(NodeOperation *output_op, const rcti &output_area);
+  void determine_areas_to_render(NodeOperation *output_op,
+                                 const rcti &output_area,
+                                 SharedOperationBuffers &buffers);
   /**
    * Determines reads to receive by operations in output operation tree (i.e: Number of dependent
    * operations each operation has).
@@ -97,6 +141,10 @@ class FullFrameExecutionModel : public ExecutionModel {
   void determine_reads(NodeOperation *output_op);
 
   void update_progress_bar();
+  /**
+   * Reports the peak memory used by operations buffers during execution.
+   */
+  void report_peak_memory();
 
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:FullFrameExecutionModel")
@@ -23,6 +23,8 @@
 #include "IMB_colormanagement.h"
 #include "IMB_imbuf_types.h"
 
+#include "BLI_task.hh"
+
 #define ASSERT_BUFFER_CONTAINS_AREA(buf, area) \
   BLI_assert(BLI_rcti_inside_rcti(&(buf)->get_rect(), &(area)))
 
@@ -52,6 +54,7 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memory_proxy, const rcti &rect, MemoryBu
   num_channels_ = COM_data_type_num_channels(memory_proxy->get_data_type());
   buffer_ = (float *)MEM_mallocN_aligned(
       sizeof(float) * buffer_len() * num_channels_, 16, "COM_MemoryBuffer");
+  half_buffer_ = nullptr;
   owns_data_ = true;
   state_ = state;
   datatype_ = memory_proxy->get_data_type();
@@ -67,6 +70,7 @@ MemoryBuffer::MemoryBuffer(DataType data_type, const rcti &rect, bool is_a_singl
   num_channels_ = COM_data_type_num_channels(data_type);
   buffer_ = (float *)MEM_mallocN_aligned(
       sizeof(float) * buffer_len() * num_channels_, 16, "COM_MemoryBuffer");
+  half_buffer_ = nullptr;
   owns_data_ = true;
   state_ = MemoryBufferState::Temporary;
   datatype_ = data_type;
@@ -91,6 +95,7 @@ MemoryBuffer::MemoryBuffer(float *buffer,
   num_channels_ = num_channels;
   datatype_ = COM_num_channels_data_type(num_channels);
   buffer_ = buffer;
+  half_buffer_ = nullptr;
   owns_data_ = false;
   state_ = MemoryBufferState::Temporary;
 
@@ -186,6 +191,121 @@ MemoryBuffer::~MemoryBuffer()
     MEM_freeN(buffer_);
     buffer_ = nullptr;
   }
+  MEM_SAFE_FREE(half_buffer_);
+}
+
+/**
+ * Converts to half float rounding to nearest even. Finite values out of range are clamped to the
+ * largest half float as compositing values exceeding it are commonly still meaningful (e.g. over
+ * exposed highlights), infinity is kept.
+ */
+static uint16_t float_to_half(const float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint16_t sign = (bits >> 16) & 0x8000;
+  const uint32_t abs_bits = bits & 0x7fffffff;
+
+  if (abs_bits > 0x7f800000) {
+    /* NaN. */
+    return sign | 0x7e00;
+  }
+  if (abs_bits == 0x7f800000) {
+    return sign | 0x7c00;
+  }
+  if (abs_bits >= 0x477ff000) {
+    /* Would round to infinity. */
+    return sign | 0x7bff;
+  }
+  if (abs_bits >= 0x38800000) {
+    /* Normalized half float, rebias exponent and round mantissa. */
+    const uint32_t rounded = abs_bits + 0x0fff + ((abs_bits >> 13) & 1);
+    return sign | uint16_t((rounded - 0x38000000) >> 13);
+  }
+  if (abs_bits < 0x33000000) {
+    /* Rounds to zero. */
+    return sign;
+  }
+
+  /* Denormalized half float. */
+  const uint32_t mantissa = (abs_bits & 0x7fffff) | 0x800000;
+  const uint32_t shift = 126 - (abs_bits >> 23);
+  uint32_t half = mantissa >> shift;
+  const uint32_t remainder = mantissa & ((1u << shift) - 1);
+  const uint32_t halfway = 1u << (shift - 1);
+  if (remainder > halfway || (remainder == halfway && (half & 1))) {
+    half++;
+  }
+  return sign | uint16_t(half);
+}
+
+static float half_to_float(const uint16_t half)
+{
+  const uint32_t sign = uint32_t(half & 0x8000) << 16;
+  const uint32_t exponent = (half >> 10) & 0x1f;
+  const uint32_t mantissa = half & 0x3ff;
+
+  if (exponent == 0) {
+    /* Zero or denormalized, exactly representable as float. */
+    const float value = mantissa * (1.0f / (1 << 24));
+    return sign ? -value : value;
+  }
+
+  uint32_t bits;
+  if (exponent == 0x1f) {
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  }
+  else {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/* Number of values converted per task when packing/unpacking. */
+constexpr int64_t HALF_FLOAT_CONVERT_GRAIN_SIZE = 64 * 1024;
+
+bool MemoryBuffer::can_pack_half_float() const
+{
+  return owns_data_ && !is_a_single_elem_ && num_channels_ > 1 && buffer_ != nullptr &&
+         buffer_len() > 0;
+}
+
+void MemoryBuffer::pack_half_float()
+{
+  BLI_assert(can_pack_half_float());
+  const int64_t size = int64_t(buffer_len()) * num_channels_;
+  half_buffer_ = (uint16_t *)MEM_mallocN(sizeof(uint16_t) * size, "COM_MemoryBuffer half float");
+  threading::parallel_for(
+      IndexRange(size), HALF_FLOAT_CONVERT_GRAIN_SIZE, [&](const IndexRange range) {
+        for (const int64_t i : range) {
+          half_buffer_[i] = float_to_half(buffer_[i]);
+        }
+      });
+  MEM_freeN(buffer_);
+  buffer_ = nullptr;
+}
+
+void MemoryBuffer::unpack_half_float()
+{
+  BLI_assert(is_half_float_packed());
+  const int64_t size = int64_t(buffer_len()) * num_channels_;
+  buffer_ = (float *)MEM_mallocN_aligned(sizeof(float) * size, 16, "COM_MemoryBuffer");
+  threading::parallel_for(
+      IndexRange(size), HALF_FLOAT_CONVERT_GRAIN_SIZE, [&](const IndexRange range) {
+        for (const int64_t i : range) {
+          buffer_[i] = half_to_float(half_buffer_[i]);
+        }
+      });
+  MEM_freeN(half_buffer_);
+  half_buffer_ = nullptr;
+}
+
+size_t MemoryBuffer::get_memory_size() const
+{
+  const size_t elem_size = is_half_float_packed() ? sizeof(uint16_t) : sizeof(float);
+  return elem_size * buffer_len() * num_channels_;
 }
 
 void MemoryBuffer::copy_from(const MemoryBuffer *src, const rcti &area)
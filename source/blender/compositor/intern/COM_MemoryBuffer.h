@@ -101,6 +101,12 @@ class MemoryBuffer {
    */
   float *buffer_;
 
+  /**
+   * Buffer data stored at half float precision while packed, #buffer_ is null meanwhile.
+   * See #pack_half_float.
+   */
+  uint16_t *half_buffer_;
+
   /**
    * \brief the number of channels of a single value in the buffer.
    * For value buffers this is 1, vector 3 and color 4
@@ -386,6 +392,39 @@ class MemoryBuffer {
     return buffer_;
   }
 
+  bool owns_data() const
+  {
+    return owns_data_;
+  }
+
+  /**
+   * Whether buffer data can be packed at half float precision. Only owned full size buffers with
+   * more than one channel are packed. Value buffers often contain depth or indices, which don't
+   * fit half float precision and range.
+   */
+  bool can_pack_half_float() const;
+
+  /**
+   * Stores buffer data at half float precision, halving its memory. Finite values out of half
+   * float range are clamped. Elements can't be accessed until #unpack_half_float is called.
+   */
+  void pack_half_float();
+
+  /**
+   * Converts half float packed data back to floats so that elements can be accessed again.
+   */
+  void unpack_half_float();
+
+  bool is_half_float_packed() const
+  {
+    return half_buffer_ != nullptr;
+  }
+
+  /**
+   * Get memory size of buffer data in bytes, taking into account half float packing.
+   */
+  size_t get_memory_size() const;
+
   /**
    * Converts a single elem buffer to a full size buffer (allocates memory for all
    * elements in resolution).
@@ -99,6 +99,48 @@ std::optional<NodeOperationHash> NodeOperation::generate_hash()
   return hash;
 }
 
+std::optional<size_t> NodeOperation::generate_result_hash(
+    const Map<NodeOperation *, size_t> &inputs_hashes)
+{
+  std::optional<NodeOperationHash> hash = generate_hash();
+  if (!hash) {
+    return std::nullopt;
+  }
+
+  size_t result_hash = hash->type_hash_;
+  combine_hashes(result_hash, hash->params_hash_);
+
+  params_hash_ = 0;
+  hash_output_data();
+  combine_hashes(result_hash, params_hash_);
+
+  for (NodeOperationInput &socket : inputs_) {
+    if (!socket.is_connected()) {
+      continue;
+    }
+
+    NodeOperation &input = socket.get_link()->get_operation();
+    const bool is_constant = input.get_flags().is_constant_operation;
+    combine_hashes(result_hash, get_default_hash(is_constant));
+    if (is_constant) {
+      const float *elem = ((ConstantOperation *)&input)->get_constant_elem();
+      const int num_channels = COM_data_type_num_channels(socket.get_data_type());
+      for (const int i : IndexRange(num_channels)) {
+        combine_hashes(result_hash, get_default_hash(elem[i]));
+      }
+    }
+    else {
+      const size_t *input_hash = inputs_hashes.lookup_ptr(&input);
+      if (input_hash == nullptr) {
+        return std::nullopt;
+      }
+      combine_hashes(result_hash, *input_hash);
+    }
+  }
+
+  return result_hash;
+}
+
 NodeOperationOutput *NodeOperation::get_output_socket(unsigned int index)
 {
   return &outputs_[index];
@@ -23,6 +23,7 @@
 
 #include "BLI_ghash.h"
 #include "BLI_hash.hh"
+#include "BLI_map.hh"
 #include "BLI_rect.h"
 #include "BLI_span.hh"
 #include "BLI_threads.h"
@@ -405,6 +406,15 @@ class NodeOperation {
    */
   std::optional<NodeOperationHash> generate_hash();
 
+  /**
+   * Generate a hash that identifies the operation result across executions, used for re-using
+   * results of previous executions. Linked inputs are identified by their results hashes instead
+   * of their ids and data read from outside the compositor is hashed by `hash_output_data`.
+   * \param inputs_hashes: Results hashes of the linked non-constant input operations.
+   * Returns `std::nullopt` when the operation or any of its linked inputs can't be hashed.
+   */
+  std::optional<size_t> generate_result_hash(const Map<NodeOperation *, size_t> &inputs_hashes);
+
   unsigned int get_number_of_input_sockets() const
   {
     return inputs_.size();
@@ -676,6 +686,14 @@ class NodeOperation {
     is_hash_output_params_implemented_ = false;
   }
 
+  /* Overridden by subclasses implementing `hash_output_params` that read data from outside the
+   * compositor (e.g. render passes or images). Hash what identifies the data version, like buffer
+   * pointers and update counters, hashing its content would be too slow. Only used by
+   * `generate_result_hash`. */
+  virtual void hash_output_data()
+  {
+  }
+
   static void combine_hashes(size_t &combined, size_t other)
   {
     combined = BLI_ghashutil_combine_hash(combined, other);
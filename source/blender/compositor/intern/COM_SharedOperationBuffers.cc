@@ -21,6 +21,54 @@
 
 namespace blender::compositor {
 
+SharedOperationBuffers::SharedOperationBuffers()
+    : use_half_float_(false), memory_in_use_(0), peak_memory_(0)
+{
+}
+
+/**
+ * Memory accounted for a buffer, buffers not owned are accounted by their owner.
+ */
+static size_t get_owned_memory_size(const MemoryBuffer &buffer)
+{
+  return buffer.owns_data() ? buffer.get_memory_size() : 0;
+}
+
+void SharedOperationBuffers::add_memory(const size_t memory_size)
+{
+  memory_in_use_ += memory_size;
+  peak_memory_ = std::max(peak_memory_, memory_in_use_);
+}
+
+void SharedOperationBuffers::remove_memory(const size_t memory_size)
+{
+  BLI_assert(memory_in_use_ >= memory_size);
+  memory_in_use_ -= memory_size;
+}
+
+void SharedOperationBuffers::pack_buffer(MemoryBuffer &buffer)
+{
+  if (!use_half_float_ || !buffer.can_pack_half_float()) {
+    return;
+  }
+  const size_t float_memory_size = buffer.get_memory_size();
+  buffer.pack_half_float();
+  /* Both float and half float data are allocated while packing. */
+  add_memory(buffer.get_memory_size());
+  remove_memory(float_memory_size);
+}
+
+void SharedOperationBuffers::unpack_buffer(MemoryBuffer &buffer)
+{
+  if (!buffer.is_half_float_packed()) {
+    return;
+  }
+  const size_t half_memory_size = buffer.get_memory_size();
+  buffer.unpack_half_float();
+  add_memory(buffer.get_memory_size());
+  remove_memory(half_memory_size);
+}
+
 SharedOperationBuffers::BufferData::BufferData()
     : buffer(nullptr), registered_reads(0), received_reads(0), is_rendered(false)
 {
@@ -86,12 +134,29 @@ void SharedOperationBuffers::set_rendered_buffer(NodeOperation *op,
   BLI_assert(buf_data.buffer == nullptr);
   buf_data.buffer = std::move(buffer);
   buf_data.is_rendered = true;
+  if (buf_data.buffer == nullptr) {
+    return;
+  }
+
+  add_memory(get_owned_memory_size(*buf_data.buffer));
+  if (buf_data.registered_reads == 0) {
+    /* Nothing will read it, dispose right away. */
+    remove_memory(get_owned_memory_size(*buf_data.buffer));
+    buf_data.buffer = nullptr;
+  }
+  else {
+    pack_buffer(*buf_data.buffer);
+  }
 }
 
 MemoryBuffer *SharedOperationBuffers::get_rendered_buffer(NodeOperation *op)
 {
   BLI_assert(is_operation_rendered(op));
-  return get_buffer_data(op).buffer.get();
+  MemoryBuffer *buffer = get_buffer_data(op).buffer.get();
+  if (buffer) {
+    unpack_buffer(*buffer);
+  }
+  return buffer;
 }
 
 void SharedOperationBuffers::read_finished(NodeOperation *read_op)
@@ -99,10 +164,18 @@ void SharedOperationBuffers::read_finished(NodeOperation *read_op)
   BufferData &buf_data = get_buffer_data(read_op);
   buf_data.received_reads++;
   BLI_assert(buf_data.received_reads > 0 && buf_data.received_reads <= buf_data.registered_reads);
+  if (buf_data.buffer == nullptr) {
+    return;
+  }
   if (buf_data.received_reads == buf_data.registered_reads) {
     /* Dispose buffer. */
+    remove_memory(get_owned_memory_size(*buf_data.buffer));
     buf_data.buffer = nullptr;
   }
+  else {
+    /* Pack again until next read. */
+    pack_buffer(*buf_data.buffer);
+  }
 }
 
 }  // namespace blender::compositor
@@ -35,6 +35,9 @@ class NodeOperation;
 /**
  * Stores and shares operations rendered buffers including render data. Buffers are
  * disposed once all dependent operations have finished reading them.
+ *
+ * Optionally buffers are packed at half float precision while waiting to be read, see
+ * #MemoryBuffer::pack_half_float. They are unpacked while being read only.
  */
 class SharedOperationBuffers {
  private:
@@ -49,7 +52,25 @@ class SharedOperationBuffers {
   } BufferData;
   blender::Map<NodeOperation *, BufferData> buffers_;
 
+  bool use_half_float_;
+
+  /**
+   * Memory of owned buffers in use and its peak, in bytes.
+   */
+  size_t memory_in_use_;
+  size_t peak_memory_;
+
  public:
+  SharedOperationBuffers();
+
+  /**
+   * Whether to pack rendered buffers at half float precision while not being read.
+   */
+  void set_use_half_float(bool use_half_float)
+  {
+    use_half_float_ = use_half_float;
+  }
+
   /**
    * Whether given operation area to render is already registered.
    */
@@ -82,7 +103,7 @@ class SharedOperationBuffers {
    */
   void set_rendered_buffer(NodeOperation *op, std::unique_ptr<MemoryBuffer> buffer);
   /**
-   * Get given operation rendered buffer.
+   * Get given operation rendered buffer, ready to be read until #read_finished is called.
    */
   MemoryBuffer *get_rendered_buffer(NodeOperation *op);
 
@@ -92,8 +113,25 @@ class SharedOperationBuffers {
    */
   void read_finished(NodeOperation *read_op);
 
+  size_t get_memory_in_use() const
+  {
+    return memory_in_use_;
+  }
+
+  /**
+   * Get the peak memory of owned buffers since creation, in bytes.
+   */
+  size_t get_peak_memory() const
+  {
+    return peak_memory_;
+  }
+
  private:
   BufferData &get_buffer_data(NodeOperation *op);
+  void pack_buffer(MemoryBuffer &buffer);
+  void unpack_buffer(MemoryBuffer &buffer);
+  void add_memory(size_t memory_size);
+  void remove_memory(size_t memory_size);
 
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:SharedOperationBuffers")
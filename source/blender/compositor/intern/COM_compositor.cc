@@ -23,6 +23,9 @@
 #include "BKE_node.h"
 #include "BKE_scene.h"
 
+#include "DNA_userdef_types.h"
+
+#include "COM_BuffersCache.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_WorkScheduler.h"
 #include "COM_compositor.h"
@@ -30,6 +33,8 @@
 static struct {
   bool is_initialized = false;
   ThreadMutex mutex;
+  /** Results of editor executions, re-used when only part of the tree changes. */
+  blender::compositor::BuffersCache *buffers_cache = nullptr;
 } g_compositor;
 
 /* Make sure node tree has previews.
@@ -60,13 +65,27 @@ static void compositor_reset_node_tree_status(bNodeTree *node_tree)
   node_tree->stats_draw(node_tree->sdh, IFACE_("Compositing"));
 }
 
+/**
+ * Whether to compute viewers for the visible region before the full execution. Only the full
+ * frame execution model computes areas exclusively.
+ */
+static bool use_viewer_region_pass(const bNodeTree *node_tree,
+                                   const int rendering,
+                                   const rctf *viewer_region)
+{
+  return viewer_region && !rendering && (node_tree->flag & NTREE_COM_VIEWER_REGION_FIRST) &&
+         U.experimental.use_full_frame_compositor &&
+         node_tree->execution_mode == NTREE_EXECUTION_MODE_FULL_FRAME;
+}
+
 void COM_execute(RenderData *render_data,
                  Scene *scene,
                  bNodeTree *node_tree,
                  int rendering,
                  const ColorManagedViewSettings *view_settings,
                  const ColorManagedDisplaySettings *display_settings,
-                 const char *view_name)
+                 const char *view_name,
+                 const rctf *viewer_region)
 {
   /* Initialize mutex, TODO: this mutex init is actually not thread safe and
    * should be done somewhere as part of blender startup, all the other
@@ -92,7 +111,36 @@ void COM_execute(RenderData *render_data,
   const bool use_opencl = (node_tree->flag & NTREE_COM_OPENCL) != 0;
   blender::compositor::WorkScheduler::initialize(use_opencl, BKE_render_num_threads(render_data));
 
+  /* Final renders have new render results on every execution, don't keep their buffers. */
+  blender::compositor::BuffersCache *buffers_cache = nullptr;
+  if (!rendering) {
+    if (g_compositor.buffers_cache == nullptr) {
+      g_compositor.buffers_cache = new blender::compositor::BuffersCache(
+          blender::compositor::COM_BUFFERS_CACHE_MEMORY_LIMIT);
+    }
+    buffers_cache = g_compositor.buffers_cache;
+  }
+
   /* Execute. */
+  if (use_viewer_region_pass(node_tree, rendering, viewer_region)) {
+    blender::compositor::ExecutionSystem region_pass(render_data,
+                                                     scene,
+                                                     node_tree,
+                                                     rendering,
+                                                     false,
+                                                     view_settings,
+                                                     display_settings,
+                                                     view_name,
+                                                     buffers_cache,
+                                                     viewer_region);
+    region_pass.execute();
+
+    if (node_tree->test_break(node_tree->tbh)) {
+      BLI_mutex_unlock(&g_compositor.mutex);
+      return;
+    }
+  }
+
   const bool twopass = (node_tree->flag & NTREE_TWO_PASS) && !rendering;
   if (twopass) {
     blender::compositor::ExecutionSystem fast_pass(render_data,
@@ -102,7 +150,8 @@ void COM_execute(RenderData *render_data,
                                                    true,
                                                    view_settings,
                                                    display_settings,
-                                                   view_name);
+                                                   view_name,
+                                                   buffers_cache);
     fast_pass.execute();
 
     if (node_tree->test_break(node_tree->tbh)) {
@@ -111,8 +160,15 @@ void COM_execute(RenderData *render_data,
     }
   }
 
-  blender::compositor::ExecutionSystem system(
-      render_data, scene, node_tree, rendering, false, view_settings, display_settings, view_name);
+  blender::compositor::ExecutionSystem system(render_data,
+                                              scene,
+                                              node_tree,
+                                              rendering,
+                                              false,
+                                              view_settings,
+                                              display_settings,
+                                              view_name,
+                                              buffers_cache);
   system.execute();
 
   BLI_mutex_unlock(&g_compositor.mutex);
@@ -123,6 +179,8 @@ void COM_deinitialize()
   if (g_compositor.is_initialized) {
     BLI_mutex_lock(&g_compositor.mutex);
     blender::compositor::WorkScheduler::deinitialize();
+    delete g_compositor.buffers_cache;
+    g_compositor.buffers_cache = nullptr;
     g_compositor.is_initialized = false;
     BLI_mutex_unlock(&g_compositor.mutex);
     BLI_mutex_end(&g_compositor.mutex);
@@ -66,6 +66,16 @@ void BlurBaseOperation::init_data()
   }
 }
 
+void BlurBaseOperation::hash_output_params()
+{
+  hash_params(data_.sizex, data_.sizey, data_.samples);
+  hash_params(data_.relative, data_.aspect, data_.curved);
+  hash_params(data_.fac, data_.percentx, data_.percenty);
+  hash_params(data_.filtertype, int(data_.bokeh), int(data_.gamma));
+  hash_params(size_, sizeavailable_, use_variable_size_);
+  hash_params(extend_bounds_, get_quality());
+}
+
 void BlurBaseOperation::init_execution()
 {
   input_program_ = this->get_input_socket_reader(0);
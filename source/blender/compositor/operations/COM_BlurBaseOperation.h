@@ -49,6 +49,8 @@ class BlurBaseOperation : public MultiThreadedOperation, public QualityStepHelpe
 
   void update_size();
 
+  void hash_output_params() override;
+
   /**
    * Cached reference to the input_program
    */
@@ -321,6 +321,43 @@ void BokehBlurOperation::get_area_of_interest(const int input_idx,
   }
 }
 
+void BokehBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                      const rcti &area,
+                                                      Span<MemoryBuffer *> inputs)
+{
+  const float max_dim = MAX2(this->get_width(), this->get_height());
+  const int pixel_size = size_ * max_dim / 100.0f;
+  const int kernel_size = pixel_size * 2 + 1;
+  const MemoryBuffer *image_input = inputs[IMAGE_INPUT_INDEX];
+  if (pixel_size < 2 || get_step() != 1 || image_input->is_a_single_elem() ||
+      !FFTConvolution::is_faster_than_direct(kernel_size, kernel_size)) {
+    return;
+  }
+
+  /* Direct method sums `bokeh(offset) * image(pixel + offset)` for offsets in
+   * `[-pixel_size, pixel_size)`, convolution needs the kernel mirrored. Kernel element `i` is
+   * multiplied with image pixel `pixel - i + pixel_size`. */
+  const float m = bokehDimension_ / pixel_size;
+  const MemoryBuffer *bokeh_input = inputs[BOKEH_INPUT_INDEX];
+  rcti kernel_rect;
+  BLI_rcti_init(&kernel_rect, 0, kernel_size, 0, kernel_size);
+  MemoryBuffer kernel(DataType::Color, kernel_rect);
+  for (BuffersIterator<float> it = kernel.iterate_with({}); !it.is_end(); ++it) {
+    const int offset_x = pixel_size - it.x;
+    const int offset_y = pixel_size - it.y;
+    if (offset_x == pixel_size || offset_y == pixel_size) {
+      zero_v4(it.out);
+      continue;
+    }
+    const float u = bokeh_mid_x_ - offset_x * m;
+    const float v = bokeh_mid_y_ - offset_y * m;
+    bokeh_input->read_elem_checked(u, v, it.out);
+  }
+
+  convolution_ = std::make_unique<FFTConvolution>(kernel, COM_DATA_TYPE_COLOR_CHANNELS);
+  convolution_->convolve(*image_input, *output, area);
+}
+
 void BokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                       const rcti &area,
                                                       Span<MemoryBuffer *> inputs)
@@ -334,6 +371,23 @@ void BokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
   MemoryBuffer *bounding_input = inputs[BOUNDING_BOX_INPUT_INDEX];
   BuffersIterator<float> it = output->iterate_with({bounding_input}, area);
   const rcti &image_rect = image_input->get_rect();
+  if (convolution_) {
+    /* Output has the convolved image, normalize by the bokeh area covering the image. */
+    for (; !it.is_end(); ++it) {
+      if (*it.in(0) <= 0.0f) {
+        image_input->read_elem(it.x, it.y, it.out);
+        continue;
+      }
+      float multiplier_accum[4];
+      convolution_->get_kernel_coverage(image_rect, it.x, it.y, multiplier_accum);
+      it.out[0] *= 1.0f / multiplier_accum[0];
+      it.out[1] *= 1.0f / multiplier_accum[1];
+      it.out[2] *= 1.0f / multiplier_accum[2];
+      it.out[3] *= 1.0f / multiplier_accum[3];
+    }
+    return;
+  }
+
   for (; !it.is_end(); ++it) {
     const int x = it.x;
     const int y = it.y;
@@ -378,4 +432,11 @@ void BokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
   }
 }
 
+void BokehBlurOperation::update_memory_buffer_finished(MemoryBuffer *UNUSED(output),
+                                                       const rcti &UNUSED(area),
+                                                       Span<MemoryBuffer *> UNUSED(inputs))
+{
+  convolution_.reset();
+}
+
 }  // namespace blender::compositor
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include "COM_FFTConvolution.h"
 #include "COM_MultiThreadedOperation.h"
 #include "COM_QualityStepHelper.h"
 
@@ -37,6 +38,9 @@ class BokehBlurOperation : public MultiThreadedOperation, public QualityStepHelp
   float bokehDimension_;
   bool extend_bounds_;
 
+  /** Used instead of direct convolution for large kernels. */
+  std::unique_ptr<FFTConvolution> convolution_;
+
  public:
   BokehBlurOperation();
 
@@ -83,9 +87,15 @@ class BokehBlurOperation : public MultiThreadedOperation, public QualityStepHelp
   void determine_canvas(const rcti &preferred_area, rcti &r_area) override;
 
   void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
+  void update_memory_buffer_finished(MemoryBuffer *output,
+                                     const rcti &area,
+                                     Span<MemoryBuffer *> inputs) override;
 };
 
 }  // namespace blender::compositor
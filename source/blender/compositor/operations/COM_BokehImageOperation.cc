@@ -25,6 +25,12 @@ BokehImageOperation::BokehImageOperation()
   this->add_output_socket(DataType::Color);
   delete_data_ = false;
 }
+void BokehImageOperation::hash_output_params()
+{
+  hash_params(data_->angle, data_->flaps, data_->rounding);
+  hash_params(data_->catadioptric, data_->lensshift);
+}
+
 void BokehImageOperation::init_execution()
 {
   center_[0] = get_width() / 2;
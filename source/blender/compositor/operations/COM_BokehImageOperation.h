@@ -106,6 +106,9 @@ class BokehImageOperation : public MultiThreadedOperation {
    */
   float is_inside_bokeh(float distance, float x, float y);
 
+ protected:
+  void hash_output_params() override;
+
  public:
   BokehImageOperation();
 
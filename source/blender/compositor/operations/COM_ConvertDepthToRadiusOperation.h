@@ -45,6 +45,9 @@ class ConvertDepthToRadiusOperation : public MultiThreadedOperation {
 
   FastGaussianBlurValueOperation *blur_post_operation_;
 
+ protected:
+  void hash_output_params() override;
+
  public:
   /**
    * Default constructor
@@ -352,6 +352,11 @@ bool FastGaussianBlurValueOperation::determine_depending_area_of_interest(
   return NodeOperation::determine_depending_area_of_interest(&new_input, read_operation, output);
 }
 
+void FastGaussianBlurValueOperation::hash_output_params()
+{
+  hash_params(sigma_, overlay_);
+}
+
 void FastGaussianBlurValueOperation::init_execution()
 {
   inputprogram_ = get_input_socket_reader(0);
@@ -71,6 +71,9 @@ class FastGaussianBlurValueOperation : public MultiThreadedOperation {
    *  1 re-mix with lighter */
   int overlay_;
 
+ protected:
+  void hash_output_params() override;
+
  public:
   FastGaussianBlurValueOperation();
   bool determine_depending_area_of_interest(rcti *input,
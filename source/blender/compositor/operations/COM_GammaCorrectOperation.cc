@@ -27,6 +27,11 @@ GammaCorrectOperation::GammaCorrectOperation()
   input_program_ = nullptr;
   flags_.can_be_constant = true;
 }
+void GammaCorrectOperation::hash_output_params()
+{
+  /* No parameters, result only depends on the input. */
+}
+
 void GammaCorrectOperation::init_execution()
 {
   input_program_ = this->get_input_socket_reader(0);
@@ -98,6 +103,11 @@ GammaUncorrectOperation::GammaUncorrectOperation()
   input_program_ = nullptr;
   flags_.can_be_constant = true;
 }
+void GammaUncorrectOperation::hash_output_params()
+{
+  /* No parameters, result only depends on the input. */
+}
+
 void GammaUncorrectOperation::init_execution()
 {
   input_program_ = this->get_input_socket_reader(0);
@@ -29,6 +29,9 @@ class GammaCorrectOperation : public MultiThreadedOperation {
    */
   SocketReader *input_program_;
 
+ protected:
+  void hash_output_params() override;
+
  public:
   GammaCorrectOperation();
 
@@ -59,6 +62,9 @@ class GammaUncorrectOperation : public MultiThreadedOperation {
    */
   SocketReader *input_program_;
 
+ protected:
+  void hash_output_params() override;
+
  public:
   GammaUncorrectOperation();
 
@@ -39,6 +39,12 @@ void GaussianAlphaBlurBaseOperation::init_data()
   }
 }
 
+void GaussianAlphaBlurBaseOperation::hash_output_params()
+{
+  BlurBaseOperation::hash_output_params();
+  hash_params(falloff_, do_subtract_);
+}
+
 void GaussianAlphaBlurBaseOperation::init_execution()
 {
   BlurBaseOperation::init_execution();
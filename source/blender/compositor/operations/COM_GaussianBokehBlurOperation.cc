@@ -209,11 +209,39 @@ void GaussianBokehBlurOperation::get_area_of_interest(const int input_idx,
   r_input_area.ymin = output_area.ymin - rady_;
 }
 
+void GaussianBokehBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                              const rcti &area,
+                                                              Span<MemoryBuffer *> inputs)
+{
+  const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+  const int kernel_width = radx_ * 2 + 1;
+  const int kernel_height = rady_ * 2 + 1;
+  if (get_step() != 1 || input->is_a_single_elem() ||
+      !FFTConvolution::is_faster_than_direct(kernel_width, kernel_height)) {
+    return;
+  }
+
+  /* Filter is symmetric, so convolving gives the same result as the weighted sum of the direct
+   * method. Normalization by the filter area covering the input is done per pixel. */
+  MemoryBuffer kernel(gausstab_, 1, kernel_width, kernel_height);
+  convolution_ = std::make_unique<FFTConvolution>(kernel, COM_DATA_TYPE_COLOR_CHANNELS);
+  convolution_->convolve(*input, *output, area);
+}
+
 void GaussianBokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                               const rcti &area,
                                                               Span<MemoryBuffer *> inputs)
 {
   const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+  if (convolution_) {
+    for (BuffersIterator<float> it = output->iterate_with({}, area); !it.is_end(); ++it) {
+      float multiplier_accum;
+      convolution_->get_kernel_coverage(input->get_rect(), it.x, it.y, &multiplier_accum);
+      mul_v4_fl(it.out, 1.0f / multiplier_accum);
+    }
+    return;
+  }
+
   BuffersIterator<float> it = output->iterate_with({}, area);
   const rcti &input_rect = input->get_rect();
   for (; !it.is_end(); ++it) {
@@ -246,6 +274,13 @@ void GaussianBokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *outp
   }
 }
 
+void GaussianBokehBlurOperation::update_memory_buffer_finished(MemoryBuffer *UNUSED(output),
+                                                               const rcti &UNUSED(area),
+                                                               Span<MemoryBuffer *> UNUSED(inputs))
+{
+  convolution_.reset();
+}
+
 // reference image
 GaussianBlurReferenceOperation::GaussianBlurReferenceOperation()
     : BlurBaseOperation(DataType::Color)
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "COM_BlurBaseOperation.h"
+#include "COM_FFTConvolution.h"
 #include "COM_NodeOperation.h"
 #include "COM_QualityStepHelper.h"
 
@@ -30,6 +31,8 @@ class GaussianBokehBlurOperation : public BlurBaseOperation {
   int radx_, rady_;
   float radxf_;
   float radyf_;
+  /** Used instead of direct convolution for large kernels. */
+  std::unique_ptr<FFTConvolution> convolution_;
   void update_gauss();
 
  public:
@@ -52,9 +55,15 @@ class GaussianBokehBlurOperation : public BlurBaseOperation {
                                             rcti *output) override;
 
   void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
+  void update_memory_buffer_finished(MemoryBuffer *output,
+                                     const rcti &area,
+                                     Span<MemoryBuffer *> inputs) override;
 };
 
 class GaussianBlurReferenceOperation : public BlurBaseOperation {
@@ -105,6 +105,26 @@ void BaseImageOperation::deinit_execution()
   }
 }
 
+void BaseImageOperation::hash_output_params()
+{
+  hash_params(image_, image_user_, framenumber_);
+  hash_param(StringRefNull(view_name_ ? view_name_ : ""));
+}
+
+void BaseImageOperation::hash_output_data()
+{
+  /* Image buffers may change without any change in the tree. Hashing their content would be too
+   * slow for every execution, hash the buffer identity and its update counter. */
+  ImBuf *ibuf = get_im_buf();
+  hash_param(ibuf);
+  if (ibuf) {
+    hash_params(ibuf->update_counter, ibuf->x, ibuf->y);
+    hash_params(ibuf->rect_float, ibuf->rect, ibuf->zbuf_float);
+    hash_params(ibuf->channels, ibuf->rect_colorspace);
+  }
+  BKE_image_release_ibuf(image_, ibuf, nullptr);
+}
+
 void BaseImageOperation::determine_canvas(const rcti &UNUSED(preferred_area), rcti &r_area)
 {
   ImBuf *stackbuf = get_im_buf();
@@ -18,6 +18,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_task.hh"
+
 #include "COM_InpaintOperation.h"
 
 namespace blender::compositor {
@@ -32,6 +34,7 @@ InpaintSimpleOperation::InpaintSimpleOperation()
   flags_.complex = true;
   input_image_program_ = nullptr;
   pixelorder_ = nullptr;
+  pixelorder_offsets_ = nullptr;
   manhattan_distance_ = nullptr;
   cached_buffer_ = nullptr;
   cached_buffer_ready_ = false;
@@ -42,6 +45,7 @@ void InpaintSimpleOperation::init_execution()
   input_image_program_ = this->get_input_socket_reader(0);
 
   pixelorder_ = nullptr;
+  pixelorder_offsets_ = nullptr;
   manhattan_distance_ = nullptr;
   cached_buffer_ = nullptr;
   cached_buffer_ready_ = false;
@@ -88,86 +92,84 @@ int InpaintSimpleOperation::mdist(int x, int y)
   return manhattan_distance_[y * width + x];
 }
 
-bool InpaintSimpleOperation::next_pixel(int &x, int &y, int &curr, int iters)
-{
-  int width = this->get_width();
-
-  if (curr >= area_size_) {
-    return false;
-  }
-
-  int r = pixelorder_[curr++];
-
-  x = r % width;
-  y = r / width;
-
-  if (this->mdist(x, y) > iters) {
-    return false;
-  }
-
-  return true;
-}
-
 void InpaintSimpleOperation::calc_manhattan_distance()
 {
-  int width = this->get_width();
-  int height = this->get_height();
+  const int width = this->get_width();
+  const int height = this->get_height();
+  const int max_distance = width + height;
   short *m = manhattan_distance_ = (short *)MEM_mallocN(sizeof(short) * width * height, __func__);
-  int *offsets;
-
-  offsets = (int *)MEM_callocN(sizeof(int) * (width + height + 1),
-                               "InpaintSimpleOperation offsets");
-
-  for (int j = 0; j < height; j++) {
-    for (int i = 0; i < width; i++) {
-      int r = 0;
-      /* no need to clamp here */
-      if (this->get_pixel(i, j)[3] < 1.0f) {
-        r = width + height;
-        if (i > 0) {
-          r = min_ii(r, m[j * width + i - 1] + 1);
-        }
-        if (j > 0) {
-          r = min_ii(r, m[(j - 1) * width + i] + 1);
-        }
+
+  /* Manhattan distance transform is separable: distances along rows first, then the minimum of
+   * row distances plus the vertical offset along columns. Rows and columns are independent. */
+  threading::parallel_for(IndexRange(height), 16, [&](const IndexRange range) {
+    for (const int j : range) {
+      short *row = &m[j * width];
+      int r = max_distance;
+      for (int i = 0; i < width; i++) {
+        /* no need to clamp here */
+        r = this->get_pixel(i, j)[3] < 1.0f ? min_ii(r + 1, max_distance) : 0;
+        row[i] = r;
+      }
+      r = max_distance;
+      for (int i = width - 1; i >= 0; i--) {
+        r = min_ii(row[i], r + 1);
+        row[i] = r;
       }
-      m[j * width + i] = r;
     }
-  }
+  });
 
-  for (int j = height - 1; j >= 0; j--) {
-    for (int i = width - 1; i >= 0; i--) {
-      int r = m[j * width + i];
-
-      if (i + 1 < width) {
-        r = min_ii(r, m[j * width + i + 1] + 1);
+  threading::parallel_for(IndexRange(width), 64, [&](const IndexRange range) {
+    for (int j = 1; j < height; j++) {
+      for (const int i : range) {
+        m[j * width + i] = min_ii(m[j * width + i], m[(j - 1) * width + i] + 1);
       }
-      if (j + 1 < height) {
-        r = min_ii(r, m[(j + 1) * width + i] + 1);
+    }
+    for (int j = height - 2; j >= 0; j--) {
+      for (const int i : range) {
+        m[j * width + i] = min_ii(m[j * width + i], m[(j + 1) * width + i] + 1);
       }
+    }
+  });
 
-      m[j * width + i] = r;
-
-      offsets[r]++;
+  int *offsets = pixelorder_offsets_ = (int *)MEM_callocN(sizeof(int) * (max_distance + 1),
+                                                          "InpaintSimpleOperation offsets");
+  for (int i = 0; i < width * height; i++) {
+    if (m[i] > 0) {
+      offsets[m[i]]++;
     }
   }
-
-  offsets[0] = 0;
-
-  for (int i = 1; i < width + height + 1; i++) {
+  for (int i = 1; i < max_distance + 1; i++) {
     offsets[i] += offsets[i - 1];
   }
 
-  area_size_ = offsets[width + height];
-  pixelorder_ = (int *)MEM_mallocN(sizeof(int) * area_size_, __func__);
-
+  pixelorder_ = (int *)MEM_mallocN(sizeof(int) * offsets[max_distance], __func__);
+  int *next = (int *)MEM_dupallocN(offsets);
   for (int i = 0; i < width * height; i++) {
     if (m[i] > 0) {
-      pixelorder_[offsets[m[i] - 1]++] = i;
+      pixelorder_[next[m[i] - 1]++] = i;
     }
   }
+  MEM_freeN(next);
+}
 
-  MEM_freeN(offsets);
+void InpaintSimpleOperation::inpaint()
+{
+  const int width = this->get_width();
+  this->calc_manhattan_distance();
+
+  /* Pixels only blend neighbors with a smaller distance, so pixels at the same distance don't
+   * depend on each other. */
+  const int max_distance = min_ii(iterations_, width + this->get_height());
+  for (int d = 1; d <= max_distance; d++) {
+    const int start = pixelorder_offsets_[d - 1];
+    const IndexRange pixels(start, pixelorder_offsets_[d] - start);
+    threading::parallel_for(pixels, 1024, [&](const IndexRange range) {
+      for (const int i : range) {
+        const int r = pixelorder_[i];
+        this->pix_step(r % width, r / width);
+      }
+    });
+  }
 }
 
 void InpaintSimpleOperation::pix_step(int x, int y)
@@ -222,14 +224,7 @@ void *InpaintSimpleOperation::initialize_tile_data(rcti *rect)
     MemoryBuffer *buf = (MemoryBuffer *)input_image_program_->initialize_tile_data(rect);
     cached_buffer_ = (float *)MEM_dupallocN(buf->get_buffer());
 
-    this->calc_manhattan_distance();
-
-    int curr = 0;
-    int x, y;
-
-    while (this->next_pixel(x, y, curr, iterations_)) {
-      this->pix_step(x, y);
-    }
+    this->inpaint();
     cached_buffer_ready_ = true;
   }
 
@@ -257,6 +252,11 @@ void InpaintSimpleOperation::deinit_execution()
     pixelorder_ = nullptr;
   }
 
+  if (pixelorder_offsets_) {
+    MEM_freeN(pixelorder_offsets_);
+    pixelorder_offsets_ = nullptr;
+  }
+
   if (manhattan_distance_) {
     MEM_freeN(manhattan_distance_);
     manhattan_distance_ = nullptr;
@@ -294,7 +294,6 @@ void InpaintSimpleOperation::update_memory_buffer(MemoryBuffer *output,
                                                   const rcti &area,
                                                   Span<MemoryBuffer *> inputs)
 {
-  /* TODO(manzanilla): once tiled implementation is removed, run multi-threaded where possible. */
   MemoryBuffer *input = inputs[0];
   if (!cached_buffer_ready_) {
     if (input->is_a_single_elem()) {
@@ -306,13 +305,7 @@ void InpaintSimpleOperation::update_memory_buffer(MemoryBuffer *output,
       cached_buffer_ = (float *)MEM_dupallocN(input->get_buffer());
     }
 
-    this->calc_manhattan_distance();
-
-    int curr = 0;
-    int x, y;
-    while (this->next_pixel(x, y, curr, iterations_)) {
-      this->pix_step(x, y);
-    }
+    this->inpaint();
     cached_buffer_ready_ = true;
   }
 
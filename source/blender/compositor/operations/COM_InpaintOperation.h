@@ -35,7 +35,8 @@ class InpaintSimpleOperation : public NodeOperation {
   bool cached_buffer_ready_;
 
   int *pixelorder_;
-  int area_size_;
+  /** Start of the pixels at each distance in #pixelorder_, indexed by distance - 1. */
+  int *pixelorder_offsets_;
   short *manhattan_distance_;
 
  public:
@@ -74,10 +75,10 @@ class InpaintSimpleOperation : public NodeOperation {
 
  private:
   void calc_manhattan_distance();
+  void inpaint();
   void clamp_xy(int &x, int &y);
   float *get_pixel(int x, int y);
   int mdist(int x, int y);
-  bool next_pixel(int &x, int &y, int &curr, int iters);
   void pix_step(int x, int y);
 };
 
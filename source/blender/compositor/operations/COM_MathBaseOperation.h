@@ -43,6 +43,8 @@ class MathBaseOperation : public MultiThreadedOperation {
    */
   MathBaseOperation();
 
+  void hash_output_params() override;
+
   /* TODO(manzanilla): to be removed with tiled implementation. */
   void clamp_if_needed(float color[4]);
 
@@ -50,6 +50,12 @@ ImBuf *MultilayerBaseOperation::get_im_buf()
   return nullptr;
 }
 
+void MultilayerBaseOperation::hash_output_params()
+{
+  BaseImageOperation::hash_output_params();
+  hash_params(pass_id_, view_);
+}
+
 void MultilayerBaseOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                            const rcti &area,
                                                            Span<MemoryBuffer *> UNUSED(inputs))
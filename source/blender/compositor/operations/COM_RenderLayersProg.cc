@@ -184,6 +184,46 @@ void RenderLayersProg::deinit_execution()
   }
 }
 
+void RenderLayersProg::hash_output_params()
+{
+  hash_params(scene_, layer_id_, elementsize_);
+  hash_param(pass_name_);
+  hash_param(StringRefNull(view_name_ ? view_name_ : ""));
+}
+
+void RenderLayersProg::hash_output_data()
+{
+  /* Render result may change without any change in the tree. Hashing the pass content would be
+   * too slow for every execution, hash the buffer identity and the result update counter. */
+  Scene *scene = this->get_scene();
+  Render *re = (scene) ? RE_GetSceneRender(scene) : nullptr;
+  RenderResult *rr = nullptr;
+  const float *pass_buffer = nullptr;
+
+  if (re) {
+    rr = RE_AcquireResultRead(re);
+  }
+
+  if (rr) {
+    ViewLayer *view_layer = (ViewLayer *)BLI_findlink(&scene->view_layers, get_layer_id());
+    if (view_layer) {
+      RenderLayer *rl = RE_GetRenderLayer(rr, view_layer->name);
+      if (rl && rl->rectx == get_width() && rl->recty == get_height()) {
+        pass_buffer = RE_RenderLayerGetPass(rl, pass_name_.c_str(), view_name_);
+      }
+    }
+  }
+
+  hash_param(pass_buffer);
+  if (pass_buffer) {
+    hash_param(rr->update_counter);
+  }
+
+  if (re) {
+    RE_ReleaseResult(re);
+  }
+}
+
 void RenderLayersProg::determine_canvas(const rcti &UNUSED(preferred_area), rcti &r_area)
 {
   Scene *sce = this->get_scene();
@@ -45,6 +45,12 @@ VariableSizeBokehBlurOperation::VariableSizeBokehBlurOperation()
 #endif
 }
 
+void VariableSizeBokehBlurOperation::hash_output_params()
+{
+  hash_params(max_blur_, threshold_, do_size_scale_);
+  hash_param(get_quality());
+}
+
 void VariableSizeBokehBlurOperation::init_execution()
 {
   input_program_ = get_input_socket_reader(0);
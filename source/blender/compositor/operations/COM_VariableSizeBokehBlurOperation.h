@@ -44,6 +44,9 @@ class VariableSizeBokehBlurOperation : public MultiThreadedOperation, public Qua
   SocketReader *input_search_program_;
 #endif
 
+ protected:
+  void hash_output_params() override;
+
  public:
   VariableSizeBokehBlurOperation();
 
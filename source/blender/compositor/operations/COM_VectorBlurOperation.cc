@@ -16,7 +16,10 @@
  * Copyright 2011, Blender Foundation.
  */
 
+#include "BLI_array.hh"
 #include "BLI_jitter_2d.h"
+#include "BLI_task.hh"
+#include "BLI_threads.h"
 
 #include "COM_VectorBlurOperation.h"
 
@@ -25,6 +28,9 @@ namespace blender::compositor {
 /* Defined */
 #define PASS_VECTOR_MAX 10000.0f
 
+/** Memory limit for the buffers of accumulation passes drawn at the same time. */
+constexpr size_t VECBLUR_PASSES_MAX_MEMORY = size_t(512) * 1024 * 1024;
+
 /* Forward declarations */
 struct DrawBufPixel;
 struct ZSpan;
@@ -129,7 +135,6 @@ void VectorBlurOperation::update_memory_buffer(MemoryBuffer *output,
                                                const rcti &area,
                                                Span<MemoryBuffer *> inputs)
 {
-  /* TODO(manzanilla): once tiled implementation is removed, run multi-threaded where possible. */
   if (!cached_instance_) {
     MemoryBuffer *image = inputs[IMAGE_INPUT_INDEX];
     const bool is_image_inflated = image->is_a_single_elem();
@@ -590,6 +595,117 @@ static void set_quad_bezier_ipo(float fac, float *data)
   data[2] = fac * fac;
 }
 
+/**
+ * Draws moving pixels displaced by their speed for a step of one side (past or future) into the
+ * draw buffer of \a zspan.
+ */
+static void vecblur_draw_pass(const NodeBlurData *nbd,
+                              int xsize,
+                              int ysize,
+                              const float *imgrect,
+                              const float *zbufrect,
+                              const char *rectmove,
+                              const float *rectvz,
+                              const float jit[2],
+                              int step,
+                              int samples,
+                              int side,
+                              ZSpan *zspan)
+{
+  float v1[3], v2[3], v3[3], v4[3], fx, fy;
+  float *rectz = (float *)zspan->rectz;
+  DrawBufPixel *rectdraw = zspan->rectdraw;
+  float speedfac = 0.5f * nbd->fac * (float)step / (float)(samples + 1);
+  float ipodata[4];
+  int x, y;
+
+  /* clear zbuf, if we draw future we fill in not moving pixels */
+  for (x = xsize * ysize - 1; x >= 0; x--) {
+    if (rectmove[x] == 0) {
+      rectz[x] = zbufrect[x];
+    }
+    else {
+      rectz[x] = 10e16;
+    }
+  }
+
+  /* clear drawing buffer */
+  for (x = xsize * ysize - 1; x >= 0; x--) {
+    rectdraw[x].colpoin = nullptr;
+  }
+
+  const float *dimg = imgrect;
+  const char *dm = rectmove;
+  const float *dz = zbufrect;
+  const float *dz1 = rectvz;
+  const float *dz2 = rectvz + 4 * (xsize + 1);
+
+  if (side) {
+    if (nbd->curved == 0) {
+      dz1 += 2;
+      dz2 += 2;
+    }
+    speedfac = -speedfac;
+  }
+
+  set_quad_bezier_ipo(0.5f + 0.5f * speedfac, ipodata);
+
+  for (fy = -0.5f + jit[0], y = 0; y < ysize; y++, fy += 1.0f) {
+    for (fx = -0.5f + jit[1], x = 0; x < xsize;
+         x++, fx += 1.0f, dimg += 4, dz1 += 4, dz2 += 4, dm++, dz++) {
+      if (*dm > 1) {
+        float jfx = fx + 0.5f;
+        float jfy = fy + 0.5f;
+        DrawBufPixel col;
+
+        /* make vertices */
+        if (nbd->curved) { /* curved */
+          quad_bezier_2d(v1, dz1, dz1 + 2, ipodata);
+          v1[0] += jfx;
+          v1[1] += jfy;
+          v1[2] = *dz;
+
+          quad_bezier_2d(v2, dz1 + 4, dz1 + 4 + 2, ipodata);
+          v2[0] += jfx + 1.0f;
+          v2[1] += jfy;
+          v2[2] = *dz;
+
+          quad_bezier_2d(v3, dz2 + 4, dz2 + 4 + 2, ipodata);
+          v3[0] += jfx + 1.0f;
+          v3[1] += jfy + 1.0f;
+          v3[2] = *dz;
+
+          quad_bezier_2d(v4, dz2, dz2 + 2, ipodata);
+          v4[0] += jfx;
+          v4[1] += jfy + 1.0f;
+          v4[2] = *dz;
+        }
+        else {
+          ARRAY_SET_ITEMS(v1, speedfac * dz1[0] + jfx, speedfac * dz1[1] + jfy, *dz);
+          ARRAY_SET_ITEMS(v2, speedfac * dz1[4] + jfx + 1.0f, speedfac * dz1[5] + jfy, *dz);
+          ARRAY_SET_ITEMS(
+              v3, speedfac * dz2[4] + jfx + 1.0f, speedfac * dz2[5] + jfy + 1.0f, *dz);
+          ARRAY_SET_ITEMS(v4, speedfac * dz2[0] + jfx, speedfac * dz2[1] + jfy + 1.0f, *dz);
+        }
+        if (*dm == 255) {
+          col.alpha = 1.0f;
+        }
+        else if (*dm < 2) {
+          col.alpha = 0.0f;
+        }
+        else {
+          col.alpha = ((float)*dm) / 255.0f;
+        }
+        col.colpoin = dimg;
+
+        zbuf_fill_in_rgba(zspan, &col, v1, v2, v3, v4);
+      }
+    }
+    dz1 += 4;
+    dz2 += 4;
+  }
+}
+
 void zbuf_accumulate_vecblur(NodeBlurData *nbd,
                              int xsize,
                              int ysize,
@@ -598,32 +714,17 @@ void zbuf_accumulate_vecblur(NodeBlurData *nbd,
                              float *vecbufrect,
                              const float *zbufrect)
 {
-  ZSpan zspan;
-  DrawBufPixel *rectdraw, *dr;
   static float jit[256][2];
-  float v1[3], v2[3], v3[3], v4[3], fx, fy;
-  const float *dimg, *dz, *ro;
-  float *rectvz, *dvz, *dvec1, *dvec2, *dz1, *dz2, *rectz;
-  float *minvecbufrect = nullptr, *rectweight, *rw, *rectmax, *rm;
+  float *rectvz, *dvz, *dvec1, *dvec2, *dz1, *dz2;
+  float *minvecbufrect = nullptr, *rectweight, *rectmax;
   float maxspeedsq = (float)nbd->maxspeed * nbd->maxspeed;
   int y, x, step, maxspeed = nbd->maxspeed, samples = nbd->samples;
   int tsktsk = 0;
   static int firsttime = 1;
   char *rectmove, *dm;
 
-  zbuf_alloc_span(&zspan, xsize, ysize, 1.0f);
-  zspan.zmulx = ((float)xsize) / 2.0f;
-  zspan.zmuly = ((float)ysize) / 2.0f;
-  zspan.zofsx = 0.0f;
-  zspan.zofsy = 0.0f;
-
   /* the buffers */
-  rectz = (float *)MEM_callocN(sizeof(float) * xsize * ysize, "zbuf accum");
-  zspan.rectz = (int *)rectz;
-
   rectmove = (char *)MEM_callocN(xsize * ysize, "rectmove");
-  rectdraw = (DrawBufPixel *)MEM_callocN(sizeof(DrawBufPixel) * xsize * ysize, "rect draw");
-  zspan.rectdraw = rectdraw;
 
   rectweight = (float *)MEM_callocN(sizeof(float) * xsize * ysize, "rect weight");
   rectmax = (float *)MEM_callocN(sizeof(float) * xsize * ysize, "rect max");
@@ -788,165 +889,108 @@ void zbuf_accumulate_vecblur(NodeBlurData *nbd,
 
   memset(newrect, 0, sizeof(float) * xsize * ysize * 4);
 
-  /* accumulate */
+  /* Accumulate. Passes don't depend on each other, so several of them are drawn at once into
+   * their own buffers. They are accumulated in order so the result doesn't depend on the number
+   * of threads. */
   samples /= 2;
-  for (step = 1; step <= samples; step++) {
-    float speedfac = 0.5f * nbd->fac * (float)step / (float)(samples + 1);
-    int side;
-
-    for (side = 0; side < 2; side++) {
-      float blendfac, ipodata[4];
-
-      /* clear zbuf, if we draw future we fill in not moving pixels */
-      if (false) {
-        for (x = xsize * ysize - 1; x >= 0; x--) {
-          rectz[x] = 10e16;
-        }
-      }
-      else {
-        for (x = xsize * ysize - 1; x >= 0; x--) {
-          if (rectmove[x] == 0) {
-            rectz[x] = zbufrect[x];
-          }
-          else {
-            rectz[x] = 10e16;
-          }
-        }
-      }
-
-      /* clear drawing buffer */
-      for (x = xsize * ysize - 1; x >= 0; x--) {
-        rectdraw[x].colpoin = nullptr;
-      }
-
-      dimg = imgrect;
-      dm = rectmove;
-      dz = zbufrect;
-      dz1 = rectvz;
-      dz2 = rectvz + 4 * (xsize + 1);
-
-      if (side) {
-        if (nbd->curved == 0) {
-          dz1 += 2;
-          dz2 += 2;
-        }
-        speedfac = -speedfac;
+  const int passes_num = samples * 2;
+  const size_t pass_memory = (sizeof(float) + sizeof(DrawBufPixel)) * size_t(xsize) * ysize;
+  const int passes_in_memory = int(VECBLUR_PASSES_MAX_MEMORY / max_zz(pass_memory, 1));
+  const int batch_size = clamp_i(
+      min_ii(BLI_system_thread_count(), passes_in_memory), 1, max_ii(passes_num, 1));
+  Array<ZSpan> zspans(batch_size);
+  for (ZSpan &zspan : zspans) {
+    zbuf_alloc_span(&zspan, xsize, ysize, 1.0f);
+    zspan.rectz = (int *)MEM_mallocN(sizeof(float) * xsize * ysize, "zbuf accum");
+    zspan.rectdraw = (DrawBufPixel *)MEM_mallocN(sizeof(DrawBufPixel) * xsize * ysize,
+                                                 "rect draw");
+  }
+
+  for (int batch_start = 0; batch_start < passes_num; batch_start += batch_size) {
+    const int batch_num = min_ii(batch_size, passes_num - batch_start);
+    threading::parallel_for(IndexRange(batch_num), 1, [&](const IndexRange range) {
+      for (const int i : range) {
+        const int step = (batch_start + i) / 2 + 1;
+        const int side = (batch_start + i) % 2;
+        vecblur_draw_pass(nbd,
+                          xsize,
+                          ysize,
+                          imgrect,
+                          zbufrect,
+                          rectmove,
+                          rectvz,
+                          jit[step & 255],
+                          step,
+                          samples,
+                          side,
+                          &zspans[i]);
       }
-
-      set_quad_bezier_ipo(0.5f + 0.5f * speedfac, ipodata);
-
-      for (fy = -0.5f + jit[step & 255][0], y = 0; y < ysize; y++, fy += 1.0f) {
-        for (fx = -0.5f + jit[step & 255][1], x = 0; x < xsize;
-             x++, fx += 1.0f, dimg += 4, dz1 += 4, dz2 += 4, dm++, dz++) {
-          if (*dm > 1) {
-            float jfx = fx + 0.5f;
-            float jfy = fy + 0.5f;
-            DrawBufPixel col;
-
-            /* make vertices */
-            if (nbd->curved) { /* curved */
-              quad_bezier_2d(v1, dz1, dz1 + 2, ipodata);
-              v1[0] += jfx;
-              v1[1] += jfy;
-              v1[2] = *dz;
-
-              quad_bezier_2d(v2, dz1 + 4, dz1 + 4 + 2, ipodata);
-              v2[0] += jfx + 1.0f;
-              v2[1] += jfy;
-              v2[2] = *dz;
-
-              quad_bezier_2d(v3, dz2 + 4, dz2 + 4 + 2, ipodata);
-              v3[0] += jfx + 1.0f;
-              v3[1] += jfy + 1.0f;
-              v3[2] = *dz;
-
-              quad_bezier_2d(v4, dz2, dz2 + 2, ipodata);
-              v4[0] += jfx;
-              v4[1] += jfy + 1.0f;
-              v4[2] = *dz;
-            }
-            else {
-              ARRAY_SET_ITEMS(v1, speedfac * dz1[0] + jfx, speedfac * dz1[1] + jfy, *dz);
-              ARRAY_SET_ITEMS(v2, speedfac * dz1[4] + jfx + 1.0f, speedfac * dz1[5] + jfy, *dz);
-              ARRAY_SET_ITEMS(
-                  v3, speedfac * dz2[4] + jfx + 1.0f, speedfac * dz2[5] + jfy + 1.0f, *dz);
-              ARRAY_SET_ITEMS(v4, speedfac * dz2[0] + jfx, speedfac * dz2[1] + jfy + 1.0f, *dz);
-            }
-            if (*dm == 255) {
-              col.alpha = 1.0f;
-            }
-            else if (*dm < 2) {
-              col.alpha = 0.0f;
-            }
-            else {
-              col.alpha = ((float)*dm) / 255.0f;
-            }
-            col.colpoin = dimg;
-
-            zbuf_fill_in_rgba(&zspan, &col, v1, v2, v3, v4);
+    });
+
+    threading::parallel_for(IndexRange(xsize * ysize), 4096, [&](const IndexRange range) {
+      for (int i = 0; i < batch_num; i++) {
+        const int step = (batch_start + i) / 2 + 1;
+        /* blend with a falloff. this fixes the ugly effect you get with
+         * a fast moving object. then it looks like a solid object overlaid
+         * over a very transparent moving version of itself. in reality, the
+         * whole object should become transparent if it is moving fast, be
+         * we don't know what is behind it so we don't do that. this hack
+         * overestimates the contribution of foreground pixels but looks a
+         * bit better without a sudden cutoff. */
+        float blendfac = ((samples - step) / (float)samples);
+        /* Smooth-step to make it look a bit nicer as well. */
+        blendfac = 3.0f * pow(blendfac, 2.0f) - 2.0f * pow(blendfac, 3.0f);
+
+        /* accum */
+        const DrawBufPixel *rectdraw = zspans[i].rectdraw;
+        for (const int64_t x : range) {
+          const DrawBufPixel *dr = &rectdraw[x];
+          if (dr->colpoin) {
+            float bfac = dr->alpha * blendfac;
+            float *dz2 = &newrect[x * 4];
+
+            dz2[0] += bfac * dr->colpoin[0];
+            dz2[1] += bfac * dr->colpoin[1];
+            dz2[2] += bfac * dr->colpoin[2];
+            dz2[3] += bfac * dr->colpoin[3];
+
+            rectweight[x] += bfac;
+            rectmax[x] = MAX2(rectmax[x], bfac);
           }
         }
-        dz1 += 4;
-        dz2 += 4;
       }
+    });
+  }
 
-      /* blend with a falloff. this fixes the ugly effect you get with
-       * a fast moving object. then it looks like a solid object overlaid
-       * over a very transparent moving version of itself. in reality, the
-       * whole object should become transparent if it is moving fast, be
-       * we don't know what is behind it so we don't do that. this hack
-       * overestimates the contribution of foreground pixels but looks a
-       * bit better without a sudden cutoff. */
-      blendfac = ((samples - step) / (float)samples);
-      /* Smooth-step to make it look a bit nicer as well. */
-      blendfac = 3.0f * pow(blendfac, 2.0f) - 2.0f * pow(blendfac, 3.0f);
-
-      /* accum */
-      rw = rectweight;
-      rm = rectmax;
-      for (dr = rectdraw, dz2 = newrect, x = xsize * ysize - 1; x >= 0;
-           x--, dr++, dz2 += 4, rw++, rm++) {
-        if (dr->colpoin) {
-          float bfac = dr->alpha * blendfac;
-
-          dz2[0] += bfac * dr->colpoin[0];
-          dz2[1] += bfac * dr->colpoin[1];
-          dz2[2] += bfac * dr->colpoin[2];
-          dz2[3] += bfac * dr->colpoin[3];
-
-          *rw += bfac;
-          *rm = MAX2(*rm, bfac);
-        }
-      }
-    }
+  for (ZSpan &zspan : zspans) {
+    MEM_freeN(zspan.rectz);
+    MEM_freeN(zspan.rectdraw);
+    zbuf_free_span(&zspan);
   }
 
   /* blend between original images and accumulated image */
-  rw = rectweight;
-  rm = rectmax;
-  ro = imgrect;
-  dm = rectmove;
-  for (dz2 = newrect, x = xsize * ysize - 1; x >= 0; x--, dz2 += 4, ro += 4, rw++, rm++, dm++) {
-    float mfac = *rm;
-    float fac = (*rw == 0.0f) ? 0.0f : mfac / (*rw);
-    float nfac = 1.0f - mfac;
-
-    dz2[0] = fac * dz2[0] + nfac * ro[0];
-    dz2[1] = fac * dz2[1] + nfac * ro[1];
-    dz2[2] = fac * dz2[2] + nfac * ro[2];
-    dz2[3] = fac * dz2[3] + nfac * ro[3];
-  }
+  threading::parallel_for(IndexRange(xsize * ysize), 4096, [&](const IndexRange range) {
+    for (const int64_t x : range) {
+      float *dz2 = &newrect[x * 4];
+      const float *ro = &imgrect[x * 4];
+      float mfac = rectmax[x];
+      float fac = (rectweight[x] == 0.0f) ? 0.0f : mfac / rectweight[x];
+      float nfac = 1.0f - mfac;
+
+      dz2[0] = fac * dz2[0] + nfac * ro[0];
+      dz2[1] = fac * dz2[1] + nfac * ro[1];
+      dz2[2] = fac * dz2[2] + nfac * ro[2];
+      dz2[3] = fac * dz2[3] + nfac * ro[3];
+    }
+  });
 
-  MEM_freeN(rectz);
   MEM_freeN(rectmove);
-  MEM_freeN(rectdraw);
   MEM_freeN(rectvz);
   MEM_freeN(rectweight);
   MEM_freeN(rectmax);
   if (minvecbufrect) {
     MEM_freeN(vecbufrect); /* rects were swapped! */
   }
-  zbuf_free_span(&zspan);
 }
 
 }  // namespace blender::compositor
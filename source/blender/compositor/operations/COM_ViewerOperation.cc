@@ -175,6 +175,7 @@ void ViewerOperation::init_image()
     }
 
     ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+    IMB_tag_changed(ibuf);
   }
 
   if (do_depth_buffer_) {
@@ -0,0 +1,104 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2022, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "COM_BuffersCache.h"
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor::tests {
+
+constexpr int BUFFER_WIDTH = 16;
+constexpr int BUFFER_HEIGHT = 8;
+
+static std::unique_ptr<MemoryBuffer> create_buffer()
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, BUFFER_WIDTH, 0, BUFFER_HEIGHT);
+  return std::make_unique<MemoryBuffer>(DataType::Color, rect);
+}
+
+static size_t get_buffer_size()
+{
+  return sizeof(float) * BUFFER_WIDTH * BUFFER_HEIGHT * COM_DATA_TYPE_COLOR_CHANNELS;
+}
+
+TEST(BuffersCache, lookup)
+{
+  BuffersCache cache(get_buffer_size() * 4);
+  rcti rendered_area;
+  BLI_rcti_init(&rendered_area, 0, BUFFER_WIDTH, 0, BUFFER_HEIGHT / 2);
+
+  cache.begin_execution();
+  std::unique_ptr<MemoryBuffer> buffer = create_buffer();
+  MemoryBuffer *buffer_ptr = buffer.get();
+  EXPECT_TRUE(cache.ensure_available_memory(get_buffer_size()));
+  cache.add(1, std::move(buffer), {rendered_area});
+  EXPECT_EQ(cache.get_memory_in_use(), get_buffer_size());
+  cache.end_execution();
+
+  cache.begin_execution();
+  rcti area;
+  BLI_rcti_init(&area, 2, 10, 0, 3);
+  EXPECT_EQ(cache.lookup(1, {area}), buffer_ptr);
+  EXPECT_EQ(cache.lookup(1, {rendered_area}), buffer_ptr);
+  EXPECT_EQ(cache.lookup(2, {area}), nullptr);
+
+  /* Not rendered areas. */
+  BLI_rcti_init(&area, 0, BUFFER_WIDTH, 0, BUFFER_HEIGHT);
+  EXPECT_EQ(cache.lookup(1, {area}), nullptr);
+  EXPECT_EQ(cache.lookup(1, {rendered_area, area}), nullptr);
+  cache.end_execution();
+}
+
+TEST(BuffersCache, memory_limit)
+{
+  BuffersCache cache(get_buffer_size() * 2);
+  rcti area;
+  BLI_rcti_init(&area, 0, BUFFER_WIDTH, 0, BUFFER_HEIGHT);
+
+  cache.begin_execution();
+  for (const size_t hash : {1, 2}) {
+    EXPECT_TRUE(cache.ensure_available_memory(get_buffer_size()));
+    cache.add(hash, create_buffer(), {area});
+  }
+  /* Buffers used in current execution may still be read, they can't be freed. */
+  EXPECT_FALSE(cache.ensure_available_memory(get_buffer_size()));
+  EXPECT_FALSE(cache.ensure_available_memory(get_buffer_size() * 3));
+  cache.end_execution();
+  EXPECT_EQ(cache.get_memory_in_use(), get_buffer_size() * 2);
+
+  /* Least recently used buffer is freed. */
+  cache.begin_execution();
+  EXPECT_NE(cache.lookup(1, {area}), nullptr);
+  EXPECT_TRUE(cache.ensure_available_memory(get_buffer_size()));
+  cache.add(3, create_buffer(), {area});
+  EXPECT_EQ(cache.get_memory_in_use(), get_buffer_size() * 2);
+  cache.end_execution();
+
+  cache.begin_execution();
+  EXPECT_NE(cache.lookup(1, {area}), nullptr);
+  EXPECT_EQ(cache.lookup(2, {area}), nullptr);
+  EXPECT_NE(cache.lookup(3, {area}), nullptr);
+  cache.end_execution();
+
+  cache.clear();
+  EXPECT_EQ(cache.get_memory_in_use(), 0);
+}
+
+}  // namespace blender::compositor::tests
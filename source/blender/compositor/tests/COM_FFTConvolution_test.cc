@@ -0,0 +1,178 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2022, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "BLI_rand.hh"
+
+#include "COM_FFTConvolution.h"
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor::tests {
+
+static void fill_random(MemoryBuffer &buffer, const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  for (BuffersIterator<float> it = buffer.iterate_with({}); !it.is_end(); ++it) {
+    for (int c = 0; c < buffer.get_num_channels(); c++) {
+      it.out[c] = rng.get_float();
+    }
+  }
+}
+
+/** Convolves directly, summing the kernel elements for each pixel. */
+static void convolve_direct(const MemoryBuffer &image,
+                            const MemoryBuffer &kernel,
+                            const int channels_num,
+                            MemoryBuffer &output)
+{
+  const rcti &image_rect = image.get_rect();
+  const rcti &kernel_rect = kernel.get_rect();
+  const int half_width = kernel.get_width() >> 1;
+  const int half_height = kernel.get_height() >> 1;
+  for (BuffersIterator<float> it = output.iterate_with({}); !it.is_end(); ++it) {
+    for (int c = 0; c < channels_num; c++) {
+      const int kernel_channel = kernel.get_num_channels() == 1 ? 0 : c;
+      double sum = 0.0;
+      for (int j = 0; j < kernel.get_height(); j++) {
+        for (int i = 0; i < kernel.get_width(); i++) {
+          const int x = it.x - i + half_width;
+          const int y = it.y - j + half_height;
+          if (x < image_rect.xmin || x >= image_rect.xmax || y < image_rect.ymin ||
+              y >= image_rect.ymax) {
+            continue;
+          }
+          const float *kernel_elem = kernel.get_elem(kernel_rect.xmin + i, kernel_rect.ymin + j);
+          sum += double(kernel_elem[kernel_channel]) * image.get_elem(x, y)[c];
+        }
+      }
+      it.out[c] = float(sum);
+    }
+  }
+}
+
+static void test_convolution(const rcti &image_rect,
+                             const rcti &kernel_rect,
+                             const int kernel_channels,
+                             const rcti &area,
+                             const int channels_num)
+{
+  MemoryBuffer image(DataType::Color, image_rect);
+  fill_random(image, 0);
+  MemoryBuffer kernel_data(DataType::Color, kernel_rect);
+  fill_random(kernel_data, 1);
+  /* Normalize so that results are in the same range as the image. */
+  const float kernel_scale = 1.0f / (kernel_data.get_width() * kernel_data.get_height());
+  for (BuffersIterator<float> it = kernel_data.iterate_with({}); !it.is_end(); ++it) {
+    mul_v4_fl(it.out, kernel_scale);
+  }
+  MemoryBuffer single_channel_kernel(DataType::Value, kernel_rect);
+  single_channel_kernel.copy_from(&kernel_data, kernel_rect, 0, 1, 0);
+  const MemoryBuffer &used_kernel = kernel_channels == 1 ? single_channel_kernel : kernel_data;
+
+  MemoryBuffer expected(DataType::Color, area);
+  expected.clear();
+  convolve_direct(image, used_kernel, channels_num, expected);
+
+  MemoryBuffer result(DataType::Color, area);
+  const float unmodified[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+  result.fill(area, unmodified);
+  FFTConvolution convolution(used_kernel, channels_num);
+  convolution.convolve(image, result, area);
+
+  for (BuffersIterator<float> it = result.iterate_with({}); !it.is_end(); ++it) {
+    const float *expected_elem = expected.get_elem(it.x, it.y);
+    for (int c = 0; c < channels_num; c++) {
+      EXPECT_NEAR(it.out[c], expected_elem[c], 1e-4f);
+    }
+    for (int c = channels_num; c < 4; c++) {
+      EXPECT_EQ(it.out[c], -1.0f);
+    }
+  }
+}
+
+static rcti create_rect(const int xmin, const int xmax, const int ymin, const int ymax)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, xmin, xmax, ymin, ymax);
+  return rect;
+}
+
+TEST(FFTConvolution, convolve)
+{
+  /* Single block. */
+  test_convolution(
+      create_rect(0, 40, 0, 30), create_rect(0, 7, 0, 5), 4, create_rect(0, 40, 0, 30), 4);
+  /* Multiple blocks, offset rects and area exceeding the image. */
+  test_convolution(create_rect(-20, 300, 10, 270),
+                   create_rect(3, 12, -2, 9),
+                   4,
+                   create_rect(-30, 310, 0, 280),
+                   4);
+  /* Area inside the image, even sized kernel, single channel kernel. */
+  test_convolution(create_rect(0, 260, 0, 140),
+                   create_rect(0, 16, 0, 10),
+                   1,
+                   create_rect(100, 200, 20, 130),
+                   4);
+  /* Only first channels convolved. */
+  test_convolution(
+      create_rect(0, 150, 0, 150), create_rect(0, 9, 0, 9), 4, create_rect(0, 150, 0, 150), 3);
+  /* Kernel larger than the minimum transform size. */
+  test_convolution(
+      create_rect(0, 200, 0, 90), create_rect(0, 71, 0, 33), 4, create_rect(0, 200, 0, 90), 4);
+}
+
+TEST(FFTConvolution, kernel_coverage)
+{
+  const rcti kernel_rect = create_rect(0, 5, 0, 3);
+  MemoryBuffer kernel(DataType::Vector, kernel_rect);
+  for (BuffersIterator<float> it = kernel.iterate_with({}); !it.is_end(); ++it) {
+    it.out[0] = 1.0f;
+    it.out[1] = it.x;
+    it.out[2] = it.y;
+  }
+  FFTConvolution convolution(kernel, 3);
+  const rcti image_rect = create_rect(10, 20, 10, 20);
+
+  float coverage[3];
+  /* Kernel fully inside the image. */
+  convolution.get_kernel_coverage(image_rect, 15, 15, coverage);
+  EXPECT_FLOAT_EQ(coverage[0], 15.0f);
+  EXPECT_FLOAT_EQ(coverage[1], 30.0f);
+  EXPECT_FLOAT_EQ(coverage[2], 15.0f);
+
+  /* Kernel element `(i, j)` is multiplied with pixel `(x - i + 2, y - j + 1)`, only columns 0 to
+   * 2 are inside the image. */
+  convolution.get_kernel_coverage(image_rect, 10, 15, coverage);
+  EXPECT_FLOAT_EQ(coverage[0], 9.0f);
+  EXPECT_FLOAT_EQ(coverage[1], 9.0f);
+  EXPECT_FLOAT_EQ(coverage[2], 9.0f);
+
+  /* Columns 1 to 4 and rows 1 to 2. */
+  convolution.get_kernel_coverage(image_rect, 18, 19, coverage);
+  EXPECT_FLOAT_EQ(coverage[0], 8.0f);
+  EXPECT_FLOAT_EQ(coverage[1], 20.0f);
+  EXPECT_FLOAT_EQ(coverage[2], 12.0f);
+
+  /* Kernel outside of the image. */
+  convolution.get_kernel_coverage(image_rect, 30, 15, coverage);
+  EXPECT_FLOAT_EQ(coverage[0], 0.0f);
+}
+
+}  // namespace blender::compositor::tests
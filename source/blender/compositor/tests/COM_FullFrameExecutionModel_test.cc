@@ -0,0 +1,209 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2022, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "BLI_rect.h"
+
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+
+#include "COM_ExecutionSystem.h"
+#include "COM_FullFrameExecutionModel.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_NodeOperation.h"
+#include "COM_SharedOperationBuffers.h"
+#include "COM_WorkScheduler.h"
+
+namespace blender::compositor::tests {
+
+constexpr int WIDTH = 40;
+constexpr int HEIGHT = 20;
+
+/** Records the areas it renders. */
+class RecordingOperation : public NodeOperation {
+ public:
+  Vector<rcti> rendered_areas;
+
+  RecordingOperation()
+  {
+    add_output_socket(DataType::Value);
+    rcti canvas;
+    BLI_rcti_init(&canvas, 0, WIDTH, 0, HEIGHT);
+    set_canvas(canvas);
+    flags_.is_fullframe_operation = true;
+  }
+
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &area,
+                            Span<MemoryBuffer *> UNUSED(inputs)) override
+  {
+    rendered_areas.append(area);
+    output->fill(area, &value_);
+  }
+
+ private:
+  float value_ = 1.0f;
+};
+
+/** Output operation recording the areas it renders, a viewer or any other output. */
+class RecordingOutputOperation : public NodeOperation {
+ public:
+  Vector<rcti> rendered_areas;
+
+  RecordingOutputOperation(NodeOperation &input, const bool is_viewer)
+  {
+    add_input_socket(DataType::Value);
+    get_input_socket(0)->set_link(input.get_output_socket());
+    set_canvas(input.get_canvas());
+    flags_.is_fullframe_operation = true;
+    flags_.is_viewer_operation = is_viewer;
+  }
+
+  bool is_output_operation(bool UNUSED(rendering)) const override
+  {
+    return true;
+  }
+
+  void update_memory_buffer(MemoryBuffer *UNUSED(output),
+                            const rcti &area,
+                            Span<MemoryBuffer *> UNUSED(inputs)) override
+  {
+    rendered_areas.append(area);
+  }
+};
+
+static void progress_noop(void *UNUSED(handle), float UNUSED(progress))
+{
+}
+
+static void stats_draw_noop(void *UNUSED(handle), const char *UNUSED(str))
+{
+}
+
+static int test_break_never(void *UNUSED(handle))
+{
+  return false;
+}
+
+class FullFrameExecutionModelTest : public testing::Test {
+ protected:
+  bNodeTree node_tree_ = {};
+  RenderData render_data_ = {};
+
+  void SetUp() override
+  {
+    node_tree_.progress = progress_noop;
+    node_tree_.stats_draw = stats_draw_noop;
+    node_tree_.test_break = test_break_never;
+    WorkScheduler::initialize(false, 1);
+  }
+
+  void TearDown() override
+  {
+    WorkScheduler::deinitialize();
+  }
+
+  /** Execute given operations as #COM_execute does, with an optional viewer region. */
+  void execute(Span<NodeOperation *> operations, const rctf *viewer_region)
+  {
+    /* The execution system is only passed through for debugging, its operations are unused. */
+    ExecutionSystem exec_system(&render_data_,
+                                nullptr,
+                                &node_tree_,
+                                false,
+                                false,
+                                nullptr,
+                                nullptr,
+                                "",
+                                nullptr,
+                                nullptr);
+
+    CompositorContext context;
+    context.set_bnodetree(&node_tree_);
+    context.set_render_data(&render_data_);
+    context.set_rendering(false);
+    context.set_quality(eCompositorQuality::High);
+    context.set_viewer_region(viewer_region);
+
+    SharedOperationBuffers buffers;
+    FullFrameExecutionModel model(context, buffers, nullptr, operations);
+    model.execute(exec_system);
+  }
+};
+
+TEST_F(FullFrameExecutionModelTest, viewer_region_computed_first)
+{
+  RecordingOperation input_op;
+  RecordingOutputOperation viewer_op(input_op, true);
+  RecordingOutputOperation composite_op(input_op, false);
+  const Vector<NodeOperation *> operations = {&input_op, &viewer_op, &composite_op};
+
+  /* Region pass, partial pixels at the region bounds are included. */
+  rctf viewer_region;
+  BLI_rctf_init(&viewer_region, 0.26f, 0.5f, 0.0f, 0.51f);
+  execute(operations, &viewer_region);
+
+  rcti region_area;
+  BLI_rcti_init(&region_area, 10, 20, 0, 11);
+  ASSERT_EQ(viewer_op.rendered_areas.size(), 1);
+  EXPECT_TRUE(BLI_rcti_compare(&viewer_op.rendered_areas[0], &region_area));
+  ASSERT_EQ(input_op.rendered_areas.size(), 1);
+  EXPECT_TRUE(BLI_rcti_compare(&input_op.rendered_areas[0], &region_area));
+  /* Other outputs wait for the full execution. */
+  EXPECT_TRUE(composite_op.rendered_areas.is_empty());
+
+  /* Full execution computes all outputs entirely. */
+  execute(operations, nullptr);
+
+  rcti full_area;
+  BLI_rcti_init(&full_area, 0, WIDTH, 0, HEIGHT);
+  ASSERT_EQ(viewer_op.rendered_areas.size(), 2);
+  EXPECT_TRUE(BLI_rcti_compare(&viewer_op.rendered_areas[1], &full_area));
+  ASSERT_EQ(composite_op.rendered_areas.size(), 1);
+  EXPECT_TRUE(BLI_rcti_compare(&composite_op.rendered_areas[0], &full_area));
+  ASSERT_EQ(input_op.rendered_areas.size(), 2);
+  EXPECT_TRUE(BLI_rcti_compare(&input_op.rendered_areas[1], &full_area));
+}
+
+TEST_F(FullFrameExecutionModelTest, viewer_region_outside_viewer_border)
+{
+  RecordingOperation input_op;
+  RecordingOutputOperation viewer_op(input_op, true);
+  const Vector<NodeOperation *> operations = {&input_op, &viewer_op};
+
+  /* Only the part of the visible region within the viewer border is computed. */
+  node_tree_.flag |= NTREE_VIEWER_BORDER;
+  BLI_rctf_init(&node_tree_.viewer_border, 0.0f, 0.5f, 0.0f, 1.0f);
+  rctf viewer_region;
+  BLI_rctf_init(&viewer_region, 0.25f, 1.0f, 0.5f, 1.0f);
+  execute(operations, &viewer_region);
+
+  rcti area;
+  BLI_rcti_init(&area, 10, 20, 10, 20);
+  ASSERT_EQ(viewer_op.rendered_areas.size(), 1);
+  EXPECT_TRUE(BLI_rcti_compare(&viewer_op.rendered_areas[0], &area));
+
+  /* Nothing is computed when the visible region is outside of the border. */
+  BLI_rctf_init(&viewer_region, 0.75f, 1.0f, 0.0f, 1.0f);
+  execute(operations, &viewer_region);
+  EXPECT_EQ(viewer_op.rendered_areas.size(), 1);
+  EXPECT_EQ(input_op.rendered_areas.size(), 1);
+}
+
+}  // namespace blender::compositor::tests
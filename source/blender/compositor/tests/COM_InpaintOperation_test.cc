@@ -0,0 +1,126 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2022, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_rand.hh"
+
+#include "COM_InpaintOperation.h"
+
+namespace blender::compositor::tests {
+
+/** Straightforward single threaded in-paint, processing pixels in raster order per distance. */
+static void inpaint_reference(MemoryBuffer &image, const int iterations)
+{
+  const int width = image.get_width();
+  const int height = image.get_height();
+  Array<int> distance(width * height);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      int r = 0;
+      if (image.get_elem(x, y)[3] < 1.0f) {
+        r = width + height;
+        for (int ky = 0; ky < height; ky++) {
+          for (int kx = 0; kx < width; kx++) {
+            if (image.get_elem(kx, ky)[3] >= 1.0f) {
+              r = min_ii(r, abs(kx - x) + abs(ky - y));
+            }
+          }
+        }
+      }
+      distance[y * width + x] = r;
+    }
+  }
+
+  for (int d = 1; d <= min_ii(iterations, width + height); d++) {
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        if (distance[y * width + x] != d) {
+          continue;
+        }
+        float pix[3] = {0.0f, 0.0f, 0.0f};
+        float pix_divider = 0.0f;
+        for (int dx = -1; dx <= 1; dx++) {
+          for (int dy = -1; dy <= 1; dy++) {
+            if (dx == 0 && dy == 0) {
+              continue;
+            }
+            const int x_ofs = clamp_i(x + dx, 0, width - 1);
+            const int y_ofs = clamp_i(y + dy, 0, height - 1);
+            if (distance[y_ofs * width + x_ofs] < d) {
+              const float weight = (dx == 0 || dy == 0) ? 1.0f : M_SQRT1_2;
+              madd_v3_v3fl(pix, image.get_elem(x_ofs, y_ofs), weight);
+              pix_divider += weight;
+            }
+          }
+        }
+        float *output = image.get_elem(x, y);
+        if (pix_divider != 0.0f) {
+          mul_v3_fl(pix, 1.0f / pix_divider);
+          interp_v3_v3v3(output, pix, output, output[3]);
+          output[3] = 1.0f;
+        }
+      }
+    }
+  }
+}
+
+static void test_inpaint(const int width, const int height, const int iterations)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, width, 0, height);
+  MemoryBuffer input(DataType::Color, rect);
+  RandomNumberGenerator rng(0);
+  for (BuffersIterator<float> it = input.iterate_with({}); !it.is_end(); ++it) {
+    it.out[0] = rng.get_float();
+    it.out[1] = rng.get_float();
+    it.out[2] = rng.get_float();
+    /* Known pixels in a disk, partially transparent ones around it. */
+    const float distance = hypotf(it.x - width / 3, it.y - height / 2);
+    it.out[3] = clamp_f(float(height / 4) - distance, 0.0f, 1.0f);
+  }
+
+  MemoryBuffer expected(input);
+  inpaint_reference(expected, iterations);
+
+  InpaintSimpleOperation operation;
+  operation.set_iterations(iterations);
+  operation.set_canvas(rect);
+  operation.init_execution();
+  MemoryBuffer output(DataType::Color, rect);
+  operation.update_memory_buffer(&output, rect, {&input});
+  operation.deinit_execution();
+
+  for (BuffersIterator<float> it = output.iterate_with({}); !it.is_end(); ++it) {
+    const float *expected_elem = expected.get_elem(it.x, it.y);
+    EXPECT_EQ(it.out[0], expected_elem[0]);
+    EXPECT_EQ(it.out[1], expected_elem[1]);
+    EXPECT_EQ(it.out[2], expected_elem[2]);
+    EXPECT_EQ(it.out[3], expected_elem[3]);
+  }
+}
+
+TEST(InpaintSimpleOperation, matches_reference)
+{
+  test_inpaint(60, 40, 5);
+  test_inpaint(60, 40, 200);
+  test_inpaint(1, 30, 200);
+}
+
+}  // namespace blender::compositor::tests
@@ -18,6 +18,8 @@
 
 #include "testing/testing.h"
 
+#include "BLI_array.hh"
+
 #include "COM_ConstantOperation.h"
 
 namespace blender::compositor::tests {
@@ -86,6 +88,36 @@ class HashedOperation : public NodeOperation {
   }
 };
 
+/* Reads data from outside the compositor, identified by its buffer and an update counter. */
+class HashedDataOperation : public NodeOperation {
+ private:
+  const float *buffer_;
+  int update_counter_ = 0;
+
+ public:
+  HashedDataOperation(int id, const float *buffer) : buffer_(buffer)
+  {
+    set_id(id);
+    add_output_socket(DataType::Value);
+    set_width(2);
+    set_height(3);
+  }
+
+  void tag_update()
+  {
+    update_counter_++;
+  }
+
+  void hash_output_params() override
+  {
+  }
+
+  void hash_output_data() override
+  {
+    hash_params(buffer_, update_counter_);
+  }
+};
+
 static void test_non_equal_hashes_compare(NodeOperationHash &h1,
                                           NodeOperationHash &h2,
                                           NodeOperationHash &h3)
@@ -166,4 +198,40 @@ TEST(NodeOperation, generate_hash)
   }
 }
 
+TEST(NodeOperation, generate_result_hash)
+{
+  Map<NodeOperation *, size_t> hashes;
+
+  NonHashedOperation non_hashed_op(1);
+  EXPECT_EQ(non_hashed_op.generate_result_hash(hashes), std::nullopt);
+  HashedOperation non_hashed_input_op(non_hashed_op, 6, 4);
+  EXPECT_EQ(non_hashed_input_op.generate_result_hash(hashes), std::nullopt);
+
+  /* Result hashes don't depend on operations ids, only on data and parameters. */
+  const Array<float> data(6, 0.5f);
+  HashedDataOperation data_op1(1, data.data());
+  HashedDataOperation data_op2(2, data.data());
+  const size_t data_hash = *data_op1.generate_result_hash(hashes);
+  EXPECT_EQ(data_hash, *data_op2.generate_result_hash(hashes));
+  data_op2.tag_update();
+  EXPECT_NE(data_hash, *data_op2.generate_result_hash(hashes));
+  const Array<float> other_data(6, 0.5f);
+  HashedDataOperation other_data_op(3, other_data.data());
+  EXPECT_NE(data_hash, *other_data_op.generate_result_hash(hashes));
+
+  /* Inputs results hashes are required. */
+  HashedOperation op1(data_op1, 6, 4);
+  HashedOperation op2(data_op2, 6, 4);
+  EXPECT_EQ(op1.generate_result_hash(hashes), std::nullopt);
+  hashes.add(&data_op1, data_hash);
+  hashes.add(&data_op2, data_hash);
+  const size_t hash1 = *op1.generate_result_hash(hashes);
+  EXPECT_EQ(hash1, *op2.generate_result_hash(hashes));
+  hashes.add_overwrite(&data_op2, *data_op2.generate_result_hash(hashes));
+  EXPECT_NE(hash1, *op2.generate_result_hash(hashes));
+  op2.set_param1(-1);
+  hashes.add_overwrite(&data_op2, data_hash);
+  EXPECT_NE(hash1, *op2.generate_result_hash(hashes));
+}
+
 }  // namespace blender::compositor::tests
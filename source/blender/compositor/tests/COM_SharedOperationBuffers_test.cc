@@ -0,0 +1,157 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2022, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_NodeOperation.h"
+#include "COM_SharedOperationBuffers.h"
+
+namespace blender::compositor::tests {
+
+constexpr int BUFFER_WIDTH = 32;
+constexpr int BUFFER_HEIGHT = 16;
+
+class BufferOperation : public NodeOperation {
+};
+
+static std::unique_ptr<MemoryBuffer> create_buffer(DataType data_type)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, BUFFER_WIDTH, 0, BUFFER_HEIGHT);
+  std::unique_ptr<MemoryBuffer> buffer = std::make_unique<MemoryBuffer>(data_type, rect);
+  const int size = BUFFER_WIDTH * BUFFER_HEIGHT * buffer->get_num_channels();
+  for (int i = 0; i < size; i++) {
+    (*buffer)[i] = (i - size / 2) * 0.37f;
+  }
+  return buffer;
+}
+
+static size_t get_float_size(DataType data_type)
+{
+  return sizeof(float) * BUFFER_WIDTH * BUFFER_HEIGHT * COM_data_type_num_channels(data_type);
+}
+
+TEST(MemoryBuffer, pack_half_float)
+{
+  std::unique_ptr<MemoryBuffer> buffer = create_buffer(DataType::Color);
+  const float special_values[] = {0.0f,
+                                  -0.0f,
+                                  1.0f,
+                                  65504.0f,
+                                  1.0e6f,
+                                  -1.0e6f,
+                                  1.0e-6f,
+                                  1.0e-9f,
+                                  std::numeric_limits<float>::infinity()};
+  const float expected_special_values[] = {0.0f,
+                                           -0.0f,
+                                           1.0f,
+                                           65504.0f,
+                                           65504.0f,
+                                           -65504.0f,
+                                           17.0f / (1 << 24),
+                                           0.0f,
+                                           std::numeric_limits<float>::infinity()};
+  const int special_values_num = ARRAY_SIZE(special_values);
+  for (int i = 0; i < special_values_num; i++) {
+    (*buffer)[i] = special_values[i];
+  }
+  (*buffer)[special_values_num] = std::numeric_limits<float>::quiet_NaN();
+  const MemoryBuffer original(*buffer);
+
+  EXPECT_TRUE(buffer->can_pack_half_float());
+  buffer->pack_half_float();
+  EXPECT_TRUE(buffer->is_half_float_packed());
+  EXPECT_FALSE(buffer->can_pack_half_float());
+  EXPECT_EQ(buffer->get_memory_size(), get_float_size(DataType::Color) / 2);
+  buffer->unpack_half_float();
+  EXPECT_FALSE(buffer->is_half_float_packed());
+  EXPECT_EQ(buffer->get_memory_size(), get_float_size(DataType::Color));
+
+  for (int i = 0; i < special_values_num; i++) {
+    EXPECT_EQ((*buffer)[i], expected_special_values[i]);
+  }
+  EXPECT_TRUE(std::isnan((*buffer)[special_values_num]));
+
+  /* Half float has 11 bits of precision. */
+  const int size = BUFFER_WIDTH * BUFFER_HEIGHT * COM_DATA_TYPE_COLOR_CHANNELS;
+  for (int i = special_values_num + 1; i < size; i++) {
+    EXPECT_NEAR((*buffer)[i], original[i], fabsf(original[i]) / 2048.0f);
+  }
+}
+
+TEST(MemoryBuffer, can_pack_half_float)
+{
+  EXPECT_TRUE(create_buffer(DataType::Vector)->can_pack_half_float());
+  /* Value buffers may contain depth or indices. */
+  EXPECT_FALSE(create_buffer(DataType::Value)->can_pack_half_float());
+
+  rcti rect;
+  BLI_rcti_init(&rect, 0, BUFFER_WIDTH, 0, BUFFER_HEIGHT);
+  MemoryBuffer single_elem(DataType::Color, rect, true);
+  EXPECT_FALSE(single_elem.can_pack_half_float());
+
+  std::unique_ptr<MemoryBuffer> owner = create_buffer(DataType::Color);
+  MemoryBuffer shared(owner->get_buffer(), owner->get_num_channels(), rect);
+  EXPECT_FALSE(shared.can_pack_half_float());
+}
+
+TEST(SharedOperationBuffers, release_and_peak_memory)
+{
+  BufferOperation op1, op2, op3;
+  SharedOperationBuffers buffers;
+  buffers.set_use_half_float(true);
+  buffers.register_read(&op1);
+  buffers.register_read(&op1);
+  buffers.register_read(&op2);
+
+  const size_t color_size = get_float_size(DataType::Color);
+  const size_t value_size = get_float_size(DataType::Value);
+  std::unique_ptr<MemoryBuffer> buffer1 = create_buffer(DataType::Color);
+  const MemoryBuffer original1(*buffer1);
+  buffers.set_rendered_buffer(&op1, std::move(buffer1));
+  EXPECT_EQ(buffers.get_memory_in_use(), color_size / 2);
+  EXPECT_EQ(buffers.get_peak_memory(), color_size + color_size / 2);
+
+  buffers.set_rendered_buffer(&op2, create_buffer(DataType::Value));
+  EXPECT_EQ(buffers.get_memory_in_use(), color_size / 2 + value_size);
+
+  /* Buffers nobody reads are disposed right away. */
+  buffers.set_rendered_buffer(&op3, create_buffer(DataType::Color));
+  EXPECT_TRUE(buffers.is_operation_rendered(&op3));
+  EXPECT_EQ(buffers.get_memory_in_use(), color_size / 2 + value_size);
+
+  /* Unpacked while read, packed again until last read. */
+  MemoryBuffer *read_buffer = buffers.get_rendered_buffer(&op1);
+  EXPECT_FALSE(read_buffer->is_half_float_packed());
+  EXPECT_NEAR((*read_buffer)[7], original1[7], fabsf(original1[7]) / 2048.0f);
+  EXPECT_EQ(buffers.get_memory_in_use(), color_size + value_size);
+  buffers.read_finished(&op1);
+  EXPECT_TRUE(read_buffer->is_half_float_packed());
+  EXPECT_EQ(buffers.get_memory_in_use(), color_size / 2 + value_size);
+
+  buffers.get_rendered_buffer(&op1);
+  buffers.read_finished(&op1);
+  EXPECT_EQ(buffers.get_memory_in_use(), value_size);
+  buffers.read_finished(&op2);
+  EXPECT_EQ(buffers.get_memory_in_use(), 0);
+  EXPECT_EQ(buffers.get_peak_memory(), color_size + color_size / 2 + value_size);
+}
+
+}  // namespace blender::compositor::tests
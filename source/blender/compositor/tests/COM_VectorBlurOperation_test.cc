@@ -0,0 +1,109 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2022, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "BLI_threads.h"
+
+#include "COM_VectorBlurOperation.h"
+
+namespace blender::compositor::tests {
+
+constexpr int WIDTH = 64;
+constexpr int HEIGHT = 48;
+
+/** Image with a square in front of a gradient, moving with given speed. */
+static void vector_blur(const float speed[4], const int threads_num, MemoryBuffer &output)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, WIDTH, 0, HEIGHT);
+  MemoryBuffer image(DataType::Color, rect);
+  MemoryBuffer z(DataType::Value, rect);
+  MemoryBuffer speeds(DataType::Color, rect);
+  for (BuffersIterator<float> it = image.iterate_with({}); !it.is_end(); ++it) {
+    const bool is_square = it.x >= 20 && it.x < 40 && it.y >= 15 && it.y < 30;
+    if (is_square) {
+      const float color[4] = {1.0f, 0.5f, 0.0f, 1.0f};
+      copy_v4_v4(it.out, color);
+      copy_v4_v4(speeds.get_elem(it.x, it.y), speed);
+    }
+    else {
+      const float color[4] = {it.x / float(WIDTH), it.y / float(HEIGHT), 1.0f, 1.0f};
+      copy_v4_v4(it.out, color);
+      zero_v4(speeds.get_elem(it.x, it.y));
+    }
+    *z.get_elem(it.x, it.y) = is_square ? 1.0f : 10.0f;
+  }
+
+  NodeBlurData settings = {0};
+  settings.samples = 16;
+  settings.maxspeed = 0;
+  settings.minspeed = 0;
+  settings.curved = 0;
+  settings.fac = 1.0f;
+
+  VectorBlurOperation operation;
+  operation.set_vector_blur_settings(&settings);
+  operation.set_canvas(rect);
+  BLI_system_num_threads_override_set(threads_num);
+  operation.init_execution();
+  operation.update_memory_buffer(&output, rect, {&image, &z, &speeds});
+  operation.deinit_execution();
+  BLI_system_num_threads_override_set(0);
+}
+
+TEST(VectorBlurOperation, threads_independent)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, WIDTH, 0, HEIGHT);
+  const float speed[4] = {12.0f, 4.0f, -12.0f, -4.0f};
+  MemoryBuffer single_thread(DataType::Color, rect);
+  vector_blur(speed, 1, single_thread);
+  MemoryBuffer multi_thread(DataType::Color, rect);
+  vector_blur(speed, 5, multi_thread);
+
+  int blurred_num = 0;
+  for (BuffersIterator<float> it = multi_thread.iterate_with({}); !it.is_end(); ++it) {
+    const float *expected = single_thread.get_elem(it.x, it.y);
+    EXPECT_EQ(it.out[0], expected[0]);
+    EXPECT_EQ(it.out[1], expected[1]);
+    EXPECT_EQ(it.out[2], expected[2]);
+    EXPECT_EQ(it.out[3], expected[3]);
+    /* Square is blurred into the background in the direction of motion. */
+    if (it.y == 20 && it.x >= 40 && it.out[0] > it.x / float(WIDTH) + 0.01f) {
+      blurred_num++;
+    }
+  }
+  EXPECT_GT(blurred_num, 2);
+}
+
+TEST(VectorBlurOperation, no_motion)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, WIDTH, 0, HEIGHT);
+  const float speed[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  MemoryBuffer output(DataType::Color, rect);
+  vector_blur(speed, 4, output);
+  for (BuffersIterator<float> it = output.iterate_with({}); !it.is_end(); ++it) {
+    const bool is_square = it.x >= 20 && it.x < 40 && it.y >= 15 && it.y < 30;
+    EXPECT_FLOAT_EQ(it.out[0], is_square ? 1.0f : it.x / float(WIDTH));
+    EXPECT_FLOAT_EQ(it.out[1], is_square ? 0.5f : it.y / float(HEIGHT));
+  }
+}
+
+}  // namespace blender::compositor::tests
@@ -83,6 +83,16 @@ void DEG_graph_relations_update(struct Depsgraph *graph);
 /** Tag all relations in the database for update. */
 void DEG_relations_tag_update(struct Main *bmain);
 
+/**
+ * Tag relations of the given ID for update in all dependency graphs.
+ *
+ * Unlike #DEG_relations_tag_update this allows graphs to only re-build nodes and relations of the
+ * ID and its direct neighbours, falling back to a full rebuild when this is not possible.
+ * Meant to be used for changes which only affect relations of the ID itself, such as adding a
+ * modifier, constraint or driver.
+ */
+void DEG_id_tag_relations_update(struct Main *bmain, struct ID *id);
+
 /* Add Dependencies  ----------------------------- */
 
 /**
@@ -393,6 +393,68 @@ void DepsgraphNodeBuilder::begin_build()
   graph_->entry_tags.clear();
 }
 
+void DepsgraphNodeBuilder::begin_build_partial(Span<IDNode *> id_nodes)
+{
+  Set<IDNode *> rebuild_id_nodes;
+  for (IDNode *id_node : id_nodes) {
+    rebuild_id_nodes.add(id_node);
+  }
+
+  for (IDNode *id_node : graph_->id_nodes) {
+    /* Visibility of components is re-flushed from scratch when the build is finalized. */
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      comp_node->affects_directly_visible = false;
+    }
+    if (!rebuild_id_nodes.contains(id_node)) {
+      /* Node is kept as-is: consider it built, and make it so the finalization only reacts on
+       * changes which are caused by the partial update. */
+      id_node->previously_visible_components_mask = id_node->visible_components_mask;
+      id_node->previous_eval_flags = id_node->eval_flags;
+      id_node->previous_customdata_masks = id_node->customdata_masks;
+      built_map_.tagBuild(id_node->id_orig);
+      continue;
+    }
+
+    /* The ID node itself is not removed from the graph, so its copy-on-write data-block does not
+     * need to be stolen. Only the state which the finalization compares against is stored. */
+    IDInfo *id_info = (IDInfo *)MEM_mallocN(sizeof(IDInfo), "depsgraph id info");
+    id_info->id_cow = nullptr;
+    id_info->previously_visible_components_mask = id_node->visible_components_mask;
+    id_info->previous_eval_flags = id_node->eval_flags;
+    id_info->previous_customdata_masks = id_node->customdata_masks;
+    BLI_assert(!id_info_hash_.contains(id_node->id_orig_session_uuid));
+    id_info_hash_.add_new(id_node->id_orig_session_uuid, id_info);
+
+    id_node->linked_state = DEG_ID_LINKED_INDIRECTLY;
+    id_node->is_directly_visible = true;
+    id_node->is_collection_fully_expanded = false;
+    id_node->has_base = false;
+    id_node->eval_flags = 0;
+    id_node->customdata_masks = DEGCustomDataMeshMasks();
+    id_node->visible_components_mask = 0;
+  }
+
+  for (OperationNode *op_node : graph_->entry_tags) {
+    ComponentNode *comp_node = op_node->owner;
+    IDNode *id_node = comp_node->owner;
+    if (!rebuild_id_nodes.contains(id_node)) {
+      continue;
+    }
+
+    SavedEntryTag entry_tag;
+    entry_tag.id_orig = id_node->id_orig;
+    entry_tag.component_type = comp_node->type;
+    entry_tag.opcode = op_node->opcode;
+    entry_tag.name = op_node->name;
+    entry_tag.name_tag = op_node->name_tag;
+    saved_entry_tags_.append(entry_tag);
+  }
+
+  for (IDNode *id_node : id_nodes) {
+    graph_->clear_id_node_components(id_node);
+  }
+}
+
 /* Util callbacks for `BKE_library_foreach_ID_link`, used to detect when a COW ID is using ID
  * pointers that are either:
  *  - COW ID pointers that do not exist anymore in current depsgraph.
@@ -102,6 +102,14 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void begin_build();
   virtual void end_build();
 
+  /**
+   * Begin partial update of the graph, where only nodes of the given IDs are re-created.
+   *
+   * Nodes of all other IDs are kept as-is and are considered built. The copy-on-write
+   * data-blocks of the re-created IDs are preserved.
+   */
+  virtual void begin_build_partial(Span<IDNode *> id_nodes);
+
   /**
    * `id_cow_self` is the user of `id_pointer`,
    * see also `LibraryIDLinkCallbackData` struct definition.
@@ -179,6 +187,11 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void build_view_layer(Scene *scene,
                                 ViewLayer *view_layer,
                                 eDepsNode_LinkedState_Type linked_state);
+  /* Build objects of the given set which have base in the view layer, in the same way as they are
+   * built by #build_view_layer. Used by partial updates of the graph. */
+  virtual void build_view_layer_objects(Scene *scene,
+                                        ViewLayer *view_layer,
+                                        const Set<Object *> &objects);
   virtual void build_collection(LayerCollection *from_layer_collection, Collection *collection);
   virtual void build_object(int base_index,
                             Object *object,
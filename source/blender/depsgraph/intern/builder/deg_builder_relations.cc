@@ -247,7 +247,10 @@ bool object_have_geometry_component(const Object *object)
 DepsgraphRelationBuilder::DepsgraphRelationBuilder(Main *bmain,
                                                    Depsgraph *graph,
                                                    DepsgraphBuilderCache *cache)
-    : DepsgraphBuilder(bmain, graph, cache), scene_(nullptr), rna_node_query_(graph, this)
+    : DepsgraphBuilder(bmain, graph, cache),
+      scene_(nullptr),
+      relation_flags_(0),
+      rna_node_query_(graph, this)
 {
 }
 
@@ -353,7 +356,7 @@ Relation *DepsgraphRelationBuilder::add_time_relation(TimeSourceNode *timesrc,
                                                       int flags)
 {
   if (timesrc && node_to) {
-    return graph_->add_new_relation(timesrc, node_to, description, flags);
+    return graph_->add_new_relation(timesrc, node_to, description, flags | relation_flags_);
   }
 
   DEG_DEBUG_PRINTF((::Depsgraph *)graph_,
@@ -381,7 +384,7 @@ Relation *DepsgraphRelationBuilder::add_operation_relation(OperationNode *node_f
                                                            int flags)
 {
   if (node_from && node_to) {
-    return graph_->add_new_relation(node_from, node_to, description, flags);
+    return graph_->add_new_relation(node_from, node_to, description, flags | relation_flags_);
   }
 
   DEG_DEBUG_PRINTF((::Depsgraph *)graph_,
@@ -495,6 +498,19 @@ void DepsgraphRelationBuilder::begin_build()
 {
 }
 
+void DepsgraphRelationBuilder::begin_build_partial(Scene *scene, const Set<ID *> &rebuild_ids)
+{
+  scene_ = scene;
+  for (IDNode *id_node : graph_->id_nodes) {
+    if (!rebuild_ids.contains(id_node->id_orig)) {
+      built_map_.tagBuild(id_node->id_orig);
+    }
+  }
+  /* Relations of the IDs which are re-built might already be in the graph, when they are
+   * created by the builder of a neighbour ID. */
+  relation_flags_ = RELATION_CHECK_BEFORE_ADD;
+}
+
 void DepsgraphRelationBuilder::build_id(ID *id)
 {
   if (id == nullptr) {
@@ -2966,6 +2982,11 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
       /* Component explicitly requests to not add relation. */
       continue;
     }
+    if (comp_node->operations_map == nullptr) {
+      /* Component is kept from previous build of the graph by a partial update, its relations
+       * are already in place. */
+      continue;
+    }
     int rel_flag = (RELATION_FLAG_NO_FLUSH | RELATION_FLAG_GODMODE);
     if ((ELEM(id_type, ID_ME, ID_HA, ID_PT, ID_VO) && comp_node->type == NodeType::GEOMETRY) ||
         (id_type == ID_CF && comp_node->type == NodeType::CACHE)) {
@@ -2995,7 +3016,8 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
      * copy of ID. */
     OperationNode *op_entry = comp_node->get_entry_operation();
     if (op_entry != nullptr) {
-      Relation *rel = graph_->add_new_relation(op_cow, op_entry, "CoW Dependency");
+      Relation *rel = graph_->add_new_relation(
+          op_cow, op_entry, "CoW Dependency", relation_flags_);
       rel->flag |= rel_flag;
     }
     /* All dangling operations should also be executed after copy-on-write. */
@@ -3004,7 +3026,8 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
         continue;
       }
       if (op_node->inlinks.is_empty()) {
-        Relation *rel = graph_->add_new_relation(op_cow, op_node, "CoW Dependency");
+        Relation *rel = graph_->add_new_relation(
+            op_cow, op_node, "CoW Dependency", relation_flags_);
         rel->flag |= rel_flag;
       }
       else {
@@ -3020,7 +3043,8 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
           }
         }
         if (!has_same_comp_dependency) {
-          Relation *rel = graph_->add_new_relation(op_cow, op_node, "CoW Dependency");
+          Relation *rel = graph_->add_new_relation(
+              op_cow, op_node, "CoW Dependency", relation_flags_);
           rel->flag |= rel_flag;
         }
       }
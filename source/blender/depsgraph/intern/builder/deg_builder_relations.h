@@ -165,6 +165,14 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
 
   void begin_build();
 
+  /**
+   * Begin partial update of the graph relations.
+   *
+   * Relations of IDs from the given set are to be re-created, all other IDs of the graph are
+   * considered built. Relations which already exist in the graph are not duplicated.
+   */
+  void begin_build_partial(Scene *scene, const Set<ID *> &rebuild_ids);
+
   template<typename KeyFrom, typename KeyTo>
   Relation *add_relation(const KeyFrom &key_from,
                          const KeyTo &key_to,
@@ -379,6 +387,9 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   /* State which demotes currently built entities. */
   Scene *scene_;
 
+  /* Flags which are added to every relation created by this builder. */
+  int relation_flags_;
+
   BuilderMap built_map_;
   RNANodeQuery rna_node_query_;
 };
@@ -61,6 +61,10 @@ void deg_graph_remove_unused_noops(Depsgraph *graph)
     OperationNode *to_remove = queue.front();
     queue.pop_front();
 
+    if (!to_remove->inlinks.is_empty()) {
+      to_remove->flag |= OperationFlag::DEPSOP_FLAG_UNUSED_NOOP_REMOVED;
+    }
+
     while (!to_remove->inlinks.is_empty()) {
       Relation *rel_in = to_remove->inlinks[0];
       Node *dependency = rel_in->from;
@@ -19,6 +19,8 @@
 
 #include "pipeline.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "PIL_time.h"
 
 #include "BKE_global.h"
@@ -42,6 +44,8 @@ AbstractBuilderPipeline::AbstractBuilderPipeline(::Depsgraph *graph)
 
 void AbstractBuilderPipeline::build()
 {
+  MEM_DomainScope memory_domain(MEM_DOMAIN_DEPSGRAPH);
+
   double start_time = 0.0;
   if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
     start_time = PIL_check_seconds_timer();
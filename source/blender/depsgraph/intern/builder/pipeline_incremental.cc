@@ -0,0 +1,284 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2022 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "pipeline_incremental.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "PIL_time.h"
+
+#include "BLI_listbase.h"
+
+#include "BKE_global.h"
+
+#include "DNA_modifier_types.h"
+#include "DNA_object_force_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "intern/builder/deg_builder_nodes.h"
+#include "intern/builder/deg_builder_relations.h"
+#include "intern/depsgraph.h"
+#include "intern/depsgraph_physics.h"
+#include "intern/depsgraph_relation.h"
+#include "intern/node/deg_node.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace blender::deg {
+
+namespace {
+
+bool object_supports_incremental_update(const Depsgraph *graph, const IDNode *id_node)
+{
+  if (id_node->id_type != ID_OB) {
+    return false;
+  }
+  /* Object is to be built from its base, in the same way as the full build does. */
+  if (id_node->linked_state != DEG_ID_LINKED_DIRECTLY || !id_node->has_base) {
+    return false;
+  }
+  const Object *object = reinterpret_cast<const Object *>(id_node->id_orig);
+  /* Proxies and instanced collections are building nodes of other IDs, and the result depends on
+   * the order in which the objects are built. */
+  if (object->proxy != nullptr || object->proxy_from != nullptr ||
+      object->proxy_group != nullptr || object->instance_collection != nullptr) {
+    return false;
+  }
+  /* Physics relations are cached in the graph, and are only invalidated by a full rebuild. */
+  if (object->rigidbody_object != nullptr || object->rigidbody_constraint != nullptr ||
+      object->soft != nullptr) {
+    return false;
+  }
+  if (object->pd != nullptr && object->pd->forcefield != 0) {
+    return false;
+  }
+  if (!BLI_listbase_is_empty(&object->particlesystem)) {
+    return false;
+  }
+  LISTBASE_FOREACH (const ModifierData *, md, &object->modifiers) {
+    if (ELEM(md->type,
+             eModifierType_Collision,
+             eModifierType_Fluid,
+             eModifierType_DynamicPaint)) {
+      return false;
+    }
+  }
+  if (physics_relations_use_object(graph, object)) {
+    return false;
+  }
+  return true;
+}
+
+IDNode *relation_node_owner_id_node(const Node *node)
+{
+  if (node->type != NodeType::OPERATION) {
+    /* Time source. */
+    return nullptr;
+  }
+  const OperationNode *op_node = static_cast<const OperationNode *>(node);
+  return op_node->owner->owner;
+}
+
+}  // namespace
+
+IncrementalBuilderPipeline::IncrementalBuilderPipeline(::Depsgraph *graph)
+    : AbstractBuilderPipeline(graph)
+{
+  for (IDNode *id_node : deg_graph_->id_nodes_relations_update) {
+    id_nodes_.append(id_node);
+    if (id_node->id_type == ID_OB) {
+      objects_.add(reinterpret_cast<Object *>(id_node->id_orig));
+    }
+  }
+}
+
+bool IncrementalBuilderPipeline::can_build_incremental() const
+{
+  if (deg_graph_->is_render_pipeline_depsgraph) {
+    return false;
+  }
+  if (deg_graph_->id_nodes.is_empty()) {
+    return false;
+  }
+  for (const IDNode *id_node : id_nodes_) {
+    if (!object_supports_incremental_update(deg_graph_, id_node)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void IncrementalBuilderPipeline::collect_neighbour_id_nodes()
+{
+  Set<IDNode *> visited_id_nodes;
+  for (IDNode *id_node : id_nodes_) {
+    visited_id_nodes.add(id_node);
+  }
+  auto add_neighbour = [&](IDNode *id_node) {
+    if (id_node != nullptr && visited_id_nodes.add(id_node)) {
+      neighbour_id_nodes_.append(id_node);
+    }
+  };
+  for (IDNode *id_node : id_nodes_) {
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        for (Relation *rel : op_node->inlinks) {
+          add_neighbour(relation_node_owner_id_node(rel->from));
+        }
+        for (Relation *rel : op_node->outlinks) {
+          add_neighbour(relation_node_owner_id_node(rel->to));
+        }
+      }
+    }
+  }
+}
+
+bool IncrementalBuilderPipeline::has_pruned_noop_dependencies() const
+{
+  /* Incoming relations of the unused no-op nodes were removed by the previous build, so such
+   * nodes can not become a dependency without re-building the relations of their owners. */
+  for (const OperationNode *op_node : deg_graph_->operations) {
+    if ((op_node->flag & OperationFlag::DEPSOP_FLAG_UNUSED_NOOP_REMOVED) &&
+        !op_node->outlinks.is_empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IncrementalBuilderPipeline::build_incremental()
+{
+  MEM_DomainScope memory_domain(MEM_DOMAIN_DEPSGRAPH);
+
+  double start_time = 0.0;
+  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+    start_time = PIL_check_seconds_timer();
+  }
+
+  if (!can_build_incremental()) {
+    return false;
+  }
+  build_step_sanity_check();
+
+  /* NOTE: Neighbours are to be collected before the nodes are removed from the graph together
+   * with their relations. */
+  collect_neighbour_id_nodes();
+
+  const int64_t num_id_nodes = deg_graph_->id_nodes.size();
+  unique_ptr<DepsgraphNodeBuilder> node_builder = construct_node_builder();
+  node_builder->begin_build_partial(id_nodes_);
+  build_nodes(*node_builder);
+  node_builder->end_build();
+  node_builder.reset();
+  for (const IDNode *id_node : id_nodes_) {
+    if (!id_node->has_base) {
+      /* Object was not pulled into the graph from its base. */
+      return false;
+    }
+  }
+  for (int64_t i = num_id_nodes; i < deg_graph_->id_nodes.size(); i++) {
+    new_id_nodes_.append(deg_graph_->id_nodes[i]);
+  }
+
+  unique_ptr<DepsgraphRelationBuilder> relation_builder = construct_relation_builder();
+  Set<ID *> rebuild_ids;
+  for (Span<IDNode *> id_nodes : {id_nodes_.as_span(),
+                                  neighbour_id_nodes_.as_span(),
+                                  new_id_nodes_.as_span()}) {
+    for (IDNode *id_node : id_nodes) {
+      rebuild_ids.add(id_node->id_orig);
+    }
+  }
+  relation_builder->begin_build_partial(scene_, rebuild_ids);
+  build_relations(*relation_builder);
+  for (IDNode *id_node : deg_graph_->id_nodes) {
+    if (rebuild_ids.contains(id_node->id_orig)) {
+      relation_builder->build_copy_on_write_relations(id_node);
+      relation_builder->build_driver_relations(id_node);
+      continue;
+    }
+    /* Components of kept IDs might have been extended with new operations. */
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      if (comp_node->operations_map != nullptr) {
+        relation_builder->build_copy_on_write_relations(id_node);
+        break;
+      }
+    }
+  }
+  relation_builder.reset();
+
+  if (has_pruned_noop_dependencies()) {
+    return false;
+  }
+
+  /* Cycles are detected from scratch. */
+  for (OperationNode *op_node : deg_graph_->operations) {
+    for (Relation *rel : op_node->outlinks) {
+      rel->flag &= ~RELATION_FLAG_CYCLIC;
+    }
+  }
+  build_step_finalize();
+  deg_graph_->id_nodes_relations_update.clear();
+
+  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+    printf("Depsgraph relations of %d ID(s) updated in %f seconds.\n",
+           int(id_nodes_.size()),
+           PIL_check_seconds_timer() - start_time);
+  }
+  return true;
+}
+
+void IncrementalBuilderPipeline::build_nodes(DepsgraphNodeBuilder &node_builder)
+{
+  node_builder.build_view_layer_objects(scene_, view_layer_, objects_);
+}
+
+void IncrementalBuilderPipeline::build_relations(DepsgraphRelationBuilder &relation_builder)
+{
+  for (Object *object : objects_) {
+    relation_builder.build_object(object);
+  }
+  for (IDNode *id_node : neighbour_id_nodes_) {
+    ID *id = id_node->id_orig;
+    if (id == &scene_->id) {
+      /* Relations of the scene are built by the view layer builder, only re-create the ones
+       * which can possibly involve objects. */
+      relation_builder.build_scene_parameters(scene_);
+      relation_builder.build_scene_compositor(scene_);
+      if (scene_->adt != nullptr) {
+        relation_builder.build_animdata(&scene_->id);
+      }
+      relation_builder.build_scene_audio(scene_);
+      relation_builder.build_scene_sequencer(scene_);
+      continue;
+    }
+    relation_builder.build_id(id);
+  }
+  for (IDNode *id_node : new_id_nodes_) {
+    relation_builder.build_id(id_node->id_orig);
+  }
+}
+
+}  // namespace blender::deg
@@ -0,0 +1,77 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2022 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+#include "pipeline.h"
+
+#include "BLI_set.hh"
+#include "BLI_vector.hh"
+
+struct ID;
+struct Object;
+
+namespace blender {
+namespace deg {
+
+struct IDNode;
+
+/* Pipeline which updates nodes and relations of the IDs tagged for relations update, without
+ * re-building the rest of the graph built from a view layer.
+ *
+ * Nodes and relations of the tagged IDs are removed and built again, relations of their direct
+ * neighbours are re-created (without duplicating the ones which were kept). All other IDs are
+ * considered built.
+ *
+ * Only objects which have base in the view layer and which are not involved into physics or
+ * instancing are supported. For all other cases the build reports failure before modifying the
+ * graph, or after the modification if the graph can not be updated in a reliable way. In both
+ * cases the caller is to perform full rebuild of the graph. */
+class IncrementalBuilderPipeline : public AbstractBuilderPipeline {
+ public:
+  IncrementalBuilderPipeline(::Depsgraph *graph);
+
+  /* Returns false if the graph is to be fully rebuilt instead. */
+  bool build_incremental();
+
+ protected:
+  virtual void build_nodes(DepsgraphNodeBuilder &node_builder) override;
+  virtual void build_relations(DepsgraphRelationBuilder &relation_builder) override;
+
+ private:
+  bool can_build_incremental() const;
+  void collect_neighbour_id_nodes();
+  bool has_pruned_noop_dependencies() const;
+
+  /* Nodes of the IDs tagged for relations update. */
+  Vector<IDNode *> id_nodes_;
+  /* Objects of the tagged IDs. */
+  Set<Object *> objects_;
+  /* Nodes of IDs which are connected to the tagged IDs with a relation. */
+  Vector<IDNode *> neighbour_id_nodes_;
+  /* Nodes of IDs which were added to the graph by the update. */
+  Vector<IDNode *> new_id_nodes_;
+};
+
+}  // namespace deg
+}  // namespace blender
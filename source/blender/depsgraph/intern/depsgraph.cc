@@ -178,10 +178,52 @@ void Depsgraph::clear_id_nodes()
   /* Clear containers. */
   id_hash.clear();
   id_nodes.clear();
+  id_nodes_relations_update.clear();
   /* Clear physics relation caches. */
   clear_physics_relations(this);
 }
 
+void Depsgraph::clear_id_node_components(IDNode *id_node)
+{
+  Set<OperationNode *> removed_operations;
+  for (ComponentNode *comp_node : id_node->components.values()) {
+    for (OperationNode *op_node : comp_node->operations) {
+      removed_operations.add(op_node);
+    }
+    if (comp_node->operations_map != nullptr) {
+      for (OperationNode *op_node : comp_node->operations_map->values()) {
+        removed_operations.add(op_node);
+      }
+    }
+  }
+  /* Unlink relations from both sides, node destructors only free incoming relations. */
+  for (OperationNode *op_node : removed_operations) {
+    while (!op_node->inlinks.is_empty()) {
+      Relation *rel = op_node->inlinks[0];
+      rel->unlink();
+      delete rel;
+    }
+    while (!op_node->outlinks.is_empty()) {
+      Relation *rel = op_node->outlinks[0];
+      rel->unlink();
+      delete rel;
+    }
+    entry_tags.remove(op_node);
+  }
+  OperationNodes remaining_operations;
+  remaining_operations.reserve(operations.size());
+  for (OperationNode *op_node : operations) {
+    if (!removed_operations.contains(op_node)) {
+      remaining_operations.append(op_node);
+    }
+  }
+  operations = std::move(remaining_operations);
+  for (ComponentNode *comp_node : id_node->components.values()) {
+    delete comp_node;
+  }
+  id_node->components.clear();
+}
+
 Relation *Depsgraph::add_new_relation(Node *from, Node *to, const char *description, int flags)
 {
   Relation *rel = nullptr;
@@ -71,6 +71,9 @@ struct Depsgraph {
   IDNode *find_id_node(const ID *id) const;
   IDNode *add_id_node(ID *id, ID *id_cow_hint = nullptr);
   void clear_id_nodes();
+  /* Remove all components and operations of the ID node, together with their relations.
+   * The ID node itself and its copy-on-write data-block are preserved. */
+  void clear_id_node_components(IDNode *id_node);
 
   /** Add new relationship between two nodes. */
   Relation *add_new_relation(Node *from, Node *to, const char *description, int flags = 0);
@@ -108,6 +111,11 @@ struct Depsgraph {
   /* Indicates whether relations needs to be updated. */
   bool need_update;
 
+  /* ID nodes of which relations are to be updated, when there is no need to update all relations
+   * of the graph. Allows to only rebuild nodes and relations of these IDs and their direct
+   * neighbours. */
+  Set<IDNode *> id_nodes_relations_update;
+
   /* Indicated whether IDs in this graph are to be tagged as if they first appear visible, with
    * an optional tag for their animation (time) update. */
   bool need_visibility_update;
@@ -50,6 +50,7 @@
 #include "builder/pipeline_all_objects.h"
 #include "builder/pipeline_compositor.h"
 #include "builder/pipeline_from_ids.h"
+#include "builder/pipeline_incremental.h"
 #include "builder/pipeline_render.h"
 #include "builder/pipeline_view_layer.h"
 
@@ -303,8 +304,15 @@ void DEG_graph_relations_update(Depsgraph *graph)
 {
   deg::Depsgraph *deg_graph = (deg::Depsgraph *)graph;
   if (!deg_graph->need_update) {
-    /* Graph is up to date, nothing to do. */
-    return;
+    if (deg_graph->id_nodes_relations_update.is_empty()) {
+      /* Graph is up to date, nothing to do. */
+      return;
+    }
+    deg::IncrementalBuilderPipeline builder(graph);
+    if (builder.build_incremental()) {
+      return;
+    }
+    DEG_DEBUG_PRINTF(graph, BUILD, "%s: Falling back to full relations update.\n", __func__);
   }
   DEG_graph_build_from_view_layer(graph);
 }
@@ -316,3 +324,23 @@ void DEG_relations_tag_update(Main *bmain)
     DEG_graph_tag_relations_update(reinterpret_cast<Depsgraph *>(depsgraph));
   }
 }
+
+void DEG_id_tag_relations_update(Main *bmain, ID *id)
+{
+  DEG_GLOBAL_DEBUG_PRINTF(TAG, "%s: Tagging relations of %s for update.\n", __func__, id->name);
+  for (deg::Depsgraph *deg_graph : deg::get_all_registered_graphs(bmain)) {
+    Depsgraph *graph = reinterpret_cast<Depsgraph *>(deg_graph);
+    deg::IDNode *id_node = deg_graph->find_id_node(id);
+    if (id_node == nullptr) {
+      /* ID is not yet in the graph, which requires full update of relations. */
+      DEG_graph_tag_relations_update(graph);
+      continue;
+    }
+    deg_graph->id_nodes_relations_update.add(id_node);
+    /* Same as for the full update, flat array of bases is to be re-created. */
+    deg::IDNode *scene_id_node = deg_graph->find_id_node(&deg_graph->scene->id);
+    if (scene_id_node != nullptr) {
+      scene_id_node->tag_update(deg_graph, deg::DEG_UPDATE_SOURCE_RELATIONS);
+    }
+  }
+}
@@ -40,6 +40,7 @@
 #include "intern/depsgraph_type.h"
 #include "intern/node/deg_node_component.h"
 #include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
 #include "intern/node/deg_node_time.h"
 
 namespace deg = blender::deg;
@@ -68,22 +69,68 @@ const char *DEG_debug_name_get(struct Depsgraph *depsgraph)
   return deg_graph->debug.name.c_str();
 }
 
+namespace blender::deg {
+
+static string node_full_identifier(const Node *node)
+{
+  if (node->type == NodeType::OPERATION) {
+    return static_cast<const OperationNode *>(node)->full_identifier();
+  }
+  return node->identifier();
+}
+
+static void graph_collect_identifiers(const Depsgraph *graph,
+                                      Set<string> &r_operations,
+                                      Set<string> &r_relations)
+{
+  for (OperationNode *op_node : graph->operations) {
+    r_operations.add(op_node->full_identifier());
+    for (Relation *rel : op_node->inlinks) {
+      r_relations.add(node_full_identifier(rel->from) + " -> " + op_node->full_identifier() +
+                      " (" + rel->name + ")");
+    }
+  }
+}
+
+static bool identifiers_compare(const Set<string> &identifiers1,
+                                const Set<string> &identifiers2,
+                                const char *what)
+{
+  bool is_equal = true;
+  for (const string &identifier : identifiers1) {
+    if (!identifiers2.contains(identifier)) {
+      fprintf(stderr, "Only in the first graph %s: %s\n", what, identifier.c_str());
+      is_equal = false;
+    }
+  }
+  for (const string &identifier : identifiers2) {
+    if (!identifiers1.contains(identifier)) {
+      fprintf(stderr, "Only in the second graph %s: %s\n", what, identifier.c_str());
+      is_equal = false;
+    }
+  }
+  return is_equal;
+}
+
+}  // namespace blender::deg
+
 bool DEG_debug_compare(const struct Depsgraph *graph1, const struct Depsgraph *graph2)
 {
   BLI_assert(graph1 != nullptr);
   BLI_assert(graph2 != nullptr);
   const deg::Depsgraph *deg_graph1 = reinterpret_cast<const deg::Depsgraph *>(graph1);
   const deg::Depsgraph *deg_graph2 = reinterpret_cast<const deg::Depsgraph *>(graph2);
-  if (deg_graph1->operations.size() != deg_graph2->operations.size()) {
-    return false;
-  }
-  /* TODO(sergey): Currently we only do real stupid check,
-   * which is fast but which isn't 100% reliable.
-   *
-   * Would be cool to make it more robust, but it's good enough
-   * for now. Also, proper graph check is actually NP-complex
-   * problem. */
-  return true;
+  /* NOTE: Nodes are compared by their identifiers, which is not 100% reliable (identifiers are
+   * not guaranteed to be unique), but is good enough to catch missing or extra nodes and
+   * relations. Proper graph isomorphism check is way too expensive. Multiple relations between
+   * the same pair of nodes are considered equal. */
+  blender::Set<std::string> operations1, operations2;
+  blender::Set<std::string> relations1, relations2;
+  deg::graph_collect_identifiers(deg_graph1, operations1, relations1);
+  deg::graph_collect_identifiers(deg_graph2, operations2, relations2);
+  const bool operations_equal = deg::identifiers_compare(operations1, operations2, "operation");
+  const bool relations_equal = deg::identifiers_compare(relations1, relations2, "relation");
+  return operations_equal && relations_equal;
 }
 
 bool DEG_debug_graph_relations_validate(Depsgraph *graph,
@@ -95,7 +142,7 @@ bool DEG_debug_graph_relations_validate(Depsgraph *graph,
   bool valid = true;
   DEG_graph_build_from_view_layer(temp_depsgraph);
   if (!DEG_debug_compare(temp_depsgraph, graph)) {
-    fprintf(stderr, "ERROR! Depsgraph wasn't tagged for update when it should have!\n");
+    fprintf(stderr, "ERROR! Depsgraph relations differ from the ones of a full rebuild!\n");
     BLI_assert_msg(0, "This should not happen!");
     valid = false;
   }
@@ -215,6 +215,43 @@ ListBase *build_collision_relations(Depsgraph *graph,
   });
 }
 
+bool physics_relations_use_object(const Depsgraph *graph, const Object *object)
+{
+  for (int i = 0; i < DEG_PHYSICS_RELATIONS_NUM; i++) {
+    const Map<const ID *, ListBase *> *hash = graph->physics_relations[i];
+    if (hash == nullptr) {
+      continue;
+    }
+    const ePhysicsRelationType type = (ePhysicsRelationType)i;
+    for (const ListBase *list : hash->values()) {
+      if (list == nullptr) {
+        continue;
+      }
+      switch (type) {
+        case DEG_PHYSICS_EFFECTOR:
+          LISTBASE_FOREACH (const EffectorRelation *, relation, list) {
+            if (relation->ob == object) {
+              return true;
+            }
+          }
+          break;
+        case DEG_PHYSICS_COLLISION:
+        case DEG_PHYSICS_SMOKE_COLLISION:
+        case DEG_PHYSICS_DYNAMIC_BRUSH:
+          LISTBASE_FOREACH (const CollisionRelation *, relation, list) {
+            if (relation->ob == object) {
+              return true;
+            }
+          }
+          break;
+        case DEG_PHYSICS_RELATIONS_NUM:
+          break;
+      }
+    }
+  }
+  return false;
+}
+
 void clear_physics_relations(Depsgraph *graph)
 {
   for (int i = 0; i < DEG_PHYSICS_RELATIONS_NUM; i++) {
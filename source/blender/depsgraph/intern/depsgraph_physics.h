@@ -25,6 +25,7 @@
 
 struct Collection;
 struct ListBase;
+struct Object;
 
 namespace blender {
 namespace deg {
@@ -36,6 +37,8 @@ ListBase *build_collision_relations(Depsgraph *graph,
                                     Collection *collection,
                                     unsigned int modifier_type);
 void clear_physics_relations(Depsgraph *graph);
+/* Check whether the object is used by any of the cached effector or collision relations. */
+bool physics_relations_use_object(const Depsgraph *graph, const Object *object);
 
 }  // namespace deg
 }  // namespace blender
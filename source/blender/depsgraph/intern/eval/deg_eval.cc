@@ -25,11 +25,15 @@
 
 #include "intern/eval/deg_eval.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "PIL_time.h"
 
 #include "BLI_compiler_attrs.h"
 #include "BLI_gsqueue.h"
+#include "BLI_heap.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_global.h"
@@ -73,10 +77,7 @@ void schedule_children(DepsgraphEvalState *state,
                        ScheduleFunction *schedule_function,
                        ScheduleFunctionArgs... schedule_function_args);
 
-void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), TaskPool *pool)
-{
-  BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
-}
+void schedule_node_to_pool(OperationNode *node, const int thread_id, TaskPool *pool);
 
 /* Denotes which part of dependency graph is being evaluated. */
 enum class EvaluationStage {
@@ -100,39 +101,63 @@ struct DepsgraphEvalState {
   bool do_stats;
   EvaluationStage stage;
   bool need_single_thread_pass;
+  /* Operations which are ready for evaluation, ordered by their critical path time. Every pushed
+   * task pops the operation with the longest critical path from the heap, so that the long chains
+   * of operations start as early as possible. */
+  Heap *ready_operations_heap;
+  SpinLock ready_operations_lock;
+  /* Longest estimated critical path of the evaluation, in seconds. */
+  double critical_path_time;
 };
 
+/* Cost of an operation which was never evaluated yet, so that critical path of operations
+ * without timing information is defined by the number of operations in the chain. */
+constexpr double DEFAULT_OPERATION_COST = 1e-6;
+
 void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
 {
   ::Depsgraph *depsgraph = reinterpret_cast<::Depsgraph *>(state->graph);
 
   /* Sanity checks. */
   BLI_assert_msg(!operation_node->is_noop(), "NOOP nodes should not actually be scheduled");
-  /* Perform operation. */
-  if (state->do_stats) {
-    const double start_time = PIL_check_seconds_timer();
-    operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
-  }
-  else {
-    operation_node->evaluate(depsgraph);
-  }
+  /* Perform operation. Timing is always gathered, it is used to estimate critical path of the
+   * following evaluations. */
+  const double start_time = PIL_check_seconds_timer();
+  operation_node->evaluate(depsgraph);
+  operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
 }
 
-void deg_task_run_func(TaskPool *pool, void *taskdata)
+void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), TaskPool *pool)
+{
+  DepsgraphEvalState *state = (DepsgraphEvalState *)BLI_task_pool_user_data(pool);
+  BLI_spin_lock(&state->ready_operations_lock);
+  BLI_heap_insert(state->ready_operations_heap, -float(node->critical_path_time), node);
+  BLI_spin_unlock(&state->ready_operations_lock);
+  /* The task evaluates whichever operation has the longest critical path at the time it runs.
+   * There is one task pushed per operation, so the heap is never empty when the task runs. */
+  BLI_task_pool_push(pool, deg_task_run_func, nullptr, false, nullptr);
+}
+
+void deg_task_run_func(TaskPool *pool, void *UNUSED(taskdata))
 {
+  MEM_DomainScope memory_domain(MEM_DOMAIN_DEPSGRAPH);
+
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
+  BLI_spin_lock(&state->ready_operations_lock);
+  OperationNode *operation_node = reinterpret_cast<OperationNode *>(
+      BLI_heap_pop_min(state->ready_operations_heap));
+  BLI_spin_unlock(&state->ready_operations_lock);
+
   /* Evaluate node. */
-  OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
   evaluate_node(state, operation_node);
 
   /* Schedule children. */
   schedule_children(state, operation_node, schedule_node_to_pool, pool);
 }
 
-bool check_operation_node_visible(OperationNode *op_node)
+bool check_operation_node_visible(const OperationNode *op_node)
 {
   const ComponentNode *comp_node = op_node->owner;
   /* Special exception, copy on write component is to be always evaluated,
@@ -182,16 +207,93 @@ void calculate_pending_parents(Depsgraph *graph)
   }
 }
 
+bool need_evaluate_operation(const OperationNode *node)
+{
+  return (node->flag & DEPSOP_FLAG_NEEDS_UPDATE) && check_operation_node_visible(node);
+}
+
+/* Check whether the relation is to be waited for during evaluation, the same way as it is done
+ * by #calculate_pending_parents_for_node. */
+bool need_wait_for_relation(const Relation *rel)
+{
+  if (rel->from->type != NodeType::OPERATION || rel->to->type != NodeType::OPERATION) {
+    return false;
+  }
+  if (rel->flag & RELATION_FLAG_CYCLIC) {
+    return false;
+  }
+  return need_evaluate_operation((const OperationNode *)rel->from) &&
+         need_evaluate_operation((const OperationNode *)rel->to);
+}
+
+double estimate_operation_cost(const OperationNode *node)
+{
+  if (node->is_noop()) {
+    return 0.0;
+  }
+  if (node->stats.average_time > 0.0) {
+    return node->stats.average_time;
+  }
+  return DEFAULT_OPERATION_COST;
+}
+
+/* Calculate critical path time of all operations which are to be evaluated: the estimated time of
+ * the operation itself and the longest chain of operations depending on it.
+ *
+ * Operations are visited in reverse topological order, starting from the ones which have no
+ * children to be evaluated. Uses `custom_flags` to count children which were not visited yet. */
+double calculate_critical_path(Span<OperationNode *> operations)
+{
+  Vector<OperationNode *> stack;
+  for (OperationNode *node : operations) {
+    node->critical_path_time = 0.0;
+    node->custom_flags = 0;
+    if (!need_evaluate_operation(node)) {
+      continue;
+    }
+    for (Relation *rel : node->outlinks) {
+      if (need_wait_for_relation(rel)) {
+        ++node->custom_flags;
+      }
+    }
+    if (node->custom_flags == 0) {
+      stack.append(node);
+    }
+  }
+  double max_critical_path_time = 0.0;
+  while (!stack.is_empty()) {
+    OperationNode *node = stack.pop_last();
+    double children_time = 0.0;
+    for (Relation *rel : node->outlinks) {
+      if (need_wait_for_relation(rel)) {
+        children_time = max(children_time, ((OperationNode *)rel->to)->critical_path_time);
+      }
+    }
+    node->critical_path_time = estimate_operation_cost(node) + children_time;
+    max_critical_path_time = max(max_critical_path_time, node->critical_path_time);
+    for (Relation *rel : node->inlinks) {
+      if (!need_wait_for_relation(rel)) {
+        continue;
+      }
+      OperationNode *parent = (OperationNode *)rel->from;
+      if (--parent->custom_flags == 0) {
+        stack.append(parent);
+      }
+    }
+  }
+  return max_critical_path_time;
+}
+
 void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
 {
-  const bool do_stats = state->do_stats;
   calculate_pending_parents(graph);
   /* Clear tags and other things which needs to be clear. */
   for (OperationNode *node : graph->operations) {
-    if (do_stats) {
-      node->stats.reset_current();
-    }
+    /* Timing of the previous evaluation is used to estimate cost of the operation. */
+    node->stats.update_average();
+    node->stats.reset_current();
   }
+  state->critical_path_time = calculate_critical_path(graph->operations);
 }
 
 bool is_metaball_object_operation(const OperationNode *operation_node)
@@ -352,6 +454,11 @@ void depsgraph_ensure_view_layer(Depsgraph *graph)
 
 }  // namespace
 
+double deg_calculate_critical_path(Span<OperationNode *> operations)
+{
+  return calculate_critical_path(operations);
+}
+
 static TaskPool *deg_evaluate_task_pool_create(DepsgraphEvalState *state)
 {
   if (G.debug & G_DEBUG_DEPSGRAPH_NO_THREADS) {
@@ -368,6 +475,8 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
     return;
   }
 
+  MEM_DomainScope memory_domain(MEM_DOMAIN_DEPSGRAPH);
+
   graph->debug.begin_graph_evaluation();
 
 #ifdef WITH_PYTHON
@@ -382,6 +491,8 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
   state.need_single_thread_pass = false;
+  state.ready_operations_heap = BLI_heap_new();
+  BLI_spin_init(&state.ready_operations_lock);
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
 
@@ -410,7 +521,10 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
    * synchronization. */
   if (state.do_stats) {
     deg_eval_stats_aggregate(graph);
+    printf("Depsgraph estimated critical path %f seconds.\n", state.critical_path_time);
   }
+  BLI_heap_free(state.ready_operations_heap, nullptr);
+  BLI_spin_end(&state.ready_operations_lock);
   /* Clear any uncleared tags - just in case. */
   deg_graph_clear_tags(graph);
   graph->is_evaluating = false;
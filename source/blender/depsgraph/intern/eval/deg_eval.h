@@ -25,10 +25,13 @@
 
 #pragma once
 
+#include "BLI_span.hh"
+
 namespace blender {
 namespace deg {
 
 struct Depsgraph;
+struct OperationNode;
 
 /**
  * Evaluate all nodes tagged for updating,
@@ -39,5 +42,14 @@ struct Depsgraph;
  */
 void deg_evaluate_on_refresh(Depsgraph *graph);
 
+/**
+ * Calculate the critical path time of the given operations which are tagged for update: their own
+ * estimated time plus the longest chain of operations depending on them. Operations with a longer
+ * critical path are scheduled first.
+ *
+ * \return The longest critical path time.
+ */
+double deg_calculate_critical_path(Span<OperationNode *> operations);
+
 }  // namespace deg
 }  // namespace blender
@@ -0,0 +1,161 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/eval/deg_eval.h"
+
+#include "intern/depsgraph_relation.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_operation.h"
+
+#include "testing/testing.h"
+
+namespace blender::deg::tests {
+
+static void dummy_evaluate(::Depsgraph * /*depsgraph*/)
+{
+}
+
+class CriticalPathTest : public testing::Test {
+ protected:
+  ComponentNode component;
+  Vector<OperationNode *> operations;
+
+  void SetUp() override
+  {
+    component.type = NodeType::GEOMETRY;
+    component.affects_directly_visible = true;
+  }
+
+  void TearDown() override
+  {
+    /* Nodes free their incoming relations. */
+    for (OperationNode *node : operations) {
+      delete node;
+    }
+  }
+
+  OperationNode *add_operation(const double average_time)
+  {
+    OperationNode *node = new OperationNode();
+    node->type = NodeType::OPERATION;
+    node->owner = &component;
+    node->evaluate = dummy_evaluate;
+    node->flag = DEPSOP_FLAG_NEEDS_UPDATE;
+    node->stats.average_time = average_time;
+    operations.append(node);
+    return node;
+  }
+
+  Relation *add_relation(OperationNode *from, OperationNode *to)
+  {
+    return new Relation(from, to, "test");
+  }
+};
+
+TEST_F(CriticalPathTest, chain)
+{
+  /* A long chain of cheap operations next to a single more expensive one. */
+  OperationNode *a = add_operation(1.0);
+  OperationNode *b = add_operation(1.0);
+  OperationNode *c = add_operation(1.0);
+  OperationNode *d = add_operation(2.0);
+  add_relation(a, b);
+  add_relation(b, c);
+
+  EXPECT_DOUBLE_EQ(deg_calculate_critical_path(operations), 3.0);
+  EXPECT_DOUBLE_EQ(a->critical_path_time, 3.0);
+  EXPECT_DOUBLE_EQ(b->critical_path_time, 2.0);
+  EXPECT_DOUBLE_EQ(c->critical_path_time, 1.0);
+  EXPECT_DOUBLE_EQ(d->critical_path_time, 2.0);
+  /* The start of the chain is scheduled before the expensive operation. */
+  EXPECT_GT(a->critical_path_time, d->critical_path_time);
+}
+
+TEST_F(CriticalPathTest, longest_branch)
+{
+  /* Diamond where one branch is more expensive than the other. */
+  OperationNode *root = add_operation(1.0);
+  OperationNode *cheap = add_operation(1.0);
+  OperationNode *expensive = add_operation(5.0);
+  OperationNode *tail = add_operation(1.0);
+  add_relation(root, cheap);
+  add_relation(root, expensive);
+  add_relation(cheap, tail);
+  add_relation(expensive, tail);
+
+  EXPECT_DOUBLE_EQ(deg_calculate_critical_path(operations), 7.0);
+  EXPECT_DOUBLE_EQ(root->critical_path_time, 7.0);
+  EXPECT_DOUBLE_EQ(cheap->critical_path_time, 2.0);
+  EXPECT_DOUBLE_EQ(expensive->critical_path_time, 6.0);
+}
+
+TEST_F(CriticalPathTest, skipped_operations)
+{
+  /* Operations which are not evaluated don't contribute, no-op and unevaluated operations are
+   * ordered by the number of operations in their chain. */
+  OperationNode *a = add_operation(0.0);
+  OperationNode *noop = add_operation(0.0);
+  OperationNode *b = add_operation(0.0);
+  OperationNode *untagged = add_operation(10.0);
+  noop->evaluate = nullptr;
+  untagged->flag = 0;
+  add_relation(a, noop);
+  add_relation(noop, b);
+  add_relation(b, untagged);
+
+  deg_calculate_critical_path(operations);
+  EXPECT_DOUBLE_EQ(untagged->critical_path_time, 0.0);
+  EXPECT_DOUBLE_EQ(noop->critical_path_time, b->critical_path_time);
+  EXPECT_GT(a->critical_path_time, b->critical_path_time);
+  EXPECT_GT(b->critical_path_time, 0.0);
+}
+
+TEST_F(CriticalPathTest, cyclic_relation)
+{
+  OperationNode *a = add_operation(1.0);
+  OperationNode *b = add_operation(1.0);
+  add_relation(a, b);
+  Relation *rel = add_relation(b, a);
+  rel->flag |= RELATION_FLAG_CYCLIC;
+
+  EXPECT_DOUBLE_EQ(deg_calculate_critical_path(operations), 2.0);
+  EXPECT_DOUBLE_EQ(a->critical_path_time, 2.0);
+}
+
+TEST(deg_node_stats, update_average)
+{
+  Node::Stats stats;
+  /* Not evaluated, nothing to average. */
+  stats.update_average();
+  EXPECT_EQ(stats.average_time, 0.0);
+
+  stats.current_time = 4.0;
+  stats.update_average();
+  EXPECT_DOUBLE_EQ(stats.average_time, 4.0);
+
+  stats.current_time = 8.0;
+  stats.update_average();
+  EXPECT_DOUBLE_EQ(stats.average_time, 5.0);
+
+  stats.reset();
+  EXPECT_EQ(stats.average_time, 0.0);
+}
+
+}  // namespace blender::deg::tests
@@ -288,6 +288,7 @@ Node::Stats::Stats()
 void Node::Stats::reset()
 {
   current_time = 0.0;
+  average_time = 0.0;
 }
 
 void Node::Stats::reset_current()
@@ -295,6 +296,20 @@ void Node::Stats::reset_current()
   current_time = 0.0;
 }
 
+void Node::Stats::update_average()
+{
+  if (current_time <= 0.0) {
+    return;
+  }
+  if (average_time == 0.0) {
+    average_time = current_time;
+  }
+  else {
+    /* Exponential moving average, reacts on changes in the scene within a few evaluations. */
+    average_time = average_time * 0.75 + current_time * 0.25;
+  }
+}
+
 /*******************************************************************************
  * Node itself.
  */
@@ -178,8 +178,14 @@ struct Node {
     /* Reset counters needed for the current graph evaluation, does not
      * touch averaging accumulators. */
     void reset_current();
+    /* Accumulate time spent during the current graph evaluation to the
+     * average time. Does nothing if the node was not evaluated. */
+    void update_average();
     /* Time spend on this node during current graph evaluation. */
     double current_time;
+    /* Moving average of time spent on this node, over the evaluations in
+     * which the node was evaluated. */
+    double average_time;
   };
   /* Relationships between nodes
    * The reason why all depsgraph nodes are descended from this type (apart
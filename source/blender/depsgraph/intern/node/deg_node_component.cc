@@ -175,6 +175,15 @@ OperationNode *ComponentNode::add_operation(const DepsEvalOperationCb &op,
 {
   OperationNode *op_node = find_operation(opcode, name, name_tag);
   if (!op_node) {
+    if (operations_map == nullptr) {
+      /* Component was finalized by a previous build and is extended by a partial update of the
+       * graph: move operations back to the map, they will be flattened on finalization again. */
+      operations_map = new Map<ComponentNode::OperationIDKey, OperationNode *>();
+      for (OperationNode *op : operations) {
+        operations_map->add(OperationIDKey(op->opcode, op->name.c_str(), op->name_tag), op);
+      }
+      operations.clear();
+    }
     DepsNodeFactory *factory = type_get_factory(NodeType::OPERATION);
     op_node = (OperationNode *)factory->create_node(this->owner->id_orig, "", name);
 
@@ -290,6 +299,10 @@ OperationNode *ComponentNode::get_exit_operation()
 
 void ComponentNode::finalize_build(Depsgraph * /*graph*/)
 {
+  if (operations_map == nullptr) {
+    /* Component was finalized by a previous build and kept by a partial update of the graph. */
+    return;
+  }
   operations.reserve(operations_map->size());
   for (OperationNode *op_node : operations_map->values()) {
     operations.append(op_node);
@@ -5722,6 +5722,7 @@ static int edbm_decimate_exec(bContext *C, wmOperator *op)
   const bool use_symmetry = RNA_boolean_get(op->ptr, "use_symmetry");
   const float symmetry_eps = 0.00002f;
   const int symmetry_axis = use_symmetry ? RNA_enum_get(op->ptr, "symmetry_axis") : -1;
+  const bool use_parallel = RNA_boolean_get(op->ptr, "use_parallel");
 
   /* nop */
   if (ratio == 1.0f) {
@@ -5814,8 +5815,14 @@ static int edbm_decimate_exec(bContext *C, wmOperator *op)
       ratio_adjust = 1.0f - ratio_adjust;
     }
 
-    BM_mesh_decimate_collapse(
-        em->bm, ratio_adjust, vweights, vertex_group_factor, false, symmetry_axis, symmetry_eps);
+    BM_mesh_decimate_collapse_ex(em->bm,
+                                 ratio_adjust,
+                                 vweights,
+                                 vertex_group_factor,
+                                 false,
+                                 symmetry_axis,
+                                 symmetry_eps,
+                                 use_parallel);
 
     MEM_freeN(vweights);
 
@@ -5863,6 +5870,8 @@ static void edbm_decimate_ui(bContext *UNUSED(C), wmOperator *op)
   sub = uiLayoutRow(row, true);
   uiLayoutSetActive(sub, RNA_boolean_get(op->ptr, "use_symmetry"));
   uiItemR(sub, op->ptr, "symmetry_axis", UI_ITEM_R_EXPAND, NULL, ICON_NONE);
+
+  uiItemR(layout, op->ptr, "use_parallel", 0, NULL, ICON_NONE);
 }
 
 void MESH_OT_decimate(wmOperatorType *ot)
@@ -5904,6 +5913,13 @@ void MESH_OT_decimate(wmOperatorType *ot)
   RNA_def_boolean(ot->srna, "use_symmetry", false, "Symmetry", "Maintain symmetry on an axis");
 
   RNA_def_enum(ot->srna, "symmetry_axis", rna_enum_axis_xyz_items, 1, "Axis", "Axis of symmetry");
+
+  RNA_def_boolean(ot->srna,
+                  "use_parallel",
+                  false,
+                  "Parallel",
+                  "Decimate parts of large meshes in parallel, faster but results differ "
+                  "slightly");
 }
 
 /** \} */
@@ -73,6 +73,7 @@
 #include "RE_pipeline.h"
 
 #include "IMB_colormanagement.h"
+#include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
 #include "RNA_access.h"
@@ -231,6 +232,7 @@ static void image_buffer_rect_update(RenderJob *rj,
          * as invalid here (sergey)
          */
         ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+        IMB_tag_changed(ibuf);
         return;
       }
       if (rr->renlay == nullptr) {
@@ -768,6 +770,7 @@ static void render_endjob(void *rjv)
 
     if (ibuf) {
       ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+      IMB_tag_changed(ibuf);
     }
 
     BKE_image_release_ibuf(ima, ibuf, lock);
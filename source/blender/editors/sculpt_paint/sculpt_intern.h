@@ -194,6 +194,15 @@ typedef struct SculptUndoNode {
   /* Sculpt Face Sets */
   int *face_sets;
 
+  /* Once the undo step is pushed, `co` or `mask` store a delta against the current state of the
+   * mesh instead of the values themselves, see #sculpt_undosys_step_encode_delta. */
+  bool use_delta;
+  /* Compressed `index` and `co` or `mask` (those arrays are freed), accessed when restoring. */
+  void *index_compressed;
+  void *data_compressed;
+  size_t index_compressed_size;
+  size_t data_compressed_size;
+
   size_t undo_size;
 } SculptUndoNode;
 
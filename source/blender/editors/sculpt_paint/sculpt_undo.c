@@ -23,6 +23,9 @@
  */
 
 #include <stddef.h>
+#include <string.h>
+
+#include <zstd.h>
 
 #include "MEM_guardedalloc.h"
 
@@ -33,6 +36,7 @@
 #include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
+#include "atomic_ops.h"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -45,6 +49,7 @@
 #include "BKE_customdata.h"
 #include "BKE_global.h"
 #include "BKE_key.h"
+#include "BKE_lib_id.h"
 #include "BKE_main.h"
 #include "BKE_mesh.h"
 #include "BKE_multires.h"
@@ -69,6 +74,7 @@
 
 #include "bmesh.h"
 #include "sculpt_intern.h"
+#include "sculpt_undo_delta.h"
 
 /* Implementation of undo system for objects in sculpt mode.
  *
@@ -87,7 +93,8 @@
  * redo is possible after undo.
  *
  * The COORDS, HIDDEN or MASK type of nodes contains arrays of the corresponding
- * values.
+ * values. Once the undo step is pushed, COORDS and MASK arrays are turned into a
+ * delta against the mesh and compressed in the background (see "Undo Node Deltas").
  *
  * Operations like Symmetrize are using GEOMETRY type of nodes which pushes the
  * entire state of the mesh to the undo stack. This node contains all CustomData
@@ -170,6 +177,127 @@ static bool test_swap_v3_v3(float a[3], float b[3])
   return false;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Undo Node Deltas
+ *
+ * Once an undo step has been pushed, COORDS and MASK nodes of regular meshes store a delta
+ * against the state of the mesh after the step, which is the current state whenever the step
+ * gets undone. The delta is an XOR of the bits of the values, so it is exact and it stays the
+ * same when swapping the stored values with the mesh: undo and redo both apply it to the mesh
+ * again. Values which the step didn't modify are zero, so the delta compresses well.
+ *
+ * Multires grids keep storing the values: they are re-created from the base mesh and its
+ * displacement in between steps (e.g. when changing levels), so there is no guarantee they still
+ * hold the exact values the delta was computed against.
+ * \{ */
+
+/* Favor speed, deltas are mostly zeros anyway. */
+#define SCULPT_UNDO_COMPRESSION_LEVEL 1
+
+static bool sculpt_undo_node_use_delta(const SculptSession *ss, const SculptUndoNode *unode)
+{
+  if (BKE_pbvh_type(ss->pbvh) != PBVH_FACES || unode->maxvert != ss->totvert) {
+    return false;
+  }
+  if (unode->type == SCULPT_UNDO_COORDS) {
+    /* Deformed and shape key coordinates aren't restored into the mesh vertices directly. */
+    return unode->co != NULL && unode->orig_co == NULL && unode->shapeName[0] == '\0' &&
+           ss->mvert != NULL && ss->shapekey_active == NULL;
+  }
+  return unode->type == SCULPT_UNDO_MASK && unode->mask != NULL && ss->vmask != NULL;
+}
+
+/**
+ * Apply the delta between the mesh and the values of the node (passed in separately as they may
+ * have been decompressed) either to the node, turning its values into a delta (when \a to_mesh
+ * is false), or to the mesh, restoring the node.
+ */
+static void sculpt_undo_node_delta_apply(SculptSession *ss,
+                                         const SculptUndoNode *unode,
+                                         const int *index,
+                                         float (*co)[3],
+                                         float *mask,
+                                         const bool to_mesh)
+{
+  const int len = co ? 3 : 1;
+  MVert *mvert = ss->mvert;
+
+  for (int i = 0; i < unode->totvert; i++) {
+    float *node_value = co ? co[i] : &mask[i];
+    float *mesh_value = co ? mvert[index[i]].co : &ss->vmask[index[i]];
+    if (!to_mesh) {
+      SCULPT_undo_delta_apply_fl(node_value, mesh_value, len);
+    }
+    else if (SCULPT_undo_delta_apply_fl(mesh_value, node_value, len)) {
+      mvert[index[i]].flag |= ME_VERT_PBVH_UPDATE;
+    }
+  }
+}
+
+void *SCULPT_undo_compress(const void *data, const size_t data_size, size_t *r_size)
+{
+  const size_t buf_size = ZSTD_compressBound(data_size);
+  void *buf = MEM_mallocN(buf_size, __func__);
+  const size_t size = ZSTD_compress(buf, buf_size, data, data_size, SCULPT_UNDO_COMPRESSION_LEVEL);
+  if (ZSTD_isError(size) || size >= data_size) {
+    MEM_freeN(buf);
+    return NULL;
+  }
+  *r_size = size;
+  return MEM_reallocN(buf, size);
+}
+
+void *SCULPT_undo_decompress(const void *data, const size_t data_size, const size_t size)
+{
+  void *buf = MEM_mallocN(size, __func__);
+  if (ZSTD_decompress(buf, size, data, data_size) != size) {
+    MEM_freeN(buf);
+    return NULL;
+  }
+  return buf;
+}
+
+/** Restore a node stored as a delta, only decompressing its data for the duration of the call. */
+static bool sculpt_undo_restore_delta(SculptSession *ss, SculptUndoNode *unode)
+{
+  const int len = unode->totvert;
+  int *index = unode->index;
+  float(*co)[3] = unode->co;
+  float *mask = unode->mask;
+
+  if (unode->index_compressed) {
+    index = SCULPT_undo_decompress(
+        unode->index_compressed, unode->index_compressed_size, sizeof(*index) * (size_t)len);
+  }
+  if (unode->data_compressed) {
+    if (unode->type == SCULPT_UNDO_COORDS) {
+      co = SCULPT_undo_decompress(
+          unode->data_compressed, unode->data_compressed_size, sizeof(*co) * (size_t)len);
+    }
+    else {
+      mask = SCULPT_undo_decompress(
+          unode->data_compressed, unode->data_compressed_size, sizeof(*mask) * (size_t)len);
+    }
+  }
+
+  const bool ok = index != NULL && (co != NULL || mask != NULL);
+  BLI_assert_msg(ok, "Failed to decompress sculpt undo node");
+  if (ok) {
+    sculpt_undo_node_delta_apply(ss, unode, index, co, mask, true);
+  }
+
+  if (unode->index_compressed) {
+    MEM_SAFE_FREE(index);
+  }
+  if (unode->data_compressed) {
+    MEM_SAFE_FREE(co);
+    MEM_SAFE_FREE(mask);
+  }
+  return ok;
+}
+
+/** \} */
+
 static bool sculpt_undo_restore_deformed(
     const SculptSession *ss, SculptUndoNode *unode, int uindex, int oindex, float coord[3])
 {
@@ -210,6 +338,10 @@ static bool sculpt_undo_restore_coords(bContext *C, Depsgraph *depsgraph, Sculpt
       }
     }
 
+    if (unode->use_delta) {
+      return sculpt_undo_restore_delta(ss, unode);
+    }
+
     /* No need for float comparison here (memory is exactly equal or not). */
     index = unode->index;
     mvert = ss->mvert;
@@ -275,6 +407,10 @@ static bool sculpt_undo_restore_coords(bContext *C, Depsgraph *depsgraph, Sculpt
     float(*co)[3];
     int gridsize;
 
+    if (unode->use_delta) {
+      return sculpt_undo_restore_delta(ss, unode);
+    }
+
     grids = subdiv_ccg->grids;
     gridsize = subdiv_ccg->grid_size;
     BKE_subdiv_ccg_key_top_level(&key, subdiv_ccg);
@@ -354,6 +490,9 @@ static bool sculpt_undo_restore_mask(bContext *C, SculptUndoNode *unode)
 
   if (unode->maxvert) {
     /* Regular mesh restore. */
+    if (unode->use_delta) {
+      return sculpt_undo_restore_delta(ss, unode);
+    }
 
     index = unode->index;
     mvert = ss->mvert;
@@ -373,6 +512,10 @@ static bool sculpt_undo_restore_mask(bContext *C, SculptUndoNode *unode)
     float *mask;
     int gridsize;
 
+    if (unode->use_delta) {
+      return sculpt_undo_restore_delta(ss, unode);
+    }
+
     grids = subdiv_ccg->grids;
     gridsize = subdiv_ccg->grid_size;
     BKE_subdiv_ccg_key_top_level(&key, subdiv_ccg);
@@ -897,6 +1040,12 @@ static void sculpt_undo_free_list(ListBase *lb)
     if (unode->face_sets) {
       MEM_freeN(unode->face_sets);
     }
+    if (unode->index_compressed) {
+      MEM_freeN(unode->index_compressed);
+    }
+    if (unode->data_compressed) {
+      MEM_freeN(unode->data_compressed);
+    }
 
     MEM_freeN(unode);
 
@@ -935,7 +1084,12 @@ SculptUndoNode *SCULPT_undo_get_node(PBVHNode *node)
     return NULL;
   }
 
-  return BLI_findptr(&usculpt->nodes, node, offsetof(SculptUndoNode, node));
+  SculptUndoNode *unode = BLI_findptr(&usculpt->nodes, node, offsetof(SculptUndoNode, node));
+  /* Nodes of steps which have been pushed don't store the original values anymore. */
+  if (unode && unode->use_delta) {
+    return NULL;
+  }
+  return unode;
 }
 
 SculptUndoNode *SCULPT_undo_get_first_node()
@@ -1434,8 +1588,122 @@ typedef struct SculptUndoStep {
   UndoStep step;
   /* NOTE: will split out into list for multi-object-sculpt-mode. */
   UndoSculpt data;
+  /* Compresses the nodes in the background once the step has been pushed. */
+  TaskPool *compress_pool;
 } SculptUndoStep;
 
+static void sculpt_undo_node_compress_task(TaskPool *__restrict pool, void *taskdata)
+{
+  SculptUndoStep *us = BLI_task_pool_user_data(pool);
+  SculptUndoNode *unode = taskdata;
+  const int len = unode->totvert;
+  size_t size_freed = 0;
+
+  void **data_p = (unode->type == SCULPT_UNDO_COORDS) ? (void **)&unode->co :
+                                                        (void **)&unode->mask;
+  const size_t data_size = (unode->type == SCULPT_UNDO_COORDS) ? sizeof(*unode->co) * len :
+                                                                 sizeof(*unode->mask) * len;
+  unode->data_compressed = SCULPT_undo_compress(*data_p, data_size, &unode->data_compressed_size);
+  if (unode->data_compressed) {
+    size_freed += MEM_allocN_len(*data_p) - unode->data_compressed_size;
+    MEM_freeN(*data_p);
+    *data_p = NULL;
+  }
+
+  if (unode->index) {
+    unode->index_compressed = SCULPT_undo_compress(
+        unode->index, sizeof(*unode->index) * len, &unode->index_compressed_size);
+    if (unode->index_compressed) {
+      size_freed += MEM_allocN_len(unode->index) - unode->index_compressed_size;
+      MEM_freeN(unode->index);
+      unode->index = NULL;
+    }
+  }
+
+  atomic_sub_and_fetch_z(&us->step.data_size, size_freed);
+}
+
+typedef struct SculptUndoEncodeDeltaData {
+  SculptSession *ss;
+  SculptUndoNode **unodes;
+} SculptUndoEncodeDeltaData;
+
+static void sculpt_undo_node_encode_delta_task_cb(void *__restrict userdata,
+                                                  const int n,
+                                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SculptUndoEncodeDeltaData *data = userdata;
+  SculptUndoNode *unode = data->unodes[n];
+  sculpt_undo_node_delta_apply(data->ss, unode, unode->index, unode->co, unode->mask, false);
+  unode->use_delta = true;
+}
+
+/**
+ * Store the nodes as a delta against the current state of the mesh (after the step) and compress
+ * them in the background, see #sculpt_undo_node_delta_apply.
+ */
+static void sculpt_undosys_step_encode_delta(Main *bmain, SculptUndoStep *us)
+{
+  const SculptUndoNode *unode_first = us->data.nodes.first;
+  if (unode_first == NULL) {
+    return;
+  }
+  LISTBASE_FOREACH (const SculptUndoNode *, unode, &us->data.nodes) {
+    /* Other kinds of steps replace the mesh, the current state doesn't match the nodes. */
+    if (!ELEM(unode->type,
+              SCULPT_UNDO_COORDS,
+              SCULPT_UNDO_MASK,
+              SCULPT_UNDO_HIDDEN,
+              SCULPT_UNDO_COLOR)) {
+      return;
+    }
+  }
+
+  Object *ob = (Object *)BKE_libblock_find_name(bmain, ID_OB, unode_first->idname + 2);
+  SculptSession *ss = ob ? ob->sculpt : NULL;
+  if (ss == NULL || ss->pbvh == NULL || BKE_pbvh_type(ss->pbvh) == PBVH_BMESH) {
+    return;
+  }
+
+  SculptUndoNode **unodes = MEM_mallocN(sizeof(*unodes) * BLI_listbase_count(&us->data.nodes),
+                                        __func__);
+  int unodes_len = 0;
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &us->data.nodes) {
+    if (STREQ(unode->idname, ob->id.name) && sculpt_undo_node_use_delta(ss, unode)) {
+      unodes[unodes_len++] = unode;
+    }
+  }
+
+  if (unodes_len != 0) {
+    SculptUndoEncodeDeltaData data = {
+        .ss = ss,
+        .unodes = unodes,
+    };
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    BLI_task_parallel_range(
+        0, unodes_len, &data, sculpt_undo_node_encode_delta_task_cb, &settings);
+
+    us->compress_pool = BLI_task_pool_create_background(us, TASK_PRIORITY_LOW);
+    for (int i = 0; i < unodes_len; i++) {
+      BLI_task_pool_push(
+          us->compress_pool, sculpt_undo_node_compress_task, unodes[i], false, NULL);
+    }
+  }
+
+  MEM_freeN(unodes);
+}
+
+/** Wait for the background compression of the step to finish. */
+static void sculpt_undosys_step_compress_finish(SculptUndoStep *us)
+{
+  if (us->compress_pool) {
+    BLI_task_pool_work_and_wait(us->compress_pool);
+    BLI_task_pool_free(us->compress_pool);
+    us->compress_pool = NULL;
+  }
+}
+
 static void sculpt_undosys_step_encode_init(struct bContext *UNUSED(C), UndoStep *us_p)
 {
   SculptUndoStep *us = (SculptUndoStep *)us_p;
@@ -1458,6 +1726,14 @@ static bool sculpt_undosys_step_encode(struct bContext *UNUSED(C),
   }
   us->step.is_applied = true;
 
+  /* Only keep a single step compressing at a time. */
+  for (UndoStep *us_iter = us->step.prev; us_iter; us_iter = us_iter->prev) {
+    if (us_iter->type == BKE_UNDOSYS_TYPE_SCULPT) {
+      sculpt_undosys_step_compress_finish((SculptUndoStep *)us_iter);
+    }
+  }
+  sculpt_undosys_step_encode_delta(bmain, us);
+
   if (!BLI_listbase_is_empty(&us->data.nodes)) {
     bmain->is_memfile_undo_flush_needed = true;
   }
@@ -1470,6 +1746,7 @@ static void sculpt_undosys_step_decode_undo_impl(struct bContext *C,
                                                  SculptUndoStep *us)
 {
   BLI_assert(us->step.is_applied == true);
+  sculpt_undosys_step_compress_finish(us);
   sculpt_undo_restore_list(C, depsgraph, &us->data.nodes);
   us->step.is_applied = false;
 }
@@ -1479,6 +1756,7 @@ static void sculpt_undosys_step_decode_redo_impl(struct bContext *C,
                                                  SculptUndoStep *us)
 {
   BLI_assert(us->step.is_applied == false);
+  sculpt_undosys_step_compress_finish(us);
   sculpt_undo_restore_list(C, depsgraph, &us->data.nodes);
   us->step.is_applied = true;
 }
@@ -1583,6 +1861,10 @@ static void sculpt_undosys_step_decode(
 static void sculpt_undosys_step_free(UndoStep *us_p)
 {
   SculptUndoStep *us = (SculptUndoStep *)us_p;
+  if (us->compress_pool) {
+    BLI_task_pool_cancel(us->compress_pool);
+    BLI_task_pool_free(us->compress_pool);
+  }
   sculpt_undo_free_list(&us->data.nodes);
 }
 
@@ -0,0 +1,65 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup edsculpt
+ *
+ * Storage of sculpt undo nodes as compressed deltas, see "Undo Node Deltas" in `sculpt_undo.c`.
+ */
+
+#pragma once
+
+#include <string.h>
+
+#include "BLI_compiler_compat.h"
+#include "BLI_sys_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Apply the delta between `dst` and `src` to `dst`, returns true when `dst` changed.
+ *
+ * The delta is an XOR of the bits of the values: applying it twice gives back the original
+ * values bit for bit, including signed zeros and NaN.
+ */
+BLI_INLINE bool SCULPT_undo_delta_apply_fl(float *dst, const float *src, const int len)
+{
+  bool changed = false;
+  for (int i = 0; i < len; i++) {
+    uint32_t dst_bits, src_bits;
+    memcpy(&dst_bits, &dst[i], sizeof(dst_bits));
+    memcpy(&src_bits, &src[i], sizeof(src_bits));
+    dst_bits ^= src_bits;
+    memcpy(&dst[i], &dst_bits, sizeof(dst_bits));
+    changed |= (src_bits != 0);
+  }
+  return changed;
+}
+
+/**
+ * \return a compressed copy of \a data, or NULL when it doesn't get any smaller.
+ */
+void *SCULPT_undo_compress(const void *data, size_t data_size, size_t *r_size);
+/**
+ * \return the decompressed data, or NULL when it isn't exactly \a size bytes.
+ */
+void *SCULPT_undo_decompress(const void *data, size_t data_size, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,134 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
+#include "BLI_rand.hh"
+#include "BLI_utildefines.h"
+
+#include "sculpt_undo_delta.h"
+
+namespace blender::ed::sculpt_paint::tests {
+
+/* Values whose bits have to survive the round trip, not only their value. */
+static const float special_values[] = {
+    0.0f, -0.0f, 1.0f, -1.0f, FLT_MIN / 2.0f, FLT_MAX, -INFINITY, INFINITY, NAN, -NAN};
+static const int special_values_len = ARRAY_SIZE(special_values);
+
+static void expect_bits_equal(const float *a, const float *b, const int len)
+{
+  EXPECT_EQ(memcmp(a, b, sizeof(*a) * len), 0);
+}
+
+TEST(sculpt_undo_delta, apply_round_trip)
+{
+  const int len = 64;
+  RandomNumberGenerator rng(0);
+  Array<float> node(len);
+  Array<float> mesh(len);
+  for (int i = 0; i < len; i++) {
+    node[i] = (i < special_values_len) ? special_values[i] : rng.get_float() * 100.0f - 50.0f;
+    mesh[i] = (i % 4 == 0) ? node[i] : rng.get_float();
+  }
+  for (int i = 0; i < special_values_len; i++) {
+    mesh[len - 1 - i * 2] = special_values[i];
+  }
+  const Array<float> node_orig = node;
+  const Array<float> mesh_orig = mesh;
+
+  /* Turn the node values into a delta, unchanged values become zeros. */
+  SCULPT_undo_delta_apply_fl(node.data(), mesh.data(), len);
+  for (int i = 0; i < len; i += 4) {
+    uint32_t bits;
+    memcpy(&bits, &node[i], sizeof(bits));
+    EXPECT_EQ(bits, 0u);
+  }
+
+  /* Undo: applying the delta restores the node values in the mesh. */
+  EXPECT_TRUE(SCULPT_undo_delta_apply_fl(mesh.data(), node.data(), len));
+  expect_bits_equal(mesh.data(), node_orig.data(), len);
+
+  /* Redo: applying the same delta again restores the previous mesh values. */
+  EXPECT_TRUE(SCULPT_undo_delta_apply_fl(mesh.data(), node.data(), len));
+  expect_bits_equal(mesh.data(), mesh_orig.data(), len);
+}
+
+TEST(sculpt_undo_delta, apply_unchanged)
+{
+  float values[3] = {1.0f, -0.0f, NAN};
+  const float zeros[3] = {0.0f, 0.0f, 0.0f};
+  float values_orig[3];
+  memcpy(values_orig, values, sizeof(values));
+
+  EXPECT_FALSE(SCULPT_undo_delta_apply_fl(values, zeros, 3));
+  expect_bits_equal(values, values_orig, 3);
+
+  /* A negative zero in the delta is a change. */
+  const float sign[1] = {-0.0f};
+  EXPECT_TRUE(SCULPT_undo_delta_apply_fl(values, sign, 1));
+  EXPECT_EQ(values[0], -1.0f);
+}
+
+TEST(sculpt_undo_delta, compress_round_trip)
+{
+  /* A delta of mostly zeros, as left by a stroke touching few vertices. */
+  const int len = 4096;
+  RandomNumberGenerator rng(0);
+  Array<float> data(len, 0.0f);
+  for (int i = 0; i < len; i += 37) {
+    data[i] = rng.get_float();
+  }
+  const size_t data_size = sizeof(float) * len;
+
+  size_t compressed_size = 0;
+  void *compressed = SCULPT_undo_compress(data.data(), data_size, &compressed_size);
+  ASSERT_NE(compressed, nullptr);
+  EXPECT_LT(compressed_size, data_size);
+
+  float *decompressed = static_cast<float *>(
+      SCULPT_undo_decompress(compressed, compressed_size, data_size));
+  ASSERT_NE(decompressed, nullptr);
+  expect_bits_equal(decompressed, data.data(), len);
+  MEM_freeN(decompressed);
+
+  /* The size has to match exactly. */
+  EXPECT_EQ(SCULPT_undo_decompress(compressed, compressed_size, data_size / 2), nullptr);
+  EXPECT_EQ(SCULPT_undo_decompress(compressed, compressed_size, data_size * 2), nullptr);
+
+  MEM_freeN(compressed);
+}
+
+TEST(sculpt_undo_delta, compress_incompressible)
+{
+  /* Random bits don't compress, the caller keeps the data as is. */
+  const int len = 1024;
+  RandomNumberGenerator rng(0);
+  Array<uint32_t> data(len);
+  for (int i = 0; i < len; i++) {
+    data[i] = rng.get_uint32();
+  }
+  const size_t data_size = sizeof(uint32_t) * len;
+  size_t compressed_size = 0;
+  EXPECT_EQ(SCULPT_undo_compress(data.data(), data_size, &compressed_size), nullptr);
+}
+
+}  // namespace blender::ed::sculpt_paint::tests
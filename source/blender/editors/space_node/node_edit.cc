@@ -41,6 +41,7 @@
 #include "BKE_node_tree_update.h"
 #include "BKE_report.h"
 #include "BKE_scene.h"
+#include "BKE_screen.h"
 #include "BKE_workspace.h"
 
 #include "DEG_depsgraph.h"
@@ -94,6 +95,9 @@ struct CompoJob {
   ViewLayer *view_layer;
   bNodeTree *ntree;
   int recalc_flags;
+  /* Visible area of the viewer image to compute first, see #NTREE_COM_VIEWER_REGION_FIRST. */
+  rctf viewer_region;
+  bool use_viewer_region;
   /* Evaluated state/ */
   Depsgraph *compositor_depsgraph;
   bNodeTree *localtree;
@@ -175,6 +179,105 @@ static int compo_get_recalc_flags(const bContext *C)
   return recalc_flags;
 }
 
+static void viewer_border_corner_to_backdrop(SpaceNode *snode,
+                                             ARegion *region,
+                                             int x,
+                                             int y,
+                                             int backdrop_width,
+                                             int backdrop_height,
+                                             float *fx,
+                                             float *fy)
+{
+  float bufx = backdrop_width * snode->zoom;
+  float bufy = backdrop_height * snode->zoom;
+
+  *fx = (bufx > 0.0f ? ((float)x - 0.5f * region->winx - snode->xof) / bufx + 0.5f : 0.0f);
+  *fy = (bufy > 0.0f ? ((float)y - 0.5f * region->winy - snode->yof) / bufy + 0.5f : 0.0f);
+}
+
+/**
+ * Get the normalized area of the viewer image visible in node editor backdrops and image
+ * editors. Returns false when the viewer image isn't visible or is entirely visible.
+ */
+static bool compo_get_viewer_region(const bContext *C, rctf *r_region)
+{
+  wmWindowManager *wm = CTX_wm_manager(C);
+  /* Look the viewer image up without creating it, it only exists once the compositor ran. */
+  Image *ima = nullptr;
+  LISTBASE_FOREACH (Image *, image, &CTX_data_main(C)->images) {
+    if (image->source == IMA_SRC_VIEWER && image->type == IMA_TYPE_COMPOSITE) {
+      ima = image;
+      break;
+    }
+  }
+  if (ima == nullptr) {
+    return false;
+  }
+
+  void *lock;
+  ImBuf *ibuf = BKE_image_acquire_ibuf(ima, nullptr, &lock);
+  if (ibuf == nullptr) {
+    BKE_image_release_ibuf(ima, ibuf, lock);
+    return false;
+  }
+
+  bool is_visible = false;
+  BLI_rctf_init_minmax(r_region);
+  LISTBASE_FOREACH (wmWindow *, win, &wm->windows) {
+    const bScreen *screen = WM_window_get_active_screen(win);
+
+    LISTBASE_FOREACH (ScrArea *, area, &screen->areabase) {
+      ARegion *region = BKE_area_find_region_type(area, RGN_TYPE_WINDOW);
+      if (region == nullptr) {
+        continue;
+      }
+
+      rctf visible;
+      if (area->spacetype == SPACE_IMAGE) {
+        SpaceImage *sima = (SpaceImage *)area->spacedata.first;
+        if (sima->image != ima) {
+          continue;
+        }
+        /* Image editors view is in normalized image space. */
+        visible = region->v2d.cur;
+      }
+      else if (area->spacetype == SPACE_NODE) {
+        SpaceNode *snode = (SpaceNode *)area->spacedata.first;
+        if (!(snode->flag & SNODE_BACKDRAW) || !ED_node_is_compositor(snode)) {
+          continue;
+        }
+        viewer_border_corner_to_backdrop(
+            snode, region, 0, 0, ibuf->x, ibuf->y, &visible.xmin, &visible.ymin);
+        viewer_border_corner_to_backdrop(snode,
+                                         region,
+                                         region->winx,
+                                         region->winy,
+                                         ibuf->x,
+                                         ibuf->y,
+                                         &visible.xmax,
+                                         &visible.ymax);
+      }
+      else {
+        continue;
+      }
+      BLI_rctf_union(r_region, &visible);
+      is_visible = true;
+    }
+  }
+  BKE_image_release_ibuf(ima, ibuf, lock);
+
+  if (!is_visible) {
+    return false;
+  }
+
+  rctf image_rect;
+  BLI_rctf_init(&image_rect, 0.0f, 1.0f, 0.0f, 1.0f);
+  if (!BLI_rctf_isect(r_region, &image_rect, r_region)) {
+    return false;
+  }
+  return !BLI_rctf_compare(r_region, &image_rect, 0.0f);
+}
+
 /* called by compo, only to check job 'stop' value */
 static int compo_breakjob(void *cjv)
 {
@@ -287,6 +390,7 @@ static void compo_startjob(void *cjv,
 
   // XXX BIF_store_spare();
   /* 1 is do_previews */
+  const rctf *viewer_region = cj->use_viewer_region ? &cj->viewer_region : nullptr;
 
   if ((cj->scene->r.scemode & R_MULTIVIEW) == 0) {
     ntreeCompositExecTree(cj->scene,
@@ -296,7 +400,8 @@ static void compo_startjob(void *cjv,
                           true,
                           &scene->view_settings,
                           &scene->display_settings,
-                          "");
+                          "",
+                          viewer_region);
   }
   else {
     LISTBASE_FOREACH (SceneRenderView *, srv, &scene->r.views) {
@@ -310,7 +415,8 @@ static void compo_startjob(void *cjv,
                             true,
                             &scene->view_settings,
                             &scene->display_settings,
-                            srv->name);
+                            srv->name,
+                            viewer_region);
     }
   }
 
@@ -355,6 +461,9 @@ void ED_node_composite_job(const bContext *C, struct bNodeTree *nodetree, Scene
   cj->view_layer = view_layer;
   cj->ntree = nodetree;
   cj->recalc_flags = compo_get_recalc_flags(C);
+  if (nodetree->flag & NTREE_COM_VIEWER_REGION_FIRST) {
+    cj->use_viewer_region = compo_get_viewer_region(C, &cj->viewer_region);
+  }
 
   /* setup job */
   WM_jobs_customdata_set(wm_job, cj, compo_freejob);
@@ -2733,22 +2842,6 @@ void NODE_OT_shader_script_update(wmOperatorType *ot)
 
 /* ********************** Viewer border ******************/
 
-static void viewer_border_corner_to_backdrop(SpaceNode *snode,
-                                             ARegion *region,
-                                             int x,
-                                             int y,
-                                             int backdrop_width,
-                                             int backdrop_height,
-                                             float *fx,
-                                             float *fy)
-{
-  float bufx = backdrop_width * snode->zoom;
-  float bufy = backdrop_height * snode->zoom;
-
-  *fx = (bufx > 0.0f ? ((float)x - 0.5f * region->winx - snode->xof) / bufx + 0.5f : 0.0f);
-  *fy = (bufy > 0.0f ? ((float)y - 0.5f * region->winy - snode->yof) / bufy + 0.5f : 0.0f);
-}
-
 static int viewer_border_exec(bContext *C, wmOperator *op)
 {
   Main *bmain = CTX_data_main(C);
@@ -273,8 +273,19 @@ static void undo_history_draw_menu(const bContext *C, Menu *menu)
     const bool is_active = (us == wm->undo_stack->step_active);
     uiLayout *row = uiLayoutRow(column, false);
     uiLayoutSetEnabled(row, !is_active);
+
+    /* Show the memory used by each step, steps which only reference data have no size. */
+    char name[128];
+    if (us->data_size != 0) {
+      char data_size_str[15];
+      BLI_str_format_byte_unit(data_size_str, (long long int)us->data_size, false);
+      BLI_snprintf(name, sizeof(name), "%s (%s)", IFACE_(us->name), data_size_str);
+    }
+    else {
+      BLI_strncpy(name, IFACE_(us->name), sizeof(name));
+    }
     uiItemIntO(row,
-               IFACE_(us->name),
+               name,
                is_active ? ICON_LAYER_ACTIVE : ICON_NONE,
                "ED_OT_undo_history",
                "item",
@@ -184,6 +184,14 @@ struct ImBuf *IMB_makeSingleUser(struct ImBuf *ibuf);
  */
 struct ImBuf *IMB_dupImBuf(const struct ImBuf *ibuf1);
 
+/**
+ * Tag the content of the buffer as changed, giving it a new #ImBuf.update_counter. Together with
+ * the buffer pointer it identifies the content without reading the pixels.
+ *
+ * \attention Defined in allocimbuf.c
+ */
+void IMB_tag_changed(struct ImBuf *ibuf);
+
 /**
  *
  * \attention Defined in allocimbuf.c
@@ -357,6 +365,11 @@ typedef enum IMB_Proxy_Size {
 typedef enum eIMBInterpolationFilterMode {
   IMB_FILTER_NEAREST,
   IMB_FILTER_BILINEAR,
+  /**
+   * Average of bilinear samples covering the area of a destination pixel in the source image.
+   * Avoids aliasing when downscaling, same as bilinear otherwise.
+   */
+  IMB_FILTER_BOX,
 } eIMBInterpolationFilterMode;
 
 /**
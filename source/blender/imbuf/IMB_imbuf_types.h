@@ -243,6 +243,8 @@ typedef struct ImBuf {
   int index;
   /** used to set imbuf to dirty and other stuff */
   int userflags;
+  /** Changed along with the buffer content, unique across buffers, see #IMB_tag_changed. */
+  unsigned int update_counter;
   /** image metadata */
   struct IDProperty *metadata;
   /** temporary storage */
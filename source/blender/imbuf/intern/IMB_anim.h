@@ -80,6 +80,7 @@
 
 #define MAXNUMSTREAMS 50
 
+struct AnimDecodeAhead;
 struct IDProperty;
 struct _AviMovie;
 struct anim_index;
@@ -136,6 +137,9 @@ struct anim {
   int64_t cur_pts;
   int64_t cur_key_frame_pts;
   AVPacket *cur_packet;
+
+  /* Frames decoded in a background thread ahead of playback, see #anim_decode_ahead_fetch. */
+  struct AnimDecodeAhead *decode_ahead;
 #endif
 
   char index_dir[768];
@@ -151,3 +155,11 @@ struct anim {
 
   struct IDProperty *metadata;
 };
+
+#ifdef WITH_FFMPEG
+/**
+ * Stop decoding frames ahead of playback and release them, decoding ahead restarts with the next
+ * requests. Needed before freeing state the decoder uses, such as indices and proxies.
+ */
+void anim_decode_ahead_free(struct anim *anim);
+#endif
@@ -41,8 +41,13 @@
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
+#include "atomic_ops.h"
+
 static SpinLock refcounter_spin;
 
+/** Last value given to #ImBuf.update_counter. */
+static unsigned int update_counter_last = 0;
+
 void imb_refcounter_lock_init(void)
 {
   BLI_spin_init(&refcounter_spin);
@@ -572,6 +577,8 @@ bool IMB_initImBuf(
   /* assign default spaces */
   colormanage_imbuf_set_default_spaces(ibuf);
 
+  IMB_tag_changed(ibuf);
+
   return true;
 }
 
@@ -660,9 +667,16 @@ ImBuf *IMB_dupImBuf(const ImBuf *ibuf1)
 
   *ibuf2 = tbuf;
 
+  IMB_tag_changed(ibuf2);
+
   return ibuf2;
 }
 
+void IMB_tag_changed(ImBuf *ibuf)
+{
+  ibuf->update_counter = atomic_add_and_fetch_uint32(&update_counter_last, 1);
+}
+
 size_t IMB_get_rect_len(const ImBuf *ibuf)
 {
   return (size_t)ibuf->x * (size_t)ibuf->y;
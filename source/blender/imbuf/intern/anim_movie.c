@@ -55,6 +55,7 @@
 
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -1396,12 +1397,330 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
   return anim->cur_frame_final;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Decode-Ahead
+ *
+ * During playback frames are decoded in a background thread ahead of the requested position,
+ * in the direction of playback, so the caller doesn't have to wait for the decoder. Decoded
+ * frames are kept in a small ring of slots covering the positions from the last requested one
+ * onward. When a request doesn't continue the playback pattern (scrubbing, jumping) the frames
+ * are released and decoding ahead pauses until playback is detected again.
+ *
+ * The FFmpeg state of the anim is only accessed with `decode_mutex` locked, both from the
+ * background thread and from the caller on a cache miss.
+ * \{ */
+
+/* Upper limit for the number of decoded frames, and for their memory. */
+#  define ANIM_DECODE_AHEAD_FRAMES_MAX 8
+#  define ANIM_DECODE_AHEAD_MEMORY_MAX ((size_t)256 * 1024 * 1024)
+/* Largest step between requests that is still considered playback, to support frame dropping. */
+#  define ANIM_DECODE_AHEAD_STEP_MAX 4
+/* Number of requests following the playback pattern before decoding ahead starts. */
+#  define ANIM_DECODE_AHEAD_REQUESTS_MIN 2
+
+typedef struct AnimDecodeAheadSlot {
+  int position;
+  struct ImBuf *ibuf;
+} AnimDecodeAheadSlot;
+
+typedef struct AnimDecodeAhead {
+  TaskPool *task_pool;
+  /* Locked while the FFmpeg decoding state of the anim is used. */
+  ThreadMutex decode_mutex;
+  /* Protects all fields below. */
+  ThreadMutex mutex;
+
+  AnimDecodeAheadSlot slots[ANIM_DECODE_AHEAD_FRAMES_MAX];
+  int slots_num;
+
+  /* Playback pattern of the requests. */
+  IMB_Timecode_Type tc;
+  int duration;
+  int last_position;
+  int direction;
+  int playback_requests_num;
+
+  bool is_running;
+} AnimDecodeAhead;
+
+static AnimDecodeAhead *anim_decode_ahead_ensure(struct anim *anim)
+{
+  if (anim->decode_ahead) {
+    return anim->decode_ahead;
+  }
+
+  AnimDecodeAhead *decode_ahead = MEM_callocN(sizeof(AnimDecodeAhead), __func__);
+  BLI_mutex_init(&decode_ahead->decode_mutex);
+  BLI_mutex_init(&decode_ahead->mutex);
+
+  const size_t frames_num = ANIM_DECODE_AHEAD_MEMORY_MAX / max_zz(anim->framesize, 1);
+  decode_ahead->slots_num = (int)min_zz(max_zz(frames_num, 2), ANIM_DECODE_AHEAD_FRAMES_MAX);
+  decode_ahead->tc = IMB_TC_NONE;
+  decode_ahead->last_position = -1;
+
+  anim->decode_ahead = decode_ahead;
+  return decode_ahead;
+}
+
+void anim_decode_ahead_free(struct anim *anim)
+{
+  AnimDecodeAhead *decode_ahead = anim->decode_ahead;
+  if (decode_ahead == NULL) {
+    return;
+  }
+
+  /* Wait for the decoding task to finish before the FFmpeg state is freed. */
+  if (decode_ahead->task_pool) {
+    BLI_task_pool_cancel(decode_ahead->task_pool);
+    BLI_task_pool_free(decode_ahead->task_pool);
+  }
+
+  for (int i = 0; i < decode_ahead->slots_num; i++) {
+    IMB_freeImBuf(decode_ahead->slots[i].ibuf);
+  }
+
+  BLI_mutex_end(&decode_ahead->decode_mutex);
+  BLI_mutex_end(&decode_ahead->mutex);
+  MEM_freeN(decode_ahead);
+  anim->decode_ahead = NULL;
+}
+
+/* Offset of the position from the last requested one in playback direction, -1 when the
+ * position is not covered by the slots. */
+static int anim_decode_ahead_offset(const AnimDecodeAhead *decode_ahead, const int position)
+{
+  if (decode_ahead->direction == 0) {
+    return (position == decode_ahead->last_position) ? 0 : -1;
+  }
+  const int offset = (position - decode_ahead->last_position) * decode_ahead->direction;
+  return (offset >= 0 && offset < decode_ahead->slots_num) ? offset : -1;
+}
+
+static AnimDecodeAheadSlot *anim_decode_ahead_find(AnimDecodeAhead *decode_ahead,
+                                                    const int position)
+{
+  for (int i = 0; i < decode_ahead->slots_num; i++) {
+    AnimDecodeAheadSlot *slot = &decode_ahead->slots[i];
+    if (slot->ibuf && slot->position == position) {
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+/* Release frames which are not ahead of the last requested position anymore. */
+static void anim_decode_ahead_release_stale(AnimDecodeAhead *decode_ahead)
+{
+  for (int i = 0; i < decode_ahead->slots_num; i++) {
+    AnimDecodeAheadSlot *slot = &decode_ahead->slots[i];
+    if (slot->ibuf && anim_decode_ahead_offset(decode_ahead, slot->position) == -1) {
+      IMB_freeImBuf(slot->ibuf);
+      slot->ibuf = NULL;
+    }
+  }
+}
+
+/* Update the playback pattern with a new request. */
+static void anim_decode_ahead_request(struct anim *anim,
+                                      AnimDecodeAhead *decode_ahead,
+                                      const int position,
+                                      const IMB_Timecode_Type tc)
+{
+  const int step = position - decode_ahead->last_position;
+
+  if (tc != decode_ahead->tc) {
+    /* Frames of another time-code have different positions. */
+    for (int i = 0; i < decode_ahead->slots_num; i++) {
+      IMB_freeImBuf(decode_ahead->slots[i].ibuf);
+      decode_ahead->slots[i].ibuf = NULL;
+    }
+    decode_ahead->tc = tc;
+    decode_ahead->direction = 0;
+    decode_ahead->playback_requests_num = 0;
+  }
+  else if (step == 0) {
+    /* Redraw of the same frame keeps the pattern. */
+  }
+  else if (abs(step) <= ANIM_DECODE_AHEAD_STEP_MAX && decode_ahead->last_position != -1) {
+    const int direction = (step > 0) ? 1 : -1;
+    if (direction == decode_ahead->direction) {
+      decode_ahead->playback_requests_num++;
+    }
+    else {
+      decode_ahead->direction = direction;
+      decode_ahead->playback_requests_num = 1;
+    }
+  }
+  else {
+    /* Scrubbing. */
+    decode_ahead->direction = 0;
+    decode_ahead->playback_requests_num = 0;
+  }
+
+  decode_ahead->last_position = position;
+  decode_ahead->duration = IMB_anim_get_duration(anim, tc);
+  anim_decode_ahead_release_stale(decode_ahead);
+}
+
+/* Next position to decode ahead, or -1 when all slots are filled or there is no playback. */
+static int anim_decode_ahead_next_position(AnimDecodeAhead *decode_ahead)
+{
+  if (decode_ahead->direction == 0 ||
+      decode_ahead->playback_requests_num < ANIM_DECODE_AHEAD_REQUESTS_MIN) {
+    return -1;
+  }
+
+  for (int offset = 1; offset < decode_ahead->slots_num; offset++) {
+    const int position = decode_ahead->last_position + offset * decode_ahead->direction;
+    if (position < 0 || position >= decode_ahead->duration) {
+      return -1;
+    }
+    if (anim_decode_ahead_find(decode_ahead, position) == NULL) {
+      return position;
+    }
+  }
+  return -1;
+}
+
+static void anim_decode_ahead_store(AnimDecodeAhead *decode_ahead,
+                                    const int position,
+                                    struct ImBuf *ibuf)
+{
+  if (anim_decode_ahead_offset(decode_ahead, position) != -1 &&
+      anim_decode_ahead_find(decode_ahead, position) == NULL) {
+    for (int i = 0; i < decode_ahead->slots_num; i++) {
+      AnimDecodeAheadSlot *slot = &decode_ahead->slots[i];
+      if (slot->ibuf == NULL) {
+        slot->position = position;
+        slot->ibuf = ibuf;
+        return;
+      }
+    }
+  }
+  /* Playback moved on while decoding. */
+  IMB_freeImBuf(ibuf);
+}
+
+/**
+ * Decode a frame, expects `decode_mutex` to be locked. The name is set here, while the frame
+ * isn't shared with the slots yet: frames are not modified once they are stored.
+ */
+static struct ImBuf *anim_decode_ahead_decode(struct anim *anim,
+                                              const int position,
+                                              const IMB_Timecode_Type tc)
+{
+  struct ImBuf *ibuf = ffmpeg_fetchibuf(anim, position, tc);
+  if (ibuf) {
+    BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, position + 1);
+  }
+  return ibuf;
+}
+
+static void anim_decode_ahead_task(TaskPool *__restrict pool, void *UNUSED(taskdata))
+{
+  struct anim *anim = BLI_task_pool_user_data(pool);
+  AnimDecodeAhead *decode_ahead = anim->decode_ahead;
+
+  BLI_mutex_lock(&decode_ahead->mutex);
+  while (!BLI_task_pool_current_canceled(pool)) {
+    const int position = anim_decode_ahead_next_position(decode_ahead);
+    if (position == -1) {
+      break;
+    }
+    const IMB_Timecode_Type tc = decode_ahead->tc;
+    BLI_mutex_unlock(&decode_ahead->mutex);
+
+    BLI_mutex_lock(&decode_ahead->decode_mutex);
+    struct ImBuf *ibuf = anim_decode_ahead_decode(anim, position, tc);
+    BLI_mutex_unlock(&decode_ahead->decode_mutex);
+
+    BLI_mutex_lock(&decode_ahead->mutex);
+    if (ibuf) {
+      if (tc == decode_ahead->tc) {
+        anim_decode_ahead_store(decode_ahead, position, ibuf);
+      }
+      else {
+        IMB_freeImBuf(ibuf);
+      }
+    }
+  }
+  decode_ahead->is_running = false;
+  BLI_mutex_unlock(&decode_ahead->mutex);
+}
+
+/* Start decoding ahead in the background when there are frames to decode. Expects
+ * `decode_ahead->mutex` to be locked. */
+static void anim_decode_ahead_start(struct anim *anim, AnimDecodeAhead *decode_ahead)
+{
+  if (decode_ahead->is_running || anim_decode_ahead_next_position(decode_ahead) == -1) {
+    return;
+  }
+  if (decode_ahead->task_pool == NULL) {
+    decode_ahead->task_pool = BLI_task_pool_create_background(anim, TASK_PRIORITY_LOW);
+  }
+  decode_ahead->is_running = true;
+  BLI_task_pool_push(decode_ahead->task_pool, anim_decode_ahead_task, NULL, false, NULL);
+}
+
+/**
+ * Fetch a frame, using frames decoded ahead when possible. Frames which are not decoded yet are
+ * decoded on the calling thread.
+ */
+static ImBuf *anim_decode_ahead_fetch(struct anim *anim, int position, IMB_Timecode_Type tc)
+{
+  AnimDecodeAhead *decode_ahead = anim_decode_ahead_ensure(anim);
+
+  BLI_mutex_lock(&decode_ahead->mutex);
+  anim_decode_ahead_request(anim, decode_ahead, position, tc);
+  AnimDecodeAheadSlot *slot = anim_decode_ahead_find(decode_ahead, position);
+  struct ImBuf *ibuf = slot ? slot->ibuf : NULL;
+  if (ibuf) {
+    IMB_refImBuf(ibuf);
+    anim_decode_ahead_start(anim, decode_ahead);
+  }
+  BLI_mutex_unlock(&decode_ahead->mutex);
+
+  if (ibuf) {
+    return ibuf;
+  }
+
+  BLI_mutex_lock(&decode_ahead->decode_mutex);
+  /* The frame might have been decoded in the background while waiting for the lock. */
+  BLI_mutex_lock(&decode_ahead->mutex);
+  slot = anim_decode_ahead_find(decode_ahead, position);
+  ibuf = slot ? slot->ibuf : NULL;
+  if (ibuf) {
+    IMB_refImBuf(ibuf);
+  }
+  BLI_mutex_unlock(&decode_ahead->mutex);
+
+  if (ibuf == NULL) {
+    ibuf = anim_decode_ahead_decode(anim, position, tc);
+  }
+  BLI_mutex_unlock(&decode_ahead->decode_mutex);
+
+  BLI_mutex_lock(&decode_ahead->mutex);
+  if (ibuf && tc == decode_ahead->tc && anim_decode_ahead_find(decode_ahead, position) == NULL) {
+    /* Keep the current frame for redraws. */
+    IMB_refImBuf(ibuf);
+    anim_decode_ahead_store(decode_ahead, position, ibuf);
+  }
+  anim_decode_ahead_start(anim, decode_ahead);
+  BLI_mutex_unlock(&decode_ahead->mutex);
+
+  return ibuf;
+}
+
+/** \} */
+
 static void free_anim_ffmpeg(struct anim *anim)
 {
   if (anim == NULL) {
     return;
   }
 
+  anim_decode_ahead_free(anim);
+
   if (anim->pCodecCtx) {
     avcodec_free_context(&anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
@@ -1561,20 +1880,19 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
 #endif
 #ifdef WITH_FFMPEG
     case ANIM_FFMPEG:
-      ibuf = ffmpeg_fetchibuf(anim, position, tc);
-      if (ibuf) {
-        anim->cur_position = position;
-      }
+      /* The decoder keeps track of its position, which can be ahead of the requested one. */
+      ibuf = anim_decode_ahead_fetch(anim, position, tc);
       filter_y = 0; /* done internally */
       break;
 #endif
   }
 
-  if (ibuf) {
+  /* FFmpeg frames are named when decoded, they may be shared with the decoded ahead frames. */
+  if (ibuf && anim->curtype != ANIM_FFMPEG) {
     if (filter_y) {
       IMB_filtery(ibuf);
     }
-    BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, anim->cur_position + 1);
+    BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, position + 1);
   }
   return ibuf;
 }
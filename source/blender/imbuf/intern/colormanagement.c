@@ -3541,6 +3541,8 @@ static void imb_partial_display_buffer_update_ex(
   unsigned char *display_buffer = NULL;
   int buffer_width = ibuf->x;
 
+  IMB_tag_changed(ibuf);
+
   if (ibuf->display_buffer_flags) {
     int view_flag, display_index;
 
@@ -3692,6 +3694,8 @@ void IMB_partial_display_buffer_update_threaded(
 
 void IMB_partial_display_buffer_update_delayed(ImBuf *ibuf, int xmin, int ymin, int xmax, int ymax)
 {
+  IMB_tag_changed(ibuf);
+
   if (ibuf->invalid_rect.xmin == ibuf->invalid_rect.xmax) {
     BLI_rcti_init(&ibuf->invalid_rect, xmin, xmax, ymin, ymax);
   }
@@ -498,8 +498,15 @@ struct proxy_output_ctx {
   int proxy_size;
   int orig_height;
   struct anim *anim;
+
+  /* Decoded frames waiting to be scaled and encoded by the output thread. */
+  ThreadQueue *frames;
 };
 
+/* Maximum number of decoded frames waiting for an output, limits memory usage when encoding is
+ * slower than decoding. */
+#  define PROXY_OUTPUT_QUEUE_MAX 8
+
 static struct proxy_output_ctx *alloc_proxy_output_ffmpeg(
     struct anim *anim, AVStream *st, int proxy_size, int width, int height, int quality)
 {
@@ -739,6 +746,33 @@ static void add_to_proxy_output_ffmpeg(struct proxy_output_ctx *ctx, AVFrame *fr
   av_packet_free(&packet);
 }
 
+/* Scale and encode frames of one proxy size, running in parallel to decoding and to the other
+ * proxy sizes. */
+static void *proxy_output_ffmpeg_thread(void *data)
+{
+  struct proxy_output_ctx *ctx = data;
+  AVFrame *frame;
+
+  while ((frame = BLI_thread_queue_pop(ctx->frames))) {
+    add_to_proxy_output_ffmpeg(ctx, frame);
+    av_frame_free(&frame);
+  }
+  return NULL;
+}
+
+static void proxy_output_ffmpeg_push(struct proxy_output_ctx *ctx, AVFrame *frame)
+{
+  if (!ctx) {
+    return;
+  }
+
+  if (BLI_thread_queue_len(ctx->frames) >= PROXY_OUTPUT_QUEUE_MAX) {
+    BLI_thread_queue_wait_finish(ctx->frames);
+  }
+  /* Only references the decoded data, the decoder allocates new buffers for following frames. */
+  BLI_thread_queue_push(ctx->frames, av_frame_clone(frame));
+}
+
 static void free_proxy_output_ffmpeg(struct proxy_output_ctx *ctx, int rollback)
 {
   char fname[FILE_MAX];
@@ -974,7 +1008,7 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *c
   uint64_t pts = av_get_pts_from_frame(in_frame);
 
   for (i = 0; i < context->num_proxy_sizes; i++) {
-    add_to_proxy_output_ffmpeg(context->proxy_ctx[i], in_frame);
+    proxy_output_ffmpeg_push(context->proxy_ctx[i], in_frame);
   }
 
   if (!context->start_pts_set) {
@@ -1033,6 +1067,18 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
   context->frame_rate = av_q2d(context->iStream->r_frame_rate);
   context->pts_time_base = av_q2d(context->iStream->time_base);
 
+  /* Decoding and building indices happens on this thread, while each proxy size is scaled and
+   * encoded in its own thread. */
+  ListBase output_threads;
+  BLI_threadpool_init(&output_threads, proxy_output_ffmpeg_thread, context->num_proxy_sizes);
+  for (int i = 0; i < context->num_proxy_sizes; i++) {
+    struct proxy_output_ctx *ctx = context->proxy_ctx[i];
+    if (ctx) {
+      ctx->frames = BLI_thread_queue_init();
+      BLI_threadpool_insert(&output_threads, ctx);
+    }
+  }
+
   while (av_read_frame(context->iFormatCtx, next_packet) >= 0) {
     float next_progress =
         (float)((int)floor(((double)next_packet->pos) * 100 / ((double)stream_size) + 0.5)) / 100;
@@ -1098,6 +1144,28 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
     }
   }
 
+  for (int i = 0; i < context->num_proxy_sizes; i++) {
+    struct proxy_output_ctx *ctx = context->proxy_ctx[i];
+    if (ctx) {
+      if (*stop) {
+        /* Output is discarded anyway, don't wait for pending frames to be encoded. */
+        AVFrame *frame;
+        while ((frame = BLI_thread_queue_pop_timeout(ctx->frames, 0))) {
+          av_frame_free(&frame);
+        }
+      }
+      BLI_thread_queue_nowait(ctx->frames);
+    }
+  }
+  BLI_threadpool_end(&output_threads);
+  for (int i = 0; i < context->num_proxy_sizes; i++) {
+    struct proxy_output_ctx *ctx = context->proxy_ctx[i];
+    if (ctx) {
+      BLI_thread_queue_free(ctx->frames);
+      ctx->frames = NULL;
+    }
+  }
+
   av_packet_free(&next_packet);
   av_free(in_frame);
 
@@ -1515,6 +1583,11 @@ void IMB_free_indices(struct anim *anim)
 {
   int i;
 
+#ifdef WITH_FFMPEG
+  /* Decoding ahead uses the indices and proxies. */
+  anim_decode_ahead_free(anim);
+#endif
+
   for (i = 0; i < IMB_PROXY_MAX_SLOT; i++) {
     if (anim->proxy_anim[i]) {
       IMB_close_anim(anim->proxy_anim[i]);
@@ -0,0 +1,114 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_math.h"
+#include "BLI_rect.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+
+#include "IMB_transform_test_utils.hh"
+
+namespace blender::imbuf::tests {
+
+class ImBufTransformTest : public ImBufTest {
+};
+
+TEST_F(ImBufTransformTest, bilinear_matches_reference)
+{
+  ImBuf *src = create_test_image(67, 45, IB_rect | IB_rectfloat);
+  ImBuf *dst_byte = IMB_allocImBuf(53, 61, 32, IB_rect);
+  ImBuf *dst_float = IMB_allocImBuf(53, 61, 32, IB_rectfloat);
+  float matrix[4][4];
+  transform_matrix_init(src, dst_byte, 0.3f, 1.3f, matrix);
+
+  IMB_transform(src, dst_byte, IMB_TRANSFORM_MODE_REGULAR, IMB_FILTER_BILINEAR, matrix, nullptr);
+  IMB_transform(src, dst_float, IMB_TRANSFORM_MODE_REGULAR, IMB_FILTER_BILINEAR, matrix, nullptr);
+
+  for (int y = 0; y < dst_byte->y; y++) {
+    for (int x = 0; x < dst_byte->x; x++) {
+      float uv[3] = {(float)x, (float)y, 0.0f};
+      mul_m4_v3(matrix, uv);
+      const size_t offset = ((size_t)y * dst_byte->x + x) * 4;
+
+      unsigned char expected_byte[4];
+      BLI_bilinear_interpolation_char(
+          (const unsigned char *)src->rect, expected_byte, src->x, src->y, 4, uv[0], uv[1]);
+      const unsigned char *actual_byte = (const unsigned char *)dst_byte->rect + offset;
+      for (int i = 0; i < 4; i++) {
+        EXPECT_NEAR(actual_byte[i], expected_byte[i], 1);
+      }
+
+      float expected_float[4];
+      BLI_bilinear_interpolation_fl(
+          src->rect_float, expected_float, src->x, src->y, 4, uv[0], uv[1]);
+      const float *actual_float = dst_float->rect_float + offset;
+      /* Coordinates are accumulated along the scanline, so allow for some precision loss. */
+      for (int i = 0; i < 4; i++) {
+        EXPECT_NEAR(actual_float[i], expected_float[i], 1e-4f);
+      }
+    }
+  }
+
+  IMB_freeImBuf(src);
+  IMB_freeImBuf(dst_byte);
+  IMB_freeImBuf(dst_float);
+}
+
+TEST_F(ImBufTransformTest, box_same_as_bilinear_without_downscale)
+{
+  ImBuf *src = create_test_image(40, 30, IB_rectfloat);
+  ImBuf *dst_box = IMB_allocImBuf(60, 45, 32, IB_rectfloat);
+  ImBuf *dst_bilinear = IMB_allocImBuf(60, 45, 32, IB_rectfloat);
+  float matrix[4][4];
+  transform_matrix_init(src, dst_box, 0.1f, 1.5f, matrix);
+
+  IMB_transform(src, dst_box, IMB_TRANSFORM_MODE_REGULAR, IMB_FILTER_BOX, matrix, nullptr);
+  IMB_transform(
+      src, dst_bilinear, IMB_TRANSFORM_MODE_REGULAR, IMB_FILTER_BILINEAR, matrix, nullptr);
+
+  const size_t size = (size_t)dst_box->x * dst_box->y * 4;
+  for (size_t i = 0; i < size; i++) {
+    EXPECT_EQ(dst_box->rect_float[i], dst_bilinear->rect_float[i]);
+  }
+
+  IMB_freeImBuf(src);
+  IMB_freeImBuf(dst_box);
+  IMB_freeImBuf(dst_bilinear);
+}
+
+TEST_F(ImBufTransformTest, box_downscale_checker)
+{
+  /* Downscaled checker pattern of single pixels must become uniform gray. */
+  const int width = 256;
+  ImBuf *src = IMB_allocImBuf(width, width, 32, IB_rect);
+  unsigned char *pixel = (unsigned char *)src->rect;
+  for (int y = 0; y < width; y++) {
+    for (int x = 0; x < width; x++, pixel += 4) {
+      const unsigned char value = ((x + y) % 2) ? 255 : 0;
+      pixel[0] = pixel[1] = pixel[2] = value;
+      pixel[3] = 255;
+    }
+  }
+
+  ImBuf *dst = IMB_allocImBuf(width / 4, width / 4, 32, IB_rect);
+  float matrix[4][4];
+  transform_matrix_init(src, dst, 0.0f, 0.25f, matrix);
+  IMB_transform(src, dst, IMB_TRANSFORM_MODE_REGULAR, IMB_FILTER_BOX, matrix, nullptr);
+
+  /* Skip border, where samples are partially outside of the source image. */
+  for (int y = 1; y < dst->y - 1; y++) {
+    for (int x = 1; x < dst->x - 1; x++) {
+      const unsigned char *result = (const unsigned char *)dst->rect +
+                                    ((size_t)y * dst->x + x) * 4;
+      EXPECT_NEAR(result[0], 128, 2);
+      EXPECT_EQ(result[3], 255);
+    }
+  }
+
+  IMB_freeImBuf(src);
+  IMB_freeImBuf(dst);
+}
+
+}  // namespace blender::imbuf::tests
@@ -0,0 +1,71 @@
+/* Apache License, Version 2.0 */
+
+#pragma once
+
+/** \file
+ * \ingroup imbuf
+ *
+ * Test images and transformations shared by the image transform tests and benchmarks.
+ */
+
+#include "testing/testing.h"
+
+#include "BLI_math.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+
+namespace blender::imbuf::tests {
+
+/** Base fixture for tests using image buffers, initializing the image module. */
+class ImBufTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    IMB_init();
+  }
+  static void TearDownTestSuite()
+  {
+    IMB_exit();
+  }
+};
+
+/** Create an image with a pattern in the channels, of byte and/or float type as in `flags`. */
+inline ImBuf *create_test_image(const int width, const int height, const int flags)
+{
+  ImBuf *ibuf = IMB_allocImBuf(width, height, 32, flags);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const size_t offset = ((size_t)y * width + x) * 4;
+      const float value[4] = {
+          (x % 17) / 16.0f, (y % 13) / 12.0f, ((x + y) % 7) / 6.0f, (x * y % 5) / 4.0f};
+      if (ibuf->rect_float) {
+        copy_v4_v4(ibuf->rect_float + offset, value);
+      }
+      if (ibuf->rect) {
+        rgba_float_to_uchar((unsigned char *)ibuf->rect + offset, value);
+      }
+    }
+  }
+  return ibuf;
+}
+
+/** Transformation from destination to source pixel space, rotating and scaling around center. */
+inline void transform_matrix_init(const ImBuf *src,
+                                  const ImBuf *dst,
+                                  const float angle,
+                                  const float scale,
+                                  float r_matrix[4][4])
+{
+  const float axis[3] = {0.0f, 0.0f, 1.0f};
+  float rotation[3][3];
+  axis_angle_normalized_to_mat3(rotation, axis, angle);
+  const float translation[3] = {(dst->x - src->x) / 2.0f, (dst->y - src->y) / 2.0f, 0.0f};
+  const float size[3] = {scale, scale, 1.0f};
+  const float pivot[3] = {src->x / 2.0f, src->y / 2.0f, 0.0f};
+  loc_rot_size_to_mat4(r_matrix, translation, rotation, size);
+  transform_pivot_set_m4(r_matrix, pivot);
+  invert_m4(r_matrix);
+}
+
+}  // namespace blender::imbuf::tests
@@ -0,0 +1,63 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <cstdio>
+
+#include "BLI_rect.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+
+#include "PIL_time.h"
+
+#include "IMB_transform_test_utils.hh"
+
+#define NUM_RUN_AVERAGED 8
+
+namespace blender::imbuf::tests {
+
+class ImBufTransformPerformanceTest : public ImBufTest {
+};
+
+/** Time transforming a full HD image, cropped as done by the sequencer. */
+static void transform_benchmark(const char *name,
+                                const int flags,
+                                const eIMBInterpolationFilterMode filter,
+                                const float scale)
+{
+  ImBuf *src = create_test_image(1920, 1080, flags);
+  ImBuf *dst = IMB_allocImBuf(1920, 1080, 32, flags);
+  float matrix[4][4];
+  transform_matrix_init(src, dst, 0.2f, scale, matrix);
+  rctf crop;
+  BLI_rctf_init(&crop, 10.0f, src->x - 10.0f, 10.0f, src->y - 10.0f);
+
+  const double time_start = PIL_check_seconds_timer();
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    IMB_transform(src, dst, IMB_TRANSFORM_MODE_CROP_SRC, filter, matrix, &crop);
+  }
+  const double time = (PIL_check_seconds_timer() - time_start) / NUM_RUN_AVERAGED;
+  printf("IMB_transform %s, scale %.2f: %.3f ms\n", name, scale, time * 1000.0);
+
+  IMB_freeImBuf(src);
+  IMB_freeImBuf(dst);
+}
+
+TEST_F(ImBufTransformPerformanceTest, Byte)
+{
+  transform_benchmark("byte nearest", IB_rect, IMB_FILTER_NEAREST, 1.2f);
+  transform_benchmark("byte bilinear", IB_rect, IMB_FILTER_BILINEAR, 1.2f);
+  transform_benchmark("byte bilinear", IB_rect, IMB_FILTER_BILINEAR, 0.4f);
+  transform_benchmark("byte box", IB_rect, IMB_FILTER_BOX, 0.4f);
+}
+
+TEST_F(ImBufTransformPerformanceTest, Float)
+{
+  transform_benchmark("float nearest", IB_rectfloat, IMB_FILTER_NEAREST, 1.2f);
+  transform_benchmark("float bilinear", IB_rectfloat, IMB_FILTER_BILINEAR, 1.2f);
+  transform_benchmark("float bilinear", IB_rectfloat, IMB_FILTER_BILINEAR, 0.4f);
+  transform_benchmark("float box", IB_rectfloat, IMB_FILTER_BOX, 0.4f);
+}
+
+}  // namespace blender::imbuf::tests
@@ -108,6 +108,12 @@ struct DNA_ReconstructInfo *DNA_reconstruct_info_create(const struct SDNA *oldsd
                                                         const struct SDNA *newsdna,
                                                         const char *compare_flags);
 void DNA_reconstruct_info_free(struct DNA_ReconstructInfo *reconstruct_info);
+/**
+ * Pre-process flattened endian switch steps for all structs in the old SDNA of
+ * \a reconstruct_info, used by #DNA_struct_switch_endian_blocks.
+ * Only needed when reading files saved with a different endianness.
+ */
+void DNA_reconstruct_info_ensure_endian_switch(struct DNA_ReconstructInfo *reconstruct_info);
 
 /**
  * Returns the index of the struct info for the struct with the specified name.
@@ -122,6 +128,19 @@ int DNA_struct_find_nr(const struct SDNA *sdna, const char *str);
  * \param data: Struct data that is to be converted
  */
 void DNA_struct_switch_endian(const struct SDNA *sdna, int struct_nr, char *data);
+/**
+ * Does endian swapping on an array of struct values, using the steps pre-processed by
+ * #DNA_reconstruct_info_ensure_endian_switch. Gives the same result as calling
+ * #DNA_struct_switch_endian for every block.
+ *
+ * \param old_struct_nr: Index of struct info within the old SDNA.
+ * \param blocks: The number of array elements.
+ * \param data: Struct data that is to be converted.
+ */
+void DNA_struct_switch_endian_blocks(const struct DNA_ReconstructInfo *reconstruct_info,
+                                     int old_struct_nr,
+                                     int blocks,
+                                     char *data);
 /**
  * Constructs and returns an array of byte flags with one element for each struct in oldsdna,
  * indicating how it compares to newsdna.
@@ -36,6 +36,7 @@ extern "C" {
 
 struct AnimData;
 struct Ipo;
+struct KeyBlockDelta;
 
 typedef struct KeyBlock {
   struct KeyBlock *next, *prev;
@@ -73,6 +74,8 @@ typedef struct KeyBlock {
   float slidermin;
   float slidermax;
 
+  /** Runtime only: offsets from the relative key, cached for evaluated keys (see `key.c`). */
+  struct KeyBlockDelta *delta;
 } KeyBlock;
 
 typedef struct Key {
@@ -32,6 +32,7 @@ extern "C" {
 #endif
 
 struct AnimData;
+struct ArmatureSkinningCache;
 struct BVHCache;
 struct Ipo;
 struct Key;
@@ -46,6 +47,7 @@ struct MPoly;
 struct MVert;
 struct Material;
 struct Mesh;
+struct MeshTopologyMaps;
 struct SubdivCCG;
 
 #
@@ -141,6 +143,10 @@ typedef struct Mesh_Runtime {
   char _pad[2];
   int subsurf_resolution;
 
+  /** Cached adjacency maps, see `mesh_mapping.c`. */
+  struct MeshTopologyMaps *topology_maps;
+  /** Vertex group weights resolved to bones for armature deform, see `armature_deform.c`. */
+  struct ArmatureSkinningCache *skinning_cache;
   void *_pad2;
 
   /**
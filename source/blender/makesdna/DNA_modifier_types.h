@@ -676,6 +676,8 @@ enum {
   /** for dissolve only. collapse all verts between 2 faces */
   MOD_DECIM_FLAG_ALL_BOUNDARY_VERTS = (1 << 2),
   MOD_DECIM_FLAG_SYMMETRY = (1 << 3),
+  /** For collapse only. Decimate parts of large meshes in parallel. */
+  MOD_DECIM_FLAG_PARALLEL = (1 << 4),
 };
 
 enum {
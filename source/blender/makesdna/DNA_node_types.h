@@ -613,6 +613,11 @@ typedef struct bNodeTree {
 /* tree is localized copy, free when deleting node groups */
 /* #define NTREE_IS_LOCALIZED           (1 << 5) */
 
+/** Store intermediate compositor buffers at half float precision. */
+#define NTREE_COM_HALF_FLOAT_BUFFERS (1 << 6)
+/** Compute the region of the viewer visible in the image editor before the rest of it. */
+#define NTREE_COM_VIEWER_REGION_FIRST (1 << 7)
+
 /* tree->execution_mode */
 typedef enum eNodeTreeExecutionMode {
   NTREE_EXECUTION_MODE_TILED = 0,
@@ -80,6 +80,9 @@ typedef struct StripTransform {
   float rotation;
   /** 0-1 range, use SEQ_image_transform_origin_offset_pixelspace_get to convert to pixel space. */
   float origin[2];
+  /** #eSeqTransformFilter, used for final renders, previews use nearest filtering. */
+  char filter;
+  char _pad[3];
 } StripTransform;
 
 typedef struct StripColorBalance {
@@ -137,6 +140,9 @@ typedef struct Strip {
 
 typedef struct SequenceRuntime {
   SessionUUID session_uuid;
+  /** Time in seconds spent rendering the image of this strip, for the last rendered frame. */
+  float render_time;
+  char _pad[4];
 } SequenceRuntime;
 
 /**
@@ -772,6 +778,13 @@ enum {
   SEQ_CACHE_STORE_THUMBNAIL = (1 << 12),
 };
 
+/** #StripTransform.filter */
+typedef enum eSeqTransformFilter {
+  SEQ_TRANSFORM_FILTER_BILINEAR = 0,
+  /** Average the pixels covered by an output pixel, avoids aliasing when downscaling. */
+  SEQ_TRANSFORM_FILTER_BOX = 1,
+} eSeqTransformFilter;
+
 /** #Sequence.color_tag. */
 typedef enum SequenceColorTag {
   SEQUENCE_COLOR_NONE = -1,
@@ -1106,6 +1106,17 @@ typedef struct ReconstructStep {
   } data;
 } ReconstructStep;
 
+/**
+ * Endian switch of a run of primitive values inside an old struct. Nested structs are flattened,
+ * so a single struct only needs one pass over a flat array of these steps.
+ */
+typedef struct EndianSwitchStep {
+  int offset;
+  int array_len;
+  /** Size of each element in bytes, either 2, 4 or 8. */
+  int elem_size;
+} EndianSwitchStep;
+
 typedef struct DNA_ReconstructInfo {
   const SDNA *oldsdna;
   const SDNA *newsdna;
@@ -1113,6 +1124,13 @@ typedef struct DNA_ReconstructInfo {
 
   int *step_counts;
   ReconstructStep **steps;
+
+  /** Index of the matching struct in newsdna for every struct in oldsdna, -1 when removed. */
+  int *new_struct_nrs;
+
+  /** Endian switch steps for every struct in oldsdna, only computed when requested. */
+  int *endian_step_counts;
+  EndianSwitchStep **endian_steps;
 } DNA_ReconstructInfo;
 
 static void reconstruct_structs(const DNA_ReconstructInfo *reconstruct_info,
@@ -1209,12 +1227,9 @@ void *DNA_struct_reconstruct(const DNA_ReconstructInfo *reconstruct_info,
                              int blocks,
                              const void *old_blocks)
 {
-  const SDNA *oldsdna = reconstruct_info->oldsdna;
   const SDNA *newsdna = reconstruct_info->newsdna;
 
-  const SDNA_Struct *old_struct = oldsdna->structs[old_struct_nr];
-  const char *type_name = oldsdna->types[old_struct->type];
-  const int new_struct_nr = DNA_struct_find_nr(newsdna, type_name);
+  const int new_struct_nr = reconstruct_info->new_struct_nrs[old_struct_nr];
 
   if (new_struct_nr == -1) {
     return NULL;
@@ -1501,6 +1516,174 @@ static int compress_reconstruct_steps(ReconstructStep *steps, const int old_step
   return new_step_count;
 }
 
+/** Returns the size of the elements swapped by #DNA_struct_switch_endian for a primitive type. */
+static int endian_switch_elem_size(const eSDNA_Type type)
+{
+  switch (type) {
+    case SDNA_TYPE_SHORT:
+    case SDNA_TYPE_USHORT:
+      return 2;
+    case SDNA_TYPE_INT:
+    case SDNA_TYPE_FLOAT:
+      /* NOTE: long/ulong are ignored, see #DNA_struct_switch_endian. */
+      return 4;
+    case SDNA_TYPE_INT64:
+    case SDNA_TYPE_UINT64:
+    case SDNA_TYPE_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * Append an endian switch step, merging it with the previous step when the values are contiguous
+ * and have the same size (e.g. consecutive float members or nested `float[3]` arrays).
+ */
+static void endian_switch_steps_append(EndianSwitchStep **r_steps,
+                                       int *r_steps_len,
+                                       int *r_steps_capacity,
+                                       const int offset,
+                                       const int array_len,
+                                       const int elem_size)
+{
+  if (*r_steps_len > 0) {
+    EndianSwitchStep *prev_step = &(*r_steps)[*r_steps_len - 1];
+    if (prev_step->elem_size == elem_size &&
+        prev_step->offset + prev_step->array_len * prev_step->elem_size == offset) {
+      prev_step->array_len += array_len;
+      return;
+    }
+  }
+  if (*r_steps_len == *r_steps_capacity) {
+    *r_steps_capacity = MAX2(16, *r_steps_capacity * 2);
+    *r_steps = MEM_reallocN(*r_steps, sizeof(EndianSwitchStep) * (size_t)*r_steps_capacity);
+  }
+  EndianSwitchStep *step = &(*r_steps)[*r_steps_len];
+  step->offset = offset;
+  step->array_len = array_len;
+  step->elem_size = elem_size;
+  (*r_steps_len)++;
+}
+
+/**
+ * Generate the flattened endian switch steps of a struct, nested structs are expanded in place.
+ * This mirrors #DNA_struct_switch_endian, without the per-instance member lookups.
+ */
+static void create_endian_switch_steps_for_struct(const SDNA *sdna,
+                                                  const int struct_nr,
+                                                  const int base_offset,
+                                                  EndianSwitchStep **r_steps,
+                                                  int *r_steps_len,
+                                                  int *r_steps_capacity)
+{
+  const SDNA_Struct *struct_info = sdna->structs[struct_nr];
+
+  int offset_in_bytes = base_offset;
+  for (int member_index = 0; member_index < struct_info->members_len; member_index++) {
+    const SDNA_StructMember *member = &struct_info->members[member_index];
+    const eStructMemberCategory member_category = get_struct_member_category(sdna, member);
+    const int member_array_length = sdna->names_array_len[member->name];
+
+    switch (member_category) {
+      case STRUCT_MEMBER_CATEGORY_STRUCT: {
+        const int substruct_size = sdna->types_size[member->type];
+        const int substruct_nr = DNA_struct_find_nr(sdna, sdna->types[member->type]);
+        BLI_assert(substruct_nr != -1);
+        for (int a = 0; a < member_array_length; a++) {
+          create_endian_switch_steps_for_struct(sdna,
+                                                substruct_nr,
+                                                offset_in_bytes + a * substruct_size,
+                                                r_steps,
+                                                r_steps_len,
+                                                r_steps_capacity);
+        }
+        break;
+      }
+      case STRUCT_MEMBER_CATEGORY_PRIMITIVE: {
+        const int elem_size = endian_switch_elem_size(member->type);
+        if (elem_size != 0) {
+          endian_switch_steps_append(r_steps,
+                                     r_steps_len,
+                                     r_steps_capacity,
+                                     offset_in_bytes,
+                                     member_array_length,
+                                     elem_size);
+        }
+        break;
+      }
+      case STRUCT_MEMBER_CATEGORY_POINTER: {
+        /* See #DNA_struct_switch_endian. */
+        if (sizeof(void *) < 8) {
+          if (sdna->pointer_size == 8) {
+            endian_switch_steps_append(
+                r_steps, r_steps_len, r_steps_capacity, offset_in_bytes, member_array_length, 8);
+          }
+        }
+        break;
+      }
+    }
+    offset_in_bytes += get_member_size_in_bytes(sdna, member);
+  }
+}
+
+void DNA_reconstruct_info_ensure_endian_switch(DNA_ReconstructInfo *reconstruct_info)
+{
+  if (reconstruct_info->endian_steps != NULL) {
+    return;
+  }
+  const SDNA *oldsdna = reconstruct_info->oldsdna;
+  reconstruct_info->endian_step_counts = MEM_malloc_arrayN(
+      oldsdna->structs_len, sizeof(int), __func__);
+  reconstruct_info->endian_steps = MEM_malloc_arrayN(
+      oldsdna->structs_len, sizeof(EndianSwitchStep *), __func__);
+
+  for (int old_struct_nr = 0; old_struct_nr < oldsdna->structs_len; old_struct_nr++) {
+    EndianSwitchStep *steps = NULL;
+    int steps_len = 0;
+    int steps_capacity = 0;
+    create_endian_switch_steps_for_struct(
+        oldsdna, old_struct_nr, 0, &steps, &steps_len, &steps_capacity);
+    reconstruct_info->endian_steps[old_struct_nr] = steps;
+    reconstruct_info->endian_step_counts[old_struct_nr] = steps_len;
+  }
+}
+
+void DNA_struct_switch_endian_blocks(const DNA_ReconstructInfo *reconstruct_info,
+                                     const int old_struct_nr,
+                                     const int blocks,
+                                     char *data)
+{
+  if (old_struct_nr == -1) {
+    return;
+  }
+  BLI_assert(reconstruct_info->endian_steps != NULL);
+
+  const SDNA *oldsdna = reconstruct_info->oldsdna;
+  const int block_size = oldsdna->types_size[oldsdna->structs[old_struct_nr]->type];
+  const EndianSwitchStep *steps = reconstruct_info->endian_steps[old_struct_nr];
+  const int step_count = reconstruct_info->endian_step_counts[old_struct_nr];
+
+  for (int a = 0; a < blocks; a++) {
+    char *block = data + (size_t)a * (size_t)block_size;
+    for (int b = 0; b < step_count; b++) {
+      const EndianSwitchStep *step = &steps[b];
+      char *step_data = block + step->offset;
+      switch (step->elem_size) {
+        case 2:
+          BLI_endian_switch_int16_array((int16_t *)step_data, step->array_len);
+          break;
+        case 4:
+          BLI_endian_switch_int32_array((int32_t *)step_data, step->array_len);
+          break;
+        case 8:
+          BLI_endian_switch_int64_array((int64_t *)step_data, step->array_len);
+          break;
+      }
+    }
+  }
+}
+
 DNA_ReconstructInfo *DNA_reconstruct_info_create(const SDNA *oldsdna,
                                                  const SDNA *newsdna,
                                                  const char *compare_flags)
@@ -1545,6 +1728,16 @@ DNA_ReconstructInfo *DNA_reconstruct_info_create(const SDNA *oldsdna,
     UNUSED_VARS(print_reconstruct_step);
   }
 
+  /* Map old structs to new structs once, instead of a lookup by name for every read block. */
+  reconstruct_info->new_struct_nrs = MEM_malloc_arrayN(
+      oldsdna->structs_len, sizeof(int), __func__);
+  for (int old_struct_nr = 0; old_struct_nr < oldsdna->structs_len; old_struct_nr++) {
+    const SDNA_Struct *old_struct = oldsdna->structs[old_struct_nr];
+    const char *old_struct_name = oldsdna->types[old_struct->type];
+    reconstruct_info->new_struct_nrs[old_struct_nr] = DNA_struct_find_nr(newsdna,
+                                                                         old_struct_name);
+  }
+
   return reconstruct_info;
 }
 
@@ -1557,6 +1750,14 @@ void DNA_reconstruct_info_free(DNA_ReconstructInfo *reconstruct_info)
   }
   MEM_freeN(reconstruct_info->steps);
   MEM_freeN(reconstruct_info->step_counts);
+  MEM_freeN(reconstruct_info->new_struct_nrs);
+  if (reconstruct_info->endian_steps != NULL) {
+    for (int a = 0; a < reconstruct_info->oldsdna->structs_len; a++) {
+      MEM_SAFE_FREE(reconstruct_info->endian_steps[a]);
+    }
+    MEM_freeN(reconstruct_info->endian_steps);
+    MEM_freeN(reconstruct_info->endian_step_counts);
+  }
   MEM_freeN(reconstruct_info);
 }
 
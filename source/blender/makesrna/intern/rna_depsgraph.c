@@ -259,6 +259,12 @@ static void rna_Depsgraph_debug_tag_update(Depsgraph *depsgraph)
   DEG_graph_tag_relations_update(depsgraph);
 }
 
+static bool rna_Depsgraph_debug_relations_validate(Depsgraph *depsgraph, Main *bmain)
+{
+  return DEG_debug_graph_relations_validate(
+      depsgraph, bmain, DEG_get_input_scene(depsgraph), DEG_get_input_view_layer(depsgraph));
+}
+
 static void rna_Depsgraph_debug_stats(Depsgraph *depsgraph, char *result)
 {
   size_t outer, ops, rels;
@@ -669,6 +675,14 @@ static void rna_def_depsgraph(BlenderRNA *brna)
 
   func = RNA_def_function(srna, "debug_tag_update", "rna_Depsgraph_debug_tag_update");
 
+  func = RNA_def_function(
+      srna, "debug_relations_validate", "rna_Depsgraph_debug_relations_validate");
+  RNA_def_function_ui_description(
+      func, "Compare relations of the dependency graph against a fully rebuilt graph");
+  RNA_def_function_flag(func, FUNC_USE_MAIN);
+  parm = RNA_def_boolean(func, "result", false, "", "True when relations are the same");
+  RNA_def_function_return(func, parm);
+
   func = RNA_def_function(srna, "debug_stats", "rna_Depsgraph_debug_stats");
   RNA_def_function_ui_description(func, "Report the number of elements in the Dependency Graph");
   /* weak!, no way to return dynamic string type */
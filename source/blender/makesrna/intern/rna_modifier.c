@@ -753,7 +753,7 @@ static void rna_Modifier_update(Main *UNUSED(bmain), Scene *UNUSED(scene), Point
 static void rna_Modifier_dependency_update(Main *bmain, Scene *scene, PointerRNA *ptr)
 {
   rna_Modifier_update(bmain, scene, ptr);
-  DEG_relations_tag_update(bmain);
+  DEG_id_tag_relations_update(bmain, ptr->owner_id);
 }
 
 static void rna_Modifier_is_active_set(PointerRNA *ptr, bool value)
@@ -2309,6 +2309,14 @@ static void rna_def_modifier_decimate(BlenderRNA *brna)
       prop, "Triangulate", "Keep triangulated faces resulting from decimation (collapse only)");
   RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+  prop = RNA_def_property(srna, "use_collapse_parallel", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", MOD_DECIM_FLAG_PARALLEL);
+  RNA_def_property_ui_text(prop,
+                           "Parallel",
+                           "Decimate parts of large meshes in parallel, faster but results differ "
+                           "slightly (collapse only)");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
   prop = RNA_def_property(srna, "use_symmetry", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", MOD_DECIM_FLAG_SYMMETRY);
   RNA_def_property_ui_text(prop, "Symmetry", "Maintain symmetry on an axis");
@@ -13420,6 +13420,22 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
                            "Use two pass execution during editing: first calculate fast nodes, "
                            "second pass calculate all nodes");
 
+  prop = RNA_def_property(srna, "use_half_float_buffers", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_HALF_FLOAT_BUFFERS);
+  RNA_def_property_ui_text(prop,
+                           "Half Float Buffers",
+                           "Store color and vector buffers waiting to be read at half float "
+                           "precision, reducing memory usage of large compositions (Full Frame "
+                           "execution mode only)");
+
+  prop = RNA_def_property(srna, "use_viewer_region_first", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_VIEWER_REGION_FIRST);
+  RNA_def_property_ui_text(prop,
+                           "Visible Region First",
+                           "While editing, first compute the part of the viewer image visible in "
+                           "the backdrop and image editors, then the rest (Full Frame execution "
+                           "mode only)");
+
   prop = RNA_def_property(srna, "use_viewer_border", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_VIEWER_BORDER);
   RNA_def_property_ui_text(
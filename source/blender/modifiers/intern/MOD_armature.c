@@ -167,6 +167,43 @@ static void deformVerts(ModifierData *md,
   MEM_SAFE_FREE(amd->vert_coords_prev);
 }
 
+static void *deformVertsRangeBegin(ModifierData *md,
+                                   const ModifierEvalContext *ctx,
+                                   Mesh *mesh,
+                                   float (*vertexCos)[3],
+                                   int UNUSED(numVerts))
+{
+  ArmatureModifierData *amd = (ArmatureModifierData *)md;
+
+  /* The next modifier needs the coordinates before this one, deform all of them at once. */
+  if (MOD_previous_vcos_store_needed(md)) {
+    return NULL;
+  }
+
+  return BKE_armature_deform_coords_data_create_with_mesh(amd->object,
+                                                          ctx->object,
+                                                          vertexCos,
+                                                          amd->deformflag,
+                                                          amd->vert_coords_prev,
+                                                          amd->defgrp_name,
+                                                          mesh);
+}
+
+static void deformVertsRange(ModifierData *UNUSED(md), void *range_data, int start, int end)
+{
+  BKE_armature_deform_coords_data_eval_range(range_data, start, end);
+}
+
+static void deformVertsRangeEnd(ModifierData *md, void *range_data)
+{
+  ArmatureModifierData *amd = (ArmatureModifierData *)md;
+
+  BKE_armature_deform_coords_data_destroy(range_data);
+
+  /* free cache */
+  MEM_SAFE_FREE(amd->vert_coords_prev);
+}
+
 static void deformVertsEM(ModifierData *md,
                           const ModifierEvalContext *ctx,
                           struct BMEditMesh *em,
@@ -295,6 +332,9 @@ ModifierTypeInfo modifierType_Armature = {
     /* deformMatrices */ deformMatrices,
     /* deformVertsEM */ deformVertsEM,
     /* deformMatricesEM */ deformMatricesEM,
+    /* deformVertsRangeBegin */ deformVertsRangeBegin,
+    /* deformVertsRange */ deformVertsRange,
+    /* deformVertsRangeEnd */ deformVertsRangeEnd,
     /* modifyMesh */ NULL,
     /* modifyHair */ NULL,
     /* modifyGeometrySet */ NULL,
@@ -183,15 +183,17 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
   switch (dmd->mode) {
     case MOD_DECIM_MODE_COLLAPSE: {
       const bool do_triangulate = (dmd->flag & MOD_DECIM_FLAG_TRIANGULATE) != 0;
+      const bool use_parallel = (dmd->flag & MOD_DECIM_FLAG_PARALLEL) != 0;
       const int symmetry_axis = (dmd->flag & MOD_DECIM_FLAG_SYMMETRY) ? dmd->symmetry_axis : -1;
       const float symmetry_eps = 0.00002f;
-      BM_mesh_decimate_collapse(bm,
-                                dmd->percent,
-                                vweights,
-                                dmd->defgrp_factor,
-                                do_triangulate,
-                                symmetry_axis,
-                                symmetry_eps);
+      BM_mesh_decimate_collapse_ex(bm,
+                                   dmd->percent,
+                                   vweights,
+                                   dmd->defgrp_factor,
+                                   do_triangulate,
+                                   symmetry_axis,
+                                   symmetry_eps,
+                                   use_parallel);
       break;
     }
     case MOD_DECIM_MODE_UNSUBDIV: {
@@ -256,6 +258,7 @@ static void panel_draw(const bContext *UNUSED(C), Panel *panel)
     uiItemDecoratorR(row, ptr, "symmetry_axis", 0);
 
     uiItemR(layout, ptr, "use_collapse_triangulate", 0, NULL, ICON_NONE);
+    uiItemR(layout, ptr, "use_collapse_parallel", 0, NULL, ICON_NONE);
 
     modifier_vgroup_ui(layout, ptr, &ob_ptr, "vertex_group", "invert_vertex_group", NULL);
     sub = uiLayoutRow(layout, true);
@@ -297,6 +300,9 @@ ModifierTypeInfo modifierType_Decimate = {
     /* deformMatrices */ NULL,
     /* deformVertsEM */ NULL,
     /* deformMatricesEM */ NULL,
+    /* deformVertsRangeBegin */ NULL,
+    /* deformVertsRange */ NULL,
+    /* deformVertsRangeEnd */ NULL,
     /* modifyMesh */ modifyMesh,
     /* modifyHair */ NULL,
     /* modifyGeometrySet */ NULL,
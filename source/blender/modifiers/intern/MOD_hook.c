@@ -247,7 +247,7 @@ static float hook_falloff(const struct HookData_cb *hd, const float len_sq)
   }
 }
 
-static void hook_co_apply(struct HookData_cb *hd, int j, const MDeformVert *dv)
+static void hook_co_apply(const struct HookData_cb *hd, int j, const MDeformVert *dv)
 {
   float *co = hd->vertexCos[j];
   float fac;
@@ -284,18 +284,21 @@ static void hook_co_apply(struct HookData_cb *hd, int j, const MDeformVert *dv)
   }
 }
 
-static void deformVerts_do(HookModifierData *hmd,
-                           const ModifierEvalContext *UNUSED(ctx),
+/**
+ * Initialize all members of \a hd, for applying the hook to \a vertexCos.
+ */
+static void hook_data_init(HookModifierData *hmd,
                            Object *ob,
                            Mesh *mesh,
                            BMEditMesh *em,
                            float (*vertexCos)[3],
-                           int numVerts)
+                           struct HookData_cb *r_hd,
+                           MDeformVert **r_dvert,
+                           int *r_cd_dvert_offset)
 {
   Object *ob_target = hmd->object;
   bPoseChannel *pchan = BKE_pose_channel_find_name(ob_target->pose, hmd->subtarget);
   float dmat[4][4];
-  int i, *index_pt;
   MDeformVert *dvert;
   struct HookData_cb hd;
   const bool invert_vgroup = (hmd->flag & MOD_HOOK_INVERT_VGROUP) != 0;
@@ -363,7 +366,26 @@ static void deformVerts_do(HookModifierData *hmd,
   }
   invert_m4_m4(ob->imat, ob->obmat);
   mul_m4_series(hd.mat, ob->imat, dmat, hmd->parentinv);
-  /* --- done with 'hd' init --- */
+
+  *r_hd = hd;
+  *r_dvert = dvert;
+  *r_cd_dvert_offset = cd_dvert_offset;
+}
+
+static void deformVerts_do(HookModifierData *hmd,
+                           const ModifierEvalContext *UNUSED(ctx),
+                           Object *ob,
+                           Mesh *mesh,
+                           BMEditMesh *em,
+                           float (*vertexCos)[3],
+                           int numVerts)
+{
+  int i, *index_pt;
+  MDeformVert *dvert;
+  struct HookData_cb hd;
+  int cd_dvert_offset;
+
+  hook_data_init(hmd, ob, mesh, em, vertexCos, &hd, &dvert, &cd_dvert_offset);
 
   /* Regarding index range checking below.
    *
@@ -454,6 +476,104 @@ static void deformVerts(struct ModifierData *md,
   }
 }
 
+typedef struct HookRangeData {
+  struct HookData_cb hd;
+  const MDeformVert *dvert;
+  /** Vertices affected by the hook, all when NULL. */
+  BLI_bitmap *verts_used;
+  /** Map to the indices of #verts_used when it uses original indices. */
+  const int *origindex;
+  /** Temporary mesh to free at the end, the vertex groups are read from it. */
+  Mesh *mesh_temp;
+} HookRangeData;
+
+static void deformVertsRangeEnd(struct ModifierData *UNUSED(md), void *range_data)
+{
+  HookRangeData *data = range_data;
+  MEM_SAFE_FREE(data->verts_used);
+  if (data->mesh_temp) {
+    BKE_id_free(NULL, data->mesh_temp);
+  }
+  MEM_freeN(data);
+}
+
+static void *deformVertsRangeBegin(struct ModifierData *md,
+                                   const struct ModifierEvalContext *ctx,
+                                   struct Mesh *mesh,
+                                   float (*vertexCos)[3],
+                                   int numVerts)
+{
+  HookModifierData *hmd = (HookModifierData *)md;
+  Object *ob = ctx->object;
+
+  if (hmd->force == 0.0f) {
+    return NULL;
+  }
+
+  Mesh *mesh_src = MOD_deform_mesh_eval_get(ob, NULL, mesh, NULL, numVerts, false, false);
+
+  HookRangeData *range_data = MEM_callocN(sizeof(*range_data), __func__);
+  range_data->mesh_temp = ELEM(mesh_src, NULL, mesh) ? NULL : mesh_src;
+
+  MDeformVert *dvert;
+  int cd_dvert_offset;
+  hook_data_init(hmd, ob, mesh_src, NULL, vertexCos, &range_data->hd, &dvert, &cd_dvert_offset);
+  range_data->dvert = dvert;
+
+  /* Same cases as #deformVerts_do. */
+  bool supported = true;
+  if (hmd->indexar) {
+    const int *origindex_ar;
+    if (mesh_src && (origindex_ar = CustomData_get_layer(&mesh_src->vdata, CD_ORIGINDEX))) {
+      int numVerts_orig = numVerts;
+      if (ob->type == OB_MESH) {
+        const Mesh *me_orig = ob->data;
+        numVerts_orig = me_orig->totvert;
+      }
+      range_data->verts_used = hook_index_array_to_bitmap(hmd, numVerts_orig);
+      range_data->origindex = origindex_ar;
+    }
+    else {
+      range_data->verts_used = BLI_BITMAP_NEW(numVerts, __func__);
+      for (int i = 0; i < hmd->totindex; i++) {
+        const int j = hmd->indexar[i];
+        if (j < numVerts) {
+          /* Vertices listed twice are hooked twice. */
+          if (BLI_BITMAP_TEST(range_data->verts_used, j)) {
+            supported = false;
+            break;
+          }
+          BLI_BITMAP_ENABLE(range_data->verts_used, j);
+        }
+      }
+    }
+  }
+  else if (range_data->hd.defgrp_index == -1) {
+    /* Nothing to deform. */
+    supported = false;
+  }
+
+  if (!supported) {
+    deformVertsRangeEnd(md, range_data);
+    return NULL;
+  }
+  return range_data;
+}
+
+static void deformVertsRange(struct ModifierData *UNUSED(md), void *range_data, int start, int end)
+{
+  const HookRangeData *data = range_data;
+  for (int i = start; i < end; i++) {
+    if (data->verts_used) {
+      const int index = data->origindex ? data->origindex[i] : i;
+      if (!BLI_BITMAP_TEST(data->verts_used, index)) {
+        continue;
+      }
+    }
+    hook_co_apply(&data->hd, i, data->dvert ? &data->dvert[i] : NULL);
+  }
+}
+
 static void deformVertsEM(struct ModifierData *md,
                           const struct ModifierEvalContext *ctx,
                           struct BMEditMesh *editData,
@@ -571,6 +691,9 @@ ModifierTypeInfo modifierType_Hook = {
     /* deformMatrices */ NULL,
     /* deformVertsEM */ deformVertsEM,
     /* deformMatricesEM */ NULL,
+    /* deformVertsRangeBegin */ deformVertsRangeBegin,
+    /* deformVertsRange */ deformVertsRange,
+    /* deformVertsRangeEnd */ deformVertsRangeEnd,
     /* modifyMesh */ NULL,
     /* modifyHair */ NULL,
     /* modifyGeometrySet */ NULL,
@@ -131,6 +131,59 @@ static void deformVerts(ModifierData *md,
   }
 }
 
+typedef struct LatticeRangeData {
+  struct LatticeDeformCoordsData *deform_data;
+  /** Temporary mesh to free at the end, the vertex groups are read from it. */
+  struct Mesh *mesh_temp;
+} LatticeRangeData;
+
+static void *deformVertsRangeBegin(ModifierData *md,
+                                   const ModifierEvalContext *ctx,
+                                   struct Mesh *mesh,
+                                   float (*vertexCos)[3],
+                                   int numVerts)
+{
+  LatticeModifierData *lmd = (LatticeModifierData *)md;
+
+  /* The next modifier needs the coordinates before this one, deform all of them at once. */
+  if (MOD_previous_vcos_store_needed(md)) {
+    return NULL;
+  }
+
+  struct Mesh *mesh_src = MOD_deform_mesh_eval_get(
+      ctx->object, NULL, mesh, NULL, numVerts, false, false);
+
+  LatticeRangeData *range_data = MEM_mallocN(sizeof(*range_data), __func__);
+  range_data->deform_data = BKE_lattice_deform_coords_data_create_with_mesh(
+      lmd->object, ctx->object, vertexCos, lmd->flag, lmd->name, lmd->strength, mesh_src);
+  range_data->mesh_temp = ELEM(mesh_src, NULL, mesh) ? NULL : mesh_src;
+
+  if (range_data->deform_data == NULL) {
+    if (range_data->mesh_temp) {
+      BKE_id_free(NULL, range_data->mesh_temp);
+    }
+    MEM_freeN(range_data);
+    return NULL;
+  }
+  return range_data;
+}
+
+static void deformVertsRange(ModifierData *UNUSED(md), void *range_data, int start, int end)
+{
+  const LatticeRangeData *data = range_data;
+  BKE_lattice_deform_coords_data_eval_range(data->deform_data, start, end);
+}
+
+static void deformVertsRangeEnd(ModifierData *UNUSED(md), void *range_data)
+{
+  LatticeRangeData *data = range_data;
+  BKE_lattice_deform_coords_data_destroy(data->deform_data);
+  if (data->mesh_temp) {
+    BKE_id_free(NULL, data->mesh_temp);
+  }
+  MEM_freeN(data);
+}
+
 static void deformVertsEM(ModifierData *md,
                           const ModifierEvalContext *ctx,
                           struct BMEditMesh *em,
@@ -190,6 +243,9 @@ ModifierTypeInfo modifierType_Lattice = {
     /* deformMatrices */ NULL,
     /* deformVertsEM */ deformVertsEM,
     /* deformMatricesEM */ NULL,
+    /* deformVertsRangeBegin */ deformVertsRangeBegin,
+    /* deformVertsRange */ deformVertsRange,
+    /* deformVertsRangeEnd */ deformVertsRangeEnd,
     /* modifyMesh */ NULL,
     /* modifyHair */ NULL,
     /* modifyGeometrySet */ NULL,
@@ -307,6 +307,9 @@ ModifierTypeInfo modifierType_MeshToVolume = {
     /* deformMatrices */ nullptr,
     /* deformVertsEM */ nullptr,
     /* deformMatricesEM */ nullptr,
+    /* deformVertsRangeBegin */ nullptr,
+    /* deformVertsRange */ nullptr,
+    /* deformVertsRangeEnd */ nullptr,
     /* modifyMesh */ nullptr,
     /* modifyHair */ nullptr,
     /* modifyGeometrySet */ modifyGeometrySet,
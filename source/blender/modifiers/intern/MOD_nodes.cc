@@ -1113,6 +1113,8 @@ static void modifyGeometry(ModifierData *md,
     return;
   }
 
+  MEM_DomainScope memory_domain(MEM_DOMAIN_GEOMETRY_NODES);
+
   check_property_socket_sync(ctx->object, md);
 
   NodeTreeRefMap tree_refs;
@@ -1615,6 +1617,9 @@ ModifierTypeInfo modifierType_Nodes = {
     /* deformMatrices */ nullptr,
     /* deformVertsEM */ nullptr,
     /* deformMatricesEM */ nullptr,
+    /* deformVertsRangeBegin */ nullptr,
+    /* deformVertsRange */ nullptr,
+    /* deformVertsRangeEnd */ nullptr,
     /* modifyMesh */ modifyMesh,
     /* modifyHair */ nullptr,
     /* modifyGeometrySet */ modifyGeometrySet,
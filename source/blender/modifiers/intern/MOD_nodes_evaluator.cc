@@ -16,6 +16,8 @@
 
 #include "MOD_nodes_evaluator.hh"
 
+#include "MEM_guardedalloc.h"
+
 #include "BKE_type_conversions.hh"
 
 #include "NOD_geometry_exec.hh"
@@ -750,6 +752,8 @@ class GeometryNodesEvaluator {
 
   static void run_node_from_task_pool(TaskPool *task_pool, void *task_data)
   {
+    MEM_DomainScope memory_domain(MEM_DOMAIN_GEOMETRY_NODES);
+
     void *user_data = BLI_task_pool_user_data(task_pool);
     GeometryNodesEvaluator &evaluator = *(GeometryNodesEvaluator *)user_data;
     const NodeWithState *root_node_with_state = (const NodeWithState *)task_data;
@@ -181,6 +181,16 @@ void MOD_previous_vcos_store(ModifierData *md, const float (*vert_coords)[3])
   /* lattice/mesh modifier too */
 }
 
+bool MOD_previous_vcos_store_needed(const ModifierData *md)
+{
+  const ModifierData *md_next = md->next;
+  if (md_next && md_next->type == eModifierType_Armature) {
+    const ArmatureModifierData *amd = (const ArmatureModifierData *)md_next;
+    return amd->multi && amd->vert_coords_prev == NULL;
+  }
+  return false;
+}
+
 Mesh *MOD_deform_mesh_eval_get(Object *ob,
                                struct BMEditMesh *em,
                                Mesh *mesh,
@@ -43,6 +43,11 @@ void MOD_get_texture_coords(struct MappingInfoModifierData *dmd,
                             float (*r_texco)[3]);
 
 void MOD_previous_vcos_store(struct ModifierData *md, const float (*vert_coords)[3]);
+/**
+ * Whether #MOD_previous_vcos_store would copy the coordinates for the next modifier, which has
+ * to happen before \a md deforms them.
+ */
+bool MOD_previous_vcos_store_needed(const struct ModifierData *md);
 
 /**
  * \returns a mesh if mesh == NULL, for deforming modifiers that need it.
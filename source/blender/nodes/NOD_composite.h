@@ -159,7 +159,8 @@ void ntreeCompositExecTree(struct Scene *scene,
                            int do_previews,
                            const struct ColorManagedViewSettings *view_settings,
                            const struct ColorManagedDisplaySettings *display_settings,
-                           const char *view_name);
+                           const char *view_name,
+                           const struct rctf *viewer_region);
 
 /**
  * Called from render pipeline, to tag render input and output.
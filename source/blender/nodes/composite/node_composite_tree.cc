@@ -223,12 +223,15 @@ void ntreeCompositExecTree(Scene *scene,
                            int do_preview,
                            const ColorManagedViewSettings *view_settings,
                            const ColorManagedDisplaySettings *display_settings,
-                           const char *view_name)
+                           const char *view_name,
+                           const rctf *viewer_region)
 {
 #ifdef WITH_COMPOSITOR
-  COM_execute(rd, scene, ntree, rendering, view_settings, display_settings, view_name);
+  COM_execute(
+      rd, scene, ntree, rendering, view_settings, display_settings, view_name, viewer_region);
 #else
-  UNUSED_VARS(scene, ntree, rd, rendering, view_settings, display_settings, view_name);
+  UNUSED_VARS(
+      scene, ntree, rd, rendering, view_settings, display_settings, view_name, viewer_region);
 #endif
 
   UNUSED_VARS(do_preview);
@@ -47,6 +47,8 @@
 
 #include "BLI_utildefines.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "BKE_appdir.h"
 #include "BKE_blender_version.h"
 #include "BKE_global.h"
@@ -355,6 +357,34 @@ static PyObject *bpy_app_autoexec_fail_message_get(PyObject *UNUSED(self), void
   return PyC_UnicodeFromByte(G.autoexec_fail);
 }
 
+PyDoc_STRVAR(bpy_app_memory_domains_doc,
+             "Dictionary of memory usage per subsystem, mapping the domain identifier to a "
+             "dictionary with ``memory_in_use``, ``blocks_in_use`` and ``peak_memory`` values, "
+             "memory values are in bytes (read-only)");
+static PyObject *bpy_app_memory_domains_get(PyObject *UNUSED(self), void *UNUSED(closure))
+{
+  PyObject *ret = PyDict_New();
+  for (int i = 0; i < MEM_DOMAIN_NUM; i++) {
+    const eMemDomain domain = (eMemDomain)i;
+    PyObject *dict = PyDict_New();
+    PyObject *item;
+    PyDict_SetItemString(
+        dict, "memory_in_use", item = PyLong_FromSize_t(MEM_get_domain_memory_in_use(domain)));
+    Py_DECREF(item);
+    PyDict_SetItemString(
+        dict,
+        "blocks_in_use",
+        item = PyLong_FromUnsignedLong(MEM_get_domain_blocks_in_use(domain)));
+    Py_DECREF(item);
+    PyDict_SetItemString(
+        dict, "peak_memory", item = PyLong_FromSize_t(MEM_get_domain_peak_memory(domain)));
+    Py_DECREF(item);
+    PyDict_SetItemString(ret, MEM_domain_name(domain), dict);
+    Py_DECREF(dict);
+  }
+  return ret;
+}
+
 static PyGetSetDef bpy_app_getsets[] = {
     {"debug", bpy_app_debug_get, bpy_app_debug_set, bpy_app_debug_doc, (void *)G_DEBUG},
     {"debug_ffmpeg",
@@ -439,6 +469,7 @@ static PyGetSetDef bpy_app_getsets[] = {
      NULL},
     {"tempdir", bpy_app_tempdir_get, NULL, bpy_app_tempdir_doc, NULL},
     {"driver_namespace", bpy_app_driver_dict_get, NULL, bpy_app_driver_dict_doc, NULL},
+    {"memory_domains", bpy_app_memory_domains_get, NULL, bpy_app_memory_domains_doc, NULL},
 
     {"render_icon_size",
      bpy_app_preview_render_size_get,
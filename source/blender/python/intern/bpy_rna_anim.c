@@ -591,7 +591,7 @@ PyObject *pyrna_struct_driver_add(BPy_StructRNA *self, PyObject *args)
 
     bContext *context = BPY_context_get();
     WM_event_add_notifier(BPY_context_get(), NC_ANIMATION | ND_FCURVES_ORDER, NULL);
-    DEG_relations_tag_update(CTX_data_main(context));
+    DEG_id_tag_relations_update(CTX_data_main(context), id);
   }
   else {
     /* XXX: should be handled by reports. */
@@ -154,6 +154,9 @@ typedef struct RenderResult {
   struct StampData *stamp_data;
 
   bool passes_allocated;
+
+  /* Changed along with the passes content, unique across render results. */
+  unsigned int update_counter;
 } RenderResult;
 
 typedef struct RenderStats {
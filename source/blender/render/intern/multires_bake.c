@@ -417,6 +417,7 @@ static void *do_multires_bake_thread(void *data_v)
     }
 
     data->ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+    IMB_tag_changed(data->ibuf);
 
     /* update progress */
     BLI_spin_lock(&handle->queue->spin);
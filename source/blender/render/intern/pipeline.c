@@ -1227,7 +1227,8 @@ static void do_render_compositor(Render *re)
                                 G.background == 0,
                                 &re->scene->view_settings,
                                 &re->scene->display_settings,
-                                rv->name);
+                                rv->name,
+                                NULL);
         }
 
         ntree->stats_draw = NULL;
@@ -1409,6 +1410,7 @@ static void do_render_sequencer(Render *re)
 static void do_render_full_pipeline(Render *re)
 {
   bool render_seq = false;
+  const eMemDomain previous_memory_domain = MEM_domain_begin(MEM_DOMAIN_RENDER);
 
   re->current_scene_update(re->suh, re->scene);
 
@@ -1455,6 +1457,8 @@ static void do_render_full_pipeline(Render *re)
       re->display_update(re->duh, re->result, NULL);
     }
   }
+
+  MEM_domain_end(previous_memory_domain);
 }
 
 static bool check_valid_compositing_camera(Scene *scene, Object *camera_override)
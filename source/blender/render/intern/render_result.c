@@ -28,6 +28,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_ghash.h"
 #include "BLI_hash_md5.h"
 #include "BLI_listbase.h"
@@ -58,6 +60,14 @@
 
 /********************************** Free *************************************/
 
+/** Last value given to #RenderResult.update_counter. */
+static unsigned int update_counter_last = 0;
+
+static void render_result_tag_changed(RenderResult *rr)
+{
+  rr->update_counter = atomic_add_and_fetch_uint32(&update_counter_last, 1);
+}
+
 static void render_result_views_free(RenderResult *rr)
 {
   while (rr->views.first) {
@@ -465,6 +475,8 @@ RenderResult *render_result_new(Render *re,
   rr->xof = re->disprect.xmin + BLI_rcti_cent_x(&re->disprect) - (re->winx / 2);
   rr->yof = re->disprect.ymin + BLI_rcti_cent_y(&re->disprect) - (re->winy / 2);
 
+  render_result_tag_changed(rr);
+
   return rr;
 }
 
@@ -487,6 +499,7 @@ void render_result_passes_allocated_ensure(RenderResult *rr)
   }
 
   rr->passes_allocated = true;
+  render_result_tag_changed(rr);
 }
 
 void render_result_clone_passes(Render *re, RenderResult *rr, const char *viewname)
@@ -768,6 +781,8 @@ RenderResult *render_result_new_from_exr(
     }
   }
 
+  render_result_tag_changed(rr);
+
   return rr;
 }
 
@@ -859,6 +874,8 @@ void render_result_merge(RenderResult *rr, RenderResult *rrpart)
       }
     }
   }
+
+  render_result_tag_changed(rr);
 }
 
 bool RE_WriteRenderResult(ReportList *reports,
@@ -1072,6 +1089,8 @@ void render_result_single_layer_end(Render *re)
 
   RE_FreeRenderResult(re->pushedresult);
   re->pushedresult = NULL;
+
+  render_result_tag_changed(re->result);
 }
 
 int render_result_exr_file_read_path(RenderResult *rr,
@@ -1124,6 +1143,8 @@ int render_result_exr_file_read_path(RenderResult *rr,
   IMB_exr_read_channels(exrhandle);
   IMB_exr_close(exrhandle);
 
+  render_result_tag_changed(rr);
+
   return 1;
 }
 
@@ -1452,5 +1473,6 @@ RenderResult *RE_DuplicateRenderResult(RenderResult *rr)
     new_rr->rectz = MEM_dupallocN(new_rr->rectz);
   }
   new_rr->stamp_data = BKE_stamp_data_copy(new_rr->stamp_data);
+  render_result_tag_changed(new_rr);
   return new_rr;
 }
@@ -22,6 +22,7 @@
  */
 
 #include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -34,6 +35,8 @@
 #include "DNA_windowmanager_types.h"
 
 #include "BLI_listbase.h"
+#include "BLI_math_base.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "IMB_imbuf.h"
@@ -53,6 +56,8 @@
 #include "DEG_depsgraph_debug.h"
 #include "DEG_depsgraph_query.h"
 
+#include "PIL_time.h"
+
 #include "SEQ_iterator.h"
 #include "SEQ_prefetch.h"
 #include "SEQ_relations.h"
@@ -63,6 +68,26 @@
 #include "prefetch.h"
 #include "render.h"
 
+/** Maximum number of frames, which are rendered concurrently. */
+#define SEQ_PREFETCH_FRAMES_MAX 8
+
+/**
+ * Renders one of the frames following the frame that is rendered by the prefetch job itself.
+ * Each worker has its own depsgraph, so strips can be evaluated for different frames at once.
+ * Workers don't access the cache, their images are stored by the prefetch job in frame order.
+ */
+typedef struct PrefetchWorker {
+  struct Depsgraph *depsgraph;
+  struct Scene *scene_eval;
+  struct SeqRenderData context;
+
+  float timeline_frame;
+  /* Top-most strip of evaluated scene, NULL when frame doesn't need to be rendered. */
+  struct Sequence *seq;
+  struct ImBuf *ibuf;
+  double render_time;
+} PrefetchWorker;
+
 typedef struct PrefetchJob {
   struct PrefetchJob *next, *prev;
 
@@ -87,6 +112,19 @@ typedef struct PrefetchJob {
   float cfra;
   int num_frames_prefetched;
 
+  /* Concurrent rendering of following frames. */
+  PrefetchWorker workers[SEQ_PREFETCH_FRAMES_MAX - 1];
+  /* Number of frames rendered at once, adapted to how fast playback drains the cache. */
+  int num_frames_concurrent;
+  int num_frames_concurrent_max;
+  int drain_cfra;
+  double drain_time;
+
+  /* Timing report, printed with `--debug-jobs`. */
+  int num_frames_rendered;
+  double render_time;
+  int num_frames_concurrent_peak;
+
   /* control */
   bool running;
   bool waiting;
@@ -210,6 +248,15 @@ static void seq_prefetch_free_depsgraph(PrefetchJob *pfjob)
   }
   pfjob->depsgraph = NULL;
   pfjob->scene_eval = NULL;
+
+  for (int i = 0; i < ARRAY_SIZE(pfjob->workers); i++) {
+    PrefetchWorker *worker = &pfjob->workers[i];
+    if (worker->depsgraph != NULL) {
+      DEG_graph_free(worker->depsgraph);
+    }
+    worker->depsgraph = NULL;
+    worker->scene_eval = NULL;
+  }
 }
 
 static void seq_prefetch_update_depsgraph(PrefetchJob *pfjob)
@@ -328,13 +375,13 @@ static void seq_prefetch_update_scene(Scene *scene)
   seq_prefetch_init_depsgraph(pfjob);
 }
 
-static void seq_prefetch_update_active_seqbase(PrefetchJob *pfjob)
+static void seq_prefetch_update_active_seqbase(PrefetchJob *pfjob, Scene *scene_eval)
 {
   MetaStack *ms_orig = SEQ_meta_stack_active_get(SEQ_editing_get(pfjob->scene));
-  Editing *ed_eval = SEQ_editing_get(pfjob->scene_eval);
+  Editing *ed_eval = SEQ_editing_get(scene_eval);
 
   if (ms_orig != NULL) {
-    Sequence *meta_eval = seq_prefetch_get_original_sequence(ms_orig->parseq, pfjob->scene_eval);
+    Sequence *meta_eval = seq_prefetch_get_original_sequence(ms_orig->parseq, scene_eval);
     SEQ_seqbase_active_set(ed_eval, &meta_eval->seqbase);
   }
   else {
@@ -372,10 +419,10 @@ void seq_prefetch_free(Scene *scene)
 
 static bool seq_prefetch_seq_has_disk_cache(PrefetchJob *pfjob,
                                             Sequence *seq,
+                                            float cfra,
                                             bool can_have_final_image)
 {
   SeqRenderData *ctx = &pfjob->context_cpy;
-  float cfra = seq_prefetch_cfra(pfjob);
 
   ImBuf *ibuf = seq_cache_get(ctx, seq, cfra, SEQ_CACHE_STORE_PREPROCESSED);
   if (ibuf != NULL) {
@@ -404,10 +451,10 @@ static bool seq_prefetch_seq_has_disk_cache(PrefetchJob *pfjob,
 
 static bool seq_prefetch_scene_strip_is_rendered(PrefetchJob *pfjob,
                                                  ListBase *seqbase,
+                                                 float cfra,
                                                  SeqCollection *scene_strips,
                                                  bool is_recursive_check)
 {
-  float cfra = seq_prefetch_cfra(pfjob);
   Sequence *seq_arr[MAXSEQ + 1];
   int count = seq_get_shown_sequences(seqbase, cfra, 0, seq_arr);
 
@@ -415,13 +462,13 @@ static bool seq_prefetch_scene_strip_is_rendered(PrefetchJob *pfjob,
   for (int i = 0; i < count; i++) {
     Sequence *seq = seq_arr[i];
     if (seq->type == SEQ_TYPE_META &&
-        seq_prefetch_scene_strip_is_rendered(pfjob, &seq->seqbase, scene_strips, true)) {
+        seq_prefetch_scene_strip_is_rendered(pfjob, &seq->seqbase, cfra, scene_strips, true)) {
       return true;
     }
 
     /* Disable prefetching 3D scene strips, but check for disk cache. */
     if (seq->type == SEQ_TYPE_SCENE && (seq->flag & SEQ_SCENE_STRIPS) == 0 &&
-        !seq_prefetch_seq_has_disk_cache(pfjob, seq, !is_recursive_check)) {
+        !seq_prefetch_seq_has_disk_cache(pfjob, seq, cfra, !is_recursive_check)) {
       return true;
     }
 
@@ -449,10 +496,10 @@ static SeqCollection *query_scene_strips(ListBase *seqbase)
 
 /* Prefetch must avoid rendering scene strips, because rendering in background locks UI and can
  * make it unresponsive for long time periods. */
-static bool seq_prefetch_must_skip_frame(PrefetchJob *pfjob, ListBase *seqbase)
+static bool seq_prefetch_must_skip_frame(PrefetchJob *pfjob, ListBase *seqbase, float cfra)
 {
   SeqCollection *scene_strips = query_scene_strips(seqbase);
-  if (seq_prefetch_scene_strip_is_rendered(pfjob, seqbase, scene_strips, false)) {
+  if (seq_prefetch_scene_strip_is_rendered(pfjob, seqbase, cfra, scene_strips, false)) {
     SEQ_collection_free(scene_strips);
     return true;
   }
@@ -479,9 +526,209 @@ static void seq_prefetch_do_suspend(PrefetchJob *pfjob)
   BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 }
 
+static void seq_prefetch_worker_init_depsgraph(PrefetchJob *pfjob, PrefetchWorker *worker)
+{
+  Scene *scene = pfjob->scene;
+  ViewLayer *view_layer = BKE_view_layer_default_render(scene);
+
+  worker->depsgraph = DEG_graph_new(pfjob->bmain_eval, scene, view_layer, DAG_EVAL_RENDER);
+  DEG_debug_name_set(worker->depsgraph, "SEQUENCER PREFETCH WORKER");
+  DEG_graph_build_for_render_pipeline(worker->depsgraph);
+}
+
+static void seq_prefetch_worker_update(PrefetchJob *pfjob, PrefetchWorker *worker)
+{
+  if (worker->depsgraph == NULL) {
+    seq_prefetch_worker_init_depsgraph(pfjob, worker);
+  }
+
+  /* Workers don't access the cache, so their scene copy never references the job. */
+  if (worker->scene_eval != NULL) {
+    worker->scene_eval->ed->prefetch_job = NULL;
+  }
+  DEG_evaluate_on_framechange(worker->depsgraph, worker->timeline_frame);
+  worker->scene_eval = DEG_get_evaluated_scene(worker->depsgraph);
+  worker->scene_eval->ed->prefetch_job = NULL;
+  worker->scene_eval->ed->cache_flag = 0;
+
+  AnimData *adt = BKE_animdata_from_id(&worker->scene_eval->id);
+  AnimationEvalContext anim_eval_context = BKE_animsys_eval_context_construct(
+      worker->depsgraph, worker->timeline_frame);
+  BKE_animsys_evaluate_animdata(
+      &worker->scene_eval->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
+  seq_prefetch_update_active_seqbase(pfjob, worker->scene_eval);
+
+  SEQ_render_new_render_data(pfjob->bmain_eval,
+                             worker->depsgraph,
+                             worker->scene_eval,
+                             pfjob->context_cpy.rectx,
+                             pfjob->context_cpy.recty,
+                             pfjob->context_cpy.preview_render_size,
+                             false,
+                             &worker->context);
+  worker->context.is_prefetch_render = true;
+  worker->context.skip_cache = true;
+  worker->context.task_id = SEQ_TASK_PREFETCH_RENDER;
+
+  Sequence *seq_arr[MAXSEQ + 1];
+  ListBase *seqbase = SEQ_active_seqbase_get(SEQ_editing_get(worker->scene_eval));
+  const int count = seq_get_shown_sequences(seqbase, worker->timeline_frame, 0, seq_arr);
+  worker->seq = (count > 0) ? seq_arr[count - 1] : NULL;
+}
+
+static void seq_prefetch_worker_render(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  PrefetchWorker *worker = (PrefetchWorker *)taskdata;
+  const double time_start = PIL_check_seconds_timer();
+
+  worker->ibuf = SEQ_render_give_ibuf(&worker->context, worker->timeline_frame, 0);
+  worker->render_time = PIL_check_seconds_timer() - time_start;
+}
+
+/**
+ * Start rendering frames following the current prefetch frame in the task pool.
+ * Only consecutive frames are started, so they can be stored in order.
+ *
+ * \return Number of frames handled by workers.
+ */
+static int seq_prefetch_workers_start(PrefetchJob *pfjob, TaskPool *task_pool)
+{
+  const float cfra = seq_prefetch_cfra(pfjob);
+  ListBase *seqbase = SEQ_active_seqbase_get(SEQ_editing_get(pfjob->scene_eval));
+  Sequence *seq_arr[MAXSEQ + 1];
+  int num_workers = 0;
+
+  for (int i = 0; i < pfjob->num_frames_concurrent - 1; i++) {
+    const float timeline_frame = cfra + i + 1;
+    if (timeline_frame > pfjob->scene->r.efra ||
+        seq_prefetch_must_skip_frame(pfjob, seqbase, timeline_frame)) {
+      break;
+    }
+
+    PrefetchWorker *worker = &pfjob->workers[i];
+    worker->timeline_frame = timeline_frame;
+    worker->seq = NULL;
+    worker->ibuf = NULL;
+    worker->render_time = 0.0;
+    num_workers++;
+
+    /* Frame can still be cached from previous prefetching. */
+    const int count = seq_get_shown_sequences(seqbase, timeline_frame, 0, seq_arr);
+    if (count == 0) {
+      continue;
+    }
+    ImBuf *ibuf = seq_cache_get(
+        &pfjob->context_cpy, seq_arr[count - 1], timeline_frame, SEQ_CACHE_STORE_FINAL_OUT);
+    if (ibuf != NULL) {
+      IMB_freeImBuf(ibuf);
+      continue;
+    }
+
+    seq_prefetch_worker_update(pfjob, worker);
+    if (worker->seq != NULL) {
+      BLI_task_pool_push(task_pool, seq_prefetch_worker_render, worker, false, NULL);
+    }
+  }
+
+  return num_workers;
+}
+
+/**
+ * Store images rendered by workers in frame order. Storing stops at first frame which doesn't
+ * fit into the cache, such frame is rendered again when prefetching is resumed.
+ */
+static void seq_prefetch_workers_finish(PrefetchJob *pfjob, int num_workers)
+{
+  bool do_store = true;
+
+  for (int i = 0; i < num_workers; i++) {
+    PrefetchWorker *worker = &pfjob->workers[i];
+    pfjob->render_time += worker->render_time;
+    if (worker->ibuf != NULL) {
+      pfjob->num_frames_rendered++;
+    }
+
+    do_store = do_store && !pfjob->stop && !seq_prefetch_is_cache_full(pfjob->scene);
+    if (do_store) {
+      pfjob->num_frames_prefetched++;
+      Sequence *seq_orig = (worker->seq != NULL) ?
+                               seq_prefetch_get_original_sequence(worker->seq, pfjob->scene) :
+                               NULL;
+      if (seq_orig != NULL) {
+        seq_render_final_image_cache_put(
+            &pfjob->context, seq_orig, worker->timeline_frame, worker->ibuf);
+      }
+    }
+
+    IMB_freeImBuf(worker->ibuf);
+    worker->ibuf = NULL;
+  }
+}
+
+/**
+ * Render more frames at once when playback consumes prefetched frames about as fast as they are
+ * rendered, and fewer when prefetching is well ahead of playback.
+ */
+static void seq_prefetch_update_num_frames_concurrent(PrefetchJob *pfjob,
+                                                      int num_frames,
+                                                      double batch_time)
+{
+  const double time = PIL_check_seconds_timer();
+  const int cfra = pfjob->scene->r.cfra;
+  const double drain_rate = max_ii(cfra - pfjob->drain_cfra, 0) /
+                            max_dd(time - pfjob->drain_time, 1e-6);
+  const double render_rate = num_frames / max_dd(batch_time, 1e-6);
+  const int num_frames_concurrent = pfjob->num_frames_concurrent;
+
+  pfjob->drain_cfra = cfra;
+  pfjob->drain_time = time;
+
+  if (drain_rate > render_rate * 0.75) {
+    pfjob->num_frames_concurrent = min_ii(num_frames_concurrent + 1,
+                                          pfjob->num_frames_concurrent_max);
+  }
+  else if (drain_rate < render_rate * 0.25) {
+    pfjob->num_frames_concurrent = max_ii(num_frames_concurrent - 1, 1);
+  }
+
+  pfjob->num_frames_concurrent_peak = max_ii(pfjob->num_frames_concurrent_peak,
+                                             pfjob->num_frames_concurrent);
+
+  if ((G.debug & G_DEBUG_JOBS) && pfjob->num_frames_concurrent != num_frames_concurrent) {
+    printf("Sequencer prefetch: %d frames at once (render %.2f fps, playback %.2f fps)\n",
+           pfjob->num_frames_concurrent,
+           render_rate,
+           drain_rate);
+  }
+}
+
+static void seq_prefetch_print_timing_report(PrefetchJob *pfjob, double time)
+{
+  const int num_frames = pfjob->num_frames_rendered;
+
+  printf("Sequencer prefetch: rendered %d frames in %.2f s (%.2f fps)\n",
+         num_frames,
+         time,
+         num_frames / max_dd(time, 1e-6));
+  printf("  average frame render time: %.1f ms\n",
+         (num_frames > 0) ? pfjob->render_time / num_frames * 1000.0 : 0.0);
+  printf("  frames at once: %d (peak %d, maximum %d)\n",
+         pfjob->num_frames_concurrent,
+         pfjob->num_frames_concurrent_peak,
+         pfjob->num_frames_concurrent_max);
+}
+
 static void *seq_prefetch_frames(void *job)
 {
   PrefetchJob *pfjob = (PrefetchJob *)job;
+  TaskPool *task_pool = BLI_task_pool_create(pfjob, TASK_PRIORITY_LOW);
+  const double time_start = PIL_check_seconds_timer();
+
+  pfjob->num_frames_rendered = 0;
+  pfjob->render_time = 0.0;
+  pfjob->num_frames_concurrent_peak = pfjob->num_frames_concurrent;
+  pfjob->drain_cfra = pfjob->scene->r.cfra;
+  pfjob->drain_time = time_start;
 
   while (seq_prefetch_cfra(pfjob) <= pfjob->scene->r.efra) {
     pfjob->scene_eval->ed->prefetch_job = NULL;
@@ -501,15 +748,29 @@ static void *seq_prefetch_frames(void *job)
     pfjob->scene_eval->ed->prefetch_job = pfjob;
 
     ListBase *seqbase = SEQ_active_seqbase_get(SEQ_editing_get(pfjob->scene_eval));
-    if (seq_prefetch_must_skip_frame(pfjob, seqbase)) {
+    if (seq_prefetch_must_skip_frame(pfjob, seqbase, seq_prefetch_cfra(pfjob))) {
       pfjob->num_frames_prefetched++;
       continue;
     }
 
+    /* Following frames are rendered by workers, while this thread renders current frame. */
+    const double batch_time_start = PIL_check_seconds_timer();
+    const int num_workers = seq_prefetch_workers_start(pfjob, task_pool);
+
+    const double render_time_start = PIL_check_seconds_timer();
     ImBuf *ibuf = SEQ_render_give_ibuf(&pfjob->context_cpy, seq_prefetch_cfra(pfjob), 0);
     seq_cache_free_temp_cache(pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
+    pfjob->render_time += PIL_check_seconds_timer() - render_time_start;
+    pfjob->num_frames_rendered++;
     IMB_freeImBuf(ibuf);
 
+    if (num_workers > 0) {
+      BLI_task_pool_work_and_wait(task_pool);
+      seq_prefetch_workers_finish(pfjob, num_workers);
+    }
+    seq_prefetch_update_num_frames_concurrent(
+        pfjob, num_workers + 1, PIL_check_seconds_timer() - batch_time_start);
+
     /* Suspend thread if there is nothing to be prefetched. */
     seq_prefetch_do_suspend(pfjob);
 
@@ -528,6 +789,12 @@ static void *seq_prefetch_frames(void *job)
   }
 
   seq_cache_free_temp_cache(pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
+  BLI_task_pool_free(task_pool);
+
+  if (G.debug & G_DEBUG_JOBS) {
+    seq_prefetch_print_timing_report(pfjob, PIL_check_seconds_timer() - time_start);
+  }
+
   pfjob->running = false;
   pfjob->scene_eval->ed->prefetch_job = NULL;
 
@@ -549,6 +816,9 @@ static PrefetchJob *seq_prefetch_start_ex(const SeqRenderData *context, float cf
 
       pfjob->bmain_eval = BKE_main_new();
       pfjob->scene = context->scene;
+      pfjob->num_frames_concurrent = 1;
+      pfjob->num_frames_concurrent_max = clamp_i(
+          BLI_system_thread_count() / 2, 1, SEQ_PREFETCH_FRAMES_MAX);
       seq_prefetch_init_depsgraph(pfjob);
     }
   }
@@ -563,7 +833,7 @@ static PrefetchJob *seq_prefetch_start_ex(const SeqRenderData *context, float cf
 
   seq_prefetch_update_scene(context->scene);
   seq_prefetch_update_context(context);
-  seq_prefetch_update_active_seqbase(pfjob);
+  seq_prefetch_update_active_seqbase(pfjob, pfjob->scene_eval);
 
   BLI_threadpool_remove(&pfjob->threads, pfjob);
   BLI_threadpool_insert(&pfjob->threads, pfjob);
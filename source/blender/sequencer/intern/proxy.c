@@ -36,6 +36,8 @@
 #include "BLI_path_util.h"
 #include "BLI_session_uuid.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #ifdef WIN32
 #  include "BLI_winstuff.h"
@@ -265,63 +267,161 @@ ImBuf *seq_proxy_fetch(const SeqRenderData *context, Sequence *seq, int timeline
   return NULL;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Proxy Build Pipeline
+ *
+ * Strips are rendered frame by frame on the calling thread, while the rendered frames are scaled
+ * and saved for each proxy size in parallel tasks.
+ * \{ */
+
+typedef struct SeqProxyBuildPipeline {
+  ThreadMutex mutex;
+  ThreadCondition cond;
+  /* Number of pushed tasks which are not finished yet. */
+  int tasks_num;
+  /* Limits the number of rendered frames waiting for tasks, to limit memory usage. */
+  int tasks_max;
+} SeqProxyBuildPipeline;
+
+typedef struct SeqProxyOutputTask {
+  /* Rendered frame, shared between the proxy sizes. */
+  ImBuf *ibuf;
+  int proxy_render_size;
+  char name[PROXY_MAXFILE];
+} SeqProxyOutputTask;
+
+static void seq_proxy_pipeline_init(SeqProxyBuildPipeline *pipeline)
+{
+  BLI_mutex_init(&pipeline->mutex);
+  BLI_condition_init(&pipeline->cond);
+  pipeline->tasks_num = 0;
+  pipeline->tasks_max = 2 * BLI_system_thread_count();
+}
+
+static void seq_proxy_pipeline_end(SeqProxyBuildPipeline *pipeline)
+{
+  BLI_condition_end(&pipeline->cond);
+  BLI_mutex_end(&pipeline->mutex);
+}
+
+static void seq_proxy_output_task(TaskPool *__restrict pool, void *taskdata)
+{
+  SeqProxyBuildPipeline *pipeline = BLI_task_pool_user_data(pool);
+  SeqProxyOutputTask *task = taskdata;
+  ImBuf *ibuf_src = task->ibuf;
+  ImBuf *ibuf = ibuf_src;
+
+  const int rectx = (task->proxy_render_size * ibuf_src->x) / 100;
+  const int recty = (task->proxy_render_size * ibuf_src->y) / 100;
+
+  if (ibuf_src->x != rectx || ibuf_src->y != recty) {
+    ibuf = IMB_dupImBuf(ibuf_src);
+    IMB_metadata_copy(ibuf, ibuf_src);
+    IMB_scaleImBuf(ibuf, (unsigned int)rectx, (unsigned int)recty);
+  }
+
+  BLI_make_existing_file(task->name);
+
+  const bool ok = IMB_saveiff(ibuf, task->name, IB_rect | IB_zbuf | IB_zbuffloat);
+  if (ok == false) {
+    perror(task->name);
+  }
+
+  if (ibuf != ibuf_src) {
+    IMB_freeImBuf(ibuf);
+  }
+  IMB_freeImBuf(ibuf_src);
+
+  BLI_mutex_lock(&pipeline->mutex);
+  pipeline->tasks_num--;
+  BLI_condition_notify_one(&pipeline->cond);
+  BLI_mutex_unlock(&pipeline->mutex);
+}
+
+static void seq_proxy_output_push(TaskPool *pool,
+                                  ImBuf *ibuf,
+                                  const int proxy_render_size,
+                                  const char *name)
+{
+  SeqProxyBuildPipeline *pipeline = BLI_task_pool_user_data(pool);
+
+  BLI_mutex_lock(&pipeline->mutex);
+  while (pipeline->tasks_num >= pipeline->tasks_max) {
+    BLI_condition_wait(&pipeline->cond, &pipeline->mutex);
+  }
+  pipeline->tasks_num++;
+  BLI_mutex_unlock(&pipeline->mutex);
+
+  SeqProxyOutputTask *task = MEM_mallocN(sizeof(SeqProxyOutputTask), __func__);
+  task->ibuf = ibuf;
+  task->proxy_render_size = proxy_render_size;
+  BLI_strncpy(task->name, name, sizeof(task->name));
+  IMB_refImBuf(ibuf);
+
+  BLI_task_pool_push(pool, seq_proxy_output_task, task, true, NULL);
+}
+
+/* Render the strip once and push tasks to save all requested proxy sizes of the frame. */
 static void seq_proxy_build_frame(const SeqRenderData *context,
                                   SeqRenderState *state,
+                                  TaskPool *pool,
                                   Sequence *seq,
                                   int timeline_frame,
-                                  int proxy_render_size,
+                                  const int size_flags,
                                   const bool overwrite)
 {
-  char name[PROXY_MAXFILE];
-  int quality;
-  int rectx, recty;
-  ImBuf *ibuf_tmp, *ibuf;
+  const int proxy_render_sizes[] = {25, 50, 75, 100};
+  const int proxy_sizes[] = {IMB_PROXY_25, IMB_PROXY_50, IMB_PROXY_75, IMB_PROXY_100};
+  char names[ARRAY_SIZE(proxy_sizes)][PROXY_MAXFILE];
+  bool need_build[ARRAY_SIZE(proxy_sizes)];
+  bool need_render = false;
   Editing *ed = context->scene->ed;
 
-  if (!seq_proxy_get_fname(ed, seq, timeline_frame, proxy_render_size, name, context->view_id)) {
-    return;
+  for (int i = 0; i < ARRAY_SIZE(proxy_sizes); i++) {
+    need_build[i] = (size_flags & proxy_sizes[i]) &&
+                    seq_proxy_get_fname(ed,
+                                        seq,
+                                        timeline_frame,
+                                        proxy_render_sizes[i],
+                                        names[i],
+                                        context->view_id) &&
+                    (overwrite || !BLI_exists(names[i]));
+    need_render |= need_build[i];
   }
 
-  if (!overwrite && BLI_exists(name)) {
+  if (!need_render) {
     return;
   }
 
-  ibuf_tmp = seq_render_strip(context, state, seq, timeline_frame);
+  ImBuf *ibuf = seq_render_strip(context, state, seq, timeline_frame);
 
-  rectx = (proxy_render_size * ibuf_tmp->x) / 100;
-  recty = (proxy_render_size * ibuf_tmp->y) / 100;
-
-  if (ibuf_tmp->x != rectx || ibuf_tmp->y != recty) {
-    ibuf = IMB_dupImBuf(ibuf_tmp);
-    IMB_metadata_copy(ibuf, ibuf_tmp);
-    IMB_freeImBuf(ibuf_tmp);
-    IMB_scalefastImBuf(ibuf, (short)rectx, (short)recty);
-  }
-  else {
-    ibuf = ibuf_tmp;
+  /* Proxies are saved as JPEG, convert to bytes once instead of for every proxy size. */
+  if (ibuf->rect == NULL) {
+    IMB_rect_from_float(ibuf);
   }
+  imb_freerectfloatImBuf(ibuf);
 
   /* depth = 32 is intentionally left in, otherwise ALPHA channels
    * won't work... */
-  quality = seq->strip->proxy->quality;
   ibuf->ftype = IMB_FTYPE_JPG;
-  ibuf->foptions.quality = quality;
+  ibuf->foptions.quality = seq->strip->proxy->quality;
 
   /* unsupported feature only confuses other s/w */
   if (ibuf->planes == 32) {
     ibuf->planes = 24;
   }
 
-  BLI_make_existing_file(name);
-
-  const bool ok = IMB_saveiff(ibuf, name, IB_rect | IB_zbuf | IB_zbuffloat);
-  if (ok == false) {
-    perror(name);
+  for (int i = 0; i < ARRAY_SIZE(proxy_sizes); i++) {
+    if (need_build[i]) {
+      seq_proxy_output_push(pool, ibuf, proxy_render_sizes[i], names[i]);
+    }
   }
 
   IMB_freeImBuf(ibuf);
 }
 
+/** \} */
+
 /**
  * Returns whether the file this context would read from even exist,
  * if not, don't create the context
@@ -540,21 +640,15 @@ void SEQ_proxy_rebuild(SeqIndexBuildContext *context,
   SeqRenderState state;
   seq_render_state_init(&state);
 
+  SeqProxyBuildPipeline pipeline;
+  seq_proxy_pipeline_init(&pipeline);
+  TaskPool *pool = BLI_task_pool_create_background(&pipeline, TASK_PRIORITY_LOW);
+
   for (timeline_frame = seq->startdisp + seq->startstill;
        timeline_frame < seq->enddisp - seq->endstill;
        timeline_frame++) {
-    if (context->size_flags & IMB_PROXY_25) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 25, overwrite);
-    }
-    if (context->size_flags & IMB_PROXY_50) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 50, overwrite);
-    }
-    if (context->size_flags & IMB_PROXY_75) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 75, overwrite);
-    }
-    if (context->size_flags & IMB_PROXY_100) {
-      seq_proxy_build_frame(&render_context, &state, seq, timeline_frame, 100, overwrite);
-    }
+    seq_proxy_build_frame(
+        &render_context, &state, pool, seq, timeline_frame, context->size_flags, overwrite);
 
     *progress = (float)(timeline_frame - seq->startdisp - seq->startstill) /
                 (seq->enddisp - seq->endstill - seq->startdisp - seq->startstill);
@@ -564,6 +658,10 @@ void SEQ_proxy_rebuild(SeqIndexBuildContext *context,
       break;
     }
   }
+
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+  seq_proxy_pipeline_end(&pipeline);
 }
 
 static bool seq_orig_free_anims(Sequence *seq_iter, void *data)
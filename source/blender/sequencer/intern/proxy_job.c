@@ -28,6 +28,8 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_ghash.h"
+#include "BLI_math_base.h"
+#include "BLI_threads.h"
 #include "BLI_timecode.h"
 
 #include "DNA_scene_types.h"
@@ -48,6 +50,10 @@
 
 #include "RNA_define.h"
 
+#include "PIL_time.h"
+
+#include "atomic_ops.h"
+
 static void proxy_freejob(void *pjv)
 {
   ProxyJob *pj = pjv;
@@ -57,23 +63,92 @@ static void proxy_freejob(void *pjv)
   MEM_freeN(pj);
 }
 
+/* Building proxies of a strip uses a thread for decoding and threads for saving each proxy size,
+ * so the number of strips built at once is a fraction of the available threads. */
+#define PROXY_BUILD_THREADS_PER_STRIP 4
+
+typedef struct ProxyBuildThreadData {
+  struct SeqIndexBuildContext **contexts;
+  /* Progress of each strip. */
+  float *progress;
+  int contexts_num;
+  /* Index of the next strip to build. */
+  int next_context;
+  int contexts_done;
+
+  short *stop;
+  short *do_update;
+} ProxyBuildThreadData;
+
+static void *proxy_build_thread(void *data_v)
+{
+  ProxyBuildThreadData *data = data_v;
+
+  while (!*data->stop) {
+    const int index = atomic_fetch_and_add_int32(&data->next_context, 1);
+    if (index >= data->contexts_num) {
+      break;
+    }
+
+    SEQ_proxy_rebuild(data->contexts[index], data->stop, data->do_update, &data->progress[index]);
+    data->progress[index] = 1.0f;
+    atomic_add_and_fetch_int32(&data->contexts_done, 1);
+  }
+  return NULL;
+}
+
 /* Only this runs inside thread. */
 static void proxy_startjob(void *pjv, short *stop, short *do_update, float *progress)
 {
   ProxyJob *pj = pjv;
-  LinkData *link;
+  ProxyBuildThreadData data = {NULL};
 
-  for (link = pj->queue.first; link; link = link->next) {
-    struct SeqIndexBuildContext *context = link->data;
+  data.contexts_num = BLI_listbase_count(&pj->queue);
+  if (data.contexts_num == 0) {
+    return;
+  }
 
-    SEQ_proxy_rebuild(context, stop, do_update, progress);
+  data.contexts = MEM_mallocN(sizeof(*data.contexts) * data.contexts_num, __func__);
+  data.progress = MEM_callocN(sizeof(*data.progress) * data.contexts_num, __func__);
+  data.stop = stop;
+  data.do_update = do_update;
 
-    if (*stop) {
-      pj->stop = 1;
-      fprintf(stderr, "Canceling proxy rebuild on users request...\n");
-      break;
+  int index = 0;
+  LISTBASE_FOREACH (LinkData *, link, &pj->queue) {
+    data.contexts[index++] = link->data;
+  }
+
+  /* Strips are built in separate threads, each thread takes the next strip from the queue until
+   * all are built. */
+  const int threads_num = clamp_i(
+      BLI_system_thread_count() / PROXY_BUILD_THREADS_PER_STRIP, 1, data.contexts_num);
+  ListBase threads;
+  BLI_threadpool_init(&threads, proxy_build_thread, threads_num);
+  for (int i = 0; i < threads_num; i++) {
+    BLI_threadpool_insert(&threads, &data);
+  }
+
+  /* Total progress is the average of the progress of all strips. */
+  while (!*stop && atomic_add_and_fetch_int32(&data.contexts_done, 0) < data.contexts_num) {
+    PIL_sleep_ms(50);
+
+    float progress_sum = 0.0f;
+    for (int i = 0; i < data.contexts_num; i++) {
+      progress_sum += data.progress[i];
     }
+    *progress = progress_sum / data.contexts_num;
+    *do_update = true;
+  }
+
+  BLI_threadpool_end(&threads);
+
+  if (*stop) {
+    pj->stop = 1;
+    fprintf(stderr, "Canceling proxy rebuild on users request...\n");
   }
+
+  MEM_freeN(data.contexts);
+  MEM_freeN(data.progress);
 }
 
 static void proxy_endjob(void *pjv)
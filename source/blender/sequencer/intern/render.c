@@ -39,6 +39,7 @@
 #include "BLI_listbase.h"
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
+#include "BLI_task.h"
 
 #include "BKE_anim_data.h"
 #include "BKE_animsys.h"
@@ -61,6 +62,8 @@
 #include "IMB_imbuf_types.h"
 #include "IMB_metadata.h"
 
+#include "PIL_time.h"
+
 #include "RNA_access.h"
 
 #include "RE_engine.h"
@@ -245,6 +248,7 @@ void SEQ_render_new_render_data(Main *bmain,
 void seq_render_state_init(SeqRenderState *state)
 {
   state->scene_parents = NULL;
+  state->deferred_cache_puts = NULL;
 }
 
 StripElem *SEQ_render_give_stripelem(Sequence *seq, int timeline_frame)
@@ -524,8 +528,12 @@ static void sequencer_preprocess_transform_crop(
   const float crop_scale_factor = do_scale_to_render_size ? preview_scale_factor : 1.0f;
   sequencer_image_crop_init(seq, in, crop_scale_factor, &source_crop);
 
-  const eIMBInterpolationFilterMode filter = context->for_render ? IMB_FILTER_BILINEAR :
-                                                                   IMB_FILTER_NEAREST;
+  eIMBInterpolationFilterMode filter = IMB_FILTER_NEAREST;
+  if (context->for_render) {
+    /* Box filter is same as bilinear, unless image is downscaled. */
+    filter = (seq->strip->transform->filter == SEQ_TRANSFORM_FILTER_BOX) ? IMB_FILTER_BOX :
+                                                                           IMB_FILTER_BILINEAR;
+  }
   IMB_transform(in, out, IMB_TRANSFORM_MODE_CROP_SRC, filter, transform_matrix, &source_crop);
 
   if (!seq_image_transform_transparency_gained(context, seq)) {
@@ -655,7 +663,43 @@ static ImBuf *input_preprocess(const SeqRenderData *context,
   return preprocessed_ibuf;
 }
 
+/** Cache entry of a strip, which is rendered concurrently with other strips of a stack. */
+typedef struct SeqDeferredCachePut {
+  struct SeqDeferredCachePut *next, *prev;
+  int type;
+  ImBuf *ibuf;
+} SeqDeferredCachePut;
+
+static void seq_render_cache_put(const SeqRenderData *context,
+                                 SeqRenderState *state,
+                                 Sequence *seq,
+                                 float timeline_frame,
+                                 int type,
+                                 ImBuf *ibuf)
+{
+  if (state == NULL || state->deferred_cache_puts == NULL) {
+    seq_cache_put(context, seq, timeline_frame, type, ibuf);
+    return;
+  }
+
+  if (ibuf == NULL) {
+    return;
+  }
+
+  /* Reference the image like the cache does, so it is not modified in place. */
+  SeqDeferredCachePut *put = MEM_mallocN(sizeof(*put), __func__);
+  put->type = type;
+  put->ibuf = ibuf;
+  IMB_refImBuf(ibuf);
+  BLI_addtail(state->deferred_cache_puts, put);
+}
+
+/**
+ * \param state: Can be NULL for strips, that are never rendered concurrently with other strips
+ * (multi-view images).
+ */
 static ImBuf *seq_render_preprocess_ibuf(const SeqRenderData *context,
+                                         SeqRenderState *state,
                                          Sequence *seq,
                                          ImBuf *ibuf,
                                          float timeline_frame,
@@ -669,14 +713,14 @@ static ImBuf *seq_render_preprocess_ibuf(const SeqRenderData *context,
 
   /* Proxies and effect strips are not stored in cache. */
   if (!is_proxy_image && (seq->type & SEQ_TYPE_EFFECT) == 0) {
-    seq_cache_put(context, seq, timeline_frame, SEQ_CACHE_STORE_RAW, ibuf);
+    seq_render_cache_put(context, state, seq, timeline_frame, SEQ_CACHE_STORE_RAW, ibuf);
   }
 
   if (use_preprocess) {
     ibuf = input_preprocess(context, seq, timeline_frame, ibuf, is_proxy_image);
   }
 
-  seq_cache_put(context, seq, timeline_frame, SEQ_CACHE_STORE_PREPROCESSED, ibuf);
+  seq_render_cache_put(context, state, seq, timeline_frame, SEQ_CACHE_STORE_PREPROCESSED, ibuf);
   return ibuf;
 }
 
@@ -983,7 +1027,7 @@ static ImBuf *seq_render_image_strip(const SeqRenderData *context,
 
       if (view_id != context->view_id) {
         ibufs_arr[view_id] = seq_render_preprocess_ibuf(
-            &localcontext, seq, ibufs_arr[view_id], timeline_frame, true, false);
+            &localcontext, NULL, seq, ibufs_arr[view_id], timeline_frame, true, false);
       }
     }
 
@@ -1131,7 +1175,7 @@ static ImBuf *seq_render_movie_strip(const SeqRenderData *context,
 
       if (view_id != context->view_id) {
         ibuf_arr[view_id] = seq_render_preprocess_ibuf(
-            &localcontext, seq, ibuf_arr[view_id], timeline_frame, true, false);
+            &localcontext, NULL, seq, ibuf_arr[view_id], timeline_frame, true, false);
       }
     }
 
@@ -1727,6 +1771,8 @@ ImBuf *seq_render_strip(const SeqRenderData *context,
     return ibuf;
   }
 
+  const double time_start = PIL_check_seconds_timer();
+
   /* Proxies are not stored in cache. */
   if (!SEQ_can_use_proxy(
           context, seq, SEQ_rendersize_to_proxysize(context->preview_render_size))) {
@@ -1740,7 +1786,7 @@ ImBuf *seq_render_strip(const SeqRenderData *context,
   if (ibuf) {
     use_preprocess = seq_input_have_to_preprocess(context, seq, timeline_frame);
     ibuf = seq_render_preprocess_ibuf(
-        context, seq, ibuf, timeline_frame, use_preprocess, is_proxy_image);
+        context, state, seq, ibuf, timeline_frame, use_preprocess, is_proxy_image);
   }
 
   if (ibuf == NULL) {
@@ -1748,6 +1794,8 @@ ImBuf *seq_render_strip(const SeqRenderData *context,
     seq_imbuf_assign_spaces(context->scene, ibuf);
   }
 
+  seq->runtime.render_time = (float)(PIL_check_seconds_timer() - time_start);
+
   return ibuf;
 }
 
@@ -1816,6 +1864,168 @@ static ImBuf *seq_render_strip_stack_apply_effect(
   return out;
 }
 
+/** Image of a stack strip, rendered before blending of the stack starts. */
+typedef struct SeqStackInput {
+  ImBuf *ibuf;
+  ListBase cache_puts;
+} SeqStackInput;
+
+typedef struct SeqStackInputsTaskData {
+  const SeqRenderData *context;
+  Sequence **seq_arr;
+  const int *indices;
+  SeqStackInput *inputs;
+  float timeline_frame;
+} SeqStackInputsTaskData;
+
+/**
+ * Find strips of the stack, whose images are used for blending. This follows the search of
+ * #seq_render_strip_stack, but stops at strips whose image must be inspected first.
+ */
+static void seq_render_stack_inputs_find(const SeqRenderData *context,
+                                         Sequence **seq_arr,
+                                         int count,
+                                         float timeline_frame,
+                                         bool *r_is_input)
+{
+  int i;
+  for (i = count - 1; i >= 0; i--) {
+    Sequence *seq = seq_arr[i];
+
+    ImBuf *out = seq_cache_get(context, seq, timeline_frame, SEQ_CACHE_STORE_COMPOSITE);
+    if (out) {
+      IMB_freeImBuf(out);
+      break;
+    }
+
+    const int early_out = seq_get_early_out_for_blend_mode(seq);
+    if (seq->blend_mode == SEQ_BLEND_REPLACE ||
+        ELEM(early_out, EARLY_NO_INPUT, EARLY_USE_INPUT_2) ||
+        (seq->blend_mode == SEQ_TYPE_ALPHAOVER && seq->blend_opacity == 100.0f)) {
+      r_is_input[i] = true;
+      break;
+    }
+    if (early_out == EARLY_DO_EFFECT && i == 0) {
+      r_is_input[i] = true;
+    }
+  }
+
+  for (i++; i < count; i++) {
+    if (seq_get_early_out_for_blend_mode(seq_arr[i]) == EARLY_DO_EFFECT) {
+      r_is_input[i] = true;
+    }
+  }
+}
+
+static bool seq_render_stack_input_is_concurrent(Sequence *seq)
+{
+  /* Other strip types render other strips, scenes or use API which is not thread safe. */
+  if (!ELEM(seq->type, SEQ_TYPE_IMAGE, SEQ_TYPE_MOVIE, SEQ_TYPE_MOVIECLIP)) {
+    return false;
+  }
+  /* Other views are stored in cache directly. */
+  if (seq->flag & SEQ_USE_VIEWS) {
+    return false;
+  }
+  /* Masks of modifiers are rendered from other strips. */
+  LISTBASE_FOREACH (SequenceModifierData *, smd, &seq->modifiers) {
+    if (smd->mask_sequence != NULL || smd->mask_id != NULL) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void seq_render_stack_inputs_task(void *__restrict userdata,
+                                         const int index,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SeqStackInputsTaskData *data = (SeqStackInputsTaskData *)userdata;
+  const int i = data->indices[index];
+  SeqStackInput *input = &data->inputs[i];
+
+  SeqRenderState state;
+  seq_render_state_init(&state);
+  state.deferred_cache_puts = &input->cache_puts;
+
+  input->ibuf = seq_render_strip(data->context, &state, data->seq_arr[i], data->timeline_frame);
+}
+
+/**
+ * Decode and preprocess images of stack strips concurrently. Blending is still done in stack
+ * order, images are taken by #seq_render_stack_input.
+ */
+static void seq_render_stack_inputs_render(const SeqRenderData *context,
+                                           Sequence **seq_arr,
+                                           int count,
+                                           float timeline_frame,
+                                           SeqStackInput *inputs)
+{
+  bool is_input[MAXSEQ + 1] = {false};
+  int indices[MAXSEQ + 1];
+  int num_inputs = 0;
+
+  seq_render_stack_inputs_find(context, seq_arr, count, timeline_frame, is_input);
+  for (int i = 0; i < count; i++) {
+    if (is_input[i] && seq_render_stack_input_is_concurrent(seq_arr[i])) {
+      indices[num_inputs++] = i;
+    }
+  }
+
+  if (num_inputs < 2) {
+    return;
+  }
+
+  SeqStackInputsTaskData data = {
+      .context = context,
+      .seq_arr = seq_arr,
+      .indices = indices,
+      .inputs = inputs,
+      .timeline_frame = timeline_frame,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, num_inputs, &data, seq_render_stack_inputs_task, &settings);
+}
+
+/**
+ * Get image of a stack strip. Cache entries of concurrently rendered strips are stored now, so
+ * they are stored in the same order as if strips were rendered one by one.
+ */
+static ImBuf *seq_render_stack_input(const SeqRenderData *context,
+                                     SeqRenderState *state,
+                                     Sequence *seq,
+                                     SeqStackInput *input,
+                                     float timeline_frame)
+{
+  if (input->ibuf == NULL) {
+    return seq_render_strip(context, state, seq, timeline_frame);
+  }
+
+  LISTBASE_FOREACH_MUTABLE (SeqDeferredCachePut *, put, &input->cache_puts) {
+    seq_cache_put(context, seq, timeline_frame, put->type, put->ibuf);
+    IMB_freeImBuf(put->ibuf);
+    MEM_freeN(put);
+  }
+  BLI_listbase_clear(&input->cache_puts);
+
+  ImBuf *ibuf = input->ibuf;
+  input->ibuf = NULL;
+  return ibuf;
+}
+
+/* Images which were not used, because search ended earlier than expected. */
+static void seq_render_stack_inputs_free(SeqStackInput *inputs, int count)
+{
+  for (int i = 0; i < count; i++) {
+    LISTBASE_FOREACH_MUTABLE (SeqDeferredCachePut *, put, &inputs[i].cache_puts) {
+      IMB_freeImBuf(put->ibuf);
+      MEM_freeN(put);
+    }
+    IMB_freeImBuf(inputs[i].ibuf);
+  }
+}
+
 static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      SeqRenderState *state,
                                      ListBase *seqbasep,
@@ -1833,6 +2043,10 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     return NULL;
   }
 
+  SeqStackInput inputs[MAXSEQ + 1];
+  memset(inputs, 0, sizeof(*inputs) * count);
+  seq_render_stack_inputs_render(context, seq_arr, count, timeline_frame, inputs);
+
   for (i = count - 1; i >= 0; i--) {
     int early_out;
     Sequence *seq = seq_arr[i];
@@ -1843,7 +2057,7 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
       break;
     }
     if (seq->blend_mode == SEQ_BLEND_REPLACE) {
-      out = seq_render_strip(context, state, seq, timeline_frame);
+      out = seq_render_stack_input(context, state, seq, &inputs[i], timeline_frame);
       break;
     }
 
@@ -1852,7 +2066,7 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     /* Early out for alpha over. It requires image to be rendered, so it can't use
      * `seq_get_early_out_for_blend_mode`. */
     if (out == NULL && seq->blend_mode == SEQ_TYPE_ALPHAOVER && seq->blend_opacity == 100.0f) {
-      ImBuf *test = seq_render_strip(context, state, seq, timeline_frame);
+      ImBuf *test = seq_render_stack_input(context, state, seq, &inputs[i], timeline_frame);
       if (ELEM(test->planes, R_IMF_PLANES_BW, R_IMF_PLANES_RGB)) {
         early_out = EARLY_USE_INPUT_2;
       }
@@ -1866,7 +2080,7 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     switch (early_out) {
       case EARLY_NO_INPUT:
       case EARLY_USE_INPUT_2:
-        out = seq_render_strip(context, state, seq, timeline_frame);
+        out = seq_render_stack_input(context, state, seq, &inputs[i], timeline_frame);
         break;
       case EARLY_USE_INPUT_1:
         if (i == 0) {
@@ -1876,7 +2090,8 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
       case EARLY_DO_EFFECT:
         if (i == 0) {
           ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-          ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
+          ImBuf *ibuf2 = seq_render_stack_input(
+              context, state, seq, &inputs[i], timeline_frame);
 
           out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
 
@@ -1899,7 +2114,7 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
 
     if (seq_get_early_out_for_blend_mode(seq) == EARLY_DO_EFFECT) {
       ImBuf *ibuf1 = out;
-      ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
+      ImBuf *ibuf2 = seq_render_stack_input(context, state, seq, &inputs[i], timeline_frame);
 
       out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
 
@@ -1910,6 +2125,8 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     seq_cache_put(context, seq_arr[i], timeline_frame, SEQ_CACHE_STORE_COMPOSITE, out);
   }
 
+  seq_render_stack_inputs_free(inputs, count);
+
   return out;
 }
 
@@ -1949,7 +2166,13 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
   SEQ_relations_free_all_anim_ibufs(context->scene, timeline_frame);
 
   if (count && !out) {
-    BLI_mutex_lock(&seq_render_mutex);
+    /* Additional prefetch workers don't access the cache, so they can render concurrently with
+     * other threads, see `seq_prefetch_frames`. */
+    const bool use_render_mutex = !(context->is_prefetch_render && context->skip_cache);
+
+    if (use_render_mutex) {
+      BLI_mutex_lock(&seq_render_mutex);
+    }
     out = seq_render_strip_stack(context, &state, seqbasep, timeline_frame, chanshown);
 
     if (context->is_prefetch_render) {
@@ -1959,7 +2182,9 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
       seq_cache_put_if_possible(
           context, seq_arr[count - 1], timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, out);
     }
-    BLI_mutex_unlock(&seq_render_mutex);
+    if (use_render_mutex) {
+      BLI_mutex_unlock(&seq_render_mutex);
+    }
   }
 
   seq_prefetch_start(context, timeline_frame);
@@ -1967,6 +2192,16 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
   return out;
 }
 
+void seq_render_final_image_cache_put(const SeqRenderData *context,
+                                      Sequence *seq,
+                                      float timeline_frame,
+                                      ImBuf *ibuf)
+{
+  BLI_mutex_lock(&seq_render_mutex);
+  seq_cache_put(context, seq, timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, ibuf);
+  BLI_mutex_unlock(&seq_render_mutex);
+}
+
 ImBuf *seq_render_give_ibuf_seqbase(const SeqRenderData *context,
                                     float timeline_frame,
                                     int chan_shown,
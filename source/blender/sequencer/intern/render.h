@@ -42,6 +42,9 @@ struct Sequence;
 /* mutable state for sequencer */
 typedef struct SeqRenderState {
   struct LinkNode *scene_parents;
+  /* Cache entries of a strip, which is rendered concurrently with other strips of a stack.
+   * They are stored when the stack uses the strip image, see `seq_render_strip_stack`. */
+  struct ListBase *deferred_cache_puts;
 } SeqRenderState;
 
 void seq_render_state_init(SeqRenderState *state);
@@ -72,6 +75,14 @@ struct ImBuf *seq_render_mask(const struct SeqRenderData *context,
                               float frame_index,
                               bool make_float);
 void seq_imbuf_assign_spaces(struct Scene *scene, struct ImBuf *ibuf);
+/**
+ * Store final image, which was rendered without cache access, so it doesn't interfere with
+ * cache key linking of other renders.
+ */
+void seq_render_final_image_cache_put(const struct SeqRenderData *context,
+                                      struct Sequence *seq,
+                                      float timeline_frame,
+                                      struct ImBuf *ibuf);
 
 #ifdef __cplusplus
 }
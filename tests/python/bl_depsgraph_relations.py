@@ -0,0 +1,130 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Compare relations of the dependency graph after incremental updates against a full rebuild.
+
+blender -b -noaudio --factory-startup --python tests/python/bl_depsgraph_relations.py
+"""
+
+import sys
+import unittest
+
+import bpy
+
+
+class DepsgraphRelationsUpdateTest(unittest.TestCase):
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        self.scene = bpy.context.scene
+        self.objects = []
+        for index in range(4):
+            mesh = bpy.data.meshes.new("Mesh%d" % index)
+            mesh.from_pydata(((0, 0, 0), (1, 0, 0), (0, 1, 0)), (), ((0, 1, 2),))
+            ob = bpy.data.objects.new("Object%d" % index, mesh)
+            ob.location.x = index * 2.0
+            self.scene.collection.objects.link(ob)
+            self.objects.append(ob)
+        self.empty = bpy.data.objects.new("Empty", None)
+        self.scene.collection.objects.link(self.empty)
+        self.objects[1].parent = self.objects[0]
+        self.evaluate()
+
+    def evaluate(self):
+        return bpy.context.evaluated_depsgraph_get()
+
+    def assertRelationsValid(self):
+        depsgraph = self.evaluate()
+        self.assertTrue(depsgraph.debug_relations_validate())
+
+    def test_modifier_add(self):
+        ob = self.objects[2]
+        md = ob.modifiers.new("Array", 'ARRAY')
+        self.assertRelationsValid()
+        md.use_object_offset = True
+        md.offset_object = self.objects[3]
+        self.assertRelationsValid()
+        ob.modifiers.new("Subdivision", 'SUBSURF')
+        self.assertRelationsValid()
+
+    def test_modifier_target_change(self):
+        ob = self.objects[0]
+        md = ob.modifiers.new("Hook", 'HOOK')
+        md.object = self.empty
+        self.assertRelationsValid()
+        md.object = self.objects[3]
+        self.assertRelationsValid()
+        md.object = None
+        self.assertRelationsValid()
+
+    def test_modifier_remove(self):
+        ob = self.objects[1]
+        md = ob.modifiers.new("Shrinkwrap", 'SHRINKWRAP')
+        md.target = self.objects[2]
+        self.assertRelationsValid()
+        ob.modifiers.remove(md)
+        self.assertRelationsValid()
+
+    def test_constraint_target(self):
+        ob = self.objects[3]
+        con = ob.constraints.new('COPY_LOCATION')
+        con.target = self.objects[1]
+        self.assertRelationsValid()
+        con.target = self.empty
+        self.assertRelationsValid()
+        con = self.empty.constraints.new('TRACK_TO')
+        con.target = ob
+        self.assertRelationsValid()
+
+    def test_driver_add(self):
+        ob = self.objects[2]
+        fcurve = ob.driver_add("location", 2)
+        driver = fcurve.driver
+        driver.type = 'AVERAGE'
+        var = driver.variables.new()
+        var.type = 'TRANSFORMS'
+        var.targets[0].id = self.objects[0]
+        var.targets[0].transform_type = 'LOC_X'
+        ob.driver_add("scale", 0)
+        self.assertRelationsValid()
+
+    def test_evaluated_result(self):
+        ob = self.objects[2]
+        con = ob.constraints.new('COPY_LOCATION')
+        con.target = self.objects[3]
+        depsgraph = self.evaluate()
+        ob_eval = ob.evaluated_get(depsgraph)
+        self.assertAlmostEqual(ob_eval.matrix_world.translation.x, 6.0)
+        self.objects[3].location.x = 10.0
+        depsgraph = self.evaluate()
+        ob_eval = ob.evaluated_get(depsgraph)
+        self.assertAlmostEqual(ob_eval.matrix_world.translation.x, 10.0)
+
+
+def main():
+    # Run tests without the Blender arguments.
+    argv = [sys.argv[0]]
+    if '--' in sys.argv:
+        argv += sys.argv[sys.argv.index('--') + 1:]
+    unittest.main(argv=argv)
+
+
+if __name__ == '__main__':
+    main()
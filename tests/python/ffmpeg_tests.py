@@ -22,6 +22,7 @@
 import argparse
 import pathlib
 import sys
+import tempfile
 import unittest
 
 from modules.test_utils import AbstractBlenderRunnerTest
@@ -101,6 +102,79 @@ class FPSDetectionTest(AbstractFFmpegSequencerTest):
             50)
 
 
+class DecodeAheadTest(AbstractFFmpegTest):
+    """Frames must match the requested position, regardless of frames decoded ahead."""
+
+    # Each frame has its index encoded in the levels of the color channels.
+    frames_num = 27
+
+    def get_script_for_frames(self, tempdir: pathlib.Path, frames: list) -> str:
+        return (
+            "import bpy\n"
+            "levels = (0.0, 0.5, 1.0)\n"
+            "scene = bpy.context.scene\n"
+            "scene.render.resolution_x = 64\n"
+            "scene.render.resolution_y = 64\n"
+            "scene.render.resolution_percentage = 100\n"
+            "scene.frame_start = 1\n"
+            "scene.frame_end = %d\n"
+            "scene.render.image_settings.file_format = 'FFMPEG'\n"
+            "scene.render.image_settings.color_mode = 'RGB'\n"
+            "scene.render.ffmpeg.format = 'MKV'\n"
+            "scene.render.ffmpeg.codec = 'FFV1'\n"
+            "scene.render.filepath = %r\n"
+            "scene.sequence_editor_create()\n"
+            "strip = scene.sequence_editor.sequences.new_effect(\n"
+            "    'color', 'COLOR', channel=1, frame_start=1, frame_end=scene.frame_end + 1)\n"
+            "for index in range(scene.frame_end):\n"
+            "    strip.color = (levels[index %% 3], levels[index // 3 %% 3], levels[index // 9])\n"
+            "    strip.keyframe_insert('color', frame=index + 1)\n"
+            "bpy.ops.render.render(animation=True, scene=scene.name)\n"
+            "movie_path = scene.render.frame_path(frame=1)\n"
+            "playback = bpy.data.scenes.new('playback')\n"
+            "playback.render.resolution_x = 64\n"
+            "playback.render.resolution_y = 64\n"
+            "playback.render.resolution_percentage = 100\n"
+            "playback.sequence_editor_create()\n"
+            "playback.sequence_editor.sequences.new_movie(\n"
+            "    'movie', movie_path, channel=1, frame_start=1)\n"
+            "image_path = %r\n"
+            "for frame in %r:\n"
+            "    playback.frame_set(frame)\n"
+            "    bpy.ops.render.render(scene=playback.name)\n"
+            "    bpy.data.images['Render Result'].save_render(image_path, scene=playback)\n"
+            "    image = bpy.data.images.load(image_path)\n"
+            "    pixel = image.pixels[(32 * 64 + 32) * 4:(32 * 64 + 32) * 4 + 3]\n"
+            "    bpy.data.images.remove(image)\n"
+            "    codes = [0 if value < 0.25 else 2 if value > 0.85 else 1 for value in pixel]\n"
+            "    print(f'frame:{frame}:{codes[0] + codes[1] * 3 + codes[2] * 9}')\n"
+        ) % (self.frames_num,
+             (tempdir / "decode_ahead_").as_posix(),
+             (tempdir / "frame.png").as_posix(),
+             frames)
+
+    def check_frames(self, frames: list):
+        with tempfile.TemporaryDirectory() as tempdir:
+            script = self.get_script_for_frames(pathlib.Path(tempdir), frames)
+            output = self.run_blender('', script)
+        decoded_frames = []
+        for line in output.splitlines():
+            if line.startswith("frame:"):
+                _, frame, index = line.split(':')
+                self.assertEqual(int(index), int(frame) - 1, "Wrong image for frame " + frame)
+                decoded_frames.append(int(frame))
+        self.assertEqual(decoded_frames, frames)
+
+    def test_forward(self):
+        self.check_frames(list(range(1, self.frames_num + 1)))
+
+    def test_backward(self):
+        self.check_frames(list(range(self.frames_num, 0, -1)))
+
+    def test_scrubbing(self):
+        self.check_frames([5, 6, 7, 20, 3, 3, 4, 5, 6, 7, 8, 26, 1, 2, 4, 6, 8, 15, 14, 13, 12])
+
+
 if __name__ == '__main__':
     parser = argparse.ArgumentParser()
     parser.add_argument('--blender', required=True)